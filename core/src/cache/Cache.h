@@ -11,22 +11,42 @@
 
 #pragma once
 
-#include "LRU.h"
 #include "utils/Log.h"
 
 #include <atomic>
+#include <list>
+#include <memory>
 #include <mutex>
-#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace milvus {
 namespace cache {
 
+constexpr int64_t DEFAULT_CACHE_SHARD_NUM = 16;
+
+struct CacheShardStats {
+    int64_t item_count_ = 0;
+    int64_t usage_ = 0;
+    int64_t protected_usage_ = 0;
+    int64_t hits_ = 0;
+    int64_t misses_ = 0;
+    int64_t evictions_ = 0;
+};
+
+// The cache is split into shards by key hash, each shard has its own lock, so concurrent lookups of different
+// keys don't serialize on one mutex. Usage and capacity are global, an item can be as large as the whole cache.
+//
+// Each shard runs a 2Q policy: new items are admitted into the probation list, an item hit in probation is
+// promoted into the protected list. Eviction drains probation first, so a one-pass scan(loading a collection,
+// compaction) only replaces other probation items and can't flush the hot items.
 template <typename ItemObj>
 class Cache {
  public:
     // mem_capacity, units:GB
-    Cache(int64_t capacity_gb, int64_t cache_max_count, const std::string& header = "");
+    Cache(int64_t capacity_gb, int64_t cache_max_count, const std::string& header = "",
+          int64_t shard_num = DEFAULT_CACHE_SHARD_NUM);
     ~Cache() = default;
 
     int64_t
@@ -54,6 +74,18 @@ class Cache {
         freemem_percent_ = percent;
     }
 
+    // the protected lists can use at most this percent of capacity, the rest is left for new items,
+    // each shard is bounded by its own share of the limit
+    double
+    protected_percent() const {
+        return protected_percent_;
+    }
+
+    void
+    set_protected_percent(double percent) {
+        protected_percent_ = percent;
+    }
+
     size_t
     size() const;
 
@@ -78,24 +110,66 @@ class Cache {
     void
     clear();
 
+    std::vector<CacheShardStats>
+    shard_stats() const;
+
  private:
+    struct Entry {
+        std::string key_;
+        ItemObj item_;
+        int64_t size_ = 0;
+        bool protected_ = false;
+    };
+    using EntryList = std::list<Entry>;
+
+    struct Shard {
+        EntryList probation_;
+        EntryList protected_;
+        std::unordered_map<std::string, typename EntryList::iterator> entries_;
+        int64_t usage_ = 0;
+        int64_t protected_usage_ = 0;
+        int64_t hits_ = 0;
+        int64_t misses_ = 0;
+        int64_t evictions_ = 0;
+        mutable std::mutex mutex_;
+    };
+
+    Shard&
+    shard_of(const std::string& key) const;
+
+    // caller must hold the shard lock
+    void
+    erase_internal(Shard& shard, typename EntryList::iterator it);
+
+    // caller must hold the shard lock
+    bool
+    evict_one(Shard& shard, bool from_protected);
+
+    // caller must hold the shard lock
     void
-    insert_internal(const std::string& key, const ItemObj& item);
+    promote(Shard& shard, typename EntryList::iterator it);
 
+    // caller must hold the shard lock
     void
-    erase_internal(const std::string& key);
+    shrink_protected(Shard& shard);
 
     void
     free_memory_internal(const int64_t target_size);
 
  private:
     std::string header_;
-    int64_t usage_;
-    int64_t capacity_;
+    std::atomic<int64_t> usage_;
+    std::atomic<int64_t> protected_usage_;
+    std::atomic<int64_t> capacity_;
     double freemem_percent_;
+    double protected_percent_;
+    int64_t shard_max_count_;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
 
-    LRU<std::string, ItemObj> lru_;
-    mutable std::mutex mutex_;
+    // serialize eviction, shard locks are taken one by one inside
+    std::mutex evict_mutex_;
+    size_t evict_cursor_ = 0;
 };
 
 }  // namespace cache
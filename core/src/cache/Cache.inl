@@ -9,79 +9,161 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
 namespace milvus {
 namespace cache {
 
 constexpr double DEFAULT_THRESHOLD_PERCENT = 0.7;
+constexpr double DEFAULT_PROTECTED_PERCENT = 0.8;
 
 template <typename ItemObj>
-Cache<ItemObj>::Cache(int64_t capacity, int64_t cache_max_count, const std::string& header)
+Cache<ItemObj>::Cache(int64_t capacity, int64_t cache_max_count, const std::string& header, int64_t shard_num)
     : header_(header),
       usage_(0),
+      protected_usage_(0),
       capacity_(capacity),
       freemem_percent_(DEFAULT_THRESHOLD_PERCENT),
-      lru_(cache_max_count) {
+      protected_percent_(DEFAULT_PROTECTED_PERCENT) {
+    shard_num = std::max(shard_num, (int64_t)1);
+    shard_max_count_ = std::max(cache_max_count / shard_num, (int64_t)1);
+    for (int64_t i = 0; i < shard_num; ++i) {
+        shards_.emplace_back(std::make_unique<Shard>());
+    }
 }
 
 template <typename ItemObj>
 void
 Cache<ItemObj>::set_capacity(int64_t capacity) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (capacity > 0) {
         capacity_ = capacity;
-        free_memory_internal(capacity);
+        if (usage_ > capacity) {
+            free_memory_internal(capacity);
+        }
     }
 }
 
 template <typename ItemObj>
 size_t
 Cache<ItemObj>::size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return lru_.size();
+    size_t count = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex_);
+        count += shard->entries_.size();
+    }
+    return count;
 }
 
 template <typename ItemObj>
 bool
 Cache<ItemObj>::exists(const std::string& key) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return lru_.exists(key);
+    auto& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    return shard.entries_.find(key) != shard.entries_.end();
 }
 
 template <typename ItemObj>
 ItemObj
 Cache<ItemObj>::get(const std::string& key) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!lru_.exists(key)) {
+    auto& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto iter = shard.entries_.find(key);
+    if (iter == shard.entries_.end()) {
+        ++shard.misses_;
         return nullptr;
     }
-    return lru_.get(key);
+
+    ++shard.hits_;
+    promote(shard, iter->second);
+    return iter->second->item_;
 }
 
 template <typename ItemObj>
 void
 Cache<ItemObj>::insert(const std::string& key, const ItemObj& item) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    insert_internal(key, item);
+    if (item == nullptr) {
+        return;
+    }
+
+    int64_t item_size = item->Size();
+    auto& shard = shard_of(key);
+
+    // if key already exist, release old item, a protected item stays protected
+    bool was_protected = false;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto iter = shard.entries_.find(key);
+        if (iter != shard.entries_.end()) {
+            was_protected = iter->second->protected_;
+            erase_internal(shard, iter->second);
+        }
+    }
+
+    // free memory before insert, the new item must not be evicted by itself
+    if (usage_ + item_size > capacity_) {
+        LOG_SERVER_DEBUG_ << header_ << " Current usage " << (usage_ >> 20) << "MB is too high for capacity "
+                          << (capacity_ >> 20) << "MB, start free memory";
+        free_memory_internal(capacity_ - item_size);
+    }
+
+    // new item is admitted into probation list
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto iter = shard.entries_.find(key);
+    if (iter != shard.entries_.end()) {
+        was_protected = was_protected || iter->second->protected_;
+        erase_internal(shard, iter->second);
+    }
+    while ((int64_t)shard.entries_.size() >= shard_max_count_) {
+        if (!evict_one(shard, false) && !evict_one(shard, true)) {
+            break;
+        }
+    }
+
+    Entry entry;
+    entry.key_ = key;
+    entry.item_ = item;
+    entry.size_ = item_size;
+    shard.probation_.emplace_front(std::move(entry));
+    shard.entries_[key] = shard.probation_.begin();
+    shard.usage_ += item_size;
+    usage_ += item_size;
+    if (was_protected) {
+        promote(shard, shard.probation_.begin());
+    }
+
+    LOG_SERVER_DEBUG_ << header_ << " Insert " << key << " size: " << (item_size >> 20) << "MB into cache";
+    LOG_SERVER_DEBUG_ << header_ << " Usage: " << (usage_ >> 20) << "MB, Capacity: " << (capacity_ >> 20) << "MB";
 }
 
 template <typename ItemObj>
 void
 Cache<ItemObj>::erase(const std::string& key) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    erase_internal(key);
+    auto& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto iter = shard.entries_.find(key);
+    if (iter == shard.entries_.end()) {
+        return;
+    }
+
+    int64_t item_size = iter->second->size_;
+    erase_internal(shard, iter->second);
+    LOG_SERVER_DEBUG_ << header_ << " Erase " << key << " size: " << (item_size >> 20) << "MB from cache";
+    LOG_SERVER_DEBUG_ << header_ << " Usage: " << (usage_ >> 20) << "MB, Capacity: " << (capacity_ >> 20) << "MB";
 }
 
 template <typename ItemObj>
 bool
 Cache<ItemObj>::reserve(const int64_t item_size) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (item_size > capacity_) {
+    int64_t capacity = capacity_;
+    if (item_size > capacity) {
         LOG_SERVER_ERROR_ << header_ << " item size " << (item_size >> 20) << "MB too big to insert into cache capacity"
-                         << (capacity_ >> 20) << "MB";
+                          << (capacity >> 20) << "MB";
         return false;
     }
-    if (item_size > capacity_ - usage_) {
-        free_memory_internal(capacity_ - item_size);
+    if (item_size > capacity - usage_) {
+        free_memory_internal(capacity - item_size);
     }
     return true;
 }
@@ -89,102 +171,152 @@ Cache<ItemObj>::reserve(const int64_t item_size) {
 template <typename ItemObj>
 void
 Cache<ItemObj>::clear() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    lru_.clear();
-    usage_ = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex_);
+        usage_ -= shard->usage_;
+        protected_usage_ -= shard->protected_usage_;
+
+        shard->entries_.clear();
+        shard->probation_.clear();
+        shard->protected_.clear();
+        shard->usage_ = 0;
+        shard->protected_usage_ = 0;
+    }
     LOG_SERVER_DEBUG_ << header_ << " Clear cache !";
 }
 
-
 template <typename ItemObj>
 void
 Cache<ItemObj>::print() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    size_t cache_count = lru_.size();
-    // for (auto it = lru_.begin(); it != lru_.end(); ++it) {
-    //     LOG_SERVER_DEBUG_ << it->first;
-    // }
-    LOG_SERVER_DEBUG_ << header_ << " [item count]: " << cache_count << ", [usage] " << (usage_ >> 20)
-                     << "MB, [capacity] " << (capacity_ >> 20) << "MB";
+    int64_t count = 0, hits = 0, misses = 0, evictions = 0;
+    for (auto& stats : shard_stats()) {
+        count += stats.item_count_;
+        hits += stats.hits_;
+        misses += stats.misses_;
+        evictions += stats.evictions_;
+    }
+    LOG_SERVER_DEBUG_ << header_ << " [item count]: " << count << ", [usage] " << (usage_ >> 20) << "MB, [capacity] "
+                      << (capacity_ >> 20) << "MB, [protected] " << (protected_usage_ >> 20) << "MB, [hits] " << hits
+                      << ", [misses] " << misses << ", [evictions] " << evictions;
 }
 
 template <typename ItemObj>
-void
-Cache<ItemObj>::insert_internal(const std::string& key, const ItemObj& item) {
-    if (item == nullptr) {
-        return;
+std::vector<CacheShardStats>
+Cache<ItemObj>::shard_stats() const {
+    std::vector<CacheShardStats> stats_array;
+    stats_array.reserve(shards_.size());
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex_);
+        CacheShardStats stats;
+        stats.item_count_ = shard->entries_.size();
+        stats.usage_ = shard->usage_;
+        stats.protected_usage_ = shard->protected_usage_;
+        stats.hits_ = shard->hits_;
+        stats.misses_ = shard->misses_;
+        stats.evictions_ = shard->evictions_;
+        stats_array.push_back(stats);
     }
+    return stats_array;
+}
 
-    size_t item_size = item->Size();
+template <typename ItemObj>
+typename Cache<ItemObj>::Shard&
+Cache<ItemObj>::shard_of(const std::string& key) const {
+    return *shards_[std::hash<std::string>()(key) % shards_.size()];
+}
 
-    // if key already exist, subtract old item size
-    if (lru_.exists(key)) {
-        const ItemObj& old_item = lru_.get(key);
-        usage_ -= old_item->Size();
+template <typename ItemObj>
+void
+Cache<ItemObj>::erase_internal(Shard& shard, typename EntryList::iterator it) {
+    if (it->protected_) {
+        shard.protected_usage_ -= it->size_;
+        protected_usage_ -= it->size_;
     }
+    shard.usage_ -= it->size_;
+    usage_ -= it->size_;
 
-    // plus new item size
-    usage_ += item_size;
+    shard.entries_.erase(it->key_);
+    if (it->protected_) {
+        shard.protected_.erase(it);
+    } else {
+        shard.probation_.erase(it);
+    }
+}
 
-    // if usage exceed capacity, free some items
-    if (usage_ > capacity_) {
-        LOG_SERVER_DEBUG_ << header_ << " Current usage " << (usage_ >> 20) << "MB is too high for capacity "
-                         << (capacity_ >> 20) << "MB, start free memory";
-        free_memory_internal(capacity_);
+template <typename ItemObj>
+bool
+Cache<ItemObj>::evict_one(Shard& shard, bool from_protected) {
+    auto& list = from_protected ? shard.protected_ : shard.probation_;
+    if (list.empty()) {
+        return false;
     }
 
-    // insert new item
-    lru_.put(key, item);
-    LOG_SERVER_DEBUG_ << header_ << " Insert " << key << " size: " << (item_size >> 20) << "MB into cache";
-    LOG_SERVER_DEBUG_ << header_ << " Count: " << lru_.size() << ", Usage: " << (usage_ >> 20) << "MB, Capacity: "
-                     << (capacity_ >> 20) << "MB";
+    erase_internal(shard, std::prev(list.end()));
+    ++shard.evictions_;
+    return true;
 }
 
 template <typename ItemObj>
 void
-Cache<ItemObj>::erase_internal(const std::string& key) {
-    if (!lru_.exists(key)) {
+Cache<ItemObj>::promote(Shard& shard, typename EntryList::iterator it) {
+    if (it->protected_) {
+        shard.protected_.splice(shard.protected_.begin(), shard.protected_, it);
         return;
     }
 
-    const ItemObj& item = lru_.get(key);
-    size_t item_size = item->Size();
-
-    lru_.erase(key);
+    shard.protected_.splice(shard.protected_.begin(), shard.probation_, it);
+    it->protected_ = true;
+    shard.protected_usage_ += it->size_;
+    protected_usage_ += it->size_;
+    shrink_protected(shard);
+}
 
-    usage_ -= item_size;
-    LOG_SERVER_DEBUG_ << header_ << " Erase " << key << " size: " << (item_size >> 20) << "MB from cache";
-    LOG_SERVER_DEBUG_ << header_ << " Count: " << lru_.size() << ", Usage: " << (usage_ >> 20) << "MB, Capacity: "
-                     << (capacity_ >> 20) << "MB";
+template <typename ItemObj>
+void
+Cache<ItemObj>::shrink_protected(Shard& shard) {
+    // the shard's protected list is full, demote its least recently used items back to probation,
+    // the most recently promoted item is kept even if it alone exceeds the shard limit
+    auto shard_limit = (int64_t)(capacity_ * protected_percent_ / shards_.size());
+    while (shard.protected_usage_ > shard_limit && shard.protected_.size() > 1) {
+        auto tail = std::prev(shard.protected_.end());
+        tail->protected_ = false;
+        shard.protected_usage_ -= tail->size_;
+        protected_usage_ -= tail->size_;
+        shard.probation_.splice(shard.probation_.begin(), shard.protected_, tail);
+    }
 }
 
 template <typename ItemObj>
 void
 Cache<ItemObj>::free_memory_internal(const int64_t target_size) {
+    std::lock_guard<std::mutex> lock(evict_mutex_);
     int64_t threshold = std::min((int64_t)(capacity_ * freemem_percent_), target_size);
     int64_t delta_size = usage_ - threshold;
     if (delta_size <= 0) {
         delta_size = 1;  // ensure at least one item erased
     }
 
-    std::set<std::string> key_array;
+    // evict tail items round-robin over shards, probation items go first
     int64_t released_size = 0;
+    for (bool from_protected : {false, true}) {
+        size_t idle_count = 0;
+        while (released_size < delta_size && idle_count < shards_.size()) {
+            auto& shard = *shards_[evict_cursor_];
+            evict_cursor_ = (evict_cursor_ + 1) % shards_.size();
 
-    auto it = lru_.rbegin();
-    while (it != lru_.rend() && released_size < delta_size) {
-        auto& key = it->first;
-        auto& obj_ptr = it->second;
-
-        key_array.emplace(key);
-        released_size += obj_ptr->Size();
-        ++it;
+            std::lock_guard<std::mutex> shard_lock(shard.mutex_);
+            auto& list = from_protected ? shard.protected_ : shard.probation_;
+            if (list.empty()) {
+                ++idle_count;
+                continue;
+            }
+            idle_count = 0;
+            released_size += list.back().size_;
+            evict_one(shard, from_protected);
+        }
     }
 
-    LOG_SERVER_DEBUG_ << header_ << " To be released memory size: " << (released_size >> 20) << "MB";
-
-    for (auto& key : key_array) {
-        erase_internal(key);
-    }
+    LOG_SERVER_DEBUG_ << header_ << " Released memory size: " << (released_size >> 20) << "MB";
 }
 
 }  // namespace cache
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace milvus {
 namespace cache {
@@ -56,6 +57,9 @@ class CacheMgr {
     void
     SetCapacity(int64_t capacity);
 
+    std::vector<CacheShardStats>
+    ShardStats() const;
+
  protected:
     CacheMgr();
 
@@ -130,5 +130,15 @@ CacheMgr<ItemObj>::SetCapacity(int64_t capacity) {
     cache_->set_capacity(capacity);
 }
 
+template <typename ItemObj>
+std::vector<CacheShardStats>
+CacheMgr<ItemObj>::ShardStats() const {
+    if (cache_ == nullptr) {
+        LOG_SERVER_ERROR_ << "Cache doesn't exist";
+        return {};
+    }
+    return cache_->shard_stats();
+}
+
 }  // namespace cache
 }  // namespace milvus
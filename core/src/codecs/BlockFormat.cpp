@@ -21,9 +21,13 @@
 #include <algorithm>
 #include <boost/filesystem.hpp>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "codecs/ExtraFileInfo.h"
+#include "crc32c/crc32c.h"
 #include "db/Utils.h"
 #include "utils/Exception.h"
 #include "utils/Log.h"
@@ -32,6 +36,9 @@
 namespace milvus {
 namespace codec {
 
+// the data is verified by chunks in ranged read
+constexpr int64_t BLOCK_CHUNK_SIZE = 64 * 1024;
+
 Status
 BlockFormat::Read(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, engine::BinaryDataPtr& raw) {
     milvus::TimeRecorderAuto recorder("BlockFormat::Read:" + file_path);
@@ -67,34 +74,8 @@ BlockFormat::Read(const storage::FSHandlerPtr& fs_ptr, const std::string& file_p
         return Status(SERVER_INVALID_ARGUMENT, "Invalid input to read: " + file_path);
     }
 
-    if (!fs_ptr->reader_ptr_->Open(file_path)) {
-        return Status(SERVER_CANNOT_OPEN_FILE, "Fail to open file: " + file_path);
-    }
-    CHECK_MAGIC_VALID(fs_ptr);
-    std::vector<char> header;
-    header.resize(HEADER_SIZE);
-    fs_ptr->reader_ptr_->Read(header.data(), HEADER_SIZE);
-
-    HeaderMap map = TransformHeaderData(header);
-    size_t total_num_bytes = stol(map.at("size"));
-
-    if (offset + num_bytes > total_num_bytes) {
-        return Status(SERVER_INVALID_ARGUMENT, "Invalid argument to read: " + file_path);
-    }
-
-    raw = std::make_shared<engine::BinaryData>();
-    raw->data_.resize(num_bytes);
-
-    fs_ptr->reader_ptr_->Seekg(offset + MAGIC_SIZE + HEADER_SIZE);
-    fs_ptr->reader_ptr_->Read(raw->data_.data(), num_bytes);
-
-    uint32_t record;
-    fs_ptr->reader_ptr_->Read(&record, SUM_SIZE);
-    fs_ptr->reader_ptr_->Close();
-
-    CHECK_SUM_VALID(header.data(), reinterpret_cast<const char*>(raw->data_.data()), num_bytes, record);
-
-    return Status::OK();
+    ReadRanges ranges = {ReadRange(offset, num_bytes)};
+    return Read(fs_ptr, file_path, ranges, raw);
 }
 
 Status
@@ -114,21 +95,12 @@ BlockFormat::Read(const storage::FSHandlerPtr& fs_ptr, const std::string& file_p
     fs_ptr->reader_ptr_->Read(header.data(), HEADER_SIZE);
 
     HeaderMap map = TransformHeaderData(header);
-    size_t total_num_bytes = stol(map.at("size"));
-
-    std::vector<char> data;
-    data.resize(total_num_bytes);
-
-    fs_ptr->reader_ptr_->Read(data.data(), total_num_bytes);
-    uint32_t record;
-    fs_ptr->reader_ptr_->Read(&record, SUM_SIZE);
-    fs_ptr->reader_ptr_->Close();
-
-    CHECK_SUM_VALID(header.data(), reinterpret_cast<const char*>(data.data()), total_num_bytes, record);
+    int64_t total_num_bytes = stol(map.at("size"));
 
     int64_t total_bytes = 0;
     for (auto& range : read_ranges) {
-        if (range.offset_ > total_num_bytes) {
+        if (range.offset_ < 0 || range.num_bytes_ < 0 || range.offset_ + range.num_bytes_ > total_num_bytes) {
+            fs_ptr->reader_ptr_->Close();
             return Status(SERVER_INVALID_ARGUMENT, "Invalid argument to read: " + file_path);
         }
         total_bytes += range.num_bytes_;
@@ -136,16 +108,121 @@ BlockFormat::Read(const storage::FSHandlerPtr& fs_ptr, const std::string& file_p
 
     raw = std::make_shared<engine::BinaryData>();
     raw->data_.resize(total_bytes);
+
+    // file written by old version has no chunk sums, read the whole data to verify the file sum
+    if (map.find("chunk_size") == map.end()) {
+        std::vector<char> data;
+        data.resize(total_num_bytes);
+
+        fs_ptr->reader_ptr_->Read(data.data(), total_num_bytes);
+        uint32_t record;
+        fs_ptr->reader_ptr_->Read(&record, SUM_SIZE);
+        fs_ptr->reader_ptr_->Close();
+
+        CHECK_SUM_VALID(header.data(), reinterpret_cast<const char*>(data.data()), total_num_bytes, record);
+
+        int64_t poz = 0;
+        for (auto& range : read_ranges) {
+            memcpy(raw->data_.data() + poz, data.data() + range.offset_, range.num_bytes_);
+            poz += range.num_bytes_;
+        }
+
+        return Status::OK();
+    }
+
+    // only read the chunks touched by the ranges, each chunk is verified by its own sum
+    int64_t chunk_size = stol(map.at("chunk_size"));
+    int64_t chunk_count = stol(map.at("chunk_count"));
+    if (chunk_size <= 0) {
+        fs_ptr->reader_ptr_->Close();
+        return Status(SERVER_UNEXPECTED_ERROR, "Invalid chunk size of file: " + file_path);
+    }
+
+    std::vector<uint32_t> chunk_sums(chunk_count);
+    fs_ptr->reader_ptr_->Seekg(MAGIC_SIZE + HEADER_SIZE + total_num_bytes + SUM_SIZE);
+    fs_ptr->reader_ptr_->Read(chunk_sums.data(), chunk_count * SUM_SIZE);
+
+    std::set<int64_t> chunk_ids;
+    for (auto& range : read_ranges) {
+        if (range.num_bytes_ == 0) {
+            continue;
+        }
+        int64_t first = range.offset_ / chunk_size;
+        int64_t last = (range.offset_ + range.num_bytes_ - 1) / chunk_size;
+        for (int64_t i = first; i <= last; ++i) {
+            chunk_ids.insert(i);
+        }
+    }
+
+    // adjacent chunks are read by one call
+    std::vector<std::vector<char>> runs;
+    std::unordered_map<int64_t, const char*> chunks;
+    for (auto iter = chunk_ids.begin(); iter != chunk_ids.end();) {
+        int64_t first = *iter;
+        int64_t last = first;
+        for (++iter; iter != chunk_ids.end() && *iter == last + 1; ++iter) {
+            last = *iter;
+        }
+
+        int64_t run_offset = first * chunk_size;
+        int64_t run_bytes = std::min((last + 1) * chunk_size, total_num_bytes) - run_offset;
+        runs.emplace_back(run_bytes);
+        std::vector<char>& run_data = runs.back();
+        fs_ptr->reader_ptr_->Seekg(MAGIC_SIZE + HEADER_SIZE + run_offset);
+        fs_ptr->reader_ptr_->Read(run_data.data(), run_bytes);
+
+        for (int64_t i = first; i <= last; ++i) {
+            int64_t begin = (i - first) * chunk_size;
+            int64_t bytes = std::min(chunk_size, run_bytes - begin);
+            if (CalculateSum(run_data.data() + begin, bytes) != chunk_sums[i]) {
+                fs_ptr->reader_ptr_->Close();
+                LOG_ENGINE_ERROR_ << "Wrong sum bytes of chunk " << i << " in file: " << file_path;
+                return Status(SERVER_FILE_SUM_BYTES_ERROR, "Wrong sum bytes, file has been changed");
+            }
+            chunks[i] = run_data.data() + begin;
+        }
+    }
+    fs_ptr->reader_ptr_->Close();
+
     int64_t poz = 0;
     for (auto& range : read_ranges) {
         int64_t offset = range.offset_;
-        memcpy(raw->data_.data() + poz, data.data() + offset, range.num_bytes_);
-        poz += range.num_bytes_;
+        int64_t left = range.num_bytes_;
+        while (left > 0) {
+            int64_t chunk_id = offset / chunk_size;
+            int64_t chunk_offset = offset % chunk_size;
+            int64_t bytes = std::min(left, chunk_size - chunk_offset);
+            memcpy(raw->data_.data() + poz, chunks[chunk_id] + chunk_offset, bytes);
+            poz += bytes;
+            offset += bytes;
+            left -= bytes;
+        }
     }
 
     return Status::OK();
 }
 
+Status
+BlockFormat::ReadSize(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, int64_t& num_bytes,
+                      int64_t& chunk_size) {
+    if (!fs_ptr->reader_ptr_->Open(file_path)) {
+        return Status(SERVER_CANNOT_OPEN_FILE, "Fail to open file: " + file_path);
+    }
+    CHECK_MAGIC_VALID(fs_ptr);
+
+    std::vector<char> header;
+    header.resize(HEADER_SIZE);
+    fs_ptr->reader_ptr_->Read(header.data(), HEADER_SIZE);
+    fs_ptr->reader_ptr_->Close();
+
+    HeaderMap map = TransformHeaderData(header);
+    num_bytes = stol(map.at("size"));
+    auto iter = map.find("chunk_size");
+    chunk_size = (iter == map.end()) ? 0 : stol(iter->second);
+
+    return Status::OK();
+}
+
 Status
 BlockFormat::Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path,
                    const engine::BinaryDataPtr& raw) {
@@ -164,9 +241,12 @@ BlockFormat::Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_
         WRITE_MAGIC(fs_ptr);
 
         size_t num_bytes = raw->data_.size();
+        int64_t chunk_count = (num_bytes + BLOCK_CHUNK_SIZE - 1) / BLOCK_CHUNK_SIZE;
 
         HeaderMap maps;
         maps.insert(std::make_pair("size", std::to_string(num_bytes)));
+        maps.insert(std::make_pair("chunk_size", std::to_string(BLOCK_CHUNK_SIZE)));
+        maps.insert(std::make_pair("chunk_count", std::to_string(chunk_count)));
         std::string header = HeaderWrapper(maps);
         WRITE_HEADER(fs_ptr, header);
 
@@ -174,6 +254,83 @@ BlockFormat::Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_
 
         WRITE_SUM(fs_ptr, header, reinterpret_cast<char*>(raw->data_.data()), num_bytes);
 
+        // chunk sums are appended after the file sum, so that the layout before them is unchanged
+        std::vector<uint32_t> chunk_sums(chunk_count);
+        for (int64_t i = 0; i < chunk_count; ++i) {
+            int64_t offset = i * BLOCK_CHUNK_SIZE;
+            int64_t bytes = std::min<int64_t>(BLOCK_CHUNK_SIZE, num_bytes - offset);
+            chunk_sums[i] = CalculateSum(reinterpret_cast<const char*>(raw->data_.data() + offset), bytes);
+        }
+        fs_ptr->writer_ptr_->Write(chunk_sums.data(), chunk_count * SUM_SIZE);
+
+        fs_ptr->writer_ptr_->Close();
+    } catch (std::exception& ex) {
+        std::string err_msg = "Failed to write block data: " + std::string(ex.what());
+        LOG_ENGINE_ERROR_ << err_msg;
+
+        engine::utils::SendExitSignal();
+        return Status(SERVER_WRITE_ERROR, err_msg);
+    }
+
+    return Status::OK();
+}
+
+Status
+BlockFormat::Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, int64_t num_bytes,
+                   const BlockPieceFunc& get_piece) {
+    milvus::TimeRecorderAuto recorder("BlockFormat::Write:" + file_path);
+
+    if (!fs_ptr->writer_ptr_->Open(file_path)) {
+        return Status(SERVER_CANNOT_CREATE_FILE, "Fail to open file: " + file_path);
+    }
+
+    try {
+        WRITE_MAGIC(fs_ptr);
+
+        int64_t chunk_count = (num_bytes + BLOCK_CHUNK_SIZE - 1) / BLOCK_CHUNK_SIZE;
+
+        HeaderMap maps;
+        maps.insert(std::make_pair("size", std::to_string(num_bytes)));
+        maps.insert(std::make_pair("chunk_size", std::to_string(BLOCK_CHUNK_SIZE)));
+        maps.insert(std::make_pair("chunk_count", std::to_string(chunk_count)));
+        std::string header = HeaderWrapper(maps);
+        WRITE_HEADER(fs_ptr, header);
+
+        // the file sum and chunk sums are extended piece by piece, a piece may cross chunks
+        uint32_t file_sum = crc32c::Extend(0, reinterpret_cast<const uint8_t*>(MAGIC), MAGIC_SIZE);
+        file_sum = crc32c::Extend(file_sum, reinterpret_cast<const uint8_t*>(header.data()), HEADER_SIZE);
+        std::vector<uint32_t> chunk_sums(chunk_count, 0);
+
+        int64_t written = 0;
+        while (written < num_bytes) {
+            engine::BinaryDataPtr piece;
+            auto status = get_piece(piece);
+            if (!status.ok()) {
+                fs_ptr->writer_ptr_->Close();
+                return status;
+            }
+            if (piece == nullptr || piece->data_.empty() || written + piece->Size() > num_bytes) {
+                fs_ptr->writer_ptr_->Close();
+                return Status(SERVER_UNEXPECTED_ERROR, "Data size mismatch in writing file: " + file_path);
+            }
+
+            const uint8_t* data = piece->data_.data();
+            int64_t bytes = piece->Size();
+            fs_ptr->writer_ptr_->Write(data, bytes);
+            file_sum = crc32c::Extend(file_sum, data, bytes);
+            while (bytes > 0) {
+                int64_t chunk_id = written / BLOCK_CHUNK_SIZE;
+                int64_t chunk_bytes = std::min(bytes, BLOCK_CHUNK_SIZE - written % BLOCK_CHUNK_SIZE);
+                chunk_sums[chunk_id] = crc32c::Extend(chunk_sums[chunk_id], data, chunk_bytes);
+                data += chunk_bytes;
+                bytes -= chunk_bytes;
+                written += chunk_bytes;
+            }
+        }
+
+        fs_ptr->writer_ptr_->Write(&file_sum, SUM_SIZE);
+        fs_ptr->writer_ptr_->Write(chunk_sums.data(), chunk_count * SUM_SIZE);
+
         fs_ptr->writer_ptr_->Close();
     } catch (std::exception& ex) {
         std::string err_msg = "Failed to write block data: " + std::string(ex.what());
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -38,6 +39,9 @@ struct ReadRange {
 
 using ReadRanges = std::vector<ReadRange>;
 
+// provide the next piece of data for streaming write
+using BlockPieceFunc = std::function<Status(engine::BinaryDataPtr& piece)>;
+
 class BlockFormat {
  public:
     BlockFormat() = default;
@@ -53,9 +57,20 @@ class BlockFormat {
     Read(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, const ReadRanges& read_ranges,
          engine::BinaryDataPtr& raw);
 
+    // read the data size from header, chunk_size is 0 if the file has no chunk sums and can't be read by ranges
+    Status
+    ReadSize(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, int64_t& num_bytes,
+             int64_t& chunk_size);
+
     Status
     Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, const engine::BinaryDataPtr& raw);
 
+    // write num_bytes data pulled piece by piece from get_piece, so that only one piece is held in memory
+    // the file is the same as written by Write() with the whole data
+    Status
+    Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, int64_t num_bytes,
+          const BlockPieceFunc& get_piece);
+
     // No copy and move
     BlockFormat(const BlockFormat&) = delete;
     BlockFormat(BlockFormat&&) = delete;
@@ -21,6 +21,7 @@
 
 #include "DeletedDocsFormat.h"
 #include "IdBloomFilterFormat.h"
+#include "IdIndexFormat.h"
 #include "StructuredIndexFormat.h"
 #include "VectorIndexFormat.h"
 
@@ -43,6 +44,8 @@ Codec::Codec() {
     suffix_set_.insert(deleted_docs_format_ptr_->FilePostfix());
     id_bloom_filter_format_ptr_ = std::make_shared<IdBloomFilterFormat>();
     suffix_set_.insert(id_bloom_filter_format_ptr_->FilePostfix());
+    id_index_format_ptr_ = std::make_shared<IdIndexFormat>();
+    suffix_set_.insert(id_index_format_ptr_->FilePostfix());
     vector_compress_format_ptr_ = std::make_shared<VectorCompressFormat>();
     suffix_set_.insert(vector_compress_format_ptr_->FilePostfix());
 }
@@ -77,6 +80,11 @@ Codec::GetIdBloomFilterFormat() {
     return id_bloom_filter_format_ptr_;
 }
 
+IdIndexFormatPtr
+Codec::GetIdIndexFormat() {
+    return id_index_format_ptr_;
+}
+
 VectorCompressFormatPtr
 Codec::GetVectorCompressFormat() {
     return vector_compress_format_ptr_;
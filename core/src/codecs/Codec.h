@@ -23,6 +23,7 @@
 #include "codecs/BlockFormat.h"
 #include "codecs/DeletedDocsFormat.h"
 #include "codecs/IdBloomFilterFormat.h"
+#include "codecs/IdIndexFormat.h"
 #include "codecs/StructuredIndexFormat.h"
 #include "codecs/VectorCompressFormat.h"
 #include "codecs/VectorIndexFormat.h"
@@ -50,6 +51,9 @@ class Codec {
     IdBloomFilterFormatPtr
     GetIdBloomFilterFormat();
 
+    IdIndexFormatPtr
+    GetIdIndexFormat();
+
     VectorCompressFormatPtr
     GetVectorCompressFormat();
 
@@ -65,6 +69,7 @@ class Codec {
     VectorIndexFormatPtr vector_index_format_ptr_;
     DeletedDocsFormatPtr deleted_docs_format_ptr_;
     IdBloomFilterFormatPtr id_bloom_filter_format_ptr_;
+    IdIndexFormatPtr id_index_format_ptr_;
     VectorCompressFormatPtr vector_compress_format_ptr_;
 
     std::set<std::string> suffix_set_;
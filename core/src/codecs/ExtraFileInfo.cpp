@@ -104,7 +104,7 @@ CalculateSum(const storage::FSHandlerPtr& fs_ptr, bool written) {
 }
 
 std::uint32_t
-CalculateSum(char* data, size_t size) {
+CalculateSum(const char* data, const size_t size) {
     std::uint32_t result = crc32c::Crc32c(data, size);
     return result;
 }
@@ -137,6 +137,39 @@ WriteHeaderValues(const storage::FSHandlerPtr& fs_ptr, const std::string& kv) {
     return true;
 }
 
+bool
+MapFileData(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, HeaderMap& header_map,
+            std::shared_ptr<uint8_t[]>& data, int64_t& data_size) {
+    int64_t length = 0;
+    auto mapped = fs_ptr->reader_ptr_->Map(file_path, length);
+    if (mapped == nullptr) {
+        return false;
+    }
+
+    if (length < MAGIC_SIZE + HEADER_SIZE + SUM_SIZE || strncmp((const char*)mapped.get(), MAGIC, MAGIC_SIZE)) {
+        LOG_ENGINE_DEBUG_ << "Wrong Magic bytes";
+        throw Exception(SERVER_FILE_MAGIC_BYTES_ERROR, "Wrong magic bytes");
+    }
+
+    std::vector<char> header(mapped.get() + MAGIC_SIZE, mapped.get() + MAGIC_SIZE + HEADER_SIZE);
+    header_map = TransformHeaderData(header);
+
+    // the "size" is absent if the data fills the rest of file
+    auto iter = header_map.find("size");
+    data_size = (iter == header_map.end()) ? length - MAGIC_SIZE - HEADER_SIZE - SUM_SIZE : stol(iter->second);
+    if (data_size < 0 || MAGIC_SIZE + HEADER_SIZE + data_size + SUM_SIZE > length) {
+        throw Exception(SERVER_UNEXPECTED_ERROR, "Invalid data size of file: " + file_path);
+    }
+
+    uint32_t record;
+    memcpy(&record, mapped.get() + MAGIC_SIZE + HEADER_SIZE + data_size, SUM_SIZE);
+    data = std::shared_ptr<uint8_t[]>(mapped, mapped.get() + MAGIC_SIZE + HEADER_SIZE);
+    CHECK_SUM_VALID(std::string(header.data(), HEADER_SIZE), reinterpret_cast<const char*>(data.get()), data_size,
+                    record);
+
+    return true;
+}
+
 std::string
 HeaderWrapper(const std::unordered_map<std::string, std::string>& maps) {
     std::string kv;
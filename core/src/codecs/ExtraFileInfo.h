@@ -19,6 +19,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -104,5 +105,12 @@ std::string
 HeaderWrapper(const std::unordered_map<std::string, std::string>& maps);
 
 using HeaderMap = std::unordered_map<std::string, std::string>;
+
+// map the file into memory and verify its magic and sum, the data points to the bytes behind header
+// return false if the storage doesn't support memory mapping, throw exception if the file is invalid
+bool
+MapFileData(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, HeaderMap& header_map,
+            std::shared_ptr<uint8_t[]>& data, int64_t& data_size);
+
 }  // namespace codec
 }  // namespace milvus
@@ -0,0 +1,126 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "codecs/IdIndexFormat.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "codecs/ExtraFileInfo.h"
+#include "db/Utils.h"
+#include "utils/Exception.h"
+#include "utils/Log.h"
+#include "utils/TimeRecorder.h"
+
+namespace milvus {
+namespace codec {
+
+const char* ID_INDEX_POSTFIX = ".idx";
+
+// file layout: magic, header, sorted uids, offsets of the uids, sum
+std::string
+IdIndexFormat::FilePostfix() {
+    std::string str = ID_INDEX_POSTFIX;
+    return str;
+}
+
+Status
+IdIndexFormat::Read(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path,
+                    segment::IdIndexPtr& id_index) {
+    const std::string full_file_path = file_path + ID_INDEX_POSTFIX;
+    milvus::TimeRecorderAuto recorder("IdIndexFormat::Read:" + full_file_path);
+    if (!fs_ptr->reader_ptr_->Open(full_file_path)) {
+        return Status(SERVER_CANNOT_OPEN_FILE, "Fail to open id index file: " + full_file_path);
+    }
+    CHECK_MAGIC_VALID(fs_ptr);
+    std::vector<char> header;
+    header.resize(HEADER_SIZE);
+    fs_ptr->reader_ptr_->Read(header.data(), HEADER_SIZE);
+
+    HeaderMap map = TransformHeaderData(header);
+    int64_t count = stol(map.at("count"));
+    size_t ids_bytes = count * sizeof(engine::idx_t);
+    size_t num_bytes = ids_bytes + count * sizeof(engine::offset_t);
+
+    std::vector<uint8_t> data;
+    data.resize(num_bytes);
+    fs_ptr->reader_ptr_->Read(data.data(), num_bytes);
+
+    uint32_t record;
+    fs_ptr->reader_ptr_->Read(&record, SUM_SIZE);
+    fs_ptr->reader_ptr_->Close();
+
+    CHECK_SUM_VALID(header.data(), reinterpret_cast<const char*>(data.data()), num_bytes, record);
+
+    std::vector<engine::idx_t> ids(count);
+    std::vector<engine::offset_t> offsets(count);
+    memcpy(ids.data(), data.data(), ids_bytes);
+    memcpy(offsets.data(), data.data() + ids_bytes, num_bytes - ids_bytes);
+    id_index = std::make_shared<segment::IdIndex>(std::move(ids), std::move(offsets));
+
+    return Status::OK();
+}
+
+Status
+IdIndexFormat::Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path,
+                     const segment::IdIndexPtr& id_index) {
+    const std::string full_file_path = file_path + ID_INDEX_POSTFIX;
+    milvus::TimeRecorderAuto recorder("IdIndexFormat::Write:" + full_file_path);
+
+    auto& ids = id_index->GetIds();
+    auto& offsets = id_index->GetOffsets();
+    size_t ids_bytes = ids.size() * sizeof(engine::idx_t);
+    size_t num_bytes = ids_bytes + offsets.size() * sizeof(engine::offset_t);
+
+    // the sum is calculated on a continuous buffer
+    std::vector<uint8_t> data;
+    data.resize(num_bytes);
+    memcpy(data.data(), ids.data(), ids_bytes);
+    memcpy(data.data() + ids_bytes, offsets.data(), num_bytes - ids_bytes);
+
+    if (!fs_ptr->writer_ptr_->Open(full_file_path)) {
+        return Status(SERVER_CANNOT_CREATE_FILE, "Fail to write file: " + full_file_path);
+    }
+    try {
+        WRITE_MAGIC(fs_ptr);
+        HeaderMap maps;
+        maps.insert(std::make_pair("count", std::to_string(ids.size())));
+        std::string header = HeaderWrapper(maps);
+        WRITE_HEADER(fs_ptr, header);
+
+        fs_ptr->writer_ptr_->Write(data.data(), num_bytes);
+
+        WRITE_SUM(fs_ptr, header, reinterpret_cast<char*>(data.data()), num_bytes);
+
+        fs_ptr->writer_ptr_->Close();
+    } catch (std::exception& ex) {
+        std::string err_msg = "Failed to write id index: " + std::string(ex.what());
+        LOG_ENGINE_ERROR_ << err_msg;
+
+        engine::utils::SendExitSignal();
+        return Status(SERVER_WRITE_ERROR, err_msg);
+    }
+
+    return Status::OK();
+}
+
+}  // namespace codec
+}  // namespace milvus
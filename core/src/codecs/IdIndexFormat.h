@@ -0,0 +1,57 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "segment/IdIndex.h"
+#include "storage/FSHandler.h"
+#include "utils/Status.h"
+
+namespace milvus {
+namespace codec {
+
+class IdIndexFormat {
+ public:
+    IdIndexFormat() = default;
+
+    static std::string
+    FilePostfix();
+
+    Status
+    Read(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, segment::IdIndexPtr& id_index);
+
+    Status
+    Write(const storage::FSHandlerPtr& fs_ptr, const std::string& file_path, const segment::IdIndexPtr& id_index);
+
+    // No copy and move
+    IdIndexFormat(const IdIndexFormat&) = delete;
+    IdIndexFormat(IdIndexFormat&&) = delete;
+
+    IdIndexFormat&
+    operator=(const IdIndexFormat&) = delete;
+    IdIndexFormat&
+    operator=(IdIndexFormat&&) = delete;
+};
+
+using IdIndexFormatPtr = std::shared_ptr<IdIndexFormat>;
+
+}  // namespace codec
+}  // namespace milvus
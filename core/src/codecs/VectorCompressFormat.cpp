@@ -44,6 +44,18 @@ VectorCompressFormat::Read(const storage::FSHandlerPtr& fs_ptr, const std::strin
     milvus::TimeRecorderAuto recorder("VectorCompressFormat::Read:" + file_path);
 
     const std::string full_file_path = file_path + VECTOR_COMPRESS_POSTFIX;
+
+    // the data aliases the mapped file, no copy
+    HeaderMap mapped_header;
+    std::shared_ptr<uint8_t[]> mapped_data;
+    int64_t mapped_size = 0;
+    if (MapFileData(fs_ptr, full_file_path, mapped_header, mapped_data, mapped_size)) {
+        compress = std::make_shared<knowhere::Binary>();
+        compress->data = mapped_data;
+        compress->size = mapped_size;
+        return Status::OK();
+    }
+
     if (!fs_ptr->reader_ptr_->Open(full_file_path)) {
         return Status(SERVER_CANNOT_OPEN_FILE, "Fail to open vector compress file: " + full_file_path);
     }
@@ -45,6 +45,19 @@ VectorIndexFormat::ReadRaw(const storage::FSHandlerPtr& fs_ptr, const std::strin
                            knowhere::BinaryPtr& data) {
     milvus::TimeRecorder recorder("VectorIndexFormat::ReadRaw");
 
+    // the data aliases the mapped file, no copy
+    HeaderMap mapped_header;
+    std::shared_ptr<uint8_t[]> mapped_data;
+    int64_t mapped_size = 0;
+    if (MapFileData(fs_ptr, file_path, mapped_header, mapped_data, mapped_size)) {
+        data = std::make_shared<knowhere::Binary>();
+        data->size = mapped_size;
+        data->data = mapped_data;
+
+        LOG_ENGINE_DEBUG_ << "VectorIndexFormat::ReadRaw(" << file_path << ") mapped " << mapped_size << " bytes";
+        return Status::OK();
+    }
+
     if (!fs_ptr->reader_ptr_->Open(file_path)) {
         return Status(SERVER_CANNOT_OPEN_FILE, "Fail to open raw file: " + file_path);
     }
@@ -80,51 +93,56 @@ VectorIndexFormat::ReadIndex(const storage::FSHandlerPtr& fs_ptr, const std::str
     milvus::TimeRecorder recorder("VectorIndexFormat::ReadIndex");
 
     std::string full_file_path = file_path + VECTOR_INDEX_POSTFIX;
-    if (!fs_ptr->reader_ptr_->Open(full_file_path)) {
-        return Status(SERVER_CANNOT_OPEN_FILE, "Fail to open vector index: " + full_file_path);
-    }
-    CHECK_MAGIC_VALID(fs_ptr);
-    std::vector<char> header;
-    header.resize(HEADER_SIZE);
-    fs_ptr->reader_ptr_->Read(header.data(), HEADER_SIZE);
 
-    int64_t length = fs_ptr->reader_ptr_->Length() - MAGIC_SIZE - HEADER_SIZE - SUM_SIZE;
-    if (length <= 0) {
-        return Status(SERVER_UNEXPECTED_ERROR, "Invalid vector index length: " + full_file_path);
-    }
+    // if the storage supports memory mapping, the binaries alias the mapped file instead of copying out
+    HeaderMap mapped_header;
+    std::shared_ptr<uint8_t[]> index_data;
+    int64_t length = 0;
+    bool mapped = MapFileData(fs_ptr, full_file_path, mapped_header, index_data, length);
+    if (!mapped) {
+        if (!fs_ptr->reader_ptr_->Open(full_file_path)) {
+            return Status(SERVER_CANNOT_OPEN_FILE, "Fail to open vector index: " + full_file_path);
+        }
+        CHECK_MAGIC_VALID(fs_ptr);
+        std::vector<char> header;
+        header.resize(HEADER_SIZE);
+        fs_ptr->reader_ptr_->Read(header.data(), HEADER_SIZE);
+
+        length = fs_ptr->reader_ptr_->Length() - MAGIC_SIZE - HEADER_SIZE - SUM_SIZE;
+        if (length <= 0) {
+            return Status(SERVER_UNEXPECTED_ERROR, "Invalid vector index length: " + full_file_path);
+        }
 
-    std::vector<uint8_t> index_data;
-    index_data.resize(length);
-    fs_ptr->reader_ptr_->Read(index_data.data(), length);
+        index_data = std::shared_ptr<uint8_t[]>(new uint8_t[length]);
+        fs_ptr->reader_ptr_->Read(index_data.get(), length);
 
-    uint32_t record;
-    fs_ptr->reader_ptr_->Read(&record, SUM_SIZE);
-    fs_ptr->reader_ptr_->Close();
+        uint32_t record;
+        fs_ptr->reader_ptr_->Read(&record, SUM_SIZE);
+        fs_ptr->reader_ptr_->Close();
 
-    CHECK_SUM_VALID(header.data(), reinterpret_cast<const char*>(index_data.data()), length, record)
+        CHECK_SUM_VALID(header.data(), reinterpret_cast<const char*>(index_data.get()), length, record)
+    }
 
-    LOG_ENGINE_DEBUG_ << "Start to ReadIndex(" << full_file_path << ") length: " << length << " bytes";
+    LOG_ENGINE_DEBUG_ << "Start to ReadIndex(" << full_file_path << ") length: " << length << " bytes"
+                      << (mapped ? ", mapped" : "");
     int64_t rp = 0;
     while (rp < length) {
         size_t meta_length;
-        memcpy(&meta_length, index_data.data() + rp, sizeof(meta_length));
+        memcpy(&meta_length, index_data.get() + rp, sizeof(meta_length));
         rp += sizeof(meta_length);
 
-        auto meta = new char[meta_length];
-        memcpy(meta, index_data.data() + rp, meta_length);
+        std::string meta(reinterpret_cast<const char*>(index_data.get() + rp), meta_length);
         rp += meta_length;
 
         size_t bin_length;
-        memcpy(&bin_length, index_data.data() + rp, sizeof(bin_length));
+        memcpy(&bin_length, index_data.get() + rp, sizeof(bin_length));
         rp += sizeof(bin_length);
 
-        auto bin = new uint8_t[bin_length];
-        memcpy(bin, index_data.data() + rp, bin_length);
+        // each binary shares ownership of the whole index data
+        std::shared_ptr<uint8_t[]> binptr(index_data, index_data.get() + rp);
         rp += bin_length;
 
-        std::shared_ptr<uint8_t[]> binptr(bin);
-        data.Append(std::string(meta, meta_length), binptr, bin_length);
-        delete[] meta;
+        data.Append(meta, binptr, bin_length);
     }
 
     double span = recorder.RecordSection("End");
@@ -148,9 +166,9 @@ VectorIndexFormat::ConvertRaw(const engine::BinaryDataPtr& raw, knowhere::Binary
         return Status::OK();
     }
 
+    // the binary shares ownership of the raw data, the index loading only reads it
     data->size = raw->Size();
-    data->data = std::shared_ptr<uint8_t[]>(new uint8_t[data->size], std::default_delete<uint8_t[]>());
-    memcpy(data->data.get(), raw->data_.data(), data->size);
+    data->data = std::shared_ptr<uint8_t[]>(raw, raw->data_.data());
 
     return Status::OK();
 }
@@ -31,6 +31,8 @@ constexpr int64_t MAX_INSERT_DATA_SIZE = 256 * MB;          // max data size in
 constexpr int64_t MAX_WAL_FILE_SIZE = 256 * MB;             // max file size of wal file
 constexpr int64_t MAX_SCRIPT_FILE_SIZE = 256 * MB;          // max file size of transcript file
 
+constexpr int64_t DEFAULT_MERGE_BUFFER_SIZE = 64 * MB;  // default read buffer size of segment merge
+
 constexpr int64_t BUILD_INEDX_RETRY_TIMES = 3;  // retry times if build index failed
 
 constexpr const char* DB_FOLDER = "/db";
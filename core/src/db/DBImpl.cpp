@@ -15,6 +15,7 @@
 #include "db/IDGenerator.h"
 #include "db/SnapshotUtils.h"
 #include "db/SnapshotVisitor.h"
+#include "db/Utils.h"
 #include "db/merge/MergeManagerFactory.h"
 #include "db/merge/MergeTask.h"
 #include "db/snapshot/CompoundOperations.h"
@@ -23,9 +24,11 @@
 #include "db/snapshot/Snapshots.h"
 #include "insert/MemManagerFactory.h"
 #include "knowhere/index/vector_index/helpers/BuilderSuspend.h"
+#include "metrics/SearchMetrics.h"
 #include "scheduler/Definition.h"
 #include "scheduler/SchedInst.h"
 #include "scheduler/job/SearchJob.h"
+#include "scheduler/task/SearchTask.h"
 #include "segment/SegmentReader.h"
 #include "segment/Utils.h"
 #include "utils/Exception.h"
@@ -37,6 +40,7 @@
 #include <src/scheduler/job/BuildIndexJob.h>
 #include <algorithm>
 #include <limits>
+#include <set>
 #include <unordered_set>
 #include <utility>
 
@@ -201,7 +205,9 @@ DBImpl::CreateCollection(const snapshot::CreateCollectionContext& context) {
         0, 0, ELEMENT_BLOOM_FILTER, milvus::engine::FieldElementType::FET_BLOOM_FILTER);
     auto delete_doc_element = std::make_shared<snapshot::FieldElement>(
         0, 0, ELEMENT_DELETED_DOCS, milvus::engine::FieldElementType::FET_DELETED_DOCS);
-    ctx.fields_schema[uid_field] = {bloom_filter_element, delete_doc_element};
+    auto id_index_element = std::make_shared<snapshot::FieldElement>(
+        0, 0, ELEMENT_ID_INDEX, milvus::engine::FieldElementType::FET_ID_INDEX);
+    ctx.fields_schema[uid_field] = {bloom_filter_element, delete_doc_element, id_index_element};
 
     auto op = std::make_shared<snapshot::CreateCollectionOperation>(ctx);
     return op->Push();
@@ -226,6 +232,10 @@ DBImpl::DropCollection(const std::string& collection_name) {
 
     // clear index failed retry map of this collection
     index_task_tracker_.ClearFailedRecords(collection_name);
+    index_build_tracker_.ClearRecords(collection_name);
+
+    // search latency series labeled with this collection
+    SearchMetrics::GetInstance().RemoveCollection(collection_name);
 
     return snapshots.DropCollection(ss->GetCollectionId(), std::numeric_limits<snapshot::LSN_TYPE>::max());
 }
@@ -270,6 +280,11 @@ DBImpl::GetCollectionStats(const std::string& collection_name, milvus::json& col
     CHECK_AVAILABLE
 
     STATUS_CHECK(GetSnapshotInfo(collection_name, collection_stats));
+
+    milvus::json index_progress;
+    if (index_build_tracker_.GetProgress(collection_name, index_progress)) {
+        collection_stats[JSON_INDEX_PROGRESS] = index_progress;
+    }
     return Status::OK();
 }
 
@@ -564,6 +579,15 @@ DBImpl::Insert(const std::string& collection_name, const std::string& partition_
     consume_chunk->fixed_fields_.swap(data_chunk->fixed_fields_);
     consume_chunk->variable_fields_.swap(data_chunk->variable_fields_);
 
+    // half float vectors are inserted as float, convert them to the storage format
+    for (auto& pair : consume_chunk->fixed_fields_) {
+        auto field = ss->GetField(pair.first);
+        if (field != nullptr && utils::IsHalfFloatVectorType(static_cast<DataType>(field->GetFtype()))) {
+            STATUS_CHECK(utils::EncodeHalfFloatVectors(static_cast<DataType>(field->GetFtype()), pair.second,
+                                                       pair.second));
+        }
+    }
+
     // generate id
     if (auto_genid) {
         LOG_SERVER_DEBUG_ << "Auto generate entities id";
@@ -618,14 +642,34 @@ DBImpl::GetEntityByID(const std::string& collection_name, const IDNumbers& id_ar
     snapshot::ScopedSnapshotT ss;
     STATUS_CHECK(snapshot::Snapshots::GetInstance().GetSnapshot(ss, collection_name));
 
+    // same as Query(), collect unflushed entities before getting the latest snapshot
+    auto collection_id = ss->GetCollectionId();
+    MemChunkViews mem_chunks;
+    PendingDeleteIds delete_ids;
+    STATUS_CHECK(mem_mgr_->GetSearchView(collection_id, mem_chunks, delete_ids));
+    STATUS_CHECK(snapshot::Snapshots::GetInstance().GetSnapshot(ss, collection_id));
+
     std::string dir_root = options_.meta_.path_;
     valid_row.resize(id_array.size(), false);
-    auto handler =
-        std::make_shared<GetEntityByIdSegmentHandler>(nullptr, ss, dir_root, id_array, field_names, valid_row);
+    auto handler = std::make_shared<GetEntityByIdSegmentHandler>(nullptr, ss, dir_root, id_array, field_names,
+                                                                 valid_row, mem_chunks, delete_ids);
     handler->Iterate();
     STATUS_CHECK(handler->GetStatus());
 
     data_chunk = handler->data_chunk_;
+    if (data_chunk == nullptr) {
+        return Status::OK();
+    }
+
+    // half float vectors are returned as float
+    for (auto& pair : data_chunk->fixed_fields_) {
+        auto field = ss->GetField(pair.first);
+        if (pair.second != nullptr && field != nullptr &&
+            utils::IsHalfFloatVectorType(static_cast<DataType>(field->GetFtype()))) {
+            STATUS_CHECK(utils::DecodeHalfFloatVectors(static_cast<DataType>(field->GetFtype()), pair.second,
+                                                       pair.second));
+        }
+    }
     return Status::OK();
 }
 
@@ -668,16 +712,51 @@ DBImpl::Query(const server::ContextPtr& context, const query::QueryPtr& query_pt
     }
 
     auto vector_param = query_ptr->vectors.begin()->second;
+    SearchStageTimer select_timer(SearchStage::SELECT_SEGMENT, query_ptr->collection_id);
 
     snapshot::ScopedSnapshotT ss;
     STATUS_CHECK(snapshot::Snapshots::GetInstance().GetSnapshot(ss, query_ptr->collection_id));
 
+    // collect unflushed entities before getting the latest snapshot, an entity flushed in between
+    // will be found twice rather than missed, the duplicated ids are removed after reduce.
+    // the ids deleted since the last flush are masked in the sealed segments
+    auto collection_id = ss->GetCollectionId();
+    MemChunkViews mem_chunks;
+    auto delete_ids = std::make_shared<PendingDeleteIds>();
+    STATUS_CHECK(mem_mgr_->GetSearchView(collection_id, mem_chunks, *delete_ids));
+    STATUS_CHECK(snapshot::Snapshots::GetInstance().GetSnapshot(ss, collection_id));
+
+    // the number of queries is decided before the search tasks run in parallel, they only read it
+    auto vector_field = ss->GetField(vector_param->field_name);
+    if (vector_field != nullptr && vector_field->GetParams().contains(PARAM_DIMENSION)) {
+        int64_t dimension = vector_field->GetParams()[PARAM_DIMENSION];
+        auto field_type = static_cast<DataType>(vector_field->GetFtype());
+        if (dimension > 0 && utils::IsBinaryVectorType(field_type)) {
+            vector_param->nq = vector_param->query_vector.binary_data.size() * 8 / dimension;
+        } else if (dimension > 0) {
+            vector_param->nq = vector_param->query_vector.float_data.size() / dimension;
+        }
+    }
+
     SnapshotVisitor ss_visitor(ss);
     snapshot::IDS_TYPE segment_ids;
     STATUS_CHECK(ss_visitor.SegmentsToSearch(query_ptr->partitions, segment_ids));
-    rc.RecordSection("segments to search: " + std::to_string(segment_ids.size()));
+    index_build_tracker_.MarkSearched(query_ptr->collection_id, segment_ids);
+
+    std::set<snapshot::ID_TYPE> partition_ids;
+    STATUS_CHECK(ss_visitor.PartitionsToSearch(query_ptr->partitions, partition_ids));
+    MemChunkViews search_chunks;
+    for (auto& view : mem_chunks) {
+        if (partition_ids.find(view.partition_id_) != partition_ids.end()) {
+            search_chunks.emplace_back(view);
+        }
+    }
+    select_timer.Stop();
+    rc.RecordSection("segments to search: " + std::to_string(segment_ids.size()) +
+                     ", mem chunks to search: " + std::to_string(search_chunks.size()));
 
-    scheduler::SearchJobPtr job = std::make_shared<scheduler::SearchJob>(nullptr, ss, options_, query_ptr, segment_ids);
+    scheduler::SearchJobPtr job = std::make_shared<scheduler::SearchJob>(nullptr, ss, options_, query_ptr, segment_ids,
+                                                                         search_chunks, delete_ids);
 
     cache::CpuCacheMgr::GetInstance().PrintInfo();  // print cache info before query
 
@@ -695,14 +774,23 @@ DBImpl::Query(const server::ContextPtr& context, const query::QueryPtr& query_pt
         return job->status();
     }
 
-    if (job->query_result()) {
-        result = job->query_result();
+    {
+        SearchStageTimer reduce_timer(SearchStage::REDUCE, query_ptr->collection_id);
+        job->ReduceResults();
+        if (job->query_result()) {
+            result = job->query_result();
+            if (!search_chunks.empty()) {
+                scheduler::SearchTask::RemoveDuplicatedIds(result->row_num_, result->result_ids_,
+                                                           result->result_distances_);
+            }
+        }
     }
     rc.RecordSection("execute query");
 
     // step 4: get entities by result ids
     std::vector<bool> valid_row;
     if (!query_ptr->field_names.empty()) {
+        SearchStageTimer fetch_timer(SearchStage::FETCH_ENTITY, query_ptr->collection_id);
         STATUS_CHECK(GetEntityByID(query_ptr->collection_id, result->result_ids_, query_ptr->field_names, valid_row,
                                    result->data_chunk_));
         rc.RecordSection("get entities");
@@ -981,60 +1069,118 @@ DBImpl::BackgroundBuildIndexTask(std::vector<std::string> collection_names, bool
 
     std::unique_lock<std::mutex> lock(build_index_mutex_);
 
+    // the cpu builder runs builder_num segments concurrently, each job takes so many segments
+    int64_t batch_size = std::max<int64_t>(config.engine.builder_num(), 1);
+
+    // each segment is tried once in this round, a segment failed or deleted will be tried in next round
+    std::vector<std::pair<std::string, std::unordered_set<snapshot::ID_TYPE>>> building;
     for (const auto& collection_name : collection_names) {
-        snapshot::ScopedSnapshotT latest_ss;
-        auto status = snapshot::Snapshots::GetInstance().GetSnapshot(latest_ss, collection_name);
-        if (!status.ok()) {
-            return;
-        }
-        SnapshotVisitor ss_visitor(latest_ss);
+        building.emplace_back(collection_name, std::unordered_set<snapshot::ID_TYPE>());
+    }
 
-        snapshot::IDS_TYPE segment_ids;
-        ss_visitor.SegmentsToIndex("", segment_ids, force_build);
-        if (segment_ids.empty()) {
-            continue;
-        }
+    // one batch for each collection in turn, a large collection doesn't starve the others
+    while (!building.empty() && ServiceAvailable()) {
+        for (auto iter = building.begin(); iter != building.end();) {
+            if (BuildIndexBatch(iter->first, batch_size, force_build, iter->second)) {
+                ++iter;
+            } else {
+                index_build_tracker_.EndBuild(iter->first);
+                iter = building.erase(iter);
+            }
 
-        // check index retry times
-        index_task_tracker_.IgnoreFailedSegments(collection_name, segment_ids);
-        if (segment_ids.empty()) {
-            continue;
+            // quit this thread if the milvus server is going to shutdown
+            if (!ServiceAvailable()) {
+                break;
+            }
         }
+    }
 
-        // start build index job
-        // build one segment for each time, for two reasons:
-        // 1. we don't need to wait all segments index finish when milvus server stop
-        // 2. avoid build index for deleted segments
-        snapshot::IDS_TYPE segment_to_build = {segment_ids[0]};
-        LOG_ENGINE_DEBUG_ << "Create BuildIndexJob for segment " << segment_to_build[0] << " of " << collection_name;
-        cache::CpuCacheMgr::GetInstance().PrintInfo();  // print cache info before build index
-        scheduler::BuildIndexJobPtr job =
-            std::make_shared<scheduler::BuildIndexJob>(latest_ss, options_, segment_to_build);
-
-        IncreaseLiveBuildTaskNum();
-        scheduler::JobMgrInst::GetInstance()->Put(job);
-        job->WaitFinish();
-        DecreaseLiveBuildTaskNum();
-
-        cache::CpuCacheMgr::GetInstance().PrintInfo();  // print cache info after build index
-
-        // record failed segments, avoid build index hang
-        auto failed_segments = job->GetFailedSegments();
-        index_task_tracker_.MarkFailedSegments(collection_name, failed_segments);
-
-        if (!job->status().ok()) {
-            LOG_ENGINE_ERROR_ << job->status().message();
-        }
+    for (auto& pair : building) {
+        index_build_tracker_.EndBuild(pair.first);
+    }
+    if (!ServiceAvailable()) {
+        LOG_ENGINE_DEBUG_ << "DB background build index thread exit";
+    }
+}
 
-        // notify index request to return (if all segments index has been done)
-        index_req_swn_.Notify();
+bool
+DBImpl::BuildIndexBatch(const std::string& collection_name, int64_t batch_size, bool force_build,
+                        std::unordered_set<snapshot::ID_TYPE>& tried_segments) {
+    snapshot::ScopedSnapshotT latest_ss;
+    auto status = snapshot::Snapshots::GetInstance().GetSnapshot(latest_ss, collection_name);
+    if (!status.ok()) {
+        return false;
+    }
+    SnapshotVisitor ss_visitor(latest_ss);
 
-        // quit this thread if the milvus server is going to shutdown
-        if (!ServiceAvailable()) {
-            LOG_ENGINE_DEBUG_ << "DB background build index thread exit";
+    snapshot::IDS_TYPE segment_ids;
+    ss_visitor.SegmentsToIndex("", segment_ids, force_build);
+
+    // check index retry times
+    index_task_tracker_.IgnoreFailedSegments(collection_name, segment_ids);
+
+    // hot and large segments first
+    std::unordered_map<int64_t, int64_t> segment_rows;
+    int64_t pending_rows = 0;
+    for (auto id : segment_ids) {
+        auto segment_commit = latest_ss->GetSegmentCommitBySegmentId(id);
+        segment_rows[id] = (segment_commit != nullptr) ? segment_commit->GetRowCount() : 0;
+        pending_rows += segment_rows[id];
+    }
+    index_build_tracker_.SortByPriority(collection_name, segment_rows, segment_ids);
+
+    // start build index job
+    // build a small batch for each time, for two reasons:
+    // 1. we don't need to wait all segments index finish when milvus server stop
+    // 2. avoid build index for deleted segments
+    snapshot::IDS_TYPE segment_to_build;
+    int64_t rows_to_build = 0;
+    for (auto id : segment_ids) {
+        if (static_cast<int64_t>(segment_to_build.size()) >= batch_size) {
             break;
         }
+        if (tried_segments.insert(id).second) {
+            segment_to_build.push_back(id);
+            rows_to_build += segment_rows[id];
+        }
+    }
+    if (segment_to_build.empty()) {
+        return false;
+    }
+
+    index_build_tracker_.BeginBuild(collection_name, segment_ids.size(), pending_rows);
+    LOG_ENGINE_DEBUG_ << "Create BuildIndexJob for " << segment_to_build.size() << " segments of "
+                      << collection_name << ", " << segment_ids.size() << " segments to build";
+    cache::CpuCacheMgr::GetInstance().PrintInfo();  // print cache info before build index
+    scheduler::BuildIndexJobPtr job = std::make_shared<scheduler::BuildIndexJob>(latest_ss, options_, segment_to_build);
+
+    IncreaseLiveBuildTaskNum();
+    scheduler::JobMgrInst::GetInstance()->Put(job);
+    job->WaitFinish();
+    DecreaseLiveBuildTaskNum();
+
+    cache::CpuCacheMgr::GetInstance().PrintInfo();  // print cache info after build index
+
+    // record failed segments, avoid build index hang
+    auto failed_segments = job->GetFailedSegments();
+    index_task_tracker_.MarkFailedSegments(collection_name, failed_segments);
+    snapshot::IDS_TYPE segment_built;
+    for (auto id : segment_to_build) {
+        if (failed_segments.find(id) == failed_segments.end()) {
+            segment_built.push_back(id);
+        } else {
+            rows_to_build -= segment_rows[id];
+        }
     }
+    index_build_tracker_.FinishBuild(collection_name, segment_built, rows_to_build);
+
+    if (!job->status().ok()) {
+        LOG_ENGINE_ERROR_ << job->status().message();
+    }
+
+    // notify index request to return (if all segments index has been done)
+    index_req_swn_.Notify();
+    return true;
 }
 
 void
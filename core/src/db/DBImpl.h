@@ -19,9 +19,11 @@
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "db/DB.h"
+#include "db/IndexBuildTracker.h"
 #include "db/SegmentTaskTracker.h"
 
 #include "utils/ThreadPool.h"
@@ -143,6 +145,11 @@ class DBImpl : public DB, public ConfigObserver {
     void
     BackgroundBuildIndexTask(std::vector<std::string> collection_names, bool force_build);
 
+    // build index for one batch of segments not tried yet, return false if nothing is left to build
+    bool
+    BuildIndexBatch(const std::string& collection_name, int64_t batch_size, bool force_build,
+                    std::unordered_set<snapshot::ID_TYPE>& tried_segments);
+
     void
     TimingIndexThread();
 
@@ -197,6 +204,7 @@ class DBImpl : public DB, public ConfigObserver {
     std::list<std::future<void>> index_thread_results_;
 
     SegmentTaskTracker index_task_tracker_;
+    IndexBuildTracker index_build_tracker_;
 
     std::mutex build_index_mutex_;
 
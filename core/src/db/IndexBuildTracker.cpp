@@ -0,0 +1,164 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "db/IndexBuildTracker.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+
+namespace milvus {
+namespace engine {
+
+const char* JSON_INDEX_PROGRESS = "index_progress";
+
+constexpr uint64_t IndexBuildTracker::SEARCH_SAMPLE_INTERVAL;
+constexpr size_t IndexBuildTracker::SEARCH_SHARD_NUM;
+
+IndexBuildTracker::SearchShard&
+IndexBuildTracker::GetSearchShard(const std::string& collection_name) {
+    return search_shards_[std::hash<std::string>()(collection_name) % SEARCH_SHARD_NUM];
+}
+
+void
+IndexBuildTracker::MarkSearched(const std::string& collection_name, const std::vector<int64_t>& segment_ids) {
+    auto& shard = GetSearchShard(collection_name);
+    if (shard.searches_.fetch_add(1, std::memory_order_relaxed) % SEARCH_SAMPLE_INTERVAL != 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto& counts = shard.counts_[collection_name];
+    for (auto id : segment_ids) {
+        counts[id] += SEARCH_SAMPLE_INTERVAL;
+    }
+}
+
+void
+IndexBuildTracker::SortByPriority(const std::string& collection_name,
+                                  const std::unordered_map<int64_t, int64_t>& segment_rows,
+                                  std::vector<int64_t>& segment_ids) {
+    std::unordered_map<int64_t, int64_t> scores;
+    {
+        auto& shard = GetSearchShard(collection_name);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto& counts = shard.counts_[collection_name];
+
+        // searched segments which are not waiting for index any more are forgotten
+        std::unordered_set<int64_t> id_set(segment_ids.begin(), segment_ids.end());
+        for (auto iter = counts.begin(); iter != counts.end();) {
+            iter = id_set.find(iter->first) == id_set.end() ? counts.erase(iter) : std::next(iter);
+        }
+
+        // a segment costs brute force search in proportion to its rows, and it costs more when searched more
+        for (auto id : segment_ids) {
+            auto rows_iter = segment_rows.find(id);
+            int64_t rows = (rows_iter == segment_rows.end()) ? 0 : rows_iter->second;
+            auto count_iter = counts.find(id);
+            int64_t count = (count_iter == counts.end()) ? 0 : count_iter->second;
+            scores[id] = rows * (count + 1);
+        }
+    }
+
+    std::stable_sort(segment_ids.begin(), segment_ids.end(),
+                     [&](int64_t left, int64_t right) { return scores[left] > scores[right]; });
+}
+
+void
+IndexBuildTracker::BeginBuild(const std::string& collection_name, int64_t pending_segments, int64_t pending_rows) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& progress = progress_[collection_name];
+    if (!progress.building_) {
+        progress = Progress();
+        progress.building_ = true;
+        progress.start_time_ = std::chrono::steady_clock::now();
+        progress.last_time_ = progress.start_time_;
+    }
+    progress.pending_segments_ = pending_segments;
+    progress.pending_rows_ = pending_rows;
+}
+
+void
+IndexBuildTracker::FinishBuild(const std::string& collection_name, const std::vector<int64_t>& segment_ids,
+                               int64_t built_rows) {
+    {
+        auto& shard = GetSearchShard(collection_name);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto& counts = shard.counts_[collection_name];
+        for (auto id : segment_ids) {
+            counts.erase(id);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& progress = progress_[collection_name];
+    progress.built_segments_ += segment_ids.size();
+    progress.built_rows_ += built_rows;
+    progress.pending_segments_ = std::max<int64_t>(progress.pending_segments_ - segment_ids.size(), 0);
+    progress.pending_rows_ = std::max<int64_t>(progress.pending_rows_ - built_rows, 0);
+    progress.last_time_ = std::chrono::steady_clock::now();
+}
+
+void
+IndexBuildTracker::EndBuild(const std::string& collection_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = progress_.find(collection_name);
+    if (iter != progress_.end()) {
+        iter->second.building_ = false;
+        iter->second.pending_segments_ = 0;
+        iter->second.pending_rows_ = 0;
+    }
+}
+
+void
+IndexBuildTracker::ClearRecords(const std::string& collection_name) {
+    {
+        auto& shard = GetSearchShard(collection_name);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        shard.counts_.erase(collection_name);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    progress_.erase(collection_name);
+}
+
+bool
+IndexBuildTracker::GetProgress(const std::string& collection_name, milvus::json& json_progress) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = progress_.find(collection_name);
+    if (iter == progress_.end()) {
+        return false;
+    }
+
+    auto& progress = iter->second;
+    double seconds = std::chrono::duration<double>(progress.last_time_ - progress.start_time_).count();
+    double rows_per_second = (seconds > 0) ? progress.built_rows_ / seconds : 0;
+
+    // unknown until the first batch is finished
+    int64_t eta_seconds = -1;
+    if (progress.pending_rows_ == 0) {
+        eta_seconds = 0;
+    } else if (rows_per_second > 0) {
+        eta_seconds = static_cast<int64_t>(progress.pending_rows_ / rows_per_second);
+    }
+
+    json_progress["building"] = progress.building_;
+    json_progress["pending_segments"] = progress.pending_segments_;
+    json_progress["pending_rows"] = progress.pending_rows_;
+    json_progress["built_segments"] = progress.built_segments_;
+    json_progress["built_rows"] = progress.built_rows_;
+    json_progress["rows_per_second"] = rows_per_second;
+    json_progress["eta_seconds"] = eta_seconds;
+    return true;
+}
+
+}  // namespace engine
+}  // namespace milvus
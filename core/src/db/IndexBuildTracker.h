@@ -0,0 +1,96 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/Json.h"
+
+namespace milvus {
+namespace engine {
+
+extern const char* JSON_INDEX_PROGRESS;
+
+// Tracks which segments are searched while they have no index, to decide which segments to build first,
+// and the build progress of each collection, to estimate when the collection will be fully indexed.
+class IndexBuildTracker {
+ public:
+    IndexBuildTracker() = default;
+
+    // the segments are searched by brute force until their index is built, only one of SEARCH_SAMPLE_INTERVAL
+    // searches of a collection shard is recorded, weighted by the interval, to keep the query path cheap
+    void
+    MarkSearched(const std::string& collection_name, const std::vector<int64_t>& segment_ids);
+
+    // sort segment_ids so that hot and large segments come first, segment_rows holds the row count of each segment
+    void
+    SortByPriority(const std::string& collection_name, const std::unordered_map<int64_t, int64_t>& segment_rows,
+                   std::vector<int64_t>& segment_ids);
+
+    // a batch of segments starts building, pending counts include this batch
+    void
+    BeginBuild(const std::string& collection_name, int64_t pending_segments, int64_t pending_rows);
+
+    void
+    FinishBuild(const std::string& collection_name, const std::vector<int64_t>& segment_ids, int64_t built_rows);
+
+    // no more segment to build for now
+    void
+    EndBuild(const std::string& collection_name);
+
+    void
+    ClearRecords(const std::string& collection_name);
+
+    // return false if the collection never built index since server started
+    bool
+    GetProgress(const std::string& collection_name, milvus::json& progress);
+
+ private:
+    struct Progress {
+        bool building_ = false;
+        int64_t pending_segments_ = 0;
+        int64_t pending_rows_ = 0;
+        int64_t built_segments_ = 0;
+        int64_t built_rows_ = 0;
+        std::chrono::steady_clock::time_point start_time_;
+        std::chrono::steady_clock::time_point last_time_;
+    };
+
+    using SegmentCounts = std::unordered_map<int64_t, int64_t>;
+
+    // search counts are sharded by collection name, queries of different collections don't contend
+    struct SearchShard {
+        std::atomic<uint64_t> searches_{0};
+        std::unordered_map<std::string, SegmentCounts> counts_;
+        std::mutex mutex_;
+    };
+
+    static constexpr uint64_t SEARCH_SAMPLE_INTERVAL = 8;
+    static constexpr size_t SEARCH_SHARD_NUM = 16;
+
+    SearchShard&
+    GetSearchShard(const std::string& collection_name);
+
+    std::array<SearchShard, SEARCH_SHARD_NUM> search_shards_;
+
+    std::unordered_map<std::string, Progress> progress_;
+    std::mutex mutex_;
+};
+
+}  // namespace engine
+}  // namespace milvus
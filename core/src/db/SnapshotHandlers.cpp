@@ -22,7 +22,9 @@
 #include "segment/SegmentReader.h"
 #include "utils/StringHelpFunctions.h"
 
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 namespace milvus {
@@ -131,12 +133,69 @@ GetEntityByIdSegmentHandler::GetEntityByIdSegmentHandler(const std::shared_ptr<m
                                                          engine::snapshot::ScopedSnapshotT ss,
                                                          const std::string& dir_root, const IDNumbers& ids,
                                                          const std::vector<std::string>& field_names,
-                                                         std::vector<bool>& valid_row)
-    : BaseT(ss), context_(context), dir_root_(dir_root), ids_(ids), field_names_(field_names), valid_row_(valid_row) {
+                                                         std::vector<bool>& valid_row,
+                                                         const MemChunkViews& mem_chunks,
+                                                         const PendingDeleteIds& delete_ids)
+    : BaseT(ss),
+      context_(context),
+      dir_root_(dir_root),
+      ids_(ids),
+      field_names_(field_names),
+      valid_row_(valid_row),
+      mem_chunks_(mem_chunks),
+      delete_ids_(delete_ids) {
     ids_left_ = ids_;
     data_chunk_ = std::make_shared<engine::DataChunk>();
 }
 
+Status
+GetEntityByIdSegmentHandler::PreIterate() {
+    // unflushed entities are looked up firstly, the left ids are looked up in segments
+    for (auto& view : mem_chunks_) {
+        if (ids_left_.empty()) {
+            break;
+        }
+
+        auto uid_iter = view.chunk_->fixed_fields_.find(FIELD_UID);
+        if (uid_iter == view.chunk_->fixed_fields_.end() || uid_iter->second == nullptr) {
+            continue;
+        }
+        auto uids_address = reinterpret_cast<const idx_t*>(uid_iter->second->data_.data());
+        int64_t id_count = uid_iter->second->data_.size() / sizeof(idx_t);
+
+        // only pick the required fields, the chunk shares data with the insert buffer
+        engine::DataChunkPtr data_chunk = std::make_shared<engine::DataChunk>();
+        data_chunk->count_ = view.chunk_->count_;
+        for (auto& name : field_names_) {
+            auto iter = view.chunk_->fixed_fields_.find(name);
+            if (iter != view.chunk_->fixed_fields_.end()) {
+                data_chunk->fixed_fields_.insert(*iter);
+            }
+        }
+
+        for (auto it = ids_left_.begin(); it != ids_left_.end();) {
+            auto found = std::find(uids_address, uids_address + id_count, *it);
+            int64_t offset = found - uids_address;
+            if (offset >= id_count || (view.blacklist_ != nullptr && view.blacklist_->test(offset))) {
+                ++it;
+                continue;  // not found or deleted
+            }
+
+            result_map_.insert(std::make_pair(*it, std::make_pair(data_chunk, offset)));
+            it = ids_left_.erase(it);
+        }
+    }
+
+    // the left ids deleted since the last flush are not looked up in segments
+    if (!delete_ids_.empty()) {
+        ids_left_.erase(std::remove_if(ids_left_.begin(), ids_left_.end(),
+                                       [&](idx_t id) { return delete_ids_.find(id) != delete_ids_.end(); }),
+                        ids_left_.end());
+    }
+
+    return Status::OK();
+}
+
 Status
 GetEntityByIdSegmentHandler::Handle(const snapshot::SegmentPtr& segment) {
     LOG_ENGINE_DEBUG_ << "Get entity by id in segment " << segment->GetID();
@@ -147,15 +206,24 @@ GetEntityByIdSegmentHandler::Handle(const snapshot::SegmentPtr& segment) {
     }
     segment::SegmentReader segment_reader(dir_root_, segment_visitor);
 
-    engine::idx_t* uids_address = nullptr;
-    int64_t id_count = 0;
-    STATUS_CHECK(segment_reader.LoadUids(&uids_address, id_count));
-
     segment::IdBloomFilterPtr id_bloom_filter_ptr;
     STATUS_CHECK(segment_reader.LoadBloomFilter(id_bloom_filter_ptr));
 
+    // the id index is loaded only when some id possibly in this segment
+    segment::IdIndexPtr id_index_ptr;
+
+    // the blacklist is generated while loading deleted docs, use a set if it is not available
     segment::DeletedDocsPtr deleted_docs_ptr;
     segment_reader.LoadDeletedDocs(deleted_docs_ptr);
+    faiss::ConcurrentBitsetPtr blacklist;
+    std::unordered_set<engine::offset_t> deleted_offsets;
+    if (deleted_docs_ptr) {
+        blacklist = deleted_docs_ptr->GetBlacklist();
+        if (blacklist == nullptr) {
+            auto& deleted_docs = deleted_docs_ptr->GetDeletedDocs();
+            deleted_offsets.insert(deleted_docs.begin(), deleted_docs.end());
+        }
+    }
 
     std::vector<idx_t> ids_in_this_segment;
     std::vector<int64_t> offsets;
@@ -168,26 +236,30 @@ GetEntityByIdSegmentHandler::Handle(const snapshot::SegmentPtr& segment) {
         }
 
         // check if id really exists in uids
-        auto found = std::find(uids_address, uids_address + id_count, id);
-        int64_t offset = found - uids_address;
-        if (offset >= id_count) {
+        if (id_index_ptr == nullptr) {
+            STATUS_CHECK(segment_reader.LoadIdIndex(id_index_ptr));
+        }
+        engine::offset_t offset = 0;
+        if (!id_index_ptr->Find(id, offset)) {
             ++it;
             continue;  // not found
         }
 
         // check if this id is deleted
-        if (deleted_docs_ptr) {
-            auto& deleted_docs = deleted_docs_ptr->GetDeletedDocs();
-            auto deleted = std::find(deleted_docs.begin(), deleted_docs.end(), offset);
-            if (deleted != deleted_docs.end()) {
-                ++it;
-                continue;
-            }
+        bool deleted = false;
+        if (blacklist != nullptr) {
+            deleted = static_cast<size_t>(offset) < blacklist->count() && blacklist->test(offset);
+        } else {
+            deleted = deleted_offsets.find(offset) != deleted_offsets.end();
+        }
+        if (deleted) {
+            ++it;
+            continue;
         }
 
         ids_in_this_segment.push_back(id);
         offsets.push_back(offset);
-        ids_left_.erase(it);
+        it = ids_left_.erase(it);
     }
 
     if (offsets.empty()) {
@@ -75,7 +75,11 @@ struct GetEntityByIdSegmentHandler : public snapshot::SegmentIterator {
     using BaseT = snapshot::IterateHandler<ResourceT>;
     GetEntityByIdSegmentHandler(const server::ContextPtr& context, snapshot::ScopedSnapshotT ss,
                                 const std::string& dir_root, const IDNumbers& ids,
-                                const std::vector<std::string>& field_names, std::vector<bool>& valid_row);
+                                const std::vector<std::string>& field_names, std::vector<bool>& valid_row,
+                                const MemChunkViews& mem_chunks = {}, const PendingDeleteIds& delete_ids = {});
+
+    Status
+    PreIterate() override;
 
     Status
     Handle(const typename ResourceT::Ptr&) override;
@@ -89,6 +93,8 @@ struct GetEntityByIdSegmentHandler : public snapshot::SegmentIterator {
     const std::vector<std::string> field_names_;
     engine::DataChunkPtr data_chunk_;
     std::vector<bool>& valid_row_;
+    const MemChunkViews mem_chunks_;
+    const PendingDeleteIds delete_ids_;
 
  private:
     engine::IDNumbers ids_left_;
@@ -415,5 +415,32 @@ FieldRequireBuildIndex(const engine::SegmentFieldVisitorPtr& field_visitor) {
     return true;
 }
 
+Status
+GetSearchMetricType(const snapshot::ScopedSnapshotT& ss, const query::QueryPtr& query_ptr,
+                    const query::VectorQueryPtr& vector_param, std::string& metric_type) {
+    metric_type = vector_param->metric_type;
+    if (!metric_type.empty()) {
+        return Status::OK();
+    }
+
+    auto iter = query_ptr->metric_types.find(vector_param->field_name);
+    if (iter != query_ptr->metric_types.end()) {
+        metric_type = iter->second;
+        return Status::OK();
+    }
+
+    // use the metric type of collection index
+    auto elements = ss->GetFieldElementsByField(vector_param->field_name);
+    for (auto& element : elements) {
+        if (element->GetFEtype() == FieldElementType::FET_INDEX &&
+            element->GetParams().contains(PARAM_INDEX_METRIC_TYPE)) {
+            metric_type = element->GetParams()[PARAM_INDEX_METRIC_TYPE];
+            return Status::OK();
+        }
+    }
+
+    return Status{DB_ERROR, "Please provide a metric_type in search params since index is not created"};
+}
+
 }  // namespace engine
 }  // namespace milvus
@@ -15,6 +15,7 @@
 #include "db/Types.h"
 #include "db/snapshot/Resources.h"
 #include "db/snapshot/Snapshot.h"
+#include "query/GeneralQuery.h"
 #include "utils/Json.h"
 
 #include <string>
@@ -81,5 +82,10 @@ DropSegment(snapshot::ScopedSnapshotT& ss, snapshot::ID_TYPE segment_id);
 bool
 FieldRequireBuildIndex(const engine::SegmentFieldVisitorPtr& field_visitor);
 
+// metric of a vector query: the one in search params, or the one of collection index if omitted
+Status
+GetSearchMetricType(const snapshot::ScopedSnapshotT& ss, const query::QueryPtr& query_ptr,
+                    const query::VectorQueryPtr& vector_param, std::string& metric_type);
+
 }  // namespace engine
 }  // namespace milvus
@@ -14,6 +14,7 @@
 #include "db/SnapshotUtils.h"
 #include "db/Types.h"
 #include "db/snapshot/Snapshots.h"
+#include "utils/StringHelpFunctions.h"
 #include "value/config/ServerConfig.h"
 
 #include <sstream>
@@ -42,6 +43,30 @@ SnapshotVisitor::SegmentsToSearch(const std::vector<std::string>& partitions, sn
     return handler->GetStatus();
 }
 
+Status
+SnapshotVisitor::PartitionsToSearch(const std::vector<std::string>& partitions,
+                                    std::set<snapshot::ID_TYPE>& partition_ids) {
+    STATUS_CHECK(status_);
+
+    auto& resources = ss_->GetResources<snapshot::Partition>();
+    for (auto& kv : resources) {
+        auto& p_name = kv.second->GetName();
+        bool match = partitions.empty();
+        for (auto& pattern : partitions) {
+            if (StringHelpFunctions::IsRegexMatch(p_name, pattern)) {
+                match = true;
+                break;
+            }
+        }
+
+        if (match) {
+            partition_ids.insert(kv.first);
+        }
+    }
+
+    return Status::OK();
+}
+
 Status
 SnapshotVisitor::SegmentsToIndex(const std::string& field_name, snapshot::IDS_TYPE& segment_ids, bool force_build) {
     STATUS_CHECK(status_);
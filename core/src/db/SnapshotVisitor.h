@@ -31,6 +31,9 @@ class SnapshotVisitor {
     Status
     SegmentsToSearch(const std::vector<std::string>& partitions, snapshot::IDS_TYPE& segment_ids);
 
+    Status
+    PartitionsToSearch(const std::vector<std::string>& partitions, std::set<snapshot::ID_TYPE>& partition_ids);
+
     Status
     SegmentsToIndex(const std::string& field_name, snapshot::IDS_TYPE& segment_ids, bool force_build);
 
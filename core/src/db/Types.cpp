@@ -20,6 +20,7 @@ const char* FIELD_UID = "_id";
 const char* ELEMENT_RAW_DATA = "_raw";
 const char* ELEMENT_BLOOM_FILTER = "_blf";
 const char* ELEMENT_DELETED_DOCS = "_del";
+const char* ELEMENT_ID_INDEX = "_idx";
 const char* ELEMENT_INDEX_COMPRESS = "_compress";
 
 const char* PARAM_UID_AUTOGEN = "auto_id";
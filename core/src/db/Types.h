@@ -19,6 +19,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -35,6 +36,7 @@ extern const char* FIELD_UID;
 extern const char* ELEMENT_RAW_DATA;
 extern const char* ELEMENT_BLOOM_FILTER;
 extern const char* ELEMENT_DELETED_DOCS;
+extern const char* ELEMENT_ID_INDEX;
 extern const char* ELEMENT_INDEX_COMPRESS;
 
 extern const char* PARAM_UID_AUTOGEN;
@@ -79,6 +81,8 @@ enum class DataType {
 
     VECTOR_BINARY = 100,
     VECTOR_FLOAT = 101,
+    VECTOR_FLOAT16 = 102,   // stored as IEEE half, inserted and returned as float
+    VECTOR_BFLOAT16 = 103,  // stored as bfloat16, inserted and returned as float
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +93,7 @@ enum class FieldElementType {
     FET_DELETED_DOCS = 3,
     FET_INDEX = 4,
     FET_COMPRESS = 5,
+    FET_ID_INDEX = 6,
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -134,6 +139,19 @@ struct DataChunk {
 };
 using DataChunkPtr = std::shared_ptr<DataChunk>;
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// read-only view of an unflushed insert chunk, the chunk shares field data with the insert buffer
+struct MemChunkView {
+    int64_t partition_id_ = 0;
+    DataChunkPtr chunk_;
+    ConCurrentBitsetPtr blacklist_;  // entities deleted after insert, nullptr if nothing deleted
+};
+using MemChunkViews = std::vector<MemChunkView>;
+
+// ids deleted since the last flush, the deleted docs of sealed segments don't contain them yet
+using PendingDeleteIds = std::unordered_set<idx_t>;
+using PendingDeleteIdsPtr = std::shared_ptr<const PendingDeleteIds>;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct CollectionIndex {
     std::string index_name_;
@@ -182,6 +200,9 @@ struct DBOptions {
 
     size_t insert_buffer_size_ = 4 * GB;
 
+    // read buffer size of each field in segment merge and compaction
+    int64_t merge_buffer_size_ = DEFAULT_MERGE_BUFFER_SIZE;
+
     int64_t auto_flush_interval_ = 1;
 
     bool metric_enable_ = false;
@@ -11,6 +11,7 @@
 
 #include "db/Utils.h"
 
+#include <faiss/utils/half_float.h>
 #include <fiu/fiu-local.h>
 
 #include <unistd.h>
@@ -73,7 +74,8 @@ IsFlatIndexType(const std::string& index_type) {
 
 bool
 IsVectorType(engine::DataType type) {
-    return type == engine::DataType::VECTOR_FLOAT || type == engine::DataType::VECTOR_BINARY;
+    return type == engine::DataType::VECTOR_FLOAT || type == engine::DataType::VECTOR_BINARY ||
+           IsHalfFloatVectorType(type);
 }
 
 bool
@@ -81,6 +83,67 @@ IsBinaryVectorType(engine::DataType type) {
     return type == engine::DataType::VECTOR_BINARY;
 }
 
+bool
+IsHalfFloatVectorType(engine::DataType type) {
+    return type == engine::DataType::VECTOR_FLOAT16 || type == engine::DataType::VECTOR_BFLOAT16;
+}
+
+int64_t
+GetVectorRowSize(engine::DataType type, int64_t dimension) {
+    if (type == engine::DataType::VECTOR_BINARY) {
+        return dimension / 8;
+    } else if (IsHalfFloatVectorType(type)) {
+        return dimension * sizeof(uint16_t);
+    }
+    return dimension * sizeof(float);
+}
+
+Status
+EncodeHalfFloatVectors(engine::DataType type, const engine::BinaryDataPtr& src, engine::BinaryDataPtr& dst) {
+    if (!IsHalfFloatVectorType(type)) {
+        return Status(DB_ERROR, "Not a half float vector type");
+    }
+    if (src == nullptr || src->data_.size() % sizeof(float) != 0) {
+        return Status(DB_ERROR, "Illegal float vector data");
+    }
+
+    size_t count = src->data_.size() / sizeof(float);
+    auto from = reinterpret_cast<const float*>(src->data_.data());
+    auto result = std::make_shared<engine::BinaryData>();
+    result->data_.resize(count * sizeof(uint16_t));
+    auto to = reinterpret_cast<uint16_t*>(result->data_.data());
+    if (type == engine::DataType::VECTOR_FLOAT16) {
+        faiss::fvec_to_fp16(to, from, count);
+    } else {
+        faiss::fvec_to_bf16(to, from, count);
+    }
+    dst = result;  // src and dst may be the same pointer
+    return Status::OK();
+}
+
+Status
+DecodeHalfFloatVectors(engine::DataType type, const engine::BinaryDataPtr& src, engine::BinaryDataPtr& dst) {
+    if (!IsHalfFloatVectorType(type)) {
+        return Status(DB_ERROR, "Not a half float vector type");
+    }
+    if (src == nullptr || src->data_.size() % sizeof(uint16_t) != 0) {
+        return Status(DB_ERROR, "Illegal half float vector data");
+    }
+
+    size_t count = src->data_.size() / sizeof(uint16_t);
+    auto from = reinterpret_cast<const uint16_t*>(src->data_.data());
+    auto result = std::make_shared<engine::BinaryData>();
+    result->data_.resize(count * sizeof(float));
+    auto to = reinterpret_cast<float*>(result->data_.data());
+    if (type == engine::DataType::VECTOR_FLOAT16) {
+        faiss::fp16_to_fvec(to, from, count);
+    } else {
+        faiss::bf16_to_fvec(to, from, count);
+    }
+    dst = result;  // src and dst may be the same pointer
+    return Status::OK();
+}
+
 engine::date_t
 GetDate(const std::time_t& t, int day_delta) {
     struct tm ltm;
@@ -278,7 +341,8 @@ SplitChunk(const DataChunkPtr& chunk, int64_t segment_row_limit, std::vector<Dat
 bool
 RequireRawFile(const std::string& index_type) {
     return index_type == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT || index_type == knowhere::IndexEnum::INDEX_NSG ||
-           index_type == knowhere::IndexEnum::INDEX_HNSW;
+           index_type == knowhere::IndexEnum::INDEX_HNSW ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN;
 }
 
 bool
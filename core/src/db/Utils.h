@@ -40,6 +40,21 @@ IsVectorType(engine::DataType type);
 bool
 IsBinaryVectorType(engine::DataType type);
 
+// float vectors stored in 16-bit floats
+bool
+IsHalfFloatVectorType(engine::DataType type);
+
+// bytes of a vector stored in the field
+int64_t
+GetVectorRowSize(engine::DataType type, int64_t dimension);
+
+// convert float vectors to the 16-bit storage format of the field type, or back to float
+Status
+EncodeHalfFloatVectors(engine::DataType type, const engine::BinaryDataPtr& src, engine::BinaryDataPtr& dst);
+
+Status
+DecodeHalfFloatVectors(engine::DataType type, const engine::BinaryDataPtr& src, engine::BinaryDataPtr& dst);
+
 engine::date_t
 GetDate(const std::time_t& t, int day_delta = 0);
 engine::date_t
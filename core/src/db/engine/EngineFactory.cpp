@@ -11,6 +11,7 @@
 
 #include "db/engine/EngineFactory.h"
 #include "db/engine/ExecutionEngineImpl.h"
+#include "db/engine/MemExecutionEngine.h"
 #include "utils/Log.h"
 
 #include <memory>
@@ -29,5 +30,10 @@ EngineFactory::Build(const engine::snapshot::ScopedSnapshotT& snapshot, const st
     return execution_engine_ptr;
 }
 
+ExecutionEnginePtr
+EngineFactory::Build(const engine::snapshot::ScopedSnapshotT& snapshot, const MemChunkViews& chunks) {
+    return std::make_shared<MemExecutionEngine>(snapshot, chunks);
+}
+
 }  // namespace engine
 }  // namespace milvus
@@ -25,6 +25,9 @@ class EngineFactory {
  public:
     static ExecutionEnginePtr
     Build(const engine::snapshot::ScopedSnapshotT& snapshot, const std::string& dir_root, int64_t segment_id);
+
+    static ExecutionEnginePtr
+    Build(const engine::snapshot::ScopedSnapshotT& snapshot, const MemChunkViews& chunks);
 };
 
 }  // namespace engine
@@ -11,6 +11,7 @@
 
 #include "db/engine/ExecutionEngineImpl.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
@@ -18,6 +19,8 @@
 
 #include "db/SnapshotUtils.h"
 #include "db/Utils.h"
+#include "db/engine/SearchStrategy.h"
+#include "metrics/SearchMetrics.h"
 #include "segment/SegmentReader.h"
 #include "segment/SegmentWriter.h"
 #include "utils/CommonUtil.h"
@@ -195,6 +198,45 @@ MapAndCopyResult(const knowhere::DatasetPtr& dataset, std::shared_ptr<std::vecto
     free(res_dist);
 }
 
+// count the filtered rows, whose bits are set
+int64_t
+CountFiltered(const faiss::ConcurrentBitsetPtr& bitset, int64_t row_count) {
+    row_count = std::min<int64_t>(row_count, bitset->count());
+    auto data = bitset->data();
+    int64_t filtered = 0;
+    int64_t full_bytes = row_count >> 3;
+    for (int64_t i = 0; i < full_bytes; ++i) {
+        filtered += __builtin_popcount(data[i]);
+    }
+    for (int64_t i = full_bytes << 3; i < row_count; ++i) {
+        filtered += bitset->test(i) ? 1 : 0;
+    }
+    return filtered;
+}
+
+knowhere::DatasetPtr
+ExecutionEngineImpl::AnnQuery(const query::VectorQueryPtr& vector_param, const knowhere::VecIndexPtr& vec_index,
+                              int64_t topk, const faiss::ConcurrentBitsetPtr& bitset) {
+    milvus::json conf = vector_param->extra_params;
+    conf[knowhere::meta::TOPK] = topk;
+    conf[knowhere::Metric::TYPE] = vector_param->metric_type;
+    auto adapter = knowhere::AdapterMgr::GetInstance().GetAdapter(vec_index->index_type());
+    if (!adapter->CheckSearch(conf, vec_index->index_type(), vec_index->index_mode())) {
+        LOG_ENGINE_ERROR_ << LogOut("[%s][%ld] Illegal search params", "search", 0);
+        throw Exception(DB_ERROR, "Illegal search params");
+    }
+
+    auto& query_vector = vector_param->query_vector;
+    knowhere::DatasetPtr dataset;
+    if (!query_vector.float_data.empty()) {
+        dataset = knowhere::GenDataset(vector_param->nq, vec_index->Dim(), query_vector.float_data.data());
+    } else {
+        dataset = knowhere::GenDataset(vector_param->nq, vec_index->Dim(), query_vector.binary_data.data());
+    }
+
+    return vec_index->Query(dataset, conf, bitset);
+}
+
 Status
 ExecutionEngineImpl::VecSearch(milvus::engine::ExecutionEngineContext& context,
                                const query::VectorQueryPtr& vector_param, knowhere::VecIndexPtr& vec_index,
@@ -207,35 +249,18 @@ ExecutionEngineImpl::VecSearch(milvus::engine::ExecutionEngineContext& context,
     }
 
     uint64_t nq = vector_param->nq;
-    auto query_vector = vector_param->query_vector;
     uint64_t topk = vector_param->topk;
 
     context.query_result_ = std::make_shared<QueryResult>();
     context.query_result_->result_ids_.resize(topk * nq);
     context.query_result_->result_distances_.resize(topk * nq);
 
-    milvus::json conf = vector_param->extra_params;
-    conf[knowhere::meta::TOPK] = topk;
-    conf[knowhere::Metric::TYPE] = vector_param->metric_type;
-    auto adapter = knowhere::AdapterMgr::GetInstance().GetAdapter(vec_index->index_type());
-    if (!adapter->CheckSearch(conf, vec_index->index_type(), vec_index->index_mode())) {
-        LOG_ENGINE_ERROR_ << LogOut("[%s][%ld] Illegal search params", "search", 0);
-        throw Exception(DB_ERROR, "Illegal search params");
-    }
-
     if (hybrid) {
         //        HybridLoad();
     }
 
     rc.RecordSection("query prepare");
-    knowhere::DatasetPtr dataset;
-    if (!query_vector.float_data.empty()) {
-        dataset = knowhere::GenDataset(nq, vec_index->Dim(), query_vector.float_data.data());
-    } else {
-        dataset = knowhere::GenDataset(nq, vec_index->Dim(), query_vector.binary_data.data());
-    }
-
-    auto result = vec_index->Query(dataset, conf, bitset);
+    auto result = AnnQuery(vector_param, vec_index, topk, bitset);
     MapAndCopyResult(result, vec_index->GetUids(), nq, topk, context.query_result_->result_distances_.data(),
                      context.query_result_->result_ids_.data());
     if (hybrid) {
@@ -246,6 +271,152 @@ ExecutionEngineImpl::VecSearch(milvus::engine::ExecutionEngineContext& context,
     return Status::OK();
 }
 
+Status
+ExecutionEngineImpl::BruteForceSearch(ExecutionEngineContext& context, const query::VectorQueryPtr& vector_param,
+                                      const std::string& field_name, const knowhere::VecIndexPtr& vec_index,
+                                      const faiss::ConcurrentBitsetPtr& bitset) {
+    TimeRecorder rc(LogOut("[%s][%ld] ExecutionEngineImpl::BruteForceSearch", "search", 0));
+
+    // gather the vectors of rows passing the filter into a temporary flat index
+    std::vector<int64_t> offsets;
+    for (int64_t i = 0; i < entity_count_; ++i) {
+        if (!bitset->test(i)) {
+            offsets.push_back(i);
+        }
+    }
+
+    bool binary = vector_param->query_vector.float_data.empty();
+    auto flat_type = binary ? knowhere::IndexEnum::INDEX_FAISS_BIN_IDMAP : knowhere::IndexEnum::INDEX_FAISS_IDMAP;
+    auto flat_index = knowhere::VecIndexFactory::GetInstance().CreateVecIndex(flat_type, knowhere::IndexMode::MODE_CPU);
+    if (flat_index == nullptr) {
+        return Status(DB_ERROR, "Failed to create flat index for brute force search");
+    }
+    milvus::json conf{{knowhere::meta::DIM, vec_index->Dim()}};
+    flat_index->Train(knowhere::DatasetPtr(), conf);
+
+    engine::BinaryDataPtr raw;
+    if (!offsets.empty()) {
+        STATUS_CHECK(segment_reader_->LoadEntities(field_name, offsets, raw));
+        auto field = segment_reader_->GetSegmentVisitor()->GetFieldVisitor(field_name)->GetField();
+        auto field_type = static_cast<DataType>(field->GetFtype());
+        if (utils::IsHalfFloatVectorType(field_type)) {
+            STATUS_CHECK(utils::DecodeHalfFloatVectors(field_type, raw, raw));
+        }
+        auto dataset = knowhere::GenDataset(offsets.size(), vec_index->Dim(), raw->data_.data());
+        flat_index->AddWithoutIds(dataset, conf);
+    }
+    rc.RecordSection("gather " + std::to_string(offsets.size()) + " rows");
+
+    uint64_t nq = vector_param->nq;
+    uint64_t topk = vector_param->topk;
+    context.query_result_ = std::make_shared<QueryResult>();
+    context.query_result_->result_ids_.resize(topk * nq);
+    context.query_result_->result_distances_.resize(topk * nq);
+
+    // map the offsets in temporary index to the offsets in segment, then to the uids
+    auto result = AnnQuery(vector_param, flat_index, topk, nullptr);
+    auto res_ids = result->Get<int64_t*>(knowhere::meta::IDS);
+    for (uint64_t i = 0; i < nq * topk; ++i) {
+        if (res_ids[i] >= 0) {
+            res_ids[i] = offsets[res_ids[i]];
+        }
+    }
+    MapAndCopyResult(result, vec_index->GetUids(), nq, topk, context.query_result_->result_distances_.data(),
+                     context.query_result_->result_ids_.data());
+    rc.ElapseFromBegin("done");
+
+    return Status::OK();
+}
+
+Status
+ExecutionEngineImpl::MaskPendingDeletes(const PendingDeleteIdsPtr& delete_ids,
+                                        faiss::ConcurrentBitsetPtr& filter_list) {
+    if (delete_ids == nullptr || delete_ids->empty()) {
+        return Status::OK();
+    }
+
+    segment::IdBloomFilterPtr bloom_filter;
+    STATUS_CHECK(segment_reader_->LoadBloomFilter(bloom_filter));
+
+    // the id index is loaded only when some id possibly in this segment
+    segment::IdIndexPtr id_index;
+    faiss::ConcurrentBitsetPtr pending;
+    std::vector<offset_t> offsets;
+    for (auto id : *delete_ids) {
+        if (!bloom_filter->Check(id)) {
+            continue;
+        }
+        if (id_index == nullptr) {
+            STATUS_CHECK(segment_reader_->LoadIdIndex(id_index));
+        }
+        offsets.clear();
+        id_index->FindAll(id, offsets);
+        for (auto offset : offsets) {
+            if (offset >= entity_count_) {
+                continue;
+            }
+            if (pending == nullptr) {
+                pending = std::make_shared<faiss::ConcurrentBitset>(entity_count_);
+            }
+            pending->set(offset);
+        }
+    }
+
+    // the deleted docs bitset is cached, it is never modified in place
+    if (pending != nullptr) {
+        filter_list = (filter_list != nullptr) ? (*filter_list) | (*pending) : pending;
+    }
+    return Status::OK();
+}
+
+Status
+ExecutionEngineImpl::PostFilterSearch(ExecutionEngineContext& context, const query::VectorQueryPtr& vector_param,
+                                      const knowhere::VecIndexPtr& vec_index, const faiss::ConcurrentBitsetPtr& bitset,
+                                      int64_t pass_count, bool& satisfied) {
+    TimeRecorder rc(LogOut("[%s][%ld] ExecutionEngineImpl::PostFilterSearch", "search", 0));
+
+    int64_t nq = vector_param->nq;
+    int64_t topk = vector_param->topk;
+    int64_t fetch_k = PostFilterTopk(entity_count_, pass_count, topk);
+
+    auto result = AnnQuery(vector_param, vec_index, fetch_k, nullptr);
+    auto res_ids = result->Get<int64_t*>(knowhere::meta::IDS);
+    auto res_dist = result->Get<float*>(knowhere::meta::DISTANCE);
+    auto uids = vec_index->GetUids();
+
+    context.query_result_ = std::make_shared<QueryResult>();
+    auto& result_ids = context.query_result_->result_ids_;
+    auto& result_distances = context.query_result_->result_distances_;
+    result_ids.resize(topk * nq, -1);
+    result_distances.resize(topk * nq);
+
+    // keep the first topk results passing the filter, the search is not satisfied if any query got too few
+    int64_t expect_k = std::min(topk, pass_count);
+    satisfied = true;
+    for (int64_t i = 0; i < nq; ++i) {
+        int64_t valid_k = 0;
+        for (int64_t j = 0; j < fetch_k && valid_k < topk; ++j) {
+            int64_t offset = res_ids[i * fetch_k + j];
+            if (offset == -1 || bitset->test(offset)) {
+                continue;
+            }
+            result_ids[i * topk + valid_k] = (*uids)[offset];
+            result_distances[i * topk + valid_k] = res_dist[i * fetch_k + j];
+            ++valid_k;
+        }
+        if (valid_k < expect_k) {
+            satisfied = false;
+            break;
+        }
+    }
+
+    free(res_ids);
+    free(res_dist);
+    rc.ElapseFromBegin("done");
+
+    return Status::OK();
+}
+
 Status
 ExecutionEngineImpl::Search(ExecutionEngineContext& context) {
     TimeRecorder rc(LogOut("[%s][%ld] ExecutionEngineImpl::Search", "search", 0));
@@ -257,6 +428,7 @@ ExecutionEngineImpl::Search(ExecutionEngineContext& context) {
         SegmentPtr segment_ptr;
         segment_reader_->GetSegment(segment_ptr);
         knowhere::VecIndexPtr vec_index = nullptr;
+        std::string vector_field_name;
         std::unordered_map<std::string, engine::DataType> attr_type;
 
         auto segment_visitor = segment_reader_->GetSegmentVisitor();
@@ -267,15 +439,17 @@ ExecutionEngineImpl::Search(ExecutionEngineContext& context) {
                 return Status(SERVER_INVALID_DSL_PARAMETER, "Field: " + name + " is not existed");
             }
             auto field = field_visitor->GetField();
-            if (field->GetFtype() == static_cast<snapshot::FTYPE_TYPE>(engine::DataType::VECTOR_FLOAT) ||
-                field->GetFtype() == static_cast<snapshot::FTYPE_TYPE>(engine::DataType::VECTOR_BINARY)) {
+            if (utils::IsVectorType(static_cast<engine::DataType>(field->GetFtype()))) {
                 STATUS_CHECK(segment_ptr->GetVectorIndex(name, vec_index));
+                vector_field_name = name;
             } else {
                 attr_type.insert(std::make_pair(name, static_cast<engine::DataType>(field->GetFtype())));
             }
         }
 
         entity_count_ = vec_index->Count();
+        auto& collection_name = context.query_ptr_->collection_id;
+        SearchStageTimer filter_timer(SearchStage::FILTER, collection_name, vec_index->index_type());
 
         // Parse general query
         auto status = ExecBinaryQuery(context.query_ptr_->root, bitset, attr_type, vector_placeholder);
@@ -301,6 +475,7 @@ ExecutionEngineImpl::Search(ExecutionEngineContext& context) {
         } else {
             filter_list = bitset;
         }
+        STATUS_CHECK(MaskPendingDeletes(context.delete_ids_, filter_list));
 
         auto& vector_param = context.query_ptr_->vectors.at(vector_placeholder);
         if (!vector_param->query_vector.float_data.empty()) {
@@ -309,7 +484,34 @@ ExecutionEngineImpl::Search(ExecutionEngineContext& context) {
             vector_param->nq = vector_param->query_vector.binary_data.size() * 8 / vec_index->Dim();
         }
 
-        status = VecSearch(context, context.query_ptr_->vectors.at(vector_placeholder), vec_index, filter_list);
+        // choose search strategy by the rows passing the filter, gpu index always searches with bitset
+        auto strategy = SearchStrategy::ANN_BITSET;
+        int64_t pass_count = entity_count_;
+        if (filter_list != nullptr && vec_index->index_mode() == knowhere::IndexMode::MODE_CPU) {
+            pass_count = entity_count_ - CountFiltered(filter_list, entity_count_);
+            auto scan_count = EstimateScanCount(vec_index, vector_param->extra_params, vector_param->topk);
+            BinaryDataPtr raw_data;
+            segment_ptr->GetFixedFieldData(vector_field_name, raw_data);
+            strategy = ChooseSearchStrategy(vec_index->index_type(), entity_count_, pass_count, vector_param->topk,
+                                            scan_count, raw_data != nullptr);
+        }
+
+        filter_timer.Stop();
+
+        SearchStageTimer search_timer(SearchStage::VECTOR_SEARCH, collection_name, vec_index->index_type());
+        bool searched = false;
+        if (strategy == SearchStrategy::BRUTE_FORCE) {
+            STATUS_CHECK(BruteForceSearch(context, vector_param, vector_field_name, vec_index, filter_list));
+            searched = true;
+        } else if (strategy == SearchStrategy::ANN_POST_FILTER) {
+            STATUS_CHECK(PostFilterSearch(context, vector_param, vec_index, filter_list, pass_count, searched));
+            if (!searched) {
+                LOG_ENGINE_DEBUG_ << "Post filter got too few results, search again with bitset";
+            }
+        }
+        if (!searched) {
+            status = VecSearch(context, vector_param, vec_index, filter_list);
+        }
         if (!status.ok()) {
             return status;
         }
@@ -324,41 +526,53 @@ Status
 ExecutionEngineImpl::ExecBinaryQuery(const milvus::query::GeneralQueryPtr& general_query, ConCurrentBitsetPtr& bitset,
                                      std::unordered_map<std::string, DataType>& attr_type,
                                      std::string& vector_placeholder) {
-    Status status = Status::OK();
+    // one bitset for each level of the query tree, allocated once and reused by all nodes of the level
+    std::vector<ConCurrentBitsetPtr> bitsets;
+    bool filtered = false;
+    STATUS_CHECK(ExecFilter(general_query, 0, bitsets, filtered, attr_type, vector_placeholder));
+    bitset = filtered ? bitsets[0] : nullptr;
+    return Status::OK();
+}
+
+Status
+ExecutionEngineImpl::ExecFilter(const milvus::query::GeneralQueryPtr& general_query, size_t depth,
+                                std::vector<ConCurrentBitsetPtr>& bitsets, bool& filtered,
+                                std::unordered_map<std::string, DataType>& attr_type,
+                                std::string& vector_placeholder) {
+    filtered = false;
     if (general_query->leaf == nullptr) {
-        ConCurrentBitsetPtr left_bitset, right_bitset;
+        bool left_filtered = false, right_filtered = false;
         if (general_query->bin->left_query != nullptr) {
-            status = ExecBinaryQuery(general_query->bin->left_query, left_bitset, attr_type, vector_placeholder);
-            if (!status.ok()) {
-                return status;
-            }
+            STATUS_CHECK(ExecFilter(general_query->bin->left_query, depth, bitsets, left_filtered, attr_type,
+                                    vector_placeholder));
         }
         if (general_query->bin->right_query != nullptr) {
-            status = ExecBinaryQuery(general_query->bin->right_query, right_bitset, attr_type, vector_placeholder);
-            if (!status.ok()) {
-                return status;
-            }
+            STATUS_CHECK(ExecFilter(general_query->bin->right_query, depth + 1, bitsets, right_filtered, attr_type,
+                                    vector_placeholder));
         }
 
-        if (left_bitset == nullptr) {
-            bitset = right_bitset;
-        } else if (right_bitset == nullptr) {
-            bitset = left_bitset;
-        } else {
+        if (!left_filtered && !right_filtered) {
+            return Status::OK();
+        }
+        if (!left_filtered) {
+            std::swap(bitsets[depth], bitsets[depth + 1]);
+        } else if (right_filtered) {
+            auto& left_bitset = *bitsets[depth];
+            auto& right_bitset = *bitsets[depth + 1];
             switch (general_query->bin->relation) {
                 case milvus::query::QueryRelation::AND:
                 case milvus::query::QueryRelation::R1: {
-                    bitset = (*left_bitset) & (*right_bitset);
+                    left_bitset &= right_bitset;
                     break;
                 }
                 case milvus::query::QueryRelation::OR:
                 case milvus::query::QueryRelation::R2:
                 case milvus::query::QueryRelation::R3: {
-                    bitset = (*left_bitset) | (*right_bitset);
+                    left_bitset |= right_bitset;
                     break;
                 }
                 case milvus::query::QueryRelation::R4: {
-                    bitset = (*left_bitset) & (right_bitset->negate());
+                    left_bitset.and_not(right_bitset);
                     break;
                 }
                 default: {
@@ -368,29 +582,38 @@ ExecutionEngineImpl::ExecBinaryQuery(const milvus::query::GeneralQueryPtr& gener
             }
         }
         if (general_query->bin->is_not) {
-            bitset->negate();
+            bitsets[depth]->negate();
         }
-        return status;
+        filtered = true;
     } else {
+        if (general_query->leaf->term_query != nullptr || general_query->leaf->range_query != nullptr) {
+            if (bitsets.size() <= depth) {
+                bitsets.resize(depth + 1);
+            }
+            if (bitsets[depth] == nullptr) {
+                bitsets[depth] = std::make_shared<ConCurrentBitset>(entity_count_);
+            }
+            filtered = true;
+        }
         if (general_query->leaf->term_query != nullptr) {
-            bitset = std::make_shared<ConCurrentBitset>(entity_count_);
-            STATUS_CHECK(ProcessTermQuery(bitset, general_query->leaf->term_query, attr_type));
+            bitsets[depth]->reset();
+            STATUS_CHECK(ProcessTermQuery(*bitsets[depth], general_query->leaf->term_query, attr_type));
         }
         if (general_query->leaf->range_query != nullptr) {
-            bitset = std::make_shared<ConCurrentBitset>(entity_count_);
-            STATUS_CHECK(ProcessRangeQuery(attr_type, bitset, general_query->leaf->range_query));
+            bitsets[depth]->reset();
+            STATUS_CHECK(ProcessRangeQuery(attr_type, *bitsets[depth], general_query->leaf->range_query));
         }
         if (!general_query->leaf->vector_placeholder.empty()) {
             // skip vector query
             vector_placeholder = general_query->leaf->vector_placeholder;
         }
     }
-    return status;
+    return Status::OK();
 }
 
 template <typename T>
 Status
-ProcessIndexedTermQuery(ConCurrentBitsetPtr& bitset, knowhere::IndexPtr& index_ptr, milvus::json& term_values_json) {
+ProcessIndexedTermQuery(ConCurrentBitset& bitset, knowhere::IndexPtr& index_ptr, milvus::json& term_values_json) {
     try {
         auto T_index = std::dynamic_pointer_cast<knowhere::StructuredIndexSort<T>>(index_ptr);
         if (not T_index) {
@@ -404,7 +627,7 @@ ProcessIndexedTermQuery(ConCurrentBitsetPtr& bitset, knowhere::IndexPtr& index_p
             ++offset;
         }
 
-        bitset = T_index->In(term_size, term_value.data());
+        T_index->In(term_size, term_value.data(), bitset);
     } catch (std::exception& exception) {
         return Status{SERVER_INVALID_DSL_PARAMETER, exception.what()};
     }
@@ -412,7 +635,7 @@ ProcessIndexedTermQuery(ConCurrentBitsetPtr& bitset, knowhere::IndexPtr& index_p
 }
 
 Status
-ExecutionEngineImpl::IndexedTermQuery(ConCurrentBitsetPtr& bitset, const std::string& field_name,
+ExecutionEngineImpl::IndexedTermQuery(ConCurrentBitset& bitset, const std::string& field_name,
                                       const DataType& data_type, milvus::json& term_values_json) {
     SegmentPtr segment_ptr;
     segment_reader_->GetSegment(segment_ptr);
@@ -452,7 +675,7 @@ ExecutionEngineImpl::IndexedTermQuery(ConCurrentBitsetPtr& bitset, const std::st
 }
 
 Status
-ExecutionEngineImpl::ProcessTermQuery(ConCurrentBitsetPtr& bitset, const query::TermQueryPtr& term_query,
+ExecutionEngineImpl::ProcessTermQuery(ConCurrentBitset& bitset, const query::TermQueryPtr& term_query,
                                       std::unordered_map<std::string, DataType>& attr_type) {
     try {
         auto term_query_json = term_query->json_obj;
@@ -479,21 +702,51 @@ ExecutionEngineImpl::ProcessTermQuery(ConCurrentBitsetPtr& bitset, const query::
 
 template <typename T>
 Status
-ProcessIndexedRangeQuery(ConCurrentBitsetPtr& bitset, knowhere::IndexPtr& index_ptr, milvus::json& range_values_json) {
+ProcessIndexedRangeQuery(ConCurrentBitset& bitset, knowhere::IndexPtr& index_ptr, milvus::json& range_values_json) {
     try {
         auto T_index = std::dynamic_pointer_cast<knowhere::StructuredIndexSort<T>>(index_ptr);
+        if (not T_index) {
+            return Status{SERVER_INVALID_ARGUMENT, "Attribute's type is wrong"};
+        }
 
-        bool flag = false;
+        // all comparisons on the field are merged into one range, which is a single pass on the sorted index
+        bool has_lower = false, has_upper = false;
+        bool lower_inclusive = false, upper_inclusive = false;
+        T lower_value = T(), upper_value = T();
         for (auto& range_value_it : range_values_json.items()) {
-            const std::string& comp_op = range_value_it.key();
             T value = range_value_it.value();
-            if (not flag) {
-                bitset = (*bitset) | (*T_index->Range(value, knowhere::s_map_operator_type.at(comp_op)));
-                flag = true;
-            } else {
-                bitset = (*bitset) & (*T_index->Range(value, knowhere::s_map_operator_type.at(comp_op)));
+            auto op = knowhere::s_map_operator_type.at(range_value_it.key());
+            switch (op) {
+                case knowhere::OperatorType::GT:
+                case knowhere::OperatorType::GE: {
+                    bool inclusive = (op == knowhere::OperatorType::GE);
+                    if (!has_lower || value > lower_value || (value == lower_value && !inclusive)) {
+                        lower_value = value;
+                        lower_inclusive = inclusive;
+                    }
+                    has_lower = true;
+                    break;
+                }
+                case knowhere::OperatorType::LT:
+                case knowhere::OperatorType::LE: {
+                    bool inclusive = (op == knowhere::OperatorType::LE);
+                    if (!has_upper || value < upper_value || (value == upper_value && !inclusive)) {
+                        upper_value = value;
+                        upper_inclusive = inclusive;
+                    }
+                    has_upper = true;
+                    break;
+                }
+                default:
+                    return Status{SERVER_INVALID_DSL_PARAMETER, "Invalid range operator: " + range_value_it.key()};
             }
         }
+        if (!has_lower && !has_upper) {
+            return Status::OK();
+        }
+
+        T_index->Range(has_lower ? &lower_value : nullptr, lower_inclusive, has_upper ? &upper_value : nullptr,
+                       upper_inclusive, bitset);
     } catch (std::exception& exception) {
         return Status{SERVER_INVALID_DSL_PARAMETER, exception.what()};
     }
@@ -501,7 +754,7 @@ ProcessIndexedRangeQuery(ConCurrentBitsetPtr& bitset, knowhere::IndexPtr& index_
 }
 
 Status
-ExecutionEngineImpl::IndexedRangeQuery(ConCurrentBitsetPtr& bitset, const DataType& data_type,
+ExecutionEngineImpl::IndexedRangeQuery(ConCurrentBitset& bitset, const DataType& data_type,
                                        knowhere::IndexPtr& index_ptr, milvus::json& range_values_json) {
     auto status = Status::OK();
     switch (data_type) {
@@ -537,7 +790,7 @@ ExecutionEngineImpl::IndexedRangeQuery(ConCurrentBitsetPtr& bitset, const DataTy
 
 Status
 ExecutionEngineImpl::ProcessRangeQuery(const std::unordered_map<std::string, DataType>& attr_type,
-                                       ConCurrentBitsetPtr& bitset, const query::RangeQueryPtr& range_query) {
+                                       ConCurrentBitset& bitset, const query::RangeQueryPtr& range_query) {
     SegmentPtr segment_ptr;
     segment_reader_->GetSegment(segment_ptr);
     try {
@@ -41,10 +41,28 @@ class ExecutionEngineImpl : public ExecutionEngine {
     BuildIndex(uint64_t device_id) override;
 
  private:
+    knowhere::DatasetPtr
+    AnnQuery(const query::VectorQueryPtr& vector_param, const knowhere::VecIndexPtr& vec_index, int64_t topk,
+             const faiss::ConcurrentBitsetPtr& bitset);
+
     Status
     VecSearch(ExecutionEngineContext& context, const query::VectorQueryPtr& vector_param,
               knowhere::VecIndexPtr& vec_index, const faiss::ConcurrentBitsetPtr& bitset, bool hybrid = false);
 
+    Status
+    BruteForceSearch(ExecutionEngineContext& context, const query::VectorQueryPtr& vector_param,
+                     const std::string& field_name, const knowhere::VecIndexPtr& vec_index,
+                     const faiss::ConcurrentBitsetPtr& bitset);
+
+    // ids deleted since the last flush are not in the deleted docs yet, set their offsets in a copy of filter_list
+    Status
+    MaskPendingDeletes(const PendingDeleteIdsPtr& delete_ids, faiss::ConcurrentBitsetPtr& filter_list);
+
+    Status
+    PostFilterSearch(ExecutionEngineContext& context, const query::VectorQueryPtr& vector_param,
+                     const knowhere::VecIndexPtr& vec_index, const faiss::ConcurrentBitsetPtr& bitset,
+                     int64_t pass_count, bool& satisfied);
+
     knowhere::VecIndexPtr
     CreateVecIndex(const std::string& index_name, knowhere::IndexMode mode);
 
@@ -58,20 +76,27 @@ class ExecutionEngineImpl : public ExecutionEngine {
     ExecBinaryQuery(const query::GeneralQueryPtr& general_query, faiss::ConcurrentBitsetPtr& bitset,
                     std::unordered_map<std::string, DataType>& attr_type, std::string& vector_placeholder);
 
+    // evaluate the query tree into bitsets[depth] in place, right child of a binary query uses one level deeper,
+    // filtered is false if there is no scalar filter in the tree
+    Status
+    ExecFilter(const query::GeneralQueryPtr& general_query, size_t depth,
+               std::vector<faiss::ConcurrentBitsetPtr>& bitsets, bool& filtered,
+               std::unordered_map<std::string, DataType>& attr_type, std::string& vector_placeholder);
+
     Status
-    ProcessTermQuery(faiss::ConcurrentBitsetPtr& bitset, const query::TermQueryPtr& term_query,
+    ProcessTermQuery(faiss::ConcurrentBitset& bitset, const query::TermQueryPtr& term_query,
                      std::unordered_map<std::string, DataType>& attr_type);
 
     Status
-    IndexedTermQuery(faiss::ConcurrentBitsetPtr& bitset, const std::string& field_name, const DataType& data_type,
+    IndexedTermQuery(faiss::ConcurrentBitset& bitset, const std::string& field_name, const DataType& data_type,
                      milvus::json& term_values_json);
 
     Status
-    ProcessRangeQuery(const std::unordered_map<std::string, DataType>& attr_type, faiss::ConcurrentBitsetPtr& bitset,
+    ProcessRangeQuery(const std::unordered_map<std::string, DataType>& attr_type, faiss::ConcurrentBitset& bitset,
                       const query::RangeQueryPtr& range_query);
 
     Status
-    IndexedRangeQuery(faiss::ConcurrentBitsetPtr& bitset, const DataType& data_type, knowhere::IndexPtr& index_ptr,
+    IndexedRangeQuery(faiss::ConcurrentBitset& bitset, const DataType& data_type, knowhere::IndexPtr& index_ptr,
                       milvus::json& range_values_json);
 
     using AddSegmentFileOperation = std::shared_ptr<snapshot::ChangeSegmentFileOperation>;
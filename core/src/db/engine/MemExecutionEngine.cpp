@@ -0,0 +1,490 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "db/engine/MemExecutionEngine.h"
+
+#include <faiss/utils/BinaryDistance.h>
+#include <faiss/utils/distances.h>
+#include <faiss/utils/hamming.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "db/SnapshotUtils.h"
+#include "db/Utils.h"
+#include "knowhere/index/structured_index/StructuredIndex.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
+#include "utils/Error.h"
+#include "utils/Log.h"
+#include "utils/TimeRecorder.h"
+
+namespace milvus {
+namespace engine {
+
+namespace {
+
+template <typename T>
+void
+TermScan(const BinaryDataPtr& data, int64_t count, const milvus::json& term_values_json, ConCurrentBitset& bitset) {
+    std::vector<T> term_values;
+    term_values.reserve(term_values_json.size());
+    for (auto& value : term_values_json) {
+        term_values.push_back(value.get<T>());
+    }
+    std::sort(term_values.begin(), term_values.end());
+
+    auto values = reinterpret_cast<const T*>(data->data_.data());
+    for (int64_t i = 0; i < count; ++i) {
+        if (std::binary_search(term_values.begin(), term_values.end(), values[i])) {
+            bitset.set(i);
+        }
+    }
+}
+
+template <typename T>
+void
+RangeScan(const BinaryDataPtr& data, int64_t count, const milvus::json& range_values_json, ConCurrentBitset& bitset) {
+    std::vector<std::pair<knowhere::OperatorType, T>> conditions;
+    for (auto& range_value_it : range_values_json.items()) {
+        T value = range_value_it.value();
+        conditions.emplace_back(knowhere::s_map_operator_type.at(range_value_it.key()), value);
+    }
+
+    auto values = reinterpret_cast<const T*>(data->data_.data());
+    for (int64_t i = 0; i < count; ++i) {
+        bool match = true;
+        for (auto& condition : conditions) {
+            switch (condition.first) {
+                case knowhere::OperatorType::LT:
+                    match = values[i] < condition.second;
+                    break;
+                case knowhere::OperatorType::LE:
+                    match = values[i] <= condition.second;
+                    break;
+                case knowhere::OperatorType::GT:
+                    match = values[i] > condition.second;
+                    break;
+                case knowhere::OperatorType::GE:
+                    match = values[i] >= condition.second;
+                    break;
+                default:
+                    match = false;
+                    break;
+            }
+            if (!match) {
+                break;
+            }
+        }
+        if (match) {
+            bitset.set(i);
+        }
+    }
+}
+
+// merge two sorted topk lists of each query, the src ids are chunk offsets and mapped to uids
+void
+MergeChunkResult(const idx_t* uids, const ResultIds& src_ids, const ResultDistances& src_distances, int64_t nq,
+                 int64_t topk, bool ascending, ResultIds& tar_ids, ResultDistances& tar_distances) {
+    ResultIds buf_ids(topk);
+    ResultDistances buf_distances(topk);
+    for (int64_t i = 0; i < nq; ++i) {
+        int64_t base = i * topk;
+        int64_t src_j = 0, tar_j = 0;
+        for (int64_t buf_j = 0; buf_j < topk; ++buf_j) {
+            bool src_valid = src_j < topk && src_ids[base + src_j] != -1;
+            bool tar_valid = tar_j < topk && tar_ids[base + tar_j] != -1;
+            if (!src_valid && !tar_valid) {
+                buf_ids[buf_j] = -1;
+                buf_distances[buf_j] = 0.0;
+                continue;
+            }
+
+            bool pick_src = !tar_valid;
+            if (src_valid && tar_valid) {
+                pick_src = ascending ? (src_distances[base + src_j] < tar_distances[base + tar_j])
+                                     : (src_distances[base + src_j] > tar_distances[base + tar_j]);
+            }
+
+            if (pick_src) {
+                buf_ids[buf_j] = uids[src_ids[base + src_j]];
+                buf_distances[buf_j] = src_distances[base + src_j];
+                src_j++;
+            } else {
+                buf_ids[buf_j] = tar_ids[base + tar_j];
+                buf_distances[buf_j] = tar_distances[base + tar_j];
+                tar_j++;
+            }
+        }
+
+        std::copy(buf_ids.begin(), buf_ids.end(), tar_ids.begin() + base);
+        std::copy(buf_distances.begin(), buf_distances.end(), tar_distances.begin() + base);
+    }
+}
+
+}  // namespace
+
+MemExecutionEngine::MemExecutionEngine(const snapshot::ScopedSnapshotT& snapshot, const MemChunkViews& chunks)
+    : snapshot_(snapshot), chunks_(chunks) {
+}
+
+Status
+MemExecutionEngine::Load(ExecutionEngineContext& context) {
+    // the chunks are already in memory
+    return Status::OK();
+}
+
+Status
+MemExecutionEngine::CopyToGpu(uint64_t device_id) {
+    // brute force search of buffered chunks is always executed by cpu
+    return Status::OK();
+}
+
+Status
+MemExecutionEngine::BuildIndex(uint64_t device_id) {
+    return Status(DB_ERROR, "Not support to build index for buffered entities");
+}
+
+int64_t
+MemExecutionEngine::RowCount() const {
+    int64_t row_count = 0;
+    for (auto& view : chunks_) {
+        row_count += view.chunk_->count_;
+    }
+    return row_count;
+}
+
+Status
+MemExecutionEngine::Search(ExecutionEngineContext& context) {
+    TimeRecorder rc(LogOut("[%s][%ld] MemExecutionEngine::Search", "search", 0));
+    try {
+        auto& query_ptr = context.query_ptr_;
+        if (query_ptr == nullptr || query_ptr->root == nullptr) {
+            return Status(DB_ERROR, "BinaryQuery is null");
+        }
+
+        std::vector<ConCurrentBitsetPtr> filter_lists;
+        std::string vector_placeholder;
+        for (auto& view : chunks_) {
+            ConCurrentBitsetPtr bitset;
+            STATUS_CHECK(ExecBinaryQuery(query_ptr->root, view.chunk_, bitset, vector_placeholder));
+
+            // merge scalar filter and deletion bitset
+            ConCurrentBitsetPtr filter_list;
+            if (bitset != nullptr) {
+                bitset->negate();
+                filter_list = (view.blacklist_ != nullptr) ? (*bitset) | (*view.blacklist_) : bitset;
+            } else {
+                filter_list = view.blacklist_;
+            }
+            filter_lists.emplace_back(filter_list);
+        }
+        rc.RecordSection("Scalar field filtering");
+
+        auto vector_iter = query_ptr->vectors.find(vector_placeholder);
+        if (vector_iter == query_ptr->vectors.end()) {
+            return Status(SERVER_INVALID_DSL_PARAMETER, "Vector query is not found");
+        }
+        auto& vector_param = vector_iter->second;
+
+        auto field = snapshot_->GetField(vector_param->field_name);
+        if (field == nullptr) {
+            return Status(SERVER_INVALID_DSL_PARAMETER, "Field: " + vector_param->field_name + " is not existed");
+        }
+        auto field_type = static_cast<DataType>(field->GetFtype());
+        auto& params = field->GetParams();
+        if (!IsVectorField(field) || !params.contains(PARAM_DIMENSION)) {
+            return Status(SERVER_INVALID_DSL_PARAMETER, "Field: " + vector_param->field_name + " is not vector");
+        }
+        int64_t dimension = params[PARAM_DIMENSION];
+        // the vector query is shared by the segment searches running in parallel, it is read only here
+        int64_t nq = 0;
+        if (!utils::IsBinaryVectorType(field_type)) {
+            nq = vector_param->query_vector.float_data.size() / dimension;
+        } else {
+            nq = vector_param->query_vector.binary_data.size() * 8 / dimension;
+        }
+
+        std::string metric_type;
+        STATUS_CHECK(GetSearchMetricType(snapshot_, query_ptr, vector_param, metric_type));
+        bool ascending = (metric_type != knowhere::Metric::IP);
+
+        int64_t topk = vector_param->topk;
+        context.query_result_ = std::make_shared<QueryResult>();
+        context.query_result_->result_ids_.resize(nq * topk, -1);
+        context.query_result_->result_distances_.resize(nq * topk, 0.0);
+
+        ResultIds chunk_ids;
+        ResultDistances chunk_distances;
+        for (size_t i = 0; i < chunks_.size(); ++i) {
+            auto& view = chunks_[i];
+            auto uid_iter = view.chunk_->fixed_fields_.find(FIELD_UID);
+            if (uid_iter == view.chunk_->fixed_fields_.end() || uid_iter->second == nullptr) {
+                return Status(DB_ERROR, "Buffered entities have no id");
+            }
+
+            STATUS_CHECK(ChunkSearch(vector_param, field_type, dimension, nq, metric_type, view, filter_lists[i],
+                                     chunk_ids, chunk_distances));
+            auto uids = reinterpret_cast<const idx_t*>(uid_iter->second->data_.data());
+            MergeChunkResult(uids, chunk_ids, chunk_distances, nq, topk, ascending, context.query_result_->result_ids_,
+                             context.query_result_->result_distances_);
+        }
+        rc.RecordSection("search " + std::to_string(chunks_.size()) + " chunks");
+    } catch (std::exception& ex) {
+        LOG_ENGINE_ERROR_ << "Failed to search buffered entities: " << ex.what();
+        return Status(DB_ERROR, "Illegal search params");
+    }
+
+    rc.ElapseFromBegin("done");
+    return Status::OK();
+}
+
+Status
+MemExecutionEngine::ChunkSearch(const query::VectorQueryPtr& vector_param, DataType field_type, int64_t dimension,
+                                int64_t query_count, const std::string& metric_type, const MemChunkView& view,
+                                const ConCurrentBitsetPtr& blacklist, ResultIds& ids, ResultDistances& distances) {
+    auto data_iter = view.chunk_->fixed_fields_.find(vector_param->field_name);
+    if (data_iter == view.chunk_->fixed_fields_.end() || data_iter->second == nullptr) {
+        return Status(DB_ERROR, "Buffered entities have no field: " + vector_param->field_name);
+    }
+
+    size_t nq = query_count;
+    size_t topk = vector_param->topk;
+    size_t count = view.chunk_->count_;
+    ids.resize(nq * topk);
+    distances.resize(nq * topk);
+
+    if (!utils::IsBinaryVectorType(field_type)) {
+        // buffered half float vectors are decoded for the search, the chunk is bounded by the insert buffer
+        BinaryDataPtr float_data = data_iter->second;
+        if (utils::IsHalfFloatVectorType(field_type)) {
+            STATUS_CHECK(utils::DecodeHalfFloatVectors(field_type, float_data, float_data));
+        }
+        auto query = vector_param->query_vector.float_data.data();
+        auto data = reinterpret_cast<const float*>(float_data->data_.data());
+        if (metric_type == knowhere::Metric::IP) {
+            faiss::float_minheap_array_t res = {nq, topk, ids.data(), distances.data()};
+            faiss::knn_inner_product(query, data, dimension, nq, count, &res, blacklist);
+        } else if (metric_type == knowhere::Metric::L2) {
+            faiss::float_maxheap_array_t res = {nq, topk, ids.data(), distances.data()};
+            faiss::knn_L2sqr(query, data, dimension, nq, count, &res, blacklist);
+        } else {
+            return Status(SERVER_INVALID_ARGUMENT, "Unsupported metric type: " + metric_type);
+        }
+        return Status::OK();
+    }
+
+    // binary vectors, keep the same behavior as faiss::IndexBinaryFlat
+    auto query = vector_param->query_vector.binary_data.data();
+    auto data = data_iter->second->data_.data();
+    size_t code_size = dimension / 8;
+    auto metric = knowhere::GetMetricType(metric_type);
+    if (metric == faiss::METRIC_Jaccard || metric == faiss::METRIC_Tanimoto) {
+        faiss::float_maxheap_array_t res = {nq, topk, ids.data(), distances.data()};
+        faiss::binary_distence_knn_hc(metric, &res, query, data, count, code_size, 1, blacklist);
+        if (metric == faiss::METRIC_Tanimoto) {
+            for (auto& dis : distances) {
+                dis = -log2(1 - dis);
+            }
+        }
+    } else if (metric == faiss::METRIC_Substructure || metric == faiss::METRIC_Superstructure) {
+        faiss::binary_distence_knn_mc(metric, query, data, nq, count, topk, code_size, distances.data(), ids.data(),
+                                      blacklist);
+    } else {
+        std::vector<int32_t> int_distances(nq * topk);
+        faiss::int_maxheap_array_t res = {nq, topk, ids.data(), int_distances.data()};
+        faiss::hammings_knn_hc(&res, query, data, count, code_size, 1, blacklist);
+        for (size_t i = 0; i < int_distances.size(); ++i) {
+            distances[i] = static_cast<float>(int_distances[i]);
+        }
+    }
+
+    return Status::OK();
+}
+
+Status
+MemExecutionEngine::GetFieldData(const std::string& field_name, const DataChunkPtr& chunk, DataType& data_type,
+                                 BinaryDataPtr& data) {
+    auto field = snapshot_->GetField(field_name);
+    if (field == nullptr) {
+        return Status(SERVER_INVALID_DSL_PARAMETER, "Field: " + field_name + " is not existed");
+    }
+    data_type = static_cast<DataType>(field->GetFtype());
+
+    auto iter = chunk->fixed_fields_.find(field_name);
+    if (iter == chunk->fixed_fields_.end() || iter->second == nullptr) {
+        return Status(DB_ERROR, "Buffered entities have no field: " + field_name);
+    }
+    data = iter->second;
+
+    return Status::OK();
+}
+
+Status
+MemExecutionEngine::ExecBinaryQuery(const query::GeneralQueryPtr& general_query, const DataChunkPtr& chunk,
+                                    ConCurrentBitsetPtr& bitset, std::string& vector_placeholder) {
+    if (general_query->leaf == nullptr) {
+        ConCurrentBitsetPtr left_bitset, right_bitset;
+        if (general_query->bin->left_query != nullptr) {
+            STATUS_CHECK(ExecBinaryQuery(general_query->bin->left_query, chunk, left_bitset, vector_placeholder));
+        }
+        if (general_query->bin->right_query != nullptr) {
+            STATUS_CHECK(ExecBinaryQuery(general_query->bin->right_query, chunk, right_bitset, vector_placeholder));
+        }
+
+        if (left_bitset == nullptr) {
+            bitset = right_bitset;
+        } else if (right_bitset == nullptr) {
+            bitset = left_bitset;
+        } else {
+            switch (general_query->bin->relation) {
+                case query::QueryRelation::AND:
+                case query::QueryRelation::R1: {
+                    bitset = (*left_bitset) & (*right_bitset);
+                    break;
+                }
+                case query::QueryRelation::OR:
+                case query::QueryRelation::R2:
+                case query::QueryRelation::R3: {
+                    bitset = (*left_bitset) | (*right_bitset);
+                    break;
+                }
+                case query::QueryRelation::R4: {
+                    bitset = (*left_bitset) & (right_bitset->negate());
+                    break;
+                }
+                default: { return Status{SERVER_INVALID_ARGUMENT, "Invalid QueryRelation in BinaryQuery"}; }
+            }
+        }
+        if (general_query->bin->is_not && bitset != nullptr) {
+            bitset->negate();
+        }
+    } else {
+        if (general_query->leaf->term_query != nullptr) {
+            bitset = std::make_shared<ConCurrentBitset>(chunk->count_);
+            STATUS_CHECK(ProcessTermQuery(general_query->leaf->term_query, chunk, bitset));
+        }
+        if (general_query->leaf->range_query != nullptr) {
+            bitset = std::make_shared<ConCurrentBitset>(chunk->count_);
+            STATUS_CHECK(ProcessRangeQuery(general_query->leaf->range_query, chunk, bitset));
+        }
+        if (!general_query->leaf->vector_placeholder.empty()) {
+            vector_placeholder = general_query->leaf->vector_placeholder;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status
+MemExecutionEngine::ProcessTermQuery(const query::TermQueryPtr& term_query, const DataChunkPtr& chunk,
+                                     ConCurrentBitsetPtr& bitset) {
+    try {
+        auto term_query_json = term_query->json_obj;
+        JSON_NULL_CHECK(term_query_json);
+        auto term_it = term_query_json.begin();
+        if (term_it == term_query_json.end()) {
+            return Status::OK();
+        }
+
+        const std::string& field_name = term_it.key();
+        milvus::json term_values_json = term_it.value().is_object() ? term_it.value()["values"] : term_it.value();
+
+        DataType data_type;
+        BinaryDataPtr data;
+        STATUS_CHECK(GetFieldData(field_name, chunk, data_type, data));
+        switch (data_type) {
+            case DataType::INT8:
+                TermScan<int8_t>(data, chunk->count_, term_values_json, *bitset);
+                break;
+            case DataType::INT16:
+                TermScan<int16_t>(data, chunk->count_, term_values_json, *bitset);
+                break;
+            case DataType::INT32:
+                TermScan<int32_t>(data, chunk->count_, term_values_json, *bitset);
+                break;
+            case DataType::INT64:
+                TermScan<int64_t>(data, chunk->count_, term_values_json, *bitset);
+                break;
+            case DataType::FLOAT:
+                TermScan<float>(data, chunk->count_, term_values_json, *bitset);
+                break;
+            case DataType::DOUBLE:
+                TermScan<double>(data, chunk->count_, term_values_json, *bitset);
+                break;
+            default:
+                return Status(SERVER_INVALID_ARGUMENT, "Attribute:" + field_name + " type is wrong");
+        }
+
+        term_it++;
+        if (term_it != term_query_json.end()) {
+            return Status(SERVER_INVALID_DSL_PARAMETER, "Term query does not support multiple fields");
+        }
+    } catch (std::exception& ex) {
+        return Status{SERVER_INVALID_DSL_PARAMETER, ex.what()};
+    }
+
+    return Status::OK();
+}
+
+Status
+MemExecutionEngine::ProcessRangeQuery(const query::RangeQueryPtr& range_query, const DataChunkPtr& chunk,
+                                      ConCurrentBitsetPtr& bitset) {
+    try {
+        auto range_query_json = range_query->json_obj;
+        JSON_NULL_CHECK(range_query_json);
+        auto range_it = range_query_json.begin();
+        if (range_it == range_query_json.end()) {
+            return Status::OK();
+        }
+
+        const std::string& field_name = range_it.key();
+        DataType data_type;
+        BinaryDataPtr data;
+        STATUS_CHECK(GetFieldData(field_name, chunk, data_type, data));
+        switch (data_type) {
+            case DataType::INT8:
+                RangeScan<int8_t>(data, chunk->count_, range_it.value(), *bitset);
+                break;
+            case DataType::INT16:
+                RangeScan<int16_t>(data, chunk->count_, range_it.value(), *bitset);
+                break;
+            case DataType::INT32:
+                RangeScan<int32_t>(data, chunk->count_, range_it.value(), *bitset);
+                break;
+            case DataType::INT64:
+                RangeScan<int64_t>(data, chunk->count_, range_it.value(), *bitset);
+                break;
+            case DataType::FLOAT:
+                RangeScan<float>(data, chunk->count_, range_it.value(), *bitset);
+                break;
+            case DataType::DOUBLE:
+                RangeScan<double>(data, chunk->count_, range_it.value(), *bitset);
+                break;
+            default:
+                break;
+        }
+
+        range_it++;
+        if (range_it != range_query_json.end()) {
+            return Status(SERVER_INVALID_DSL_PARAMETER, "Range query does not support multiple fields");
+        }
+    } catch (std::exception& ex) {
+        return Status{SERVER_INVALID_DSL_PARAMETER, ex.what()};
+    }
+
+    return Status::OK();
+}
+
+}  // namespace engine
+}  // namespace milvus
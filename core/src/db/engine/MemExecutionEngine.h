@@ -0,0 +1,70 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ExecutionEngine.h"
+#include "db/snapshot/Snapshots.h"
+
+namespace milvus {
+namespace engine {
+
+// search entities buffered in MemManager, the chunks are scanned by brute force
+class MemExecutionEngine : public ExecutionEngine {
+ public:
+    MemExecutionEngine(const snapshot::ScopedSnapshotT& snapshot, const MemChunkViews& chunks);
+
+    Status
+    Load(ExecutionEngineContext& context) override;
+
+    Status
+    CopyToGpu(uint64_t device_id) override;
+
+    Status
+    Search(ExecutionEngineContext& context) override;
+
+    Status
+    BuildIndex(uint64_t device_id) override;
+
+    int64_t
+    RowCount() const;
+
+ private:
+    Status
+    ExecBinaryQuery(const query::GeneralQueryPtr& general_query, const DataChunkPtr& chunk,
+                    ConCurrentBitsetPtr& bitset, std::string& vector_placeholder);
+
+    Status
+    ProcessTermQuery(const query::TermQueryPtr& term_query, const DataChunkPtr& chunk, ConCurrentBitsetPtr& bitset);
+
+    Status
+    ProcessRangeQuery(const query::RangeQueryPtr& range_query, const DataChunkPtr& chunk,
+                      ConCurrentBitsetPtr& bitset);
+
+    Status
+    GetFieldData(const std::string& field_name, const DataChunkPtr& chunk, DataType& data_type, BinaryDataPtr& data);
+
+    Status
+    ChunkSearch(const query::VectorQueryPtr& vector_param, DataType field_type, int64_t dimension, int64_t query_count,
+                const std::string& metric_type, const MemChunkView& view, const ConCurrentBitsetPtr& blacklist,
+                ResultIds& ids, ResultDistances& distances);
+
+ private:
+    snapshot::ScopedSnapshotT snapshot_;
+    MemChunkViews chunks_;
+};
+
+}  // namespace engine
+}  // namespace milvus
@@ -0,0 +1,147 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "db/engine/SearchStrategy.h"
+
+#include <faiss/IndexBinaryIVF.h>
+#include <faiss/IndexIVF.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "db/Utils.h"
+#include "knowhere/index/IndexType.h"
+#include "knowhere/index/vector_index/FaissBaseBinaryIndex.h"
+#include "knowhere/index/vector_index/FaissBaseIndex.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
+#include "knowhere/index/vector_offset_index/OffsetBaseIndex.h"
+
+namespace milvus {
+namespace engine {
+
+namespace {
+
+bool
+IsIVFIndexType(const std::string& index_type) {
+    return index_type == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFPQ ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFSQ8 ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_IVFSQ8H ||
+           index_type == knowhere::IndexEnum::INDEX_FAISS_BIN_IVFFLAT;
+}
+
+int64_t
+GetNlist(const knowhere::VecIndexPtr& index) {
+    const faiss::Index* faiss_index = nullptr;
+    if (auto base_index = std::dynamic_pointer_cast<knowhere::FaissBaseIndex>(index)) {
+        faiss_index = base_index->index_.get();
+    } else if (auto offset_index = std::dynamic_pointer_cast<knowhere::OffsetBaseIndex>(index)) {
+        faiss_index = offset_index->index_.get();
+    } else if (auto binary_index = std::dynamic_pointer_cast<knowhere::FaissBaseBinaryIndex>(index)) {
+        auto ivf = dynamic_cast<const faiss::IndexBinaryIVF*>(binary_index->index_.get());
+        return ivf != nullptr ? ivf->nlist : 0;
+    }
+
+    auto ivf = dynamic_cast<const faiss::IndexIVF*>(faiss_index);
+    return ivf != nullptr ? ivf->nlist : 0;
+}
+
+int64_t
+GetIntParam(const milvus::json& params, const char* name, int64_t default_value) {
+    if (params.contains(name) && params[name].is_number_integer()) {
+        return params[name].get<int64_t>();
+    }
+    return default_value;
+}
+
+}  // namespace
+
+int64_t
+EstimateScanCount(const knowhere::VecIndexPtr& index, const milvus::json& search_params, int64_t topk) {
+    auto index_type = index->index_type();
+    int64_t row_count = index->Count();
+    if (utils::IsFlatIndexType(index_type)) {
+        return row_count;
+    }
+
+    if (IsIVFIndexType(index_type)) {
+        int64_t nlist = GetNlist(index);
+        if (nlist <= 0) {
+            return row_count;
+        }
+        int64_t nprobe = std::min(std::max<int64_t>(GetIntParam(search_params, knowhere::IndexParams::nprobe, 1), 1),
+                                  nlist);
+        return nlist + row_count * nprobe / nlist;
+    }
+
+    // graph and tree indexes visit a number of rows proportional to the search list
+    if (index_type == knowhere::IndexEnum::INDEX_ANNOY) {
+        int64_t search_k = GetIntParam(search_params, knowhere::IndexParams::search_k, -1);
+        if (search_k > 0) {
+            return std::min(row_count, search_k);
+        }
+    }
+    int64_t search_list = topk;
+    search_list = std::max(search_list, GetIntParam(search_params, knowhere::IndexParams::ef, 0));
+    search_list = std::max(search_list, GetIntParam(search_params, knowhere::IndexParams::search_length, 0));
+    return std::min(row_count, search_list * GRAPH_VISIT_FACTOR);
+}
+
+SearchStrategy
+ChooseSearchStrategy(const std::string& index_type, int64_t row_count, int64_t pass_count, int64_t topk,
+                     int64_t scan_count, bool raw_cached) {
+    if (row_count <= 0 || pass_count >= row_count) {
+        return SearchStrategy::ANN_BITSET;
+    }
+
+    // flat index skips the filtered rows by bitset, gathering the rows into a temporary index only adds a copy
+    if (utils::IsFlatIndexType(index_type)) {
+        return SearchStrategy::ANN_BITSET;
+    }
+
+    // too few rows left, brute force gives exact result at little cost
+    if (pass_count <= topk) {
+        return SearchStrategy::BRUTE_FORCE;
+    }
+
+    // graph search has to walk further to collect enough rows passing the filter,
+    // the cost of ivf search doesn't depend on the filter
+    bool graph = !IsIVFIndexType(index_type);
+    double bitset_cost = scan_count;
+    if (graph) {
+        bitset_cost = std::min<double>(row_count, bitset_cost * row_count / pass_count);
+    }
+
+    int64_t row_cost = raw_cached ? BRUTE_FORCE_ROW_COST : BRUTE_FORCE_ROW_COST + RAW_READ_ROW_COST;
+    if (static_cast<double>(pass_count) * row_cost <= bitset_cost) {
+        return SearchStrategy::BRUTE_FORCE;
+    }
+
+    if (graph && pass_count >= row_count * POST_FILTER_MIN_PASS_RATE) {
+        return SearchStrategy::ANN_POST_FILTER;
+    }
+
+    return SearchStrategy::ANN_BITSET;
+}
+
+int64_t
+PostFilterTopk(int64_t row_count, int64_t pass_count, int64_t topk) {
+    if (pass_count <= 0) {
+        return topk;
+    }
+    auto fetch = static_cast<int64_t>(std::ceil(topk * POST_FILTER_OVER_FETCH * row_count / pass_count));
+    return std::max(std::min(fetch, row_count), topk);
+}
+
+}  // namespace engine
+}  // namespace milvus
@@ -0,0 +1,54 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "knowhere/index/vector_index/VecIndex.h"
+#include "utils/Json.h"
+
+namespace milvus {
+namespace engine {
+
+enum class SearchStrategy {
+    BRUTE_FORCE,      // compute distances of the rows passing the filter only
+    ANN_BITSET,       // search the index, filtered rows are skipped by bitset
+    ANN_POST_FILTER,  // search the index without bitset for more results, then drop the filtered rows
+};
+
+// a gathered row costs about twice of a row scanned by the index
+constexpr int64_t BRUTE_FORCE_ROW_COST = 2;
+// a gathered row which is not cached is read from storage by offset, that costs much more than scanning it
+constexpr int64_t RAW_READ_ROW_COST = 32;
+// rows visited by graph index search for each candidate of the search list
+constexpr int64_t GRAPH_VISIT_FACTOR = 32;
+// post filter is used only when most rows pass the filter, so that the over-fetch is small
+constexpr double POST_FILTER_MIN_PASS_RATE = 0.8;
+constexpr double POST_FILTER_OVER_FETCH = 1.2;
+
+// estimate how many rows the index visits for one query vector without filter
+int64_t
+EstimateScanCount(const knowhere::VecIndexPtr& index, const milvus::json& search_params, int64_t topk);
+
+// choose search strategy by the rows passing the filter and the cost of index search,
+// raw_cached tells whether the raw vectors to gather are already in memory
+SearchStrategy
+ChooseSearchStrategy(const std::string& index_type, int64_t row_count, int64_t pass_count, int64_t topk,
+                     int64_t scan_count, bool raw_cached);
+
+// how many results to fetch from index for post filtering
+int64_t
+PostFilterTopk(int64_t row_count, int64_t pass_count, int64_t topk);
+
+}  // namespace engine
+}  // namespace milvus
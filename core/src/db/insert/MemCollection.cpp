@@ -87,16 +87,16 @@ MemCollection::Delete(const std::vector<idx_t>& ids, idx_t op_id) {
         return Status::OK();
     }
 
-    // Add the id so it can be applied to segment files during the next flush
+    // record max delete operation id here, for the case that no insert but only delete action performed
+    max_delete_op_id_ = (op_id > max_delete_op_id_) ? op_id : max_delete_op_id_;
+
+    // Add the id so it can be applied to segment files during the next flush, the ids are read by search views
+    std::lock_guard<std::mutex> lock(mem_mutex_);
     for (auto& id : ids) {
         ids_to_delete_.insert(id);
     }
 
-    // record max delete operation id here, for the case that no insert but only delete action performed
-    max_delete_op_id_ = (op_id > max_delete_op_id_) ? op_id : max_delete_op_id_;
-
     // Add the id to mem segments so it can be applied during the next flush
-    std::lock_guard<std::mutex> lock(mem_mutex_);
     for (auto& partition_segments : mem_segments_) {
         for (auto& segment : partition_segments.second) {
             segment->Delete(ids, op_id);
@@ -130,6 +130,8 @@ MemCollection::Serialize() {
     while (true) {
         auto status = ApplyDeleteToFile();
         if (status.ok()) {
+            // a search view taken before this point applies the ids again, that is harmless
+            std::lock_guard<std::mutex> lock(mem_mutex_);
             ids_to_delete_.clear();
             break;
         } else if (status.code() == SS_STALE_ERROR) {
@@ -189,10 +191,10 @@ MemCollection::ApplyDeleteToFile() {
         }
 
         // Step 2: Calculate deleted id offset
-        // load entity ids
-        engine::idx_t* uids_address = nullptr;
-        int64_t id_count = 0;
-        STATUS_CHECK(segment_reader->LoadUids(&uids_address, id_count));
+        // load id index to locate entity offsets
+        segment::IdIndexPtr id_index;
+        STATUS_CHECK(segment_reader->LoadIdIndex(id_index));
+        int64_t id_count = id_index->GetCount();
 
         // Load previous deleted offsets
         segment::DeletedDocsPtr prev_del_docs;
@@ -207,13 +209,15 @@ MemCollection::ApplyDeleteToFile() {
 
         // if the to-delete id is actually in this segment, record its offset
         std::vector<engine::idx_t> new_deleted_ids;
-        for (auto i = 0; i < id_count; ++i) {
-            auto id = uids_address[i];
-            if (ids_to_check.find(id) != ids_to_check.end()) {
-                if (del_offsets.find(i) != del_offsets.end()) {
+        std::vector<engine::offset_t> id_offsets;
+        for (auto id : ids_to_check) {
+            id_offsets.clear();
+            id_index->FindAll(id, id_offsets);
+            for (auto offset : id_offsets) {
+                if (del_offsets.find(offset) != del_offsets.end()) {
                     continue;  // this id already deleted previously
                 }
-                del_offsets.insert(i);
+                del_offsets.insert(offset);
                 new_deleted_ids.push_back(id);
             }
         }
@@ -391,6 +395,21 @@ MemCollection::SerializeSegments() {
     return Status::OK();
 }
 
+Status
+MemCollection::GetSearchView(MemChunkViews& views, PendingDeleteIds& delete_ids) {
+    // SerializeSegments() holds the lock until new segments committed and mem segments cleared,
+    // so the views never miss entities that are not yet visible in snapshot
+    std::lock_guard<std::mutex> lock(mem_mutex_);
+    delete_ids.insert(ids_to_delete_.begin(), ids_to_delete_.end());
+    for (auto& partition_segments : mem_segments_) {
+        for (auto& segment : partition_segments.second) {
+            STATUS_CHECK(segment->GetSearchView(views));
+        }
+    }
+
+    return Status::OK();
+}
+
 int64_t
 MemCollection::GetCollectionId() const {
     return collection_id_;
@@ -63,6 +63,9 @@ class MemCollection {
     Status
     SerializeSegments();
 
+    Status
+    GetSearchView(MemChunkViews& views, PendingDeleteIds& delete_ids);
+
  private:
     Status
     ApplyDeleteToFile();
@@ -46,6 +46,11 @@ class MemManager {
 
     virtual bool
     RequireFlush(std::set<int64_t>& collection_ids) = 0;
+
+    // collect views of unflushed entities of a collection, including the ones being flushed,
+    // and the ids deleted since the last flush
+    virtual Status
+    GetSearchView(int64_t collection_id, MemChunkViews& views, PendingDeleteIds& delete_ids) = 0;
 };
 
 using MemManagerPtr = std::shared_ptr<MemManager>;
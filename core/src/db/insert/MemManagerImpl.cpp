@@ -12,9 +12,11 @@
 #include "db/insert/MemManagerImpl.h"
 
 #include <fiu/fiu-local.h>
+#include <algorithm>
 #include <thread>
 
 #include "db/Constants.h"
+#include "db/Utils.h"
 #include "db/snapshot/Snapshots.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #include "utils/Log.h"
@@ -114,6 +116,8 @@ MemManagerImpl::ValidateChunk(int64_t collection_id, const DataChunkPtr& chunk)
                 }
                 break;
             case DataType::VECTOR_FLOAT:
+            case DataType::VECTOR_FLOAT16:
+            case DataType::VECTOR_BFLOAT16:
             case DataType::VECTOR_BINARY: {
                 json params = field->GetParams();
                 if (params.find(knowhere::meta::DIM) == params.end()) {
@@ -123,7 +127,7 @@ MemManagerImpl::ValidateChunk(int64_t collection_id, const DataChunkPtr& chunk)
                 }
 
                 int64_t dimension = params[knowhere::meta::DIM];
-                int64_t row_size = (ftype == DataType::VECTOR_BINARY) ? dimension / 8 : dimension * sizeof(float);
+                int64_t row_size = utils::GetVectorRowSize(ftype, dimension);
                 if (data_size != chunk->count_ * row_size) {
                     return Status(DB_ERROR, err_msg + name);
                 }
@@ -175,35 +179,49 @@ MemManagerImpl::InternalFlush(std::set<int64_t>& collection_ids) {
         if (temp_immutable_list.empty()) {
             return Status::OK();
         }
+        // keep them searchable until serialized
+        flushing_mem_list_.insert(flushing_mem_list_.end(), temp_immutable_list.begin(), temp_immutable_list.end());
     }
 
-    std::lock_guard<std::mutex> lock(flush_mtx_);
-    for (auto& mem : temp_immutable_list) {
-        int64_t collection_id = mem->GetCollectionId();
-        LOG_ENGINE_DEBUG_ << "Flushing collection: " << collection_id;
-        auto status = mem->Serialize();
-        if (!status.ok()) {
-            LOG_ENGINE_ERROR_ << "Flush collection " << collection_id << " failed";
-            return status;
+    Status status;
+    {
+        std::lock_guard<std::mutex> lock(flush_mtx_);
+        for (auto& mem : temp_immutable_list) {
+            int64_t collection_id = mem->GetCollectionId();
+            LOG_ENGINE_DEBUG_ << "Flushing collection: " << collection_id;
+            status = mem->Serialize();
+            if (!status.ok()) {
+                LOG_ENGINE_ERROR_ << "Flush collection " << collection_id << " failed";
+                break;
+            }
+            LOG_ENGINE_DEBUG_ << "Flushed collection: " << collection_id;
+            collection_ids.insert(collection_id);
         }
-        LOG_ENGINE_DEBUG_ << "Flushed collection: " << collection_id;
-        collection_ids.insert(collection_id);
     }
 
-    return Status::OK();
+    {
+        std::lock_guard<std::mutex> lock(immu_mem_mtx_);
+        for (auto& mem : temp_immutable_list) {
+            auto iter = std::find(flushing_mem_list_.begin(), flushing_mem_list_.end(), mem);
+            if (iter != flushing_mem_list_.end()) {
+                flushing_mem_list_.erase(iter);
+            }
+        }
+    }
+
+    return status;
 }
 
 Status
 MemManagerImpl::ToImmutable(int64_t collection_id) {
     MemList temp_immutable_list;
 
-    {
-        std::lock_guard<std::mutex> lock(mem_mutex_);
-        auto mem_collection = mem_map_.find(collection_id);
-        if (mem_collection != mem_map_.end()) {
-            temp_immutable_list.push_back(mem_collection->second);
-            mem_map_.erase(mem_collection);
-        }
+    // move to immutable list before releasing mem_mutex_, so that GetSearchView() always finds it
+    std::lock_guard<std::mutex> lock(mem_mutex_);
+    auto mem_collection = mem_map_.find(collection_id);
+    if (mem_collection != mem_map_.end()) {
+        temp_immutable_list.push_back(mem_collection->second);
+        mem_map_.erase(mem_collection);
     }
 
     return ToImmutable(temp_immutable_list);
@@ -213,13 +231,11 @@ Status
 MemManagerImpl::ToImmutable() {
     MemList temp_immutable_list;
 
-    {
-        std::lock_guard<std::mutex> lock(mem_mutex_);
-        for (auto& pair : mem_map_) {
-            temp_immutable_list.push_back(pair.second);
-        }
-        mem_map_.clear();
+    std::lock_guard<std::mutex> lock(mem_mutex_);
+    for (auto& pair : mem_map_) {
+        temp_immutable_list.push_back(pair.second);
     }
+    mem_map_.clear();
 
     return ToImmutable(temp_immutable_list);
 }
@@ -295,6 +311,38 @@ MemManagerImpl::RequireFlush(std::set<int64_t>& collection_ids) {
     return require_flush;
 }
 
+Status
+MemManagerImpl::GetSearchView(int64_t collection_id, MemChunkViews& views, PendingDeleteIds& delete_ids) {
+    MemList mem_list;
+    {
+        // lock order is the same as ToImmutable(): mem_mutex_ first, then immu_mem_mtx_
+        std::lock_guard<std::mutex> lock(mem_mutex_);
+        auto mem_collection = mem_map_.find(collection_id);
+        if (mem_collection != mem_map_.end()) {
+            mem_list.push_back(mem_collection->second);
+        }
+
+        std::lock_guard<std::mutex> immu_lock(immu_mem_mtx_);
+        for (auto& mem : immu_mem_list_) {
+            if (mem->GetCollectionId() == collection_id) {
+                mem_list.push_back(mem);
+            }
+        }
+        for (auto& mem : flushing_mem_list_) {
+            if (mem->GetCollectionId() == collection_id) {
+                mem_list.push_back(mem);
+            }
+        }
+    }
+
+    // a collection being serialized blocks here until its segments committed, don't hold the locks above
+    for (auto& mem : mem_list) {
+        STATUS_CHECK(mem->GetSearchView(views, delete_ids));
+    }
+
+    return Status::OK();
+}
+
 size_t
 MemManagerImpl::GetCurrentMutableMem() {
     size_t total_mem = 0;
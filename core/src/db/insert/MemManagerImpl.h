@@ -59,6 +59,9 @@ class MemManagerImpl : public MemManager {
     bool
     RequireFlush(std::set<int64_t>& collection_ids) override;
 
+    Status
+    GetSearchView(int64_t collection_id, MemChunkViews& views, PendingDeleteIds& delete_ids) override;
+
  private:
     size_t
     GetCurrentMutableMem();
@@ -90,6 +93,7 @@ class MemManagerImpl : public MemManager {
  private:
     MemCollectionMap mem_map_;
     MemList immu_mem_list_;
+    MemList flushing_mem_list_;  // protected by immu_mem_mtx_, searchable until flush finished
 
     DBOptions options_;
     std::mutex mem_mutex_;
@@ -140,6 +140,50 @@ MemSegment::Serialize(snapshot::ScopedSnapshotT& ss, std::shared_ptr<snapshot::M
     return Status::OK();
 }
 
+Status
+MemSegment::GetSearchView(MemChunkViews& views) const {
+    for (auto iter = actions_.begin(); iter != actions_.end(); ++iter) {
+        const DataChunkPtr& chunk = iter->insert_data_;
+        if (chunk == nullptr || chunk->count_ == 0) {
+            continue;
+        }
+
+        // copy the field map, the chunk could be modified by Serialize() after the lock released
+        MemChunkView view;
+        view.partition_id_ = partition_id_;
+        view.chunk_ = std::make_shared<DataChunk>();
+        view.chunk_->count_ = chunk->count_;
+        view.chunk_->fixed_fields_ = chunk->fixed_fields_;
+        view.chunk_->variable_fields_ = chunk->variable_fields_;
+
+        // entities deleted by subsequent delete actions are put into blacklist
+        auto uid_iter = chunk->fixed_fields_.find(FIELD_UID);
+        if (uid_iter != chunk->fixed_fields_.end() && uid_iter->second != nullptr &&
+            uid_iter->second->data_.size() / sizeof(idx_t) == chunk->count_) {
+            auto uid = reinterpret_cast<const idx_t*>(uid_iter->second->data_.data());
+            for (auto later = iter + 1; later != actions_.end(); ++later) {
+                const std::unordered_set<idx_t>& delete_ids = later->delete_ids_;
+                if (delete_ids.empty()) {
+                    continue;
+                }
+
+                for (int64_t i = 0; i < chunk->count_; ++i) {
+                    if (delete_ids.find(uid[i]) != delete_ids.end()) {
+                        if (view.blacklist_ == nullptr) {
+                            view.blacklist_ = std::make_shared<ConCurrentBitset>(chunk->count_);
+                        }
+                        view.blacklist_->set(i);
+                    }
+                }
+            }
+        }
+
+        views.emplace_back(view);
+    }
+
+    return Status::OK();
+}
+
 Status
 MemSegment::CreateNewSegment(snapshot::ScopedSnapshotT& ss,
                              std::shared_ptr<snapshot::MultiSegmentsOperation>& operation,
@@ -203,6 +247,19 @@ MemSegment::CreateNewSegment(snapshot::ScopedSnapshotT& ss,
 
         new_segment_files.emplace_back(delete_doc_file);
         new_segment_files.emplace_back(bloom_filter_file);
+
+        // collections created by old version have no id index element
+        if (ss->HasFieldElement(engine::FIELD_UID, engine::ELEMENT_ID_INDEX)) {
+            snapshot::SegmentFilePtr id_index_file;
+            sf_context.field_element_name = engine::ELEMENT_ID_INDEX;
+            status = operation->CommitNewSegmentFile(sf_context, id_index_file);
+            if (!status.ok()) {
+                std::string err_msg = "MemSegment::CreateSegment failed: " + status.ToString();
+                LOG_ENGINE_ERROR_ << err_msg;
+                return status;
+            }
+            new_segment_files.emplace_back(id_index_file);
+        }
     }
 
     auto visitor = SegmentVisitor::Build(ss, new_segment, new_segment_files);
@@ -253,9 +310,14 @@ MemSegment::ApplyDeleteToMem(snapshot::ScopedSnapshotT& ss) {
                 }
             }
 
+            if (offsets.empty()) {
+                continue;
+            }
+
             // construct a new engine::Segment, delete entities from chunks
             // since the temp_set is empty, it shared BinaryData with the chunk
-            // the DeleteEntity() will delete elements from the chunk
+            // the DeleteEntity() produces new BinaryData and leaves the shared one untouched,
+            // so that search views taken from this chunk stay valid
             Segment temp_set;
             auto& fields = ss->GetResources<snapshot::Field>();
             for (auto& kv : fields) {
@@ -264,6 +326,9 @@ MemSegment::ApplyDeleteToMem(snapshot::ScopedSnapshotT& ss) {
             }
             STATUS_CHECK(temp_set.AddChunk(chunk));
             temp_set.DeleteEntity(offsets);
+            for (auto& pair : temp_set.GetFixedFields()) {
+                chunk->fixed_fields_[pair.first] = pair.second;
+            }
             chunk->count_ = temp_set.GetRowCount();
         }
     }
@@ -288,6 +353,29 @@ MemSegment::PutChunksToWriter(const segment::SegmentWriterPtr& writer) {
         return Status(DB_ERROR, "Segment writer is null pointer");
     }
 
+    // a single chunk is shared with the segment without copy, for several chunks the segment is
+    // allocated once, otherwise the first chunk would be copied when the second one is appended
+    int64_t total_count = 0;
+    int64_t chunk_count = 0;
+    std::vector<std::string> field_names;
+    for (auto& action : actions_) {
+        DataChunkPtr chunk = action.insert_data_;
+        if (chunk == nullptr || chunk->count_ == 0) {
+            continue;
+        }
+        if (chunk_count++ == 0) {
+            for (auto& pair : chunk->fixed_fields_) {
+                field_names.push_back(pair.first);
+            }
+        }
+        total_count += chunk->count_;
+    }
+    if (chunk_count > 1 && !field_names.empty()) {
+        SegmentPtr segment;
+        STATUS_CHECK(writer->GetSegment(segment));
+        STATUS_CHECK(segment->Reserve(field_names, total_count));
+    }
+
     for (auto& action : actions_) {
         DataChunkPtr chunk = action.insert_data_;
         if (chunk == nullptr || chunk->count_ == 0) {
@@ -60,6 +60,10 @@ class MemSegment {
     Status
     Serialize(snapshot::ScopedSnapshotT& ss, std::shared_ptr<snapshot::MultiSegmentsOperation>& operation);
 
+    // collect views of buffered chunks for searching, the caller must hold the lock of owner MemCollection
+    Status
+    GetSearchView(MemChunkViews& views) const;
+
     idx_t
     GetMaxOpID() const {
         return max_op_id_;
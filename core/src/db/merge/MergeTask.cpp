@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace milvus {
 namespace engine {
@@ -94,6 +95,18 @@ MergeTask::Execute() {
             LOG_ENGINE_ERROR_ << err_msg;
             return status;
         }
+
+        // collections created by old version have no id index element
+        if (snapshot_->HasFieldElement(engine::FIELD_UID, engine::ELEMENT_ID_INDEX)) {
+            snapshot::SegmentFilePtr id_index_file;
+            sf_context.field_element_name = engine::ELEMENT_ID_INDEX;
+            status = op->CommitNewSegmentFile(sf_context, id_index_file);
+            if (!status.ok()) {
+                std::string err_msg = "MergeTask create id index segment file failed: " + status.ToString();
+                LOG_ENGINE_ERROR_ << err_msg;
+                return status;
+            }
+        }
     }
 
     auto ctx = op->GetContext();
@@ -101,6 +114,7 @@ MergeTask::Execute() {
 
     // create segment writer
     segment::SegmentWriterPtr segment_writer = std::make_shared<segment::SegmentWriter>(options_.meta_.path_, visitor);
+    segment_writer->SetMergeBufferSize(options_.merge_buffer_size_);
 
     // merge
     for (auto& id : segments_) {
@@ -117,12 +131,49 @@ MergeTask::Execute() {
         }
     }
 
+    // merge IVF indexes of the segments, so that the new segment is searchable by index without rebuilding
+    std::vector<std::string> indexed_fields;
+    segment_writer->MergeVectorIndexes(indexed_fields);
+    if (!indexed_fields.empty()) {
+        for (auto& name : indexed_fields) {
+            auto field_visitor = visitor->GetFieldVisitor(name);
+            auto index_visitor = field_visitor->GetElementVisitor(engine::FieldElementType::FET_INDEX);
+
+            snapshot::SegmentFileContext sf_context;
+            sf_context.collection_id = new_seg->GetCollectionId();
+            sf_context.partition_id = new_seg->GetPartitionId();
+            sf_context.segment_id = new_seg->GetID();
+            sf_context.field_name = name;
+            sf_context.field_element_name = index_visitor->GetElement()->GetName();
+
+            snapshot::SegmentFilePtr index_file;
+            status = op->CommitNewSegmentFile(sf_context, index_file);
+            if (!status.ok()) {
+                std::string err_msg = "MergeTask create index segment file failed: " + status.ToString();
+                LOG_ENGINE_ERROR_ << err_msg;
+                return status;
+            }
+        }
+
+        ctx = op->GetContext();
+        visitor = SegmentVisitor::Build(snapshot_, ctx.new_segment, ctx.new_segment_files);
+        segment_writer->SetSegmentVisitor(visitor);
+    }
+
     status = segment_writer->Serialize();
     if (!status.ok()) {
         LOG_ENGINE_ERROR_ << "Failed to serialize segment: " << new_seg->GetID();
         return status;
     }
 
+    for (auto& name : indexed_fields) {
+        status = segment_writer->WriteVectorIndex(name);
+        if (!status.ok()) {
+            LOG_ENGINE_ERROR_ << "Failed to serialize merged index of segment: " << new_seg->GetID();
+            return status;
+        }
+    }
+
     status = op->Push();
 
     return status;
@@ -11,7 +11,9 @@
 
 #include "db/meta/backend/MySqlEngine.h"
 
+#include <chrono>
 #include <memory>
+#include <random>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -33,6 +35,17 @@ namespace milvus::engine::meta {
 
 ////////// private namespace //////////
 namespace {
+// a serializable transaction aborted by these errors is rolled back by the server and could be executed again
+constexpr unsigned int MYSQL_LOCK_WAIT_TIMEOUT = 1205;
+constexpr unsigned int MYSQL_LOCK_DEADLOCK = 1213;
+constexpr int64_t TRANSACTION_MAX_RETRY = 5;
+constexpr int64_t TRANSACTION_RETRY_BACKOFF_MS = 10;
+
+bool
+IsTransactionConflict(unsigned int errnum) {
+    return errnum == MYSQL_LOCK_DEADLOCK || errnum == MYSQL_LOCK_WAIT_TIMEOUT;
+}
+
 static const auto MetaIdField = MetaField(F_ID, "BIGINT", "PRIMARY KEY AUTO_INCREMENT");
 static const MetaField MetaCollectionIdField = MetaField(F_COLLECTON_ID, "BIGINT", "NOT NULL");
 static const MetaField MetaPartitionIdField = MetaField(F_PARTITION_ID, "BIGINT", "NOT NULL");
@@ -274,6 +287,33 @@ MySqlEngine::Query(const MetaQueryContext& context, AttrsMapList& attrs) {
 
 Status
 MySqlEngine::ExecuteTransaction(const std::vector<MetaApplyContext>& sql_contexts, std::vector<int64_t>& result_ids) {
+    // operations of different collections are applied concurrently, their transactions on the shared meta tables
+    // may deadlock, the aborted one is executed again after a random backoff
+    thread_local std::default_random_engine random_engine(std::random_device{}());
+    Status status;
+    for (int64_t retry = 0;; ++retry) {
+        bool conflict = false;
+        std::vector<int64_t> ids;
+        status = ExecuteTransactionOnce(sql_contexts, ids, conflict);
+        if (status.ok()) {
+            result_ids.insert(result_ids.end(), ids.begin(), ids.end());
+            return status;
+        }
+        if (!conflict || retry >= TRANSACTION_MAX_RETRY) {
+            return status;
+        }
+
+        int64_t backoff = TRANSACTION_RETRY_BACKOFF_MS << retry;
+        backoff += std::uniform_int_distribution<int64_t>(0, backoff)(random_engine);
+        LOG_ENGINE_WARNING_ << "Meta transaction conflicts, retry " << retry + 1 << " in " << backoff
+                            << "ms: " << status.message();
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+    }
+}
+
+Status
+MySqlEngine::ExecuteTransactionOnce(const std::vector<MetaApplyContext>& sql_contexts,
+                                    std::vector<int64_t>& result_ids, bool& conflict) {
     Status status;
     mysqlpp::Connection::thread_start();
 
@@ -300,6 +340,7 @@ MySqlEngine::ExecuteTransaction(const std::vector<MetaApplyContext>& sql_context
                 std::stringstream ss;
                 ss << "Mysql execute fail: (" << query.errnum() << ": " << query.error() << ")";
                 status = Status(DB_ERROR, ss.str());
+                conflict = IsTransactionConflict(query.errnum());
                 break;
             }
 
@@ -324,6 +365,7 @@ MySqlEngine::ExecuteTransaction(const std::vector<MetaApplyContext>& sql_context
             status = Status(SS_TIMEOUT, er.what());
         } else {
             status = Status(DB_ERROR, er.what());
+            conflict = IsTransactionConflict(er.errnum());
         }
     } catch (const mysqlpp::BadConversion& er) {
         // Handle bad conversions
@@ -42,6 +42,11 @@ class MySqlEngine : public MetaEngine {
     Status
     Initialize();
 
+    // conflict is true if the server aborted the transaction by a deadlock or lock wait timeout
+    Status
+    ExecuteTransactionOnce(const std::vector<MetaApplyContext>& sql_contexts, std::vector<int64_t>& result_ids,
+                           bool& conflict);
+
  private:
     const DBMetaOptions options_;
     //    const int mode_;
@@ -36,10 +36,14 @@ class EventExecutor {
         Stop();
     }
 
+    // a stopped executor may be initialized again with another store
     static void
     Init(StorePtr store) {
         auto& instance = GetInstanceImpl();
         if (instance.initialized_) {
+            if (!instance.running_) {
+                instance.store_ = store;
+            }
             return;
         }
         instance.store_ = store;
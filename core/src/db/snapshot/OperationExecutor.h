@@ -11,9 +11,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include "Operations.h"
 #include "Store.h"
 #include "utils/BlockingQueue.h"
@@ -22,6 +24,10 @@ namespace milvus::engine::snapshot {
 
 using ThreadPtr = std::shared_ptr<std::thread>;
 using OperationQueue = BlockingQueue<OperationsPtr>;
+using OperationQueuePtr = std::shared_ptr<OperationQueue>;
+
+// the server takes the number from engine.operation_executor_num
+static constexpr size_t DEFAULT_OPERATION_EXECUTOR_NUM = 8;
 
 class OperationExecutor {
  public:
@@ -29,13 +35,22 @@ class OperationExecutor {
         Stop();
     }
 
+    // Operations of one collection are applied in order by one executor thread, operations of different
+    // collections are spread over executor_num threads and applied concurrently. A stopped executor may be
+    // initialized again with another store, the number of executors is kept
     static void
-    Init(StorePtr store) {
+    Init(StorePtr store, int64_t executor_num = DEFAULT_OPERATION_EXECUTOR_NUM) {
         auto& instance = GetInstanceImpl();
         if (instance.initialized_) {
+            if (instance.threads_.empty()) {
+                instance.store_ = store;
+            }
             return;
         }
         instance.store_ = store;
+        for (int64_t i = 0; i < std::max<int64_t>(executor_num, 1); ++i) {
+            instance.queues_.push_back(std::make_shared<OperationQueue>());
+        }
         instance.initialized_ = true;
     }
 
@@ -62,17 +77,23 @@ class OperationExecutor {
 
     void
     Start() {
-        if (thread_ptr_ == nullptr) {
-            thread_ptr_ = std::make_shared<std::thread>(&OperationExecutor::ThreadMain, this);
+        if (threads_.empty()) {
+            for (auto& queue : queues_) {
+                threads_.push_back(std::make_shared<std::thread>(&OperationExecutor::ThreadMain, this, queue));
+            }
         }
     }
 
     void
     Stop() {
-        if (thread_ptr_ != nullptr) {
-            Enqueue(nullptr);
-            thread_ptr_->join();
-            thread_ptr_ = nullptr;
+        if (!threads_.empty()) {
+            for (auto& queue : queues_) {
+                queue->Put(nullptr);
+            }
+            for (auto& thread : threads_) {
+                thread->join();
+            }
+            threads_.clear();
             LOG_ENGINE_INFO_ << "OperationExecutor Stopped";
         }
     }
@@ -88,9 +109,9 @@ class OperationExecutor {
     }
 
     void
-    ThreadMain() {
+    ThreadMain(OperationQueuePtr queue) {
         while (true) {
-            OperationsPtr operation = queue_.Take();
+            OperationsPtr operation = queue->Take();
             if (!operation) {
                 break;
             }
@@ -100,12 +121,18 @@ class OperationExecutor {
 
     void
     Enqueue(const OperationsPtr& operation) {
-        queue_.Put(operation);
+        // operations without a started snapshot, such as creating collection, go to the first queue
+        size_t pos = 0;
+        auto& ss = operation->GetStartedSS();
+        if (ss) {
+            pos = ss->GetCollectionId() % queues_.size();
+        }
+        queues_[pos]->Put(operation);
     }
 
  private:
-    ThreadPtr thread_ptr_ = nullptr;
-    OperationQueue queue_;
+    std::vector<ThreadPtr> threads_;
+    std::vector<OperationQueuePtr> queues_;
     std::atomic_bool initialized_ = false;
     StorePtr store_;
 };
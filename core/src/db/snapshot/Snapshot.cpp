@@ -18,28 +18,75 @@ namespace milvus {
 namespace engine {
 namespace snapshot {
 
+void
+SegmentEntry::Ref() {
+    // the first snapshot containing the entry references the resources
+    if (active_count_.fetch_add(1) == 0) {
+        segment_commit_->Ref();
+        segment_->Ref();
+        for (auto& kv : segment_files_) {
+            kv.second->Ref();
+        }
+    }
+}
+
+void
+SegmentEntry::UnRef() {
+    if (active_count_.fetch_sub(1) == 1) {
+        segment_commit_->UnRef();
+        segment_->UnRef();
+        for (auto& kv : segment_files_) {
+            kv.second->UnRef();
+        }
+    }
+}
+
+void
+PartitionEntry::Ref() {
+    // the entries of the unchanged segments are already active, only their counts are increased
+    if (active_count_.fetch_add(1) == 0) {
+        partition_commit_->Ref();
+        partition_->Ref();
+        for (auto& kv : segments_) {
+            kv.second->Ref();
+        }
+    }
+}
+
+void
+PartitionEntry::UnRef() {
+    if (active_count_.fetch_sub(1) == 1) {
+        partition_commit_->UnRef();
+        partition_->UnRef();
+        for (auto& kv : segments_) {
+            kv.second->UnRef();
+        }
+    }
+}
+
 void
 Snapshot::RefAll() {
     std::apply([this](auto&... resource) { ((DoRef(resource)), ...); }, resources_);
+    for (auto& kv : partitions_) {
+        kv.second->Ref();
+    }
 }
 
 void
 Snapshot::UnRefAll() {
     std::apply([this](auto&... resource) { ((DoUnRef(resource)), ...); }, resources_);
+    for (auto& kv : partitions_) {
+        kv.second->UnRef();
+    }
 }
 
-Snapshot::Snapshot(StorePtr store, ID_TYPE ss_id) {
+Snapshot::Snapshot(StorePtr store, ID_TYPE ss_id, const Ptr& prev) {
     auto& collection_commits_holder = CollectionCommitsHolder::GetInstance();
     auto& collections_holder = CollectionsHolder::GetInstance();
     auto& schema_commits_holder = SchemaCommitsHolder::GetInstance();
     auto& field_commits_holder = FieldCommitsHolder::GetInstance();
     auto& fields_holder = FieldsHolder::GetInstance();
     auto& field_elements_holder = FieldElementsHolder::GetInstance();
-    auto& partition_commits_holder = PartitionCommitsHolder::GetInstance();
-    auto& partitions_holder = PartitionsHolder::GetInstance();
-    auto& segment_commits_holder = SegmentCommitsHolder::GetInstance();
-    auto& segments_holder = SegmentsHolder::GetInstance();
-    auto& segment_files_holder = SegmentFilesHolder::GetInstance();
 
     auto collection_commit = collection_commits_holder.GetResource(store, ss_id, false);
     AddResource<CollectionCommit>(collection_commit);
@@ -56,51 +103,28 @@ Snapshot::Snapshot(StorePtr store, ID_TYPE ss_id) {
     collection_commit->LoadIds(base_path);
     auto& collection_commit_mappings = collection_commit->GetMappings();
     for (auto p_c_id : collection_commit_mappings) {
-        auto partition_commit = partition_commits_holder.GetResource(store, p_c_id, false);
-        auto partition_id = partition_commit->GetPartitionId();
-        auto partition = partitions_holder.GetResource(store, partition_id, false);
-        auto partition_name = partition->GetName();
-        AddResource<PartitionCommit>(partition_commit);
-        base_path = GetResPath<Partition>(store->GetRootPath(), std::make_shared<Partition>(*partition));
-        partition_commit->LoadIds(base_path);
-
-        p_pc_map_[partition_id] = partition_commit->GetID();
-        AddResource<Partition>(partition);
-        partition_names_map_[partition_name] = partition_id;
-        p_max_seg_num_[partition_id] = 0;
-        /* std::cout << "SS-" << ss_id << "PC_MAP=("; */
-        /* for (auto id : s_c_mappings) { */
-        /*     std::cout << id << ","; */
-        /* } */
-        /* std::cout << ")" << std::endl; */
-        auto& partition_commit_mappings = partition_commit->GetMappings();
-        for (auto s_c_id : partition_commit_mappings) {
-            auto segment_commit = segment_commits_holder.GetResource(store, s_c_id, false);
-            auto segment_id = segment_commit->GetSegmentId();
-            auto segment = segments_holder.GetResource(store, segment_id, false);
-            auto segment_schema_id = segment_commit->GetSchemaId();
-            auto segment_schema = schema_commits_holder.GetResource(store, segment_schema_id, false);
-            auto segment_partition_id = segment->GetPartitionId();
-            AddResource<SchemaCommit>(segment_schema);
-            AddResource<SegmentCommit>(segment_commit);
-            if (segment->GetNum() > p_max_seg_num_[segment_partition_id]) {
-                p_max_seg_num_[segment_partition_id] = segment->GetNum();
-            }
-            AddResource<Segment>(segment);
-
-            seg_segc_map_[segment_id] = segment_commit->GetID();
-            auto& segment_commit_mappings = segment_commit->GetMappings();
-            for (auto s_f_id : segment_commit_mappings) {
-                auto segment_file = segment_files_holder.GetResource(store, s_f_id, false);
-                auto segment_file_id = segment_file->GetID();
-                auto field_element_id = segment_file->GetFieldElementId();
-                auto field_element = field_elements_holder.GetResource(store, field_element_id, false);
-                AddResource<FieldElement>(field_element);
-                AddResource<SegmentFile>(segment_file);
-                element_segfiles_map_[field_element_id][segment_id] = segment_file_id;
-                seg_segfiles_map_[segment_id].insert(segment_file_id);
+        PartitionEntry::Ptr entry;
+        if (prev) {
+            for (auto& kv : prev->partitions_) {
+                if (kv.second->partition_commit_->GetID() == p_c_id) {
+                    entry = kv.second;
+                    break;
+                }
             }
         }
+        if (entry == nullptr) {
+            entry = LoadPartition(store, p_c_id, prev);
+        }
+
+        auto partition_id = entry->partition_->GetID();
+        partitions_[partition_id] = entry;
+        partition_names_map_[entry->partition_->GetName()] = partition_id;
+        for (auto& kv : entry->schema_commits_) {
+            AddResource<SchemaCommit>(kv.second);
+        }
+        for (auto& kv : entry->field_elements_) {
+            AddResource<FieldElement>(kv.second);
+        }
     }
 
     auto& schema_commit_mappings = schema_commit->GetMappings();
@@ -133,6 +157,104 @@ Snapshot::Snapshot(StorePtr store, ID_TYPE ss_id) {
     RefAll();
 }
 
+PartitionEntry::Ptr
+Snapshot::LoadPartition(StorePtr store, ID_TYPE partition_commit_id, const Ptr& prev) {
+    auto entry = std::make_shared<PartitionEntry>();
+    entry->partition_commit_ = PartitionCommitsHolder::GetInstance().GetResource(store, partition_commit_id, false);
+    auto partition_id = entry->partition_commit_->GetPartitionId();
+    entry->partition_ = PartitionsHolder::GetInstance().GetResource(store, partition_id, false);
+    auto base_path = GetResPath<Partition>(store->GetRootPath(), std::make_shared<Partition>(*entry->partition_));
+    entry->partition_commit_->LoadIds(base_path);
+
+    for (auto s_c_id : entry->partition_commit_->GetMappings()) {
+        auto segment = prev ? prev->FindSegmentByCommit(s_c_id) : nullptr;
+        if (segment == nullptr) {
+            segment = LoadSegment(store, s_c_id);
+        }
+
+        auto segment_id = segment->segment_->GetID();
+        entry->segments_[segment_id] = segment;
+        entry->segment_commit_ids_[s_c_id] = segment_id;
+        for (auto& kv : segment->segment_files_) {
+            entry->segment_file_ids_[kv.first] = segment_id;
+        }
+        entry->schema_commits_.emplace(segment->schema_commit_->GetID(), segment->schema_commit_);
+        for (auto& kv : segment->field_elements_) {
+            entry->field_elements_.emplace(kv.first, kv.second);
+        }
+        if (segment->segment_->GetNum() > entry->max_segment_num_) {
+            entry->max_segment_num_ = segment->segment_->GetNum();
+        }
+    }
+    return entry;
+}
+
+SegmentEntry::Ptr
+Snapshot::LoadSegment(StorePtr store, ID_TYPE segment_commit_id) {
+    auto& segment_files_holder = SegmentFilesHolder::GetInstance();
+    auto& field_elements_holder = FieldElementsHolder::GetInstance();
+
+    auto entry = std::make_shared<SegmentEntry>();
+    entry->segment_commit_ = SegmentCommitsHolder::GetInstance().GetResource(store, segment_commit_id, false);
+    auto segment_id = entry->segment_commit_->GetSegmentId();
+    entry->segment_ = SegmentsHolder::GetInstance().GetResource(store, segment_id, false);
+    auto segment_schema_id = entry->segment_commit_->GetSchemaId();
+    entry->schema_commit_ = SchemaCommitsHolder::GetInstance().GetResource(store, segment_schema_id, false);
+
+    for (auto s_f_id : entry->segment_commit_->GetMappings()) {
+        auto segment_file = segment_files_holder.GetResource(store, s_f_id, false);
+        auto field_element_id = segment_file->GetFieldElementId();
+        auto field_element = field_elements_holder.GetResource(store, field_element_id, false);
+        entry->field_elements_[field_element_id] = field_element;
+        entry->segment_files_[s_f_id] = segment_file;
+        entry->element_files_[field_element_id] = s_f_id;
+        entry->file_ids_.insert(s_f_id);
+    }
+    return entry;
+}
+
+SegmentEntry::Ptr
+Snapshot::FindSegment(ID_TYPE segment_id) const {
+    for (auto& kv : partitions_) {
+        auto entry = kv.second->FindSegment(segment_id);
+        if (entry != nullptr) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+SegmentEntry::Ptr
+Snapshot::FindSegmentByCommit(ID_TYPE segment_commit_id) const {
+    for (auto& kv : partitions_) {
+        auto it = kv.second->segment_commit_ids_.find(segment_commit_id);
+        if (it != kv.second->segment_commit_ids_.end()) {
+            return kv.second->FindSegment(it->second);
+        }
+    }
+    return nullptr;
+}
+
+void
+Snapshot::ListEntryResources() const {
+    auto& partition_commits = std::get<Index<PartitionCommit::ScopedMapT, ScopedResourcesT>::value>(listed_resources_);
+    auto& partitions = std::get<Index<Partition::ScopedMapT, ScopedResourcesT>::value>(listed_resources_);
+    auto& segment_commits = std::get<Index<SegmentCommit::ScopedMapT, ScopedResourcesT>::value>(listed_resources_);
+    auto& segments = std::get<Index<Segment::ScopedMapT, ScopedResourcesT>::value>(listed_resources_);
+    auto& segment_files = std::get<Index<SegmentFile::ScopedMapT, ScopedResourcesT>::value>(listed_resources_);
+    for (auto& kv : partitions_) {
+        auto& entry = kv.second;
+        partition_commits.emplace(entry->partition_commit_->GetID(), entry->partition_commit_);
+        partitions.emplace(kv.first, entry->partition_);
+        for (auto& segment_kv : entry->segments_) {
+            auto& segment = segment_kv.second;
+            segment_commits.emplace(segment->segment_commit_->GetID(), segment->segment_commit_);
+            segments.emplace(segment_kv.first, segment->segment_);
+            segment_files.insert(segment->segment_files_.begin(), segment->segment_files_.end());
+        }
+    }
+}
+
 Status
 Snapshot::GetSegmentRowCount(ID_TYPE segment_id, SIZE_TYPE& row_cnt) const {
     auto sc = GetSegmentCommitBySegmentId(segment_id);
@@ -182,17 +304,17 @@ Snapshot::GetFieldElement(const std::string& field_name, const std::string& fiel
 
 SegmentFilePtr
 Snapshot::GetSegmentFile(ID_TYPE segment_id, ID_TYPE field_element_id) const {
-    auto it = element_segfiles_map_.find(field_element_id);
-    if (it == element_segfiles_map_.end()) {
+    auto entry = FindSegment(segment_id);
+    if (entry == nullptr) {
         return nullptr;
     }
 
-    auto its = it->second.find(segment_id);
-    if (its == it->second.end()) {
+    auto it = entry->element_files_.find(field_element_id);
+    if (it == entry->element_files_.end()) {
         return nullptr;
     }
 
-    return GetResource<SegmentFile>(its->second);
+    return entry->segment_files_.at(it->second).Get();
 }
 
 const std::string
@@ -25,6 +25,7 @@
 #include <string>
 #include <thread>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -42,10 +43,66 @@ using ScopedResourcesT =
                Field::ScopedMapT, FieldElement::ScopedMapT, PartitionCommit::ScopedMapT, Partition::ScopedMapT,
                SegmentCommit::ScopedMapT, Segment::ScopedMapT, SegmentFile::ScopedMapT>;
 
+// Resources of one segment commit. A committed segment commit is immutable, so is its entry, which is shared by
+// all the snapshots containing the segment commit. The resources are referenced while any of them is active
+class SegmentEntry {
+ public:
+    using Ptr = std::shared_ptr<SegmentEntry>;
+
+    void
+    Ref();
+    void
+    UnRef();
+
+    ScopedResource<SegmentCommit> segment_commit_;
+    ScopedResource<Segment> segment_;
+    ScopedResource<SchemaCommit> schema_commit_;
+    SegmentFile::ScopedMapT segment_files_;
+    FieldElement::ScopedMapT field_elements_;
+    std::map<ID_TYPE, ID_TYPE> element_files_;  // field element id -> segment file id
+    std::set<ID_TYPE> file_ids_;
+
+ private:
+    std::atomic<int64_t> active_count_ = {0};
+};
+
+// Resources of one partition commit, shared by all the snapshots containing the partition commit like SegmentEntry.
+// A new partition commit reuses the entries of its unchanged segment commits
+class PartitionEntry {
+ public:
+    using Ptr = std::shared_ptr<PartitionEntry>;
+
+    void
+    Ref();
+    void
+    UnRef();
+
+    SegmentEntry::Ptr
+    FindSegment(ID_TYPE segment_id) const {
+        auto it = segments_.find(segment_id);
+        return it == segments_.end() ? nullptr : it->second;
+    }
+
+    ScopedResource<PartitionCommit> partition_commit_;
+    ScopedResource<Partition> partition_;
+    std::map<ID_TYPE, SegmentEntry::Ptr> segments_;  // segment id -> entry
+    std::map<ID_TYPE, ID_TYPE> segment_commit_ids_;  // segment commit id -> segment id
+    std::map<ID_TYPE, ID_TYPE> segment_file_ids_;    // segment file id -> segment id
+    SchemaCommit::ScopedMapT schema_commits_;        // schema commits of the segments
+    FieldElement::ScopedMapT field_elements_;        // field elements of the segment files
+    NUM_TYPE max_segment_num_ = 0;
+
+ private:
+    std::atomic<int64_t> active_count_ = {0};
+};
+
 class Snapshot : public ReferenceProxy {
  public:
     using Ptr = std::shared_ptr<Snapshot>;
-    Snapshot(StorePtr, ID_TYPE);
+    // If prev is an older snapshot of the same collection, the entries of the partition commits and segment commits
+    // unchanged since prev are shared with it, only the changed commits are loaded from store. An unchanged partition
+    // costs one pointer copy, a changed partition copies the pointers to the entries of its segments
+    Snapshot(StorePtr, ID_TYPE, const Ptr& prev = nullptr);
 
     ID_TYPE
     GetID() const {
@@ -76,7 +133,7 @@ class Snapshot : public ReferenceProxy {
 
     size_t
     NumberOfPartitions() const {
-        return GetResources<Partition>().size();
+        return partitions_.size();
     }
 
     const LSN_TYPE&
@@ -112,11 +169,11 @@ class Snapshot : public ReferenceProxy {
 
     const std::set<ID_TYPE>&
     GetSegmentFileIds(ID_TYPE segment_id) const {
-        auto it = seg_segfiles_map_.find(segment_id);
-        if (it == seg_segfiles_map_.end()) {
+        auto entry = FindSegment(segment_id);
+        if (entry == nullptr) {
             return empty_set_;
         }
-        return it->second;
+        return entry->file_ids_;
     }
 
     SegmentFilePtr
@@ -133,10 +190,10 @@ class Snapshot : public ReferenceProxy {
 
     SegmentCommitPtr
     GetSegmentCommitBySegmentId(ID_TYPE segment_id) const {
-        auto it = seg_segc_map_.find(segment_id);
-        if (it == seg_segc_map_.end())
+        auto entry = FindSegment(segment_id);
+        if (entry == nullptr)
             return nullptr;
-        return GetResource<SegmentCommit>(it->second);
+        return entry->segment_commit_.Get();
     }
 
     Status
@@ -154,10 +211,10 @@ class Snapshot : public ReferenceProxy {
 
     PartitionCommitPtr
     GetPartitionCommitByPartitionId(ID_TYPE partition_id) const {
-        auto it = p_pc_map_.find(partition_id);
-        if (it == p_pc_map_.end())
+        auto it = partitions_.find(partition_id);
+        if (it == partitions_.end())
             return nullptr;
-        return GetResource<PartitionCommit>(it->second);
+        return it->second->partition_commit_.Get();
     }
 
     template <typename HandlerT>
@@ -211,15 +268,15 @@ class Snapshot : public ReferenceProxy {
     ID_TYPE
     GetSegmentFileId(const std::string& field_name, const std::string& field_element_name, ID_TYPE segment_id) const {
         auto field_element_id = GetFieldElementId(field_name, field_element_name);
-        auto it = element_segfiles_map_.find(field_element_id);
-        if (it == element_segfiles_map_.end()) {
+        auto entry = FindSegment(segment_id);
+        if (entry == nullptr) {
             return 0;
         }
-        auto its = it->second.find(segment_id);
-        if (its == it->second.end()) {
+        auto it = entry->element_files_.find(field_element_id);
+        if (it == entry->element_files_.end()) {
             return 0;
         }
-        return its->second;
+        return it->second;
     }
 
     bool
@@ -257,10 +314,10 @@ class Snapshot : public ReferenceProxy {
 
     NUM_TYPE
     GetMaxSegmentNumByPartition(ID_TYPE partition_id) const {
-        auto it = p_max_seg_num_.find(partition_id);
-        if (it == p_max_seg_num_.end())
+        auto it = partitions_.find(partition_id);
+        if (it == partitions_.end())
             return 0;
-        return it->second;
+        return it->second->max_segment_num_;
     }
 
     void
@@ -305,34 +362,67 @@ class Snapshot : public ReferenceProxy {
         }
     }
 
+    // the resources of partitions and segments are kept in the shared entries, their maps are listed on first use
+    template <typename ResourceT>
+    static constexpr bool
+    IsEntryResource() {
+        return std::is_same<ResourceT, PartitionCommit>::value || std::is_same<ResourceT, Partition>::value ||
+               std::is_same<ResourceT, SegmentCommit>::value || std::is_same<ResourceT, Segment>::value ||
+               std::is_same<ResourceT, SegmentFile>::value;
+    }
+
     template <typename ResourceT>
     typename ResourceT::ScopedMapT&
     GetResources() {
-        return std::get<Index<typename ResourceT::ScopedMapT, ScopedResourcesT>::value>(resources_);
+        return const_cast<typename ResourceT::ScopedMapT&>(
+            static_cast<const Snapshot*>(this)->GetResources<ResourceT>());
     }
 
     template <typename ResourceT>
     const typename ResourceT::ScopedMapT&
     GetResources() const {
+        if constexpr (IsEntryResource<ResourceT>()) {
+            std::call_once(listed_flag_, [this] { ListEntryResources(); });
+            return std::get<Index<typename ResourceT::ScopedMapT, ScopedResourcesT>::value>(listed_resources_);
+        }
         return std::get<Index<typename ResourceT::ScopedMapT, ScopedResourcesT>::value>(resources_);
     }
 
     template <typename ResourceT>
     typename ResourceT::Ptr
     GetResource(ID_TYPE id) const {
-        auto& resources = GetResources<ResourceT>();
-        auto it = resources.find(id);
-        if (it == resources.end()) {
+        if constexpr (std::is_same<ResourceT, Partition>::value) {
+            auto it = partitions_.find(id);
+            return it == partitions_.end() ? nullptr : it->second->partition_.Get();
+        } else if constexpr (std::is_same<ResourceT, PartitionCommit>::value) {
+            for (auto& kv : partitions_) {
+                if (kv.second->partition_commit_->GetID() == id) {
+                    return kv.second->partition_commit_.Get();
+                }
+            }
             return nullptr;
+        } else if constexpr (std::is_same<ResourceT, Segment>::value) {
+            auto entry = FindSegment(id);
+            return entry == nullptr ? nullptr : entry->segment_.Get();
+        } else if constexpr (std::is_same<ResourceT, SegmentCommit>::value) {
+            auto entry = FindSegmentByCommit(id);
+            return entry == nullptr ? nullptr : entry->segment_commit_.Get();
+        } else if constexpr (std::is_same<ResourceT, SegmentFile>::value) {
+            for (auto& kv : partitions_) {
+                auto it = kv.second->segment_file_ids_.find(id);
+                if (it != kv.second->segment_file_ids_.end()) {
+                    return kv.second->FindSegment(it->second)->segment_files_.at(id).Get();
+                }
+            }
+            return nullptr;
+        } else {
+            auto& resources = GetResources<ResourceT>();
+            auto it = resources.find(id);
+            if (it == resources.end()) {
+                return nullptr;
+            }
+            return it->second.Get();
         }
-        return it->second.Get();
-    }
-
-    template <typename ResourceT>
-    void
-    AddResource(ScopedResource<ResourceT>& resource) {
-        auto& resources = GetResources<ResourceT>();
-        resources[resource->GetID()] = resource;
     }
 
     const std::string
@@ -343,18 +433,37 @@ class Snapshot : public ReferenceProxy {
     Snapshot&
     operator=(const Snapshot&) = delete;
 
-    // PXU TODO: Re-org below data structures to reduce memory usage
+    template <typename ResourceT>
+    void
+    AddResource(ScopedResource<ResourceT>& resource) {
+        auto& resources = std::get<Index<typename ResourceT::ScopedMapT, ScopedResourcesT>::value>(resources_);
+        resources[resource->GetID()] = resource;
+    }
+
+    PartitionEntry::Ptr
+    LoadPartition(StorePtr store, ID_TYPE partition_commit_id, const Ptr& prev);
+    SegmentEntry::Ptr
+    LoadSegment(StorePtr store, ID_TYPE segment_commit_id);
+
+    SegmentEntry::Ptr
+    FindSegment(ID_TYPE segment_id) const;
+    SegmentEntry::Ptr
+    FindSegmentByCommit(ID_TYPE segment_commit_id) const;
+
+    void
+    ListEntryResources() const;
+
+    // resources of collection and schema, the resources of partitions and segments are kept in partitions_
     ScopedResourcesT resources_;
+    std::map<ID_TYPE, PartitionEntry::Ptr> partitions_;  // partition id -> entry
+    mutable std::once_flag listed_flag_;
+    mutable ScopedResourcesT listed_resources_;
+
     ID_TYPE current_schema_id_;
     std::map<std::string, ID_TYPE> field_names_map_;
     std::map<std::string, ID_TYPE> partition_names_map_;
     std::map<std::string, std::map<std::string, ID_TYPE>> field_element_names_map_;
-    std::map<ID_TYPE, std::map<ID_TYPE, ID_TYPE>> element_segfiles_map_;
-    std::map<ID_TYPE, std::set<ID_TYPE>> seg_segfiles_map_;
-    std::map<ID_TYPE, ID_TYPE> seg_segc_map_;
-    std::map<ID_TYPE, ID_TYPE> p_pc_map_;
     ID_TYPE latest_schema_commit_id_ = 0;
-    std::map<ID_TYPE, NUM_TYPE> p_max_seg_num_;
     LSN_TYPE max_lsn_;
     std::set<ID_TYPE> empty_set_;
 };
@@ -148,6 +148,7 @@ SnapshotHolder::ApplyEject() {
 Status
 SnapshotHolder::Add(StorePtr store, ID_TYPE id) {
     Status status;
+    ScopedSnapshotT prev_ss;
     {
         std::unique_lock<std::mutex> lock(mutex_);
         if (active_.size() > 0 && id < max_id_) {
@@ -162,10 +163,14 @@ SnapshotHolder::Add(StorePtr store, ID_TYPE id) {
             emsg << "SnapshotHolder::Add: Duplicated snapshot " << id << ".";
             return Status(SS_DUPLICATED_ERROR, emsg.str());
         }
+        // hold the latest snapshot, the new one is derived from it
+        if (active_.size() > 0) {
+            prev_ss = ScopedSnapshotT(active_.at(max_id_));
+        }
     }
     Snapshot::Ptr oldest_ss;
     {
-        auto ss = std::make_shared<Snapshot>(store, id);
+        auto ss = std::make_shared<Snapshot>(store, id, prev_ss.Get());
 
         std::unique_lock<std::mutex> lock(mutex_);
         if (!IsActive(ss)) {
@@ -11,6 +11,8 @@
 
 #include "db/snapshot/Snapshots.h"
 
+#include <algorithm>
+
 #include "db/Constants.h"
 #include "db/snapshot/CompoundOperations.h"
 #include "db/snapshot/EventExecutor.h"
@@ -53,6 +55,7 @@ Snapshots::DoDropCollection(ScopedSnapshotT& ss, const LSN_TYPE& lsn) {
     {
         std::unique_lock<std::shared_timed_mutex> lock(mutex_);
         alive_cids_.erase(context.collection->GetID());
+        pending_cids_.erase(context.collection->GetID());
         name_id_map_.erase(context.collection->GetName());
         /* holders_.erase(context.collection->GetID()); */
         auto h = holders_.find(context.collection->GetID());
@@ -122,9 +125,13 @@ Snapshots::GetSnapshot(ScopedSnapshotT& ss, const std::string& name, ID_TYPE id,
 Status
 Snapshots::GetCollectionIds(IDS_TYPE& ids) const {
     std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    // loaded and pending collections are returned in ascending id order, the same as before lazy loading
+    auto begin = ids.size();
     for (auto& kv : holders_) {
         ids.push_back(kv.first);
     }
+    ids.insert(ids.end(), pending_cids_.begin(), pending_cids_.end());
+    std::inplace_merge(ids.begin() + begin, ids.begin() + begin + holders_.size(), ids.end());
     return Status::OK();
 }
 
@@ -138,7 +145,7 @@ Snapshots::GetCollectionNames(std::vector<std::string>& names) const {
 }
 
 Status
-Snapshots::LoadNoLock(StorePtr store, ID_TYPE collection_id, SnapshotHolderPtr& holder) {
+Snapshots::LoadNoLock(StorePtr store, ID_TYPE collection_id, SnapshotHolderPtr& holder) const {
     auto op = std::make_shared<GetSnapshotIDsOperation>(collection_id, false);
     /* op->Push(); */
     (*op)(store);
@@ -163,16 +170,58 @@ Snapshots::Init(StorePtr store) {
     auto event = std::make_shared<InActiveResourcesGCEvent>();
     EventExecutor::GetInstance().Submit(event, true);
     STATUS_CHECK(event->WaitToFinish());
-    auto op = std::make_shared<GetCollectionIDsOperation>();
-    STATUS_CHECK((*op)(store));
-    auto& collection_ids = op->GetIDs();
-    SnapshotHolderPtr holder;
-    for (auto& collection_id : collection_ids) {
-        STATUS_CHECK(LoadHolder(store, collection_id, holder));
+
+    // all active collections are fetched by one select, their holders are loaded on first access or by warm-up
+    std::vector<CollectionPtr> collections;
+    STATUS_CHECK(store->GetActiveResources<Collection>(collections));
+    IDS_TYPE collection_ids;
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+        store_ = store;
+        for (auto& collection : collections) {
+            if (holders_.find(collection->GetID()) != holders_.end()) {
+                continue;
+            }
+            pending_cids_.insert(collection->GetID());
+            name_id_map_[collection->GetName()] = collection->GetID();
+            collection_ids.push_back(collection->GetID());
+        }
     }
+    LOG_ENGINE_DEBUG_ << "Snapshots::Init: " << collection_ids.size() << " collections to be loaded in background";
+
+    WarmUp(collection_ids);
     return Status::OK();
 }
 
+void
+Snapshots::WarmUp(const IDS_TYPE& collection_ids) {
+    if (collection_ids.empty()) {
+        return;
+    }
+
+    // each worker takes the next collection until all are loaded, holders are loaded in parallel
+    auto ids = std::make_shared<IDS_TYPE>(collection_ids);
+    auto cursor = std::make_shared<std::atomic<size_t>>(0);
+    auto thread_num = std::min<size_t>(ids->size(), std::max<int64_t>(config.engine.snapshot_warmup_num(), 0));
+    if (thread_num == 0) {
+        return;
+    }
+    warmup_stop_ = false;
+    warmup_pool_ = std::make_shared<ThreadPool>(thread_num, thread_num);
+    for (size_t i = 0; i < thread_num; ++i) {
+        warmup_pool_->enqueue([this, ids, cursor]() {
+            size_t pos = 0;
+            while (!warmup_stop_ && (pos = (*cursor)++) < ids->size()) {
+                SnapshotHolderPtr holder;
+                auto status = GetHolder(ids->at(pos), holder);
+                if (!status.ok() && status.code() != SS_NOT_FOUND_ERROR) {
+                    LOG_ENGINE_WARNING_ << "Snapshots::WarmUp failed: " << status.message();
+                }
+            }
+        });
+    }
+}
+
 Status
 Snapshots::GetHolder(const std::string& name, SnapshotHolderPtr& holder) const {
     std::shared_lock<std::shared_timed_mutex> lock(mutex_);
@@ -191,15 +240,28 @@ Snapshots::GetHolder(const std::string& name, SnapshotHolderPtr& holder) const {
 
 Status
 Snapshots::GetHolder(const ID_TYPE& collection_id, SnapshotHolderPtr& holder) const {
-    Status status;
-    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
-    status = GetHolderNoLock(collection_id, holder);
+    StorePtr store;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        auto status = GetHolderNoLock(collection_id, holder);
+        if (status.ok() || pending_cids_.find(collection_id) == pending_cids_.end()) {
+            return status;
+        }
+        store = store_;
+    }
 
-    return status;
+    // the collection is found at startup but not loaded yet
+    return DoLoadHolder(store, collection_id, true, holder);
 }
 
 Status
 Snapshots::LoadHolder(StorePtr store, const ID_TYPE& collection_id, SnapshotHolderPtr& holder) {
+    return DoLoadHolder(store, collection_id, false, holder);
+}
+
+Status
+Snapshots::DoLoadHolder(StorePtr store, ID_TYPE collection_id, bool pending_only, SnapshotHolderPtr& holder) const {
+    auto is_dropped = [&]() { return pending_only && pending_cids_.find(collection_id) == pending_cids_.end(); };
     {
         std::shared_lock<std::shared_timed_mutex> lock(mutex_);
         auto status = GetHolderNoLock(collection_id, holder);
@@ -207,15 +269,46 @@ Snapshots::LoadHolder(StorePtr store, const ID_TYPE& collection_id, SnapshotHold
             return status;
         }
     }
-    STATUS_CHECK(LoadNoLock(store, collection_id, holder));
+    {
+        // only one thread loads the holder of a collection, the others wait for it
+        std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+        loading_cv_.wait(lock, [&]() { return loading_cids_.find(collection_id) == loading_cids_.end(); });
+        auto status = GetHolderNoLock(collection_id, holder);
+        if (status.ok() && holder) {
+            return status;
+        }
+        // dropped or reset since the caller found it pending
+        if (is_dropped()) {
+            return status;
+        }
+        loading_cids_.insert(collection_id);
+    }
 
-    std::unique_lock<std::shared_timed_mutex> lock(mutex_);
-    holders_[collection_id] = holder;
+    // the loading_cids_ gate keeps other loaders of this collection away, the store is read without mutex_
     ScopedSnapshotT ss;
-    STATUS_CHECK(holder->Load(store, ss));
-    name_id_map_[ss->GetName()] = collection_id;
-    alive_cids_.insert(collection_id);
-    return Status::OK();
+    auto status = LoadNoLock(store, collection_id, holder);
+    if (status.ok()) {
+        status = holder->Load(store, ss);
+    }
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+        loading_cids_.erase(collection_id);
+        if (status.ok() && is_dropped()) {
+            std::stringstream emsg;
+            emsg << "Snapshots::LoadHolder: Collection " << collection_id << " is dropped while loading";
+            status = Status(SS_NOT_FOUND_ERROR, emsg.str());
+        } else if (status.ok()) {
+            holders_[collection_id] = holder;
+            name_id_map_[ss->GetName()] = collection_id;
+            alive_cids_.insert(collection_id);
+            pending_cids_.erase(collection_id);
+        }
+    }
+    loading_cv_.notify_all();
+    if (!status.ok()) {
+        holder = nullptr;
+    }
+    return status;
 }
 
 Status
@@ -323,16 +416,23 @@ Snapshots::RegisterTimers(TimerManager* mgr) {
 
 Status
 Snapshots::Reset() {
+    warmup_stop_ = true;
+    if (warmup_pool_) {
+        warmup_pool_->Stop();
+        warmup_pool_ = nullptr;
+    }
+
     std::unique_lock<std::shared_timed_mutex> lock(mutex_);
     holders_.clear();
     alive_cids_.clear();
     name_id_map_.clear();
+    pending_cids_.clear();
     inactive_holders_.clear();
     return Status::OK();
 }
 
 void
-Snapshots::SnapshotGCCallback(Snapshot::Ptr ss_ptr) {
+Snapshots::SnapshotGCCallback(Snapshot::Ptr ss_ptr) const {
     ss_ptr->UnRef();
     LOG_ENGINE_DEBUG_ << "Snapshot " << ss_ptr->GetID() << " ref_count = " << ss_ptr->ref_count() << " To be removed";
 }
@@ -350,7 +450,7 @@ Snapshots::StartService() {
     }
 
     store_ = snapshot::Store::Build(config.general.meta_uri(), meta_path, codec::Codec::instance().GetSuffixSet());
-    snapshot::OperationExecutor::Init(store_);
+    snapshot::OperationExecutor::Init(store_, config.engine.operation_executor_num());
     snapshot::OperationExecutor::GetInstance().Start();
     snapshot::EventExecutor::Init(store_);
     snapshot::EventExecutor::GetInstance().Start();
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -35,6 +36,7 @@ class Snapshots {
         static Snapshots sss;
         return sss;
     }
+    // The holder of a collection which is not loaded yet is loaded on first access
     Status
     GetHolder(const ID_TYPE& collection_id, SnapshotHolderPtr& holder) const;
     Status
@@ -82,7 +84,7 @@ class Snapshots {
 
  private:
     void
-    SnapshotGCCallback(Snapshot::Ptr ss_ptr);
+    SnapshotGCCallback(Snapshot::Ptr ss_ptr) const;
     Snapshots() = default;
     Status
     DoDropCollection(ScopedSnapshotT& ss, const LSN_TYPE& lsn);
@@ -92,18 +94,30 @@ class Snapshots {
     void
     OnWriterTimer(const boost::system::error_code&);
 
+    void
+    WarmUp(const IDS_TYPE& collection_ids);
+
+    // pending_only: the collection is loaded only if it is still waiting to be loaded since startup
+    Status
+    DoLoadHolder(StorePtr store, ID_TYPE collection_id, bool pending_only, SnapshotHolderPtr& holder) const;
     Status
-    LoadNoLock(StorePtr store, ID_TYPE collection_id, SnapshotHolderPtr& holder);
+    LoadNoLock(StorePtr store, ID_TYPE collection_id, SnapshotHolderPtr& holder) const;
     Status
     GetHolderNoLock(ID_TYPE collection_id, SnapshotHolderPtr& holder) const;
 
+    // holders of the collections found at startup are loaded on first access, also by the const getters
     mutable std::shared_timed_mutex mutex_;
-    std::map<ID_TYPE, SnapshotHolderPtr> holders_;
-    std::set<ID_TYPE> alive_cids_;
-    std::map<std::string, ID_TYPE> name_id_map_;
+    mutable std::map<ID_TYPE, SnapshotHolderPtr> holders_;
+    mutable std::set<ID_TYPE> alive_cids_;
+    mutable std::map<std::string, ID_TYPE> name_id_map_;
+    mutable std::set<ID_TYPE> pending_cids_;  // collections found at startup whose holders are not loaded yet
+    mutable std::set<ID_TYPE> loading_cids_;
+    mutable std::condition_variable_any loading_cv_;
     mutable std::shared_timed_mutex inactive_mtx_;
     std::map<ID_TYPE, SnapshotHolderPtr> inactive_holders_;
     StorePtr store_;
+    ThreadPoolPtr warmup_pool_;
+    std::atomic_bool warmup_stop_ = false;
 };
 
 }  // namespace milvus::engine::snapshot
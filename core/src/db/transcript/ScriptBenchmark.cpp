@@ -0,0 +1,335 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "db/transcript/ScriptBenchmark.h"
+#include "db/transcript/ScriptCodec.h"
+#include "db/transcript/ScriptFile.h"
+#include "db/transcript/ScriptReplay.h"
+#include "utils/Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <numeric>
+#include <set>
+#include <utility>
+
+namespace milvus {
+namespace engine {
+
+namespace {
+
+constexpr size_t WORKER_QUEUE_CAPACITY = 1024;
+
+const char* J_SCRIPT = "script";
+const char* J_SPEED = "speed";
+const char* J_CONCURRENCY = "concurrency";
+const char* J_DURATION_MS = "duration_ms";
+const char* J_TOTAL = "total";
+const char* J_ACTIONS = "actions";
+const char* J_COUNT = "count";
+const char* J_FAILED = "failed";
+const char* J_THROUGHPUT = "throughput";
+const char* J_AVG_MS = "avg_ms";
+const char* J_P50_MS = "p50_ms";
+const char* J_P90_MS = "p90_ms";
+const char* J_P99_MS = "p99_ms";
+const char* J_MAX_MS = "max_ms";
+
+bool
+IsOrderedAction(const std::string& action_type) {
+    return action_type == ActionInsert || action_type == ActionDeleteEntityByID;
+}
+
+bool
+IsReadAction(const std::string& action_type) {
+    static const std::set<std::string> read_actions = {
+        ActionHasCollection, ActionListCollections, ActionGetCollectionInfo, ActionGetCollectionStats,
+        ActionCountEntities, ActionHasPartition,    ActionListPartitions,    ActionDescribeIndex,
+        ActionGetEntityByID, ActionListIDInSegment, ActionQuery,
+    };
+    return read_actions.find(action_type) != read_actions.end();
+}
+
+// nearest-rank percentile of sorted latencies
+double
+PercentileMs(const std::vector<int64_t>& latencies, double percent) {
+    if (latencies.empty()) {
+        return 0.0;
+    }
+    auto rank = static_cast<size_t>(std::ceil(percent * latencies.size()));
+    rank = std::min(std::max<size_t>(rank, 1), latencies.size());
+    return latencies[rank - 1] / 1000.0;
+}
+
+void
+PrintRow(std::ostream& out, const std::string& action, const std::string& metric, const milvus::json& base,
+         const milvus::json& target) {
+    auto print_value = [&](const milvus::json& value) {
+        if (value.is_number()) {
+            out << std::setw(14) << value.get<double>();
+        } else {
+            out << std::setw(14) << "-";
+        }
+    };
+
+    out << std::left << std::setw(24) << action << std::setw(12) << metric << std::right;
+    print_value(base);
+    print_value(target);
+    if (base.is_number() && target.is_number() && base.get<double>() != 0.0) {
+        double change = (target.get<double>() - base.get<double>()) * 100.0 / base.get<double>();
+        out << std::setw(12) << std::showpos << change << "%" << std::noshowpos;
+    } else {
+        out << std::setw(13) << "-";
+    }
+    out << std::endl;
+}
+
+}  // namespace
+
+ScriptBenchmark::ScriptBenchmark(const BenchmarkOptions& options) : options_(options) {
+    options_.speed_ = std::max(options_.speed_, 0.0);
+    options_.concurrency_ = std::max<int64_t>(options_.concurrency_, 1);
+}
+
+Status
+ScriptBenchmark::Run(const DBPtr& db, const std::string& replay_script_path, milvus::json& report) {
+    std::vector<std::string> files;
+    STATUS_CHECK(ScriptReplay::ListScriptFiles(replay_script_path, files));
+
+    workers_.clear();
+    stats_.clear();
+    first_ts_ = -1;
+    read_cursor_ = 0;
+    pending_ = 0;
+    for (int64_t i = 0; i < options_.concurrency_; ++i) {
+        auto worker = std::make_shared<Worker>();
+        worker->queue_.SetCapacity(WORKER_QUEUE_CAPACITY);
+        auto raw_worker = worker.get();
+        worker->thread_ = std::thread([this, db, raw_worker]() {
+            while (true) {
+                auto task = raw_worker->queue_.Take();
+                if (task == nullptr) {
+                    break;
+                }
+                Perform(db, *task, raw_worker->stats_);
+
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                if (--pending_ == 0) {
+                    pending_cv_.notify_all();
+                }
+            }
+        });
+        workers_.emplace_back(worker);
+    }
+
+    Status status;
+    run_start_ = Clock::now();
+    for (auto& file_path : files) {
+        ScriptFile file;
+        status = file.OpenRead(file_path);
+        if (!status.ok()) {
+            break;
+        }
+
+        std::string str_line;
+        while (status.ok() && file.ReadLine(str_line)) {
+            status = Dispatch(db, str_line);
+        }
+        if (!status.ok()) {
+            break;
+        }
+    }
+
+    for (auto& worker : workers_) {
+        worker->queue_.Put(nullptr);
+    }
+    for (auto& worker : workers_) {
+        worker->thread_.join();
+    }
+    auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - run_start_).count();
+
+    STATUS_CHECK(status);
+    MakeReport(replay_script_path, duration_us, report);
+    return Status::OK();
+}
+
+Status
+ScriptBenchmark::Dispatch(const DBPtr& db, const std::string& str_action) {
+    auto task = std::make_shared<ActionTask>();
+    int64_t action_ts = 0;
+    try {
+        task->json_obj_ = milvus::json::parse(str_action);
+        ScriptCodec::DecodeAction(task->json_obj_, task->action_type_, action_ts);
+    } catch (std::exception& ex) {
+        std::string msg = "Failed to decode script action, reason: " + std::string(ex.what());
+        LOG_SERVER_ERROR_ << msg;
+        return Status(DB_ERROR, msg);
+    }
+
+    // issue the action at its recorded time, scaled by speed
+    // in paced mode the latency is counted from the scheduled time, so that the delay caused by a saturated
+    // db is not hidden by the late issue of following actions
+    task->start_ = Clock::now();
+    if (options_.speed_ > 0.0) {
+        if (first_ts_ < 0) {
+            first_ts_ = action_ts;
+        }
+        auto offset = static_cast<int64_t>((action_ts - first_ts_) / options_.speed_);
+        task->start_ = run_start_ + std::chrono::microseconds(std::max<int64_t>(offset, 0));
+        std::this_thread::sleep_until(task->start_);
+    }
+
+    auto& action_type = task->action_type_;
+    if (IsOrderedAction(action_type)) {
+        std::string collection_name;
+        ScriptCodec::DecodeCollectionName(task->json_obj_, collection_name);
+        Issue(workers_[std::hash<std::string>()(collection_name) % workers_.size()], task);
+    } else if (IsReadAction(action_type)) {
+        Issue(workers_[read_cursor_++ % workers_.size()], task);
+    } else {
+        WaitIdle();
+        Perform(db, *task, stats_);
+    }
+
+    return Status::OK();
+}
+
+void
+ScriptBenchmark::Issue(const WorkerPtr& worker, const ActionTaskPtr& task) {
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        ++pending_;
+    }
+    worker->queue_.Put(task);
+}
+
+void
+ScriptBenchmark::Perform(const DBPtr& db, ActionTask& task, ActionStatsMap& stats) {
+    auto start = (options_.speed_ > 0.0) ? task.start_ : Clock::now();
+
+    Status db_status;
+    auto status = ScriptReplay::PerformAction(db, task.json_obj_, task.action_type_, db_status);
+
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    auto& action_stats = stats[task.action_type_];
+    action_stats.latencies_.push_back(latency);
+    if (!status.ok() || !db_status.ok()) {
+        ++action_stats.failed_;
+    }
+}
+
+void
+ScriptBenchmark::WaitIdle() {
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+    pending_cv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void
+ScriptBenchmark::MakeReport(const std::string& replay_script_path, int64_t duration_us, milvus::json& report) {
+    ActionStatsMap merged = std::move(stats_);
+    for (auto& worker : workers_) {
+        for (auto& pair : worker->stats_) {
+            auto& action_stats = merged[pair.first];
+            action_stats.latencies_.insert(action_stats.latencies_.end(), pair.second.latencies_.begin(),
+                                           pair.second.latencies_.end());
+            action_stats.failed_ += pair.second.failed_;
+        }
+    }
+    workers_.clear();
+
+    double seconds = std::max<int64_t>(duration_us, 1) / 1000000.0;
+    int64_t total_count = 0, total_failed = 0;
+    milvus::json actions = milvus::json::object();
+    for (auto& pair : merged) {
+        auto& latencies = pair.second.latencies_;
+        std::sort(latencies.begin(), latencies.end());
+        int64_t count = latencies.size();
+        int64_t sum = std::accumulate(latencies.begin(), latencies.end(), (int64_t)0);
+
+        milvus::json metrics;
+        metrics[J_COUNT] = count;
+        metrics[J_FAILED] = pair.second.failed_;
+        metrics[J_THROUGHPUT] = count / seconds;
+        metrics[J_AVG_MS] = count > 0 ? sum / 1000.0 / count : 0.0;
+        metrics[J_P50_MS] = PercentileMs(latencies, 0.50);
+        metrics[J_P90_MS] = PercentileMs(latencies, 0.90);
+        metrics[J_P99_MS] = PercentileMs(latencies, 0.99);
+        metrics[J_MAX_MS] = PercentileMs(latencies, 1.0);
+        actions[pair.first] = metrics;
+
+        total_count += count;
+        total_failed += pair.second.failed_;
+    }
+
+    milvus::json total;
+    total[J_COUNT] = total_count;
+    total[J_FAILED] = total_failed;
+    total[J_THROUGHPUT] = total_count / seconds;
+
+    report = milvus::json::object();
+    report[J_SCRIPT] = replay_script_path;
+    report[J_SPEED] = options_.speed_;
+    report[J_CONCURRENCY] = options_.concurrency_;
+    report[J_DURATION_MS] = duration_us / 1000.0;
+    report[J_TOTAL] = total;
+    report[J_ACTIONS] = actions;
+}
+
+void
+ScriptBenchmark::Compare(const milvus::json& base, const milvus::json& target, std::ostream& out) {
+    auto get_value = [](const milvus::json& json_obj, const std::string& action, const char* metric) {
+        if (json_obj.contains(J_ACTIONS) && json_obj[J_ACTIONS].contains(action) &&
+            json_obj[J_ACTIONS][action].contains(metric)) {
+            return json_obj[J_ACTIONS][action][metric];
+        }
+        return milvus::json();
+    };
+    auto get_total = [](const milvus::json& json_obj, const char* metric) {
+        if (json_obj.contains(J_TOTAL) && json_obj[J_TOTAL].contains(metric)) {
+            return json_obj[J_TOTAL][metric];
+        }
+        return milvus::json();
+    };
+
+    std::set<std::string> action_types;
+    for (auto report : {&base, &target}) {
+        if (report->contains(J_ACTIONS)) {
+            for (auto& item : (*report)[J_ACTIONS].items()) {
+                action_types.insert(item.key());
+            }
+        }
+    }
+
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << std::left << std::setw(24) << "action" << std::setw(12) << "metric" << std::right << std::setw(14)
+        << "base" << std::setw(14) << "target" << std::setw(13) << "change" << std::endl;
+
+    PrintRow(out, J_TOTAL, J_THROUGHPUT, get_total(base, J_THROUGHPUT), get_total(target, J_THROUGHPUT));
+    PrintRow(out, J_TOTAL, J_FAILED, get_total(base, J_FAILED), get_total(target, J_FAILED));
+
+    const std::vector<const char*> metrics = {J_COUNT,  J_FAILED, J_THROUGHPUT, J_AVG_MS,
+                                              J_P50_MS, J_P90_MS, J_P99_MS,     J_MAX_MS};
+    for (auto& action : action_types) {
+        for (auto metric : metrics) {
+            PrintRow(out, action, metric, get_value(base, action, metric), get_value(target, action, metric));
+        }
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+}  // namespace engine
+}  // namespace milvus
@@ -0,0 +1,102 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "db/DB.h"
+#include "utils/BlockingQueue.h"
+#include "utils/Json.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace milvus {
+namespace engine {
+
+struct BenchmarkOptions {
+    double speed_ = 0.0;       // 0: as fast as possible, 1: original pace, N: N times faster than original
+    int64_t concurrency_ = 1;  // number of replay workers
+};
+
+// Replay a recorded transcript and measure the latency of each action.
+// Insert/delete actions of one collection are performed in order by the same worker, read actions are spread
+// over all workers, other actions (ddl, flush, compact, etc.) wait for all issued actions to finish and run alone.
+class ScriptBenchmark {
+ public:
+    explicit ScriptBenchmark(const BenchmarkOptions& options);
+
+    Status
+    Run(const DBPtr& db, const std::string& replay_script_path, milvus::json& report);
+
+    // print the metrics of target report beside the base report
+    static void
+    Compare(const milvus::json& base, const milvus::json& target, std::ostream& out);
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    struct ActionTask {
+        milvus::json json_obj_;
+        std::string action_type_;
+        Clock::time_point start_;  // latency is counted from this time point
+    };
+    using ActionTaskPtr = std::shared_ptr<ActionTask>;
+
+    struct ActionStats {
+        std::vector<int64_t> latencies_;  // microseconds
+        int64_t failed_ = 0;
+    };
+    using ActionStatsMap = std::map<std::string, ActionStats>;
+
+    struct Worker {
+        BlockingQueue<ActionTaskPtr> queue_;
+        std::thread thread_;
+        ActionStatsMap stats_;
+    };
+    using WorkerPtr = std::shared_ptr<Worker>;
+
+    Status
+    Dispatch(const DBPtr& db, const std::string& str_action);
+
+    void
+    Issue(const WorkerPtr& worker, const ActionTaskPtr& task);
+
+    void
+    Perform(const DBPtr& db, ActionTask& task, ActionStatsMap& stats);
+
+    void
+    WaitIdle();
+
+    void
+    MakeReport(const std::string& replay_script_path, int64_t duration_us, milvus::json& report);
+
+ private:
+    BenchmarkOptions options_;
+    std::vector<WorkerPtr> workers_;
+    ActionStatsMap stats_;  // stats of actions performed by dispatcher
+    Clock::time_point run_start_;
+    int64_t first_ts_ = -1;  // timestamp of the first action
+    uint64_t read_cursor_ = 0;
+
+    std::mutex pending_mutex_;
+    std::condition_variable pending_cv_;
+    int64_t pending_ = 0;  // dispatched actions not finished yet
+};
+
+}  // namespace engine
+}  // namespace milvus
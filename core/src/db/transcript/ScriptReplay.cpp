@@ -25,29 +25,13 @@ namespace engine {
 
 Status
 ScriptReplay::Replay(const DBPtr& db, const std::string& replay_script_path) {
-    // get all script files under this folder, arrange them in ascending order
-    std::map<int64_t, std::experimental::filesystem::path> files_map;
-
-    using DirectoryIterator = std::experimental::filesystem::recursive_directory_iterator;
-    DirectoryIterator iter(replay_script_path);
-    DirectoryIterator end;
-    for (; iter != end; ++iter) {
-        auto path = (*iter).path();
-        if (std::experimental::filesystem::is_directory(path)) {
-            continue;
-        }
-
-        std::string file_name = path.filename().c_str();
-        int64_t file_ts = atol(file_name.c_str());
-        if (file_ts > 0) {
-            files_map.insert(std::make_pair(file_ts, path));
-        }
-    }
+    std::vector<std::string> files;
+    STATUS_CHECK(ListScriptFiles(replay_script_path, files));
 
     // replay the script files
-    for (auto& pair : files_map) {
+    for (auto& file_path : files) {
         ScriptFile file;
-        file.OpenRead(pair.second.c_str());
+        file.OpenRead(file_path);
 
         std::string str_line;
         while (file.ReadLine(str_line)) {
@@ -58,6 +42,41 @@ ScriptReplay::Replay(const DBPtr& db, const std::string& replay_script_path) {
     return Status::OK();
 }
 
+Status
+ScriptReplay::ListScriptFiles(const std::string& replay_script_path, std::vector<std::string>& files) {
+    // get all script files under this folder, arrange them in ascending order
+    std::map<int64_t, std::experimental::filesystem::path> files_map;
+
+    try {
+        using DirectoryIterator = std::experimental::filesystem::recursive_directory_iterator;
+        DirectoryIterator iter(replay_script_path);
+        DirectoryIterator end;
+        for (; iter != end; ++iter) {
+            auto path = (*iter).path();
+            if (std::experimental::filesystem::is_directory(path)) {
+                continue;
+            }
+
+            std::string file_name = path.filename().c_str();
+            int64_t file_ts = atol(file_name.c_str());
+            if (file_ts > 0) {
+                files_map.insert(std::make_pair(file_ts, path));
+            }
+        }
+    } catch (std::exception& ex) {
+        std::string msg = "Failed to list script files, reason: " + std::string(ex.what());
+        LOG_SERVER_ERROR_ << msg;
+        return Status(DB_ERROR, msg);
+    }
+
+    files.clear();
+    for (auto& pair : files_map) {
+        files.emplace_back(pair.second.c_str());
+    }
+
+    return Status::OK();
+}
+
 Status
 ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
     try {
@@ -66,58 +85,72 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
         int64_t action_ts = 0;
         ScriptCodec::DecodeAction(json_obj, action_type, action_ts);
 
+        // the replay goes on even if db operation failed
+        Status db_status;
+        return PerformAction(db, json_obj, action_type, db_status);
+    } catch (std::exception& ex) {
+        std::string msg = "Failed to perform script action, reason: " + std::string(ex.what());
+        LOG_SERVER_ERROR_ << msg;
+        return Status(DB_ERROR, msg);
+    }
+}
+
+Status
+ScriptReplay::PerformAction(const DBPtr& db, milvus::json& json_obj, const std::string& action_type,
+                            Status& db_status) {
+    try {
         if (action_type == ActionCreateCollection) {
             snapshot::CreateCollectionContext context;
             ScriptCodec::Decode(json_obj, context);
 
-            db->CreateCollection(context);
+            db_status = db->CreateCollection(context);
         } else if (action_type == ActionDropCollection) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
 
-            db->DropCollection(collection_name);
+            db_status = db->DropCollection(collection_name);
         } else if (action_type == ActionHasCollection) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
 
             bool has = false;
-            db->HasCollection(collection_name, has);
+            db_status = db->HasCollection(collection_name, has);
         } else if (action_type == ActionListCollections) {
             std::vector<std::string> names;
-            db->ListCollections(names);
+            db_status = db->ListCollections(names);
         } else if (action_type == ActionGetCollectionInfo) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
 
             snapshot::CollectionPtr collection;
             snapshot::FieldElementMappings fields_schema;
-            db->GetCollectionInfo(collection_name, collection, fields_schema);
+            db_status = db->GetCollectionInfo(collection_name, collection, fields_schema);
         } else if (action_type == ActionGetCollectionStats) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
 
             milvus::json collection_stats;
-            db->GetCollectionStats(collection_name, collection_stats);
+            db_status = db->GetCollectionStats(collection_name, collection_stats);
         } else if (action_type == ActionCountEntities) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
 
             int64_t count = 0;
-            db->CountEntities(collection_name, count);
+            db_status = db->CountEntities(collection_name, count);
         } else if (action_type == ActionCreatePartition) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
             std::string partition_name;
             ScriptCodec::DecodePartitionName(json_obj, partition_name);
 
-            db->CreatePartition(collection_name, partition_name);
+            db_status = db->CreatePartition(collection_name, partition_name);
         } else if (action_type == ActionDropPartition) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
             std::string partition_name;
             ScriptCodec::DecodePartitionName(json_obj, partition_name);
 
-            db->DropPartition(collection_name, partition_name);
+            db_status = db->DropPartition(collection_name, partition_name);
         } else if (action_type == ActionHasPartition) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
@@ -125,13 +158,13 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
             ScriptCodec::DecodePartitionName(json_obj, partition_name);
 
             bool has = false;
-            db->HasPartition(collection_name, partition_name, has);
+            db_status = db->HasPartition(collection_name, partition_name, has);
         } else if (action_type == ActionListPartitions) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
 
             std::vector<std::string> partition_names;
-            db->ListPartitions(collection_name, partition_names);
+            db_status = db->ListPartitions(collection_name, partition_names);
         } else if (action_type == ActionCreateIndex) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
@@ -141,14 +174,14 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
             ScriptCodec::Decode(json_obj, index);
 
             std::vector<std::string> partition_names;
-            db->CreateIndex(nullptr, collection_name, field_name, index);
+            db_status = db->CreateIndex(nullptr, collection_name, field_name, index);
         } else if (action_type == ActionDropIndex) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
             std::string field_name;
             ScriptCodec::DecodeFieldName(json_obj, field_name);
 
-            db->DropIndex(collection_name, field_name);
+            db_status = db->DropIndex(collection_name, field_name);
         } else if (action_type == ActionDescribeIndex) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
@@ -156,7 +189,7 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
             ScriptCodec::DecodeFieldName(json_obj, field_name);
 
             CollectionIndex index;
-            db->DescribeIndex(collection_name, field_name, index);
+            db_status = db->DescribeIndex(collection_name, field_name, index);
         } else if (action_type == ActionInsert) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
@@ -165,7 +198,7 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
             DataChunkPtr data_chunk;
             ScriptCodec::Decode(json_obj, data_chunk);
 
-            db->Insert(collection_name, partition_name, data_chunk, 0);
+            db_status = db->Insert(collection_name, partition_name, data_chunk, 0);
         } else if (action_type == ActionGetEntityByID) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
@@ -176,14 +209,14 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
 
             std::vector<bool> valid_row;
             DataChunkPtr data_chunk;
-            db->GetEntityByID(collection_name, id_array, field_names, valid_row, data_chunk);
+            db_status = db->GetEntityByID(collection_name, id_array, field_names, valid_row, data_chunk);
         } else if (action_type == ActionDeleteEntityByID) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
             IDNumbers id_array;
             ScriptCodec::Decode(json_obj, id_array);
 
-            db->DeleteEntityByID(collection_name, id_array, 0);
+            db_status = db->DeleteEntityByID(collection_name, id_array, 0);
         } else if (action_type == ActionListIDInSegment) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
@@ -191,14 +224,14 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
             ScriptCodec::DecodeSegmentID(json_obj, segment_id);
 
             IDNumbers entity_ids;
-            db->ListIDInSegment(collection_name, segment_id, entity_ids);
+            db_status = db->ListIDInSegment(collection_name, segment_id, entity_ids);
         } else if (action_type == ActionQuery) {
             query::QueryPtr query_ptr;
             ScriptCodec::Decode(json_obj, query_ptr);
 
             if (query_ptr != nullptr) {
                 engine::QueryResultPtr result;
-                db->Query(nullptr, query_ptr, result);
+                db_status = db->Query(nullptr, query_ptr, result);
             }
         } else if (action_type == ActionLoadCollection) {
             std::string collection_name;
@@ -210,15 +243,15 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
 
             std::vector<bool> valid_row;
             DataChunkPtr data_chunk;
-            db->LoadCollection(nullptr, collection_name, field_names, force);
+            db_status = db->LoadCollection(nullptr, collection_name, field_names, force);
         } else if (action_type == ActionFlush) {
             std::string collection_name;
             ScriptCodec::DecodeCollectionName(json_obj, collection_name);
 
             if (collection_name.empty()) {
-                db->Flush();
+                db_status = db->Flush();
             } else {
-                db->Flush(collection_name);
+                db_status = db->Flush(collection_name);
             }
         } else if (action_type == ActionCompact) {
             std::string collection_name;
@@ -226,7 +259,7 @@ ScriptReplay::PerformAction(const DBPtr& db, const std::string& str_action) {
             double threshold = 0.0;
             ScriptCodec::DecodeThreshold(json_obj, threshold);
 
-            db->Compact(nullptr, collection_name, threshold);
+            db_status = db->Compact(nullptr, collection_name, threshold);
         } else {
             std::string msg = "Unsupportted action: " + action_type;
             LOG_SERVER_ERROR_ << msg;
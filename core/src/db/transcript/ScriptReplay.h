@@ -12,8 +12,10 @@
 #pragma once
 
 #include "db/DB.h"
+#include "utils/Json.h"
 
 #include <string>
+#include <vector>
 
 namespace milvus {
 namespace engine {
@@ -25,6 +27,14 @@ class ScriptReplay {
     Status
     Replay(const DBPtr& db, const std::string& replay_script_path);
 
+    // list script files under the folder, in ascending order of file timestamp
+    static Status
+    ListScriptFiles(const std::string& replay_script_path, std::vector<std::string>& files);
+
+    // perform a decoded action, the status returned by db is passed out by db_status
+    static Status
+    PerformAction(const DBPtr& db, milvus::json& json_obj, const std::string& action_type, Status& db_status);
+
  private:
     Status
     PerformAction(const DBPtr& db, const std::string& str_action);
@@ -15,6 +15,9 @@
 #include "utils/CommonUtil.h"
 #include "utils/Log.h"
 
+#include <errno.h>
+#include <limits.h>
+#include <algorithm>
 #include <experimental/filesystem>
 #include <limits>
 
@@ -87,6 +90,46 @@ WalFile::ExceedMaxSize(int64_t append_size) {
     return (file_size_ + append_size) > MAX_WAL_FILE_SIZE;
 }
 
+int64_t
+WalFile::WriteV(const std::vector<struct iovec>& pieces) {
+    if (file_ == nullptr || mode_ == OpenMode::READ || pieces.empty()) {
+        return 0;
+    }
+
+    // makesure data buffered by fwrite() is ahead of this batch
+    fflush(file_);
+    int fd = fileno(file_);
+
+    std::vector<struct iovec> vecs(pieces);
+    size_t begin = 0;
+    int64_t total_bytes = 0;
+    while (begin < vecs.size()) {
+        int count = static_cast<int>(std::min<size_t>(vecs.size() - begin, IOV_MAX));
+        ssize_t bytes = writev(fd, vecs.data() + begin, count);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ENGINE_ERROR_ << "Failed to write wal file: " << file_path_ << ", errno: " << errno;
+            break;
+        }
+        total_bytes += bytes;
+
+        // skip written pieces, the partially written piece is adjusted for next writev()
+        while (begin < vecs.size() && bytes >= static_cast<ssize_t>(vecs[begin].iov_len)) {
+            bytes -= vecs[begin].iov_len;
+            ++begin;
+        }
+        if (bytes > 0) {
+            vecs[begin].iov_base = reinterpret_cast<char*>(vecs[begin].iov_base) + bytes;
+            vecs[begin].iov_len -= bytes;
+        }
+    }
+
+    file_size_ += total_bytes;
+    return total_bytes;
+}
+
 Status
 WalFile::ReadLastOpId(idx_t& op_id) {
     op_id = std::numeric_limits<idx_t>::max();
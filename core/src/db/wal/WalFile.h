@@ -14,11 +14,13 @@
 #include "db/Types.h"
 #include "utils/Status.h"
 
+#include <sys/uio.h>
 #include <unistd.h>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace milvus {
 namespace engine {
@@ -71,6 +73,10 @@ class WalFile {
         return bytes;
     }
 
+    // write a batch of pieces by writev(), return total written bytes
+    int64_t
+    WriteV(const std::vector<struct iovec>& pieces);
+
     template <typename T>
     inline int64_t
     Read(T* value) {
@@ -108,11 +114,11 @@ class WalFile {
     inline void
     Flush() {
         if (file_ && mode_ != OpenMode::READ) {
+            fflush(file_);
             if (sync_) {
+                // wal file is append only, fdatasync() also persists the file size
                 int fd = fileno(file_);
-                fsync(fd);
-            } else {
-                fflush(file_);
+                fdatasync(fd);
             }
         }
     }
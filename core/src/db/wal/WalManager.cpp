@@ -10,12 +10,12 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include "db/wal/WalManager.h"
-#include "db/Utils.h"
 #include "db/wal/WalOperationCodec.h"
 #include "utils/CommonUtil.h"
 #include "utils/Log.h"
 #include "value/config/ServerConfig.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <utility>
@@ -64,6 +64,10 @@ FindWalFiles(const std::experimental::filesystem::path& folder,
 WalManager::WalManager() : cleanup_thread_pool_(1, 1) {
 }
 
+WalManager::~WalManager() {
+    StopWriterThread();
+}
+
 WalManager&
 WalManager::GetInstance() {
     static WalManager s_mgr;
@@ -84,6 +88,8 @@ WalManager::Start(const DBOptions& options) {
         return status;
     }
 
+    StartWriterThread();
+
     LOG_ENGINE_DEBUG_ << "WalManager started";
 
     return Status::OK();
@@ -91,6 +97,8 @@ WalManager::Start(const DBOptions& options) {
 
 Status
 WalManager::Stop() {
+    StopWriterThread();
+
     {
         std::lock_guard<std::mutex> lock(file_map_mutex_);
         file_map_.clear();
@@ -317,29 +325,12 @@ WalManager::RecordInsertOperation(const InsertEntityOperationPtr& operation, con
     idx_t op_id = id_gen_.GetNextIDNumber();
     operation->SetID(op_id);
 
-    DataChunkPtr& chunk = operation->data_chunk_;
-    int64_t chunk_size = utils::GetSizeOfChunk(chunk);
-
     try {
-        // open wal file
-        std::string path = ConstructFilePath(operation->collection_name_, std::to_string(op_id));
-        if (!path.empty()) {
-            std::lock_guard<std::mutex> lock(file_map_mutex_);
-            WalFilePtr file = file_map_[operation->collection_name_];
-            if (file == nullptr) {
-                file = std::make_shared<WalFile>(sync_mode_);
-                file_map_[operation->collection_name_] = file;
-                file->OpenFile(path, WalFile::APPEND_WRITE);
-            } else if (!file->IsOpened() || file->ExceedMaxSize(chunk_size)) {
-                file->OpenFile(path, WalFile::APPEND_WRITE);
-            }
-
-            // write to wal file
-            auto status = WalOperationCodec::WriteInsertOperation(file, operation->partition_name, chunk, op_id);
-            if (!status.ok()) {
-                return status;
-            }
-        }
+        // the record references data of the operation, it is alive until the record is committed
+        WalRecord record(operation->collection_name_, op_id);
+        STATUS_CHECK(
+            WalOperationCodec::EncodeInsertOperation(operation->partition_name, operation->data_chunk_, op_id, record));
+        STATUS_CHECK(CommitRecord(record));
     } catch (std::exception& ex) {
         std::string msg = "Failed to record insert operation, reason: " + std::string(ex.what());
         return Status(DB_ERROR, msg);
@@ -360,28 +351,11 @@ Status
 WalManager::RecordDeleteOperation(const DeleteEntityOperationPtr& operation, const DBPtr& db) {
     idx_t op_id = id_gen_.GetNextIDNumber();
     operation->SetID(op_id);
-    int64_t append_size = operation->entity_ids_.size() * sizeof(idx_t);
 
-    // open wal file
     try {
-        std::string path = ConstructFilePath(operation->collection_name_, std::to_string(op_id));
-        if (!path.empty()) {
-            std::lock_guard<std::mutex> lock(file_map_mutex_);
-            WalFilePtr file = file_map_[operation->collection_name_];
-            if (file == nullptr) {
-                file = std::make_shared<WalFile>(sync_mode_);
-                file_map_[operation->collection_name_] = file;
-                file->OpenFile(path, WalFile::APPEND_WRITE);
-            } else if (!file->IsOpened() || file->ExceedMaxSize(append_size)) {
-                file->OpenFile(path, WalFile::APPEND_WRITE);
-            }
-
-            // write to wal file
-            auto status = WalOperationCodec::WriteDeleteOperation(file, operation->entity_ids_, op_id);
-            if (!status.ok()) {
-                return status;
-            }
-        }
+        WalRecord record(operation->collection_name_, op_id);
+        STATUS_CHECK(WalOperationCodec::EncodeDeleteOperation(operation->entity_ids_, op_id, record));
+        STATUS_CHECK(CommitRecord(record));
     } catch (std::exception& ex) {
         std::string msg = "Failed to record delete operation, reason: " + std::string(ex.what());
         return Status(DB_ERROR, msg);
@@ -395,6 +369,203 @@ WalManager::RecordDeleteOperation(const DeleteEntityOperationPtr& operation, con
     return Status::OK();
 }
 
+Status
+WalManager::CommitRecord(WalRecord& record) {
+    // the producer is counted before checking the running flag, StopWriterThread() clears the flag first and
+    // then waits for counted producers, so a record is either rejected here or pushed before the final drain
+    pushing_producers_.fetch_add(1);
+    if (!writer_running_) {
+        pushing_producers_.fetch_sub(1);
+        return Status(DB_ERROR, "Wal writer is not running");
+    }
+
+    WalRecord* head = pending_records_.load(std::memory_order_relaxed);
+    do {
+        record.next_ = head;
+    } while (!pending_records_.compare_exchange_weak(head, &record, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+
+    // only the first record of a batch need to wake up the writer
+    if (head == nullptr) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        writer_cv_.notify_one();
+    }
+    pushing_producers_.fetch_sub(1);
+
+    return record.WaitCommit();
+}
+
+void
+WalManager::StartWriterThread() {
+    if (writer_running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        writer_stop_ = false;
+    }
+    writer_thread_ = std::thread(&WalManager::WriterThread, this);
+    writer_running_ = true;
+}
+
+void
+WalManager::StopWriterThread() {
+    if (!writer_running_) {
+        return;
+    }
+
+    writer_running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        writer_stop_ = true;
+        writer_cv_.notify_one();
+    }
+    writer_thread_.join();
+
+    // records pushed after the writer exited are not written, keep draining until no producer is pushing
+    while (true) {
+        bool idle = (pushing_producers_.load() == 0);
+        RejectPendingRecords();
+        if (idle) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void
+WalManager::RejectPendingRecords() {
+    WalRecord* head = pending_records_.exchange(nullptr, std::memory_order_acquire);
+    for (WalRecord* record = head; record != nullptr;) {
+        WalRecord* next = record->next_;
+        record->Commit(Status(DB_ERROR, "Wal writer is stopped"));
+        record = next;
+    }
+}
+
+void
+WalManager::WriterThread() {
+    SetThreadName("wal_writer");
+
+    while (true) {
+        bool stop = false;
+        {
+            std::unique_lock<std::mutex> lock(writer_mutex_);
+            writer_cv_.wait(lock, [&] { return pending_records_.load() != nullptr || writer_stop_; });
+            stop = writer_stop_;
+        }
+
+        // records arrived while the previous batch was being synced are committed together
+        WalRecord* head = pending_records_.exchange(nullptr, std::memory_order_acquire);
+        if (head == nullptr) {
+            if (stop) {
+                break;
+            }
+            continue;
+        }
+
+        std::vector<WalRecord*> records;
+        for (WalRecord* record = head; record != nullptr; record = record->next_) {
+            records.push_back(record);
+        }
+        CommitBatch(records);
+    }
+}
+
+void
+WalManager::CommitBatch(std::vector<WalRecord*>& records) {
+    // records of a collection are written in operation id order, so the last id of a wal file is its max id
+    std::sort(records.begin(), records.end(), [](const WalRecord* a, const WalRecord* b) {
+        if (a->CollectionName() != b->CollectionName()) {
+            return a->CollectionName() < b->CollectionName();
+        }
+        return a->OpID() < b->OpID();
+    });
+
+    std::vector<Status> statuses;
+    auto begin = records.begin();
+    while (begin != records.end()) {
+        auto end = begin;
+        while (end != records.end() && (*end)->CollectionName() == (*begin)->CollectionName()) {
+            ++end;
+        }
+
+        Status status;
+        try {
+            status = WriteCollectionRecords((*begin)->CollectionName(), begin, end);
+        } catch (std::exception& ex) {
+            status = Status(DB_ERROR, "Failed to write wal, reason: " + std::string(ex.what()));
+        }
+        if (!status.ok()) {
+            LOG_ENGINE_ERROR_ << "Failed to commit wal records: " << status.message();
+        }
+        statuses.insert(statuses.end(), end - begin, status);
+        begin = end;
+    }
+
+    // each producer is woken up by its own record
+    for (size_t i = 0; i < records.size(); ++i) {
+        records[i]->Commit(statuses[i]);
+    }
+}
+
+WalManager::CollectionWalPtr
+WalManager::GetCollectionWal(const std::string& collection_name) {
+    std::lock_guard<std::mutex> lock(file_map_mutex_);
+    auto& wal = file_map_[collection_name];
+    if (wal == nullptr) {
+        wal = std::make_shared<CollectionWal>();
+    }
+    return wal;
+}
+
+Status
+WalManager::WriteCollectionRecords(const std::string& collection_name, std::vector<WalRecord*>::iterator begin,
+                                   std::vector<WalRecord*>::iterator end) {
+    auto wal = GetCollectionWal(collection_name);
+    std::lock_guard<std::mutex> lock(wal->mutex_);
+    WalFilePtr& file = wal->file_;
+
+    std::vector<struct iovec> pieces;
+    int64_t batch_bytes = 0;
+    auto flush_pieces = [&]() -> Status {
+        if (pieces.empty()) {
+            return Status::OK();
+        }
+
+        int64_t bytes = file->WriteV(pieces);
+        file->Flush();
+        if (bytes != batch_bytes) {
+            return Status(DB_ERROR, "Failed to write wal file: " + file->Path());
+        }
+
+        pieces.clear();
+        batch_bytes = 0;
+        return Status::OK();
+    };
+
+    for (auto iter = begin; iter != end; ++iter) {
+        WalRecord* record = *iter;
+        if (file == nullptr || !file->IsOpened() || file->ExceedMaxSize(batch_bytes + record->Bytes())) {
+            STATUS_CHECK(flush_pieces());
+
+            // the wal file is named by the first operation id
+            if (file == nullptr) {
+                file = std::make_shared<WalFile>(sync_mode_);
+            }
+            std::string path = ConstructFilePath(collection_name, std::to_string(record->OpID()));
+            STATUS_CHECK(file->OpenFile(path, WalFile::APPEND_WRITE));
+        }
+
+        auto& record_pieces = record->Pieces();
+        pieces.insert(pieces.end(), record_pieces.begin(), record_pieces.end());
+        batch_bytes += record->Bytes();
+    }
+
+    return flush_pieces();
+}
+
 std::string
 WalManager::ConstructFilePath(const std::string& collection_name, const std::string& file_name) {
     // typically, the wal file path is like: /xxx/milvus/wal/[collection_name]/xxxxxxxxxx
@@ -487,10 +658,20 @@ WalManager::CleanupThread() {
             // clean opened file in buffer
             {
                 std::lock_guard<std::mutex> lock(file_map_mutex_);
-                file_map_.erase(target_collection);
+                CollectionWalPtr wal;
+                auto iter = file_map_.find(target_collection);
+                if (iter != file_map_.end()) {
+                    wal = iter->second;
+                    file_map_.erase(iter);
+                }
 
                 // remove collection folder
-                // do this under the lock to avoid multi-thread conflict
+                // do this under the locks to avoid multi-thread conflict
+                std::unique_lock<std::mutex> wal_lock;
+                if (wal != nullptr) {
+                    wal_lock = std::unique_lock<std::mutex>(wal->mutex_);
+                    wal->file_ = nullptr;
+                }
                 std::experimental::filesystem::remove_all(collection_path);
                 LOG_ENGINE_DEBUG_ << "WAL cleanup: " << collection_path;
             }
@@ -530,12 +711,19 @@ WalManager::CleanupThread() {
 
                 // makesure wal file is closed
                 {
-                    std::lock_guard<std::mutex> lock(file_map_mutex_);
-                    WalFilePtr file = file_map_[target_collection];
-                    if (file) {
-                        if (file->Path() == pair.second) {
-                            file->CloseFile();
-                            file_map_.erase(target_collection);
+                    CollectionWalPtr wal;
+                    {
+                        std::lock_guard<std::mutex> lock(file_map_mutex_);
+                        auto iter = file_map_.find(target_collection);
+                        if (iter != file_map_.end()) {
+                            wal = iter->second;
+                        }
+                    }
+                    if (wal != nullptr) {
+                        std::lock_guard<std::mutex> lock(wal->mutex_);
+                        if (wal->file_ && wal->file_->Path() == pair.second) {
+                            wal->file_->CloseFile();
+                            wal->file_ = nullptr;
                         }
                     }
                 }
@@ -16,13 +16,17 @@
 #include "db/Types.h"
 #include "db/wal/WalFile.h"
 #include "db/wal/WalOperation.h"
+#include "db/wal/WalRecord.h"
 #include "utils/Status.h"
 #include "utils/ThreadPool.h"
 #include "value/config/ServerConfig.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +43,8 @@ class WalManager {
     static WalManager&
     GetInstance();
 
+    ~WalManager();
+
     Status
     Start(const DBOptions& options);
 
@@ -63,6 +69,14 @@ class WalManager {
     GetMaxOperationID(const std::string& collection_name);
 
  private:
+    // the wal file of a collection is guarded by its own lock, the map lock is only held for lookup
+    struct CollectionWal {
+        std::mutex mutex_;
+        WalFilePtr file_;
+    };
+    using CollectionWalPtr = std::shared_ptr<CollectionWal>;
+    using WalFileMap = std::unordered_map<std::string, CollectionWalPtr>;
+
     WalManager();
 
     Status
@@ -74,6 +88,33 @@ class WalManager {
     Status
     RecordDeleteOperation(const DeleteEntityOperationPtr& operation, const DBPtr& db);
 
+    // put the record into pending list and wait until the writer thread commits it
+    Status
+    CommitRecord(WalRecord& record);
+
+    void
+    StartWriterThread();
+
+    void
+    StopWriterThread();
+
+    void
+    WriterThread();
+
+    void
+    CommitBatch(std::vector<WalRecord*>& records);
+
+    // commit the records left in pending list with error
+    void
+    RejectPendingRecords();
+
+    CollectionWalPtr
+    GetCollectionWal(const std::string& collection_name);
+
+    Status
+    WriteCollectionRecords(const std::string& collection_name, std::vector<WalRecord*>::iterator begin,
+                           std::vector<WalRecord*>::iterator end);
+
     std::string
     ConstructFilePath(const std::string& collection_name, const std::string& file_name);
 
@@ -103,10 +144,19 @@ class WalManager {
     std::string wal_path_;
     int64_t insert_buffer_size_ = 0;
 
-    using WalFileMap = std::unordered_map<std::string, WalFilePtr>;
     WalFileMap file_map_;  // mapping collection name to file
     std::mutex file_map_mutex_;
 
+    // group commit: producers push records into a lock-free list, the writer thread takes all pending records
+    // and writes them by one writev() and one fdatasync() for each collection
+    std::atomic<WalRecord*> pending_records_{nullptr};
+    std::atomic<bool> writer_running_{false};
+    std::atomic<int64_t> pushing_producers_{0};  // producers between the running check and the push
+    std::thread writer_thread_;
+    bool writer_stop_ = false;
+    std::mutex writer_mutex_;
+    std::condition_variable writer_cv_;
+
     using MaxOpIdMap = std::unordered_map<std::string, idx_t>;
     MaxOpIdMap max_op_id_map_;  // mapping collection name to max operation id
     std::mutex max_op_mutex_;
@@ -27,131 +27,146 @@ WalOperationCodec::WriteInsertOperation(const WalFilePtr& file, const std::strin
     }
 
     TimeRecorderAuto rc("WAL::WriteInsertOperation");
-    try {
-        // calculate total bytes, it must equal to total_bytes
-        int64_t calculate_total_bytes = 0;
-        calculate_total_bytes += sizeof(int32_t);        // operation type
-        calculate_total_bytes += sizeof(idx_t);          // operation id
-        calculate_total_bytes += sizeof(int64_t);        // calculated total bytes
-        calculate_total_bytes += sizeof(int32_t);        // partition name length
-        calculate_total_bytes += partition_name.size();  // partition name
-        calculate_total_bytes += sizeof(int64_t);        // chunk entity count
-        calculate_total_bytes += sizeof(int32_t);        // fixed field count
-        for (auto& pair : chunk->fixed_fields_) {
-            calculate_total_bytes += sizeof(int32_t);    // field name length
-            calculate_total_bytes += pair.first.size();  // field name
-
-            calculate_total_bytes += sizeof(int64_t);            // data size
-            calculate_total_bytes += pair.second->data_.size();  // data
-        }
-        calculate_total_bytes += sizeof(idx_t);  // operation id again
+    WalRecord record("", op_id);
+    STATUS_CHECK(EncodeInsertOperation(partition_name, chunk, op_id, record));
+    return WriteRecord(file, record);
+}
 
-        int64_t total_bytes = 0;
-        // write operation type
-        int32_t type = WalOperationType::INSERT_ENTITY;
-        total_bytes += file->Write<int32_t>(&type);
+Status
+WalOperationCodec::WriteDeleteOperation(const WalFilePtr& file, const IDNumbers& entity_ids, idx_t op_id) {
+    if (file == nullptr || !file->IsOpened() || entity_ids.empty()) {
+        return Status(DB_ERROR, "Invalid input for write delete operation");
+    }
 
-        // write operation id
-        total_bytes += file->Write<idx_t>(&op_id);
+    TimeRecorderAuto rc("WAL::WriteDeleteOperation");
+    WalRecord record("", op_id);
+    STATUS_CHECK(EncodeDeleteOperation(entity_ids, op_id, record));
+    return WriteRecord(file, record);
+}
 
-        // write calculated total bytes
-        total_bytes += file->Write<int64_t>(&calculate_total_bytes);
+Status
+WalOperationCodec::EncodeInsertOperation(const std::string& partition_name, const DataChunkPtr& chunk, idx_t op_id,
+                                         WalRecord& record) {
+    if (chunk == nullptr) {
+        return Status(DB_ERROR, "Invalid input for encode insert operation");
+    }
 
-        // write partition name
-        int32_t part_name_length = partition_name.size();
-        total_bytes += file->Write<int32_t>(&part_name_length);
-        if (part_name_length > 0) {
-            total_bytes += file->Write(partition_name.data(), part_name_length);
+    // calculate total bytes, it must equal to record bytes
+    int64_t calculate_total_bytes = 0;
+    calculate_total_bytes += sizeof(int32_t);        // operation type
+    calculate_total_bytes += sizeof(idx_t);          // operation id
+    calculate_total_bytes += sizeof(int64_t);        // calculated total bytes
+    calculate_total_bytes += sizeof(int32_t);        // partition name length
+    calculate_total_bytes += partition_name.size();  // partition name
+    calculate_total_bytes += sizeof(int64_t);        // chunk entity count
+    calculate_total_bytes += sizeof(int32_t);        // fixed field count
+    for (auto& pair : chunk->fixed_fields_) {
+        calculate_total_bytes += sizeof(int32_t);    // field name length
+        calculate_total_bytes += pair.first.size();  // field name
+
+        calculate_total_bytes += sizeof(int64_t);            // data size
+        calculate_total_bytes += pair.second->data_.size();  // data
+    }
+    calculate_total_bytes += sizeof(idx_t);  // operation id again
+
+    // operation type, operation id, calculated total bytes
+    int32_t type = WalOperationType::INSERT_ENTITY;
+    record.AppendValue<int32_t>(type);
+    record.AppendValue<idx_t>(op_id);
+    record.AppendValue<int64_t>(calculate_total_bytes);
+
+    // partition name
+    int32_t part_name_length = partition_name.size();
+    record.AppendValue<int32_t>(part_name_length);
+    record.AppendMeta(partition_name.data(), part_name_length);
+
+    // chunk entity count
+    record.AppendValue<int64_t>(chunk->count_);
+
+    // fixed data, the field data is referenced by the record, not copied
+    int32_t field_count = chunk->fixed_fields_.size();
+    record.AppendValue<int32_t>(field_count);
+    for (auto& pair : chunk->fixed_fields_) {
+        if (pair.second == nullptr) {
+            continue;
         }
 
-        // write chunk entity count
-        total_bytes += file->Write<int64_t>(&(chunk->count_));
-
-        // write fixed data
-        int32_t field_count = chunk->fixed_fields_.size();
-        total_bytes += file->Write<int32_t>(&field_count);
-        for (auto& pair : chunk->fixed_fields_) {
-            if (pair.second == nullptr) {
-                continue;
-            }
-
-            int32_t field_name_length = pair.first.size();
-            total_bytes += file->Write<int32_t>(&field_name_length);
-            total_bytes += file->Write(pair.first.data(), field_name_length);
+        int32_t field_name_length = pair.first.size();
+        record.AppendValue<int32_t>(field_name_length);
+        record.AppendMeta(pair.first.data(), field_name_length);
 
-            int64_t data_size = pair.second->data_.size();
-            total_bytes += file->Write<int64_t>(&data_size);
-            total_bytes += file->Write(pair.second->data_.data(), data_size);
-        }
+        int64_t data_size = pair.second->data_.size();
+        record.AppendValue<int64_t>(data_size);
+        record.AppendData(pair.second->data_.data(), data_size);
+    }
 
-        // TODO: write variable data
+    // TODO: write variable data
 
-        // write operation id again
-        // Note: makesure operation id is written at end, so that wal cleanup thread know which file can be deleted
-        total_bytes += file->Write<idx_t>(&op_id);
+    // operation id again
+    // Note: makesure operation id is written at end, so that wal cleanup thread know which file can be deleted
+    record.AppendValue<idx_t>(op_id);
 
-        // flush to system buffer
-        file->Flush();
-
-        if (total_bytes != calculate_total_bytes) {
-            LOG_ENGINE_ERROR_ << "wal serialize(insert) bytes " << total_bytes << " not equal "
-                              << calculate_total_bytes;
-        }
-    } catch (std::exception& ex) {
-        std::string msg = "Failed to write insert operation, reason: " + std::string(ex.what());
-        return Status(DB_ERROR, msg);
+    if (record.Bytes() != calculate_total_bytes) {
+        LOG_ENGINE_ERROR_ << "wal serialize(insert) bytes " << record.Bytes() << " not equal "
+                          << calculate_total_bytes;
     }
 
     return Status::OK();
 }
 
 Status
-WalOperationCodec::WriteDeleteOperation(const WalFilePtr& file, const IDNumbers& entity_ids, idx_t op_id) {
-    if (file == nullptr || !file->IsOpened() || entity_ids.empty()) {
-        return Status(DB_ERROR, "Invalid input for write delete operation");
+WalOperationCodec::EncodeDeleteOperation(const IDNumbers& entity_ids, idx_t op_id, WalRecord& record) {
+    if (entity_ids.empty()) {
+        return Status(DB_ERROR, "Invalid input for encode delete operation");
     }
 
-    TimeRecorderAuto rc("WAL::WriteDeleteOperation");
-    try {
-        // calculate total bytes, it must equal to total_bytes
-        int64_t calculate_total_bytes = 0;
-        calculate_total_bytes += sizeof(int32_t);                    // operation type
-        calculate_total_bytes += sizeof(idx_t);                      // operation id
-        calculate_total_bytes += sizeof(int64_t);                    // calculated total bytes
-        calculate_total_bytes += sizeof(int64_t);                    // id count
-        calculate_total_bytes += entity_ids.size() * sizeof(idx_t);  // ids
-        calculate_total_bytes += sizeof(idx_t);                      // operation id again
-
-        int64_t total_bytes = 0;
-        // write operation type
-        int32_t type = WalOperationType::DELETE_ENTITY;
-        total_bytes += file->Write<int32_t>(&type);
-
-        // write operation id
-        total_bytes += file->Write<idx_t>(&op_id);
-
-        // write calculated total bytes
-        total_bytes += file->Write<int64_t>(&calculate_total_bytes);
-
-        // write entity ids
-        int64_t id_count = entity_ids.size();
-        total_bytes += file->Write<int64_t>(&id_count);
+    // calculate total bytes, it must equal to record bytes
+    int64_t calculate_total_bytes = 0;
+    calculate_total_bytes += sizeof(int32_t);                    // operation type
+    calculate_total_bytes += sizeof(idx_t);                      // operation id
+    calculate_total_bytes += sizeof(int64_t);                    // calculated total bytes
+    calculate_total_bytes += sizeof(int64_t);                    // id count
+    calculate_total_bytes += entity_ids.size() * sizeof(idx_t);  // ids
+    calculate_total_bytes += sizeof(idx_t);                      // operation id again
+
+    // operation type, operation id, calculated total bytes
+    int32_t type = WalOperationType::DELETE_ENTITY;
+    record.AppendValue<int32_t>(type);
+    record.AppendValue<idx_t>(op_id);
+    record.AppendValue<int64_t>(calculate_total_bytes);
+
+    // entity ids
+    int64_t id_count = entity_ids.size();
+    record.AppendValue<int64_t>(id_count);
+    record.AppendData(entity_ids.data(), id_count * sizeof(idx_t));
+
+    // operation id again
+    // Note: makesure operation id is written at end, so that wal cleanup thread know which file can be deleted
+    record.AppendValue<idx_t>(op_id);
+
+    if (record.Bytes() != calculate_total_bytes) {
+        LOG_ENGINE_ERROR_ << "wal serialize(delete) bytes " << record.Bytes() << " not equal "
+                          << calculate_total_bytes;
+    }
 
-        total_bytes += file->Write(entity_ids.data(), id_count * sizeof(idx_t));
+    return Status::OK();
+}
 
-        // write operation id again
-        // Note: makesure operation id is written at end, so that wal cleanup thread know which file can be deleted
-        total_bytes += file->Write<idx_t>(&op_id);
+Status
+WalOperationCodec::WriteRecord(const WalFilePtr& file, WalRecord& record) {
+    try {
+        int64_t bytes = file->WriteV(record.Pieces());
 
         // flush to system buffer
         file->Flush();
 
-        if (total_bytes != calculate_total_bytes) {
-            LOG_ENGINE_ERROR_ << "wal serialize(delete) bytes " << total_bytes << " not equal "
-                              << calculate_total_bytes;
+        if (bytes != record.Bytes()) {
+            std::string msg = "Failed to write wal file: " + file->Path();
+            LOG_ENGINE_ERROR_ << msg;
+            return Status(DB_ERROR, msg);
         }
     } catch (std::exception& ex) {
-        std::string msg = "Failed to write insert operation, reason: " + std::string(ex.what());
+        std::string msg = "Failed to write wal operation, reason: " + std::string(ex.what());
         return Status(DB_ERROR, msg);
     }
 
@@ -15,6 +15,7 @@
 
 #include "db/wal/WalFile.h"
 #include "db/wal/WalOperation.h"
+#include "db/wal/WalRecord.h"
 #include "utils/Status.h"
 
 namespace milvus {
@@ -29,6 +30,17 @@ class WalOperationCodec {
     static Status
     WriteDeleteOperation(const WalFilePtr& file, const IDNumbers& entity_ids, idx_t op_id);
 
+    // encode operation into a record, the record references data of chunk/entity_ids
+    static Status
+    EncodeInsertOperation(const std::string& partition_name, const DataChunkPtr& chunk, idx_t op_id,
+                          WalRecord& record);
+
+    static Status
+    EncodeDeleteOperation(const IDNumbers& entity_ids, idx_t op_id, WalRecord& record);
+
+    static Status
+    WriteRecord(const WalFilePtr& file, WalRecord& record);
+
     static Status
     IterateOperation(const WalFilePtr& file, WalOperationPtr& operation, idx_t from_op_id);
 };
@@ -0,0 +1,92 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "db/wal/WalRecord.h"
+
+namespace milvus {
+namespace engine {
+
+WalRecord::WalRecord(const std::string& collection_name, idx_t op_id)
+    : collection_name_(collection_name), op_id_(op_id) {
+}
+
+void
+WalRecord::AppendMeta(const void* data, int64_t length) {
+    if (data == nullptr || length <= 0) {
+        return;
+    }
+
+    // adjacent meta values are merged into one piece
+    if (!layout_.empty() && layout_.back().data_ == nullptr) {
+        layout_.back().length_ += length;
+    } else {
+        Piece piece;
+        piece.offset_ = meta_.size();
+        piece.length_ = length;
+        layout_.push_back(piece);
+    }
+    meta_.append(reinterpret_cast<const char*>(data), length);
+    bytes_ += length;
+    pieces_.clear();
+}
+
+void
+WalRecord::AppendData(const void* data, int64_t length) {
+    if (data == nullptr || length <= 0) {
+        return;
+    }
+
+    Piece piece;
+    piece.data_ = data;
+    piece.length_ = length;
+    layout_.push_back(piece);
+    bytes_ += length;
+    pieces_.clear();
+}
+
+const std::vector<struct iovec>&
+WalRecord::Pieces() {
+    // meta_ could be reallocated while appending, the addresses are resolved at the end
+    if (pieces_.empty()) {
+        pieces_.reserve(layout_.size());
+        for (auto& piece : layout_) {
+            struct iovec vec;
+            if (piece.data_ == nullptr) {
+                vec.iov_base = const_cast<char*>(meta_.data() + piece.offset_);
+            } else {
+                vec.iov_base = const_cast<void*>(piece.data_);
+            }
+            vec.iov_len = piece.length_;
+            pieces_.push_back(vec);
+        }
+    }
+
+    return pieces_;
+}
+
+void
+WalRecord::Commit(const Status& status) {
+    // notify under the lock, the waiter can't return and destroy the record before the notification is done
+    std::lock_guard<std::mutex> lock(commit_mutex_);
+    status_ = status;
+    committed_ = true;
+    commit_cv_.notify_one();
+}
+
+Status
+WalRecord::WaitCommit() {
+    std::unique_lock<std::mutex> lock(commit_mutex_);
+    commit_cv_.wait(lock, [&] { return committed_; });
+    return status_;
+}
+
+}  // namespace engine
+}  // namespace milvus
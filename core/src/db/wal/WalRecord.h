@@ -0,0 +1,98 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "db/Types.h"
+#include "utils/Status.h"
+
+#include <sys/uio.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace milvus {
+namespace engine {
+
+// an encoded wal operation, written into wal file as a list of pieces by writev()
+// small values are copied into the record, large payloads(entity data, entity ids) are only referenced,
+// so the referenced data must stay alive until the record is committed
+class WalRecord {
+ public:
+    WalRecord(const std::string& collection_name, idx_t op_id);
+
+    template <typename T>
+    inline void
+    AppendValue(const T& value) {
+        AppendMeta(&value, sizeof(T));
+    }
+
+    void
+    AppendMeta(const void* data, int64_t length);
+
+    void
+    AppendData(const void* data, int64_t length);
+
+    const std::vector<struct iovec>&
+    Pieces();
+
+    int64_t
+    Bytes() const {
+        return bytes_;
+    }
+
+    idx_t
+    OpID() const {
+        return op_id_;
+    }
+
+    const std::string&
+    CollectionName() const {
+        return collection_name_;
+    }
+
+    // called by the committer, only the producer of this record is woken up
+    // the record may be destroyed by the producer as soon as this returns
+    void
+    Commit(const Status& status);
+
+    // wait until the record is committed, return the commit status
+    Status
+    WaitCommit();
+
+ public:
+    // maintained by WalManager
+    WalRecord* next_ = nullptr;  // link of pending records
+
+ private:
+    struct Piece {
+        const void* data_ = nullptr;  // nullptr means the piece is stored in meta_
+        int64_t offset_ = 0;
+        int64_t length_ = 0;
+    };
+
+    std::string collection_name_;
+    idx_t op_id_ = 0;
+
+    std::string meta_;
+    std::vector<Piece> layout_;
+    std::vector<struct iovec> pieces_;
+    int64_t bytes_ = 0;
+
+    std::mutex commit_mutex_;
+    std::condition_variable commit_cv_;
+    bool committed_ = false;
+    Status status_;
+};
+
+}  // namespace engine
+}  // namespace milvus
@@ -23,6 +23,7 @@ const char* INVALID = "";
 const char* INDEX_FAISS_IDMAP = "FLAT";
 const char* INDEX_FAISS_IVFFLAT = "IVF_FLAT";
 const char* INDEX_FAISS_IVFPQ = "IVF_PQ";
+const char* INDEX_FAISS_IVFPQ_FASTSCAN = "IVF_PQ_FASTSCAN";
 const char* INDEX_FAISS_IVFSQ8 = "IVF_SQ8";
 const char* INDEX_FAISS_IVFSQ8H = "IVF_SQ8_HYBRID";
 const char* INDEX_FAISS_BIN_IDMAP = "BIN_FLAT";
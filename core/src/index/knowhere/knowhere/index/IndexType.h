@@ -52,6 +52,7 @@ extern const char* INVALID;
 extern const char* INDEX_FAISS_IDMAP;
 extern const char* INDEX_FAISS_IVFFLAT;
 extern const char* INDEX_FAISS_IVFPQ;
+extern const char* INDEX_FAISS_IVFPQ_FASTSCAN;
 extern const char* INDEX_FAISS_IVFSQ8;
 extern const char* INDEX_FAISS_IVFSQ8H;
 extern const char* INDEX_FAISS_BIN_IDMAP;
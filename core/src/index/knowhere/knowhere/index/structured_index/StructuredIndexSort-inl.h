@@ -11,8 +11,10 @@
 
 #include <src/index/knowhere/knowhere/common/Log.h>
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "knowhere/index/structured_index/StructuredIndexSort.h"
 
 namespace milvus {
@@ -52,9 +54,43 @@ StructuredIndexSort<T>::build() {
         KNOWHERE_THROW_MSG("StructuredIndexSort cannot build null values!");
     }
     std::sort(data_.begin(), data_.end());
+    BuildZoneMap();
     is_built_ = true;
 }
 
+template <typename T>
+void
+StructuredIndexSort<T>::BuildZoneMap() {
+    row_values_.resize(data_.size());
+    for (auto& item : data_) {
+        row_values_[item.idx_] = item.a_;
+    }
+
+    size_t block_count = (row_values_.size() + ZONE_MAP_BLOCK_SIZE - 1) / ZONE_MAP_BLOCK_SIZE;
+    block_min_.resize(block_count);
+    block_max_.resize(block_count);
+    for (size_t i = 0; i < block_count; ++i) {
+        auto begin = row_values_.begin() + i * ZONE_MAP_BLOCK_SIZE;
+        auto end = row_values_.begin() + std::min((i + 1) * ZONE_MAP_BLOCK_SIZE, row_values_.size());
+        auto min_max = std::minmax_element(begin, end);
+        block_min_[i] = *min_max.first;
+        block_max_[i] = *min_max.second;
+    }
+}
+
+template <typename T>
+typename std::vector<IndexStructure<T>>::const_iterator
+StructuredIndexSort<T>::Gallop(typename std::vector<IndexStructure<T>>::const_iterator begin, const T value) const {
+    auto end = data_.cend();
+    size_t step = 1;
+    while (static_cast<size_t>(end - begin) > step && (begin + step)->a_ < value) {
+        begin += step;
+        step <<= 1;
+    }
+    auto bound = (static_cast<size_t>(end - begin) > step) ? begin + step : end;
+    return std::lower_bound(begin, bound, IndexStructure<T>(value));
+}
+
 template <typename T>
 BinarySet
 StructuredIndexSort<T>::Serialize(const milvus::knowhere::Config& config) {
@@ -87,6 +123,7 @@ StructuredIndexSort<T>::Load(const milvus::knowhere::BinarySet& index_binary) {
         auto index_data = index_binary.GetByName("index_data");
         data_.resize(index_size);
         memcpy(data_.data(), index_data->data.get(), (size_t)index_data->size);
+        BuildZoneMap();
         is_built_ = true;
     } catch (...) {
         KNOHWERE_ERROR_MSG("StructuredIndexSort Load failed!");
@@ -96,103 +133,156 @@ StructuredIndexSort<T>::Load(const milvus::knowhere::BinarySet& index_binary) {
 template <typename T>
 const faiss::ConcurrentBitsetPtr
 StructuredIndexSort<T>::In(const size_t n, const T* values) {
-    if (!is_built_) {
-        build();
-    }
     faiss::ConcurrentBitsetPtr bitset = std::make_shared<faiss::ConcurrentBitset>(data_.size());
-    for (size_t i = 0; i < n; ++i) {
-        auto lb = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        auto ub = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        for (; lb < ub; ++lb) {
-            if (lb->a_ != *(values + i)) {
-                LOG_KNOWHERE_ERROR_ << "error happens in StructuredIndexSort<T>::In, experted value is: "
-                                    << *(values + i) << ", but real value is: " << lb->a_;
-            }
-            bitset->set(lb->idx_);
-        }
-    }
+    In(n, values, *bitset);
     return bitset;
 }
 
 template <typename T>
-const faiss::ConcurrentBitsetPtr
-StructuredIndexSort<T>::NotIn(const size_t n, const T* values) {
+void
+StructuredIndexSort<T>::In(const size_t n, const T* values, faiss::ConcurrentBitset& bitset) {
     if (!is_built_) {
         build();
     }
-    faiss::ConcurrentBitsetPtr bitset = std::make_shared<faiss::ConcurrentBitset>(data_.size(), 0xff);
-    for (size_t i = 0; i < n; ++i) {
-        auto lb = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        auto ub = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        for (; lb < ub; ++lb) {
-            if (lb->a_ != *(values + i)) {
-                LOG_KNOWHERE_ERROR_ << "error happens in StructuredIndexSort<T>::NotIn, experted value is: "
-                                    << *(values + i) << ", but real value is: " << lb->a_;
-            }
-            bitset->clear(lb->idx_);
+    std::vector<T> terms(values, values + n);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    // merge the sorted terms with sorted data, each search starts from where the previous term stops
+    auto it = data_.cbegin();
+    for (auto& term : terms) {
+        it = Gallop(it, term);
+        for (; it != data_.cend() && it->a_ == term; ++it) {
+            bitset.set(it->idx_);
         }
     }
+}
+
+template <typename T>
+const faiss::ConcurrentBitsetPtr
+StructuredIndexSort<T>::NotIn(const size_t n, const T* values) {
+    faiss::ConcurrentBitsetPtr bitset = std::make_shared<faiss::ConcurrentBitset>(data_.size());
+    In(n, values, *bitset);
+    bitset->negate();
     return bitset;
 }
 
 template <typename T>
 const faiss::ConcurrentBitsetPtr
 StructuredIndexSort<T>::Range(const T value, const OperatorType op) {
-    if (!is_built_) {
-        build();
-    }
     faiss::ConcurrentBitsetPtr bitset = std::make_shared<faiss::ConcurrentBitset>(data_.size());
-    auto lb = data_.begin();
-    auto ub = data_.end();
     switch (op) {
         case OperatorType::LT:
-            ub = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(value));
+            Range(nullptr, false, &value, false, *bitset);
             break;
         case OperatorType::LE:
-            ub = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(value));
+            Range(nullptr, false, &value, true, *bitset);
             break;
         case OperatorType::GT:
-            lb = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(value));
+            Range(&value, false, nullptr, false, *bitset);
             break;
         case OperatorType::GE:
-            lb = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(value));
+            Range(&value, true, nullptr, false, *bitset);
             break;
         default:
             KNOWHERE_THROW_MSG("Invalid OperatorType:" + std::to_string((int)op) + "!");
     }
-    for (; lb < ub; ++lb) {
-        bitset->set(lb->idx_);
-    }
     return bitset;
 }
 
 template <typename T>
 const faiss::ConcurrentBitsetPtr
 StructuredIndexSort<T>::Range(T lower_bound_value, bool lb_inclusive, T upper_bound_value, bool ub_inclusive) {
-    if (!is_built_) {
-        build();
-    }
     faiss::ConcurrentBitsetPtr bitset = std::make_shared<faiss::ConcurrentBitset>(data_.size());
     if (lower_bound_value > upper_bound_value) {
         std::swap(lower_bound_value, upper_bound_value);
         std::swap(lb_inclusive, ub_inclusive);
     }
+    Range(&lower_bound_value, lb_inclusive, &upper_bound_value, ub_inclusive, *bitset);
+    return bitset;
+}
+
+template <typename T>
+void
+StructuredIndexSort<T>::Range(const T* lower_bound_value, bool lb_inclusive, const T* upper_bound_value,
+                              bool ub_inclusive, faiss::ConcurrentBitset& bitset) {
+    if (!is_built_) {
+        build();
+    }
     auto lb = data_.begin();
     auto ub = data_.end();
-    if (lb_inclusive) {
-        lb = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(lower_bound_value));
-    } else {
-        lb = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(lower_bound_value));
+    if (lower_bound_value != nullptr) {
+        if (lb_inclusive) {
+            lb = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(*lower_bound_value));
+        } else {
+            lb = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(*lower_bound_value));
+        }
     }
-    if (ub_inclusive) {
-        ub = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(upper_bound_value));
-    } else {
-        ub = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(upper_bound_value));
+    if (upper_bound_value != nullptr) {
+        if (ub_inclusive) {
+            ub = std::upper_bound(data_.begin(), data_.end(), IndexStructure<T>(*upper_bound_value));
+        } else {
+            ub = std::lower_bound(data_.begin(), data_.end(), IndexStructure<T>(*upper_bound_value));
+        }
     }
-    for (; lb < ub; ++lb) {
-        bitset->set(lb->idx_);
+    if (lb >= ub) {
+        return;
+    }
+
+    auto below = [&](const T value) {
+        if (lower_bound_value == nullptr) {
+            return false;
+        }
+        return lb_inclusive ? value < *lower_bound_value : value <= *lower_bound_value;
+    };
+    auto above = [&](const T value) {
+        if (upper_bound_value == nullptr) {
+            return false;
+        }
+        return ub_inclusive ? value > *upper_bound_value : value >= *upper_bound_value;
+    };
+
+    // rows of blocks partially covered by the range are checked one by one, use zone map only when that is
+    // cheaper than setting the matched rows from sorted data
+    size_t partial_rows = 0;
+    for (size_t i = 0; i < block_min_.size(); ++i) {
+        if (!below(block_max_[i]) && !above(block_min_[i]) && (below(block_min_[i]) || above(block_max_[i]))) {
+            partial_rows += ZONE_MAP_BLOCK_SIZE;
+        }
+    }
+    if (partial_rows >= static_cast<size_t>(ub - lb)) {
+        for (; lb < ub; ++lb) {
+            bitset.set(lb->idx_);
+        }
+        return;
+    }
+
+    // blocks start at byte boundary of the bitset
+    auto bits = bitset.mutable_data();
+    for (size_t i = 0; i < block_min_.size(); ++i) {
+        if (below(block_max_[i]) || above(block_min_[i])) {
+            continue;
+        }
+        size_t begin = i * ZONE_MAP_BLOCK_SIZE;
+        size_t end = std::min(begin + ZONE_MAP_BLOCK_SIZE, row_values_.size());
+        if (!below(block_min_[i]) && !above(block_max_[i])) {
+            memset(bits + (begin >> 3), 0xff, (end - begin) >> 3);
+            if ((end - begin) & 0x07) {
+                bits[end >> 3] |= (uint8_t)((1 << ((end - begin) & 0x07)) - 1);
+            }
+            continue;
+        }
+        for (size_t j = begin; j < end; j += 8) {
+            uint8_t byte = 0;
+            size_t byte_end = std::min(j + 8, end);
+            for (size_t k = j; k < byte_end; ++k) {
+                byte |= (uint8_t)(!below(row_values_[k]) && !above(row_values_[k])) << (k - j);
+            }
+            if (byte) {
+                bits[j >> 3] |= byte;
+            }
+        }
     }
-    return bitset;
 }
 
 }  // namespace knowhere
@@ -21,6 +21,12 @@
 namespace milvus {
 namespace knowhere {
 
+// rows of a zone map block, a block covers 64 words of the bitset
+constexpr size_t ZONE_MAP_BLOCK_SIZE = 4096;
+
+// Values are kept sorted with their row offsets for binary search, and also in row order with the min/max of
+// each block (zone map), so that a wide range sets whole words for the blocks it covers instead of bit by bit.
+// The zone map is derived data, it is rebuilt on load and the serialized format is unchanged.
 template <typename T>
 class StructuredIndexSort : public StructuredIndex<T> {
  public:
@@ -52,6 +58,16 @@ class StructuredIndexSort : public StructuredIndex<T> {
     const faiss::ConcurrentBitsetPtr
     Range(T lower_bound_value, bool lb_inclusive, T upper_bound_value, bool ub_inclusive) override;
 
+    // set bits of rows with value in values into bitset, other bits are left unchanged
+    void
+    In(const size_t n, const T* values, faiss::ConcurrentBitset& bitset);
+
+    // set bits of rows with value between the bounds into bitset, other bits are left unchanged,
+    // a null bound means unbounded on that side, no row is selected if lower bound is above upper bound
+    void
+    Range(const T* lower_bound_value, bool lb_inclusive, const T* upper_bound_value, bool ub_inclusive,
+          faiss::ConcurrentBitset& bitset);
+
     const std::vector<IndexStructure<T>>&
     GetData() {
         return data_;
@@ -59,7 +75,8 @@ class StructuredIndexSort : public StructuredIndex<T> {
 
     int64_t
     Size() override {
-        return (int64_t)data_.size() * sizeof(IndexStructure<T>);
+        return (int64_t)data_.size() * sizeof(IndexStructure<T>) + (int64_t)row_values_.size() * sizeof(T) +
+               (int64_t)(block_min_.size() + block_max_.size()) * sizeof(T);
     }
 
     bool
@@ -67,9 +84,20 @@ class StructuredIndexSort : public StructuredIndex<T> {
         return is_built_;
     }
 
+ private:
+    void
+    BuildZoneMap();
+
+    // first element not less than value, searching forward from begin with exponential steps
+    typename std::vector<IndexStructure<T>>::const_iterator
+    Gallop(typename std::vector<IndexStructure<T>>::const_iterator begin, const T value) const;
+
  private:
     bool is_built_;
     std::vector<IndexStructure<T>> data_;
+    std::vector<T> row_values_;  // values in row order
+    std::vector<T> block_min_;
+    std::vector<T> block_max_;
 };
 
 template <typename T>
@@ -207,6 +207,32 @@ IVFPQConfAdapter::CheckCPUPQParams(int64_t dimension, int64_t m) {
     return (dimension % m == 0);
 }
 
+bool
+IVFPQFastScanConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
+    // the fast scan kernels only handle 4-bit codes, a sub-quantizer needs 16 training rows
+    const int64_t FASTSCAN_NBITS = 4;
+    const int64_t MIN_ROWS = 1 << FASTSCAN_NBITS;
+    oricfg[knowhere::IndexParams::nbits] = FASTSCAN_NBITS;
+    if (!IVFConfAdapter::CheckTrain(oricfg, mode) || oricfg[knowhere::meta::ROWS].get<int64_t>() < MIN_ROWS) {
+        return false;
+    }
+
+    CheckIntByRange(knowhere::IndexParams::m, 1, oricfg[knowhere::meta::DIM].get<int64_t>());
+    return IVFPQConfAdapter::CheckCPUPQParams(oricfg[knowhere::meta::DIM].get<int64_t>(),
+                                              oricfg[knowhere::IndexParams::m].get<int64_t>());
+}
+
+bool
+IVFPQFastScanConfAdapter::CheckSearch(Config& oricfg, const IndexType type, const IndexMode mode) {
+    const int64_t MIN_REFINE_FACTOR = 1;
+    const int64_t MAX_REFINE_FACTOR = 64;
+    if (oricfg.contains(knowhere::IndexParams::refine_factor)) {
+        CheckIntByRange(knowhere::IndexParams::refine_factor, MIN_REFINE_FACTOR, MAX_REFINE_FACTOR);
+    }
+
+    return IVFConfAdapter::CheckSearch(oricfg, type, IndexMode::MODE_CPU);
+}
+
 bool
 NSGConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
     const int64_t MIN_KNNG = 5;
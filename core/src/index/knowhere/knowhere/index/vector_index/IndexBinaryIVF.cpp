@@ -134,13 +134,14 @@ BinaryIVF::GenParams(const Config& config) {
 void
 BinaryIVF::QueryImpl(int64_t n, const uint8_t* data, int64_t k, float* distances, int64_t* labels, const Config& config,
                      const faiss::ConcurrentBitsetPtr& bitset) {
+    // the search parameters are passed per call, the shared index is not modified
     auto params = GenParams(config);
     auto ivf_index = dynamic_cast<faiss::IndexBinaryIVF*>(index_.get());
-    ivf_index->nprobe = params->nprobe;
+    params->nprobe = std::min(params->nprobe, ivf_index->invlists->nlist);
 
     stdclock::time_point before = stdclock::now();
     auto i_distances = reinterpret_cast<int32_t*>(distances);
-    index_->search(n, data, k, i_distances, labels, bitset);
+    ivf_index->search_with_parameters(n, data, k, i_distances, labels, params.get(), bitset);
 
     stdclock::time_point after = stdclock::now();
     double search_cost = (std::chrono::duration<double, std::micro>(after - before)).count();
@@ -152,7 +152,8 @@ IndexHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fais
     auto p_id = static_cast<int64_t*>(malloc(id_size * rows));
     auto p_dist = static_cast<float*>(malloc(dist_size * rows));
 
-    index_->setEf(config[IndexParams::ef]);
+    // ef is passed per query, the shared index is not modified
+    size_t ef = config[IndexParams::ef];
 
     using P = std::pair<float, int64_t>;
     auto compare = [](const P& v1, const P& v2) { return v1.first < v2.first; };
@@ -169,7 +170,7 @@ IndexHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fais
         // } else {
         //     ret = index_->searchKnn((float*)single_query, config[meta::TOPK].get<int64_t>(), compare);
         // }
-        ret = index_->searchKnn(single_query, k, compare, bitset);
+        ret = index_->searchKnn(single_query, k, compare, bitset, ef);
 
         while (ret.size() < k) {
             ret.emplace_back(std::make_pair(-1, -1));
@@ -327,16 +327,13 @@ IVF::GenParams(const Config& config) {
 void
 IVF::QueryImpl(int64_t n, const float* data, int64_t k, float* distances, int64_t* labels, const Config& config,
                const faiss::ConcurrentBitsetPtr& bitset) {
+    // the search parameters are passed per call, the shared index is not modified
     auto params = GenParams(config);
     auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
-    ivf_index->nprobe = std::min(params->nprobe, ivf_index->invlists->nlist);
+    params->nprobe = std::min(params->nprobe, ivf_index->invlists->nlist);
+    params->parallel_mode = (params->nprobe > 1 && n <= 4) ? 1 : 0;
     stdclock::time_point before = stdclock::now();
-    if (params->nprobe > 1 && n <= 4) {
-        ivf_index->parallel_mode = 1;
-    } else {
-        ivf_index->parallel_mode = 0;
-    }
-    ivf_index->search(n, data, k, distances, labels, bitset);
+    ivf_index->search_with_parameters(n, data, k, distances, labels, params.get(), bitset);
     stdclock::time_point after = stdclock::now();
     double search_cost = (std::chrono::duration<double, std::micro>(after - before)).count();
     LOG_KNOWHERE_DEBUG_ << "IVF search cost: " << search_cost
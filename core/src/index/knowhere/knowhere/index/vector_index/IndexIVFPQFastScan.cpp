@@ -0,0 +1,106 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <memory>
+#include <string>
+
+#include <faiss/IndexFlat.h>
+#include <faiss/IndexIVFPQFastScan.h>
+
+#include "knowhere/common/Exception.h"
+#include "knowhere/common/Log.h"
+#include "knowhere/index/vector_index/IndexIVFPQFastScan.h"
+#include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
+
+namespace milvus {
+namespace knowhere {
+
+void
+IVFPQFastScan::Load(const BinarySet& binary_set) {
+    IVF::Load(binary_set);
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto fastscan_index = dynamic_cast<faiss::IndexIVFPQFastScan*>(index_.get());
+    if (fastscan_index == nullptr) {
+        KNOWHERE_THROW_MSG("index is not an IVF_PQ_FASTSCAN index");
+    }
+
+    raw_data_ = nullptr;
+    fastscan_index->set_refine_data(nullptr);
+    if (binary_set.Contains(RAW_DATA)) {
+        // the ids of the index are the row numbers of the raw data
+        auto binary = binary_set.GetByName(RAW_DATA);
+        if (binary->size == fastscan_index->ntotal * fastscan_index->d * static_cast<int64_t>(sizeof(float))) {
+            raw_data_ = binary->data;
+            fastscan_index->set_refine_data(reinterpret_cast<const float*>(raw_data_.get()));
+        } else {
+            LOG_KNOWHERE_WARNING_ << "Raw data size " << binary->size << " doesn't match the index, refine disabled";
+        }
+    }
+}
+
+void
+IVFPQFastScan::Train(const DatasetPtr& dataset_ptr, const Config& config) {
+    GET_TENSOR_DATA_DIM(dataset_ptr)
+
+    faiss::MetricType metric_type = GetMetricType(config[Metric::TYPE].get<std::string>());
+    faiss::Index* coarse_quantizer = new faiss::IndexFlat(dim, metric_type);
+    auto index = std::make_shared<faiss::IndexIVFPQFastScan>(coarse_quantizer, dim,
+                                                             config[IndexParams::nlist].get<int64_t>(),
+                                                             config[IndexParams::m].get<int64_t>(), metric_type);
+    index->own_fields = true;
+    index->train(rows, reinterpret_cast<const float*>(p_data));
+    index_ = index;
+}
+
+VecIndexPtr
+IVFPQFastScan::CopyCpuToGpu(const int64_t device_id, const Config& config) {
+    KNOWHERE_THROW_MSG("IVF_PQ_FASTSCAN is only supported on CPU");
+}
+
+std::shared_ptr<faiss::IVFSearchParameters>
+IVFPQFastScan::GenParams(const Config& config) {
+    auto params = std::make_shared<faiss::IVFPQFastScanSearchParameters>();
+    params->nprobe = config[IndexParams::nprobe];
+    if (config.contains(IndexParams::refine_factor)) {
+        params->k_factor = config[IndexParams::refine_factor].get<int64_t>();
+    }
+    return params;
+}
+
+void
+IVFPQFastScan::UpdateIndexSize() {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    auto fastscan_index = dynamic_cast<faiss::IndexIVFPQFastScan*>(index_.get());
+    auto nb = fastscan_index->invlists->compute_ntotal();
+    auto code_size = fastscan_index->code_size;
+    auto pq = fastscan_index->pq;
+    auto nlist = fastscan_index->nlist;
+    auto d = fastscan_index->d;
+
+    // ivf codes, ivf ids and quantizer
+    auto capacity = nb * code_size + nb * sizeof(int64_t) + nlist * d * sizeof(float);
+    auto centroid_table = pq.M * pq.ksub * pq.dsub * sizeof(float);
+    // the raw data is kept alive by the index for refinement
+    auto raw_data = raw_data_ != nullptr ? nb * d * sizeof(float) : 0;
+    index_size_ = capacity + centroid_table + raw_data;
+}
+
+void
+IVFPQFastScan::SealImpl() {
+    // the blocked inverted lists are searched in place, there is no read-only conversion
+}
+
+}  // namespace knowhere
+}  // namespace milvus
@@ -0,0 +1,64 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "knowhere/index/vector_index/IndexIVF.h"
+
+namespace milvus {
+namespace knowhere {
+
+/*
+ * IVF_PQ with 4-bit codes scanned by blocks of 32 with in-register lookup tables.
+ * If the binary set given to Load contains RAW_DATA, the results are refined with
+ * the raw vectors when refine_factor > 1 is given at search time.
+ */
+class IVFPQFastScan : public IVF {
+ public:
+    IVFPQFastScan() : IVF() {
+        index_type_ = IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN;
+    }
+
+    explicit IVFPQFastScan(std::shared_ptr<faiss::Index> index) : IVF(std::move(index)) {
+        index_type_ = IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN;
+    }
+
+    void
+    Load(const BinarySet&) override;
+
+    void
+    Train(const DatasetPtr&, const Config&) override;
+
+    VecIndexPtr
+    CopyCpuToGpu(const int64_t, const Config&) override;
+
+    void
+    UpdateIndexSize() override;
+
+ protected:
+    std::shared_ptr<faiss::IVFSearchParameters>
+    GenParams(const Config& config) override;
+
+    void
+    SealImpl() override;
+
+ private:
+    // raw vectors used for refinement, owned by the binary set given to Load
+    std::shared_ptr<uint8_t[]> raw_data_ = nullptr;
+};
+
+using IVFPQFastScanPtr = std::shared_ptr<IVFPQFastScan>;
+
+}  // namespace knowhere
+}  // namespace milvus
@@ -98,8 +98,9 @@ IndexRHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fai
 
     auto real_index = dynamic_cast<faiss::IndexRHNSW*>(index_.get());
 
-    real_index->hnsw.efSearch = (config[IndexParams::ef]);
-    real_index->search(rows, reinterpret_cast<const float*>(p_data), k, p_dist, p_id, bitset);
+    // ef is passed per call, the shared index is not modified
+    int ef = config[IndexParams::ef];
+    real_index->search_with_ef(rows, reinterpret_cast<const float*>(p_data), k, p_dist, p_id, ef, bitset);
 
     auto ret_ds = std::make_shared<Dataset>();
     ret_ds->Set(meta::IDS, p_id);
@@ -20,6 +20,7 @@
 #include "knowhere/index/vector_index/IndexIDMAP.h"
 #include "knowhere/index/vector_index/IndexIVF.h"
 #include "knowhere/index/vector_index/IndexIVFPQ.h"
+#include "knowhere/index/vector_index/IndexIVFPQFastScan.h"
 #include "knowhere/index/vector_index/IndexIVFSQ.h"
 #include "knowhere/index/vector_index/IndexNGTONNG.h"
 #include "knowhere/index/vector_index/IndexNGTPANNG.h"
@@ -68,6 +69,8 @@ VecIndexFactory::CreateVecIndex(const IndexType& type, const IndexMode mode) {
         }
 #endif
         return std::make_shared<knowhere::IVFPQ>();
+    } else if (type == IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN) {
+        return std::make_shared<knowhere::IVFPQFastScan>();
     } else if (type == IndexEnum::INDEX_FAISS_IVFSQ8) {
 #ifdef MILVUS_GPU_VERSION
         if (mode == IndexMode::MODE_GPU) {
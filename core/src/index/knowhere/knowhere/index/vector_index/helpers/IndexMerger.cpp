@@ -0,0 +1,270 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "knowhere/index/vector_index/helpers/IndexMerger.h"
+
+#include <faiss/IndexFlat.h>
+#include <faiss/IndexIVF.h>
+#include <faiss/IndexIVFFlat.h>
+#include <faiss/IndexIVFPQ.h>
+#include <faiss/IndexScalarQuantizer.h>
+#include <faiss/clone_index.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "knowhere/common/Exception.h"
+#include "knowhere/common/Log.h"
+#include "knowhere/index/vector_index/FaissBaseIndex.h"
+#include "knowhere/index/vector_index/IndexIVF.h"
+#include "knowhere/index/vector_index/IndexIVFPQ.h"
+#include "knowhere/index/vector_index/IndexIVFSQ.h"
+#include "knowhere/index/vector_offset_index/IndexIVF_NM.h"
+
+namespace milvus {
+namespace knowhere {
+namespace merger {
+
+namespace {
+
+faiss::IndexIVF*
+GetFaissIVF(const VecIndexPtr& index) {
+    if (index == nullptr || !SupportMerge(index->index_type())) {
+        return nullptr;
+    }
+
+    std::shared_ptr<faiss::Index> faiss_index;
+    if (auto offset_index = std::dynamic_pointer_cast<IVF_NM>(index)) {
+        faiss_index = offset_index->index_;
+    } else if (auto base_index = std::dynamic_pointer_cast<IVF>(index)) {
+        faiss_index = base_index->index_;
+    }
+
+    auto ivf = dynamic_cast<faiss::IndexIVF*>(faiss_index.get());
+    if (ivf == nullptr || !ivf->is_trained) {
+        return nullptr;
+    }
+    return ivf;
+}
+
+bool
+IsSameQuantizer(const faiss::IndexIVF* left, const faiss::IndexIVF* right) {
+    if (typeid(*left) != typeid(*right) || left->d != right->d || left->nlist != right->nlist ||
+        left->metric_type != right->metric_type || left->code_size != right->code_size) {
+        return false;
+    }
+
+    auto left_flat = dynamic_cast<const faiss::IndexFlat*>(left->quantizer);
+    auto right_flat = dynamic_cast<const faiss::IndexFlat*>(right->quantizer);
+    if (left_flat == nullptr || right_flat == nullptr || left_flat->xb != right_flat->xb) {
+        return false;
+    }
+
+    if (auto left_sq = dynamic_cast<const faiss::IndexIVFScalarQuantizer*>(left)) {
+        auto right_sq = dynamic_cast<const faiss::IndexIVFScalarQuantizer*>(right);
+        return left_sq->by_residual == right_sq->by_residual && left_sq->sq.qtype == right_sq->sq.qtype &&
+               left_sq->sq.trained == right_sq->sq.trained;
+    }
+    if (auto left_pq = dynamic_cast<const faiss::IndexIVFPQ*>(left)) {
+        auto right_pq = dynamic_cast<const faiss::IndexIVFPQ*>(right);
+        return left_pq->by_residual == right_pq->by_residual && left_pq->pq.M == right_pq->pq.M &&
+               left_pq->pq.nbits == right_pq->pq.nbits && left_pq->pq.centroids == right_pq->pq.centroids;
+    }
+    return true;
+}
+
+// copy the trained quantizer and codec of the base index, with empty inverted lists
+std::shared_ptr<faiss::IndexIVF>
+CloneEmptyIVF(const faiss::IndexIVF* base) {
+    std::shared_ptr<faiss::IndexIVF> merged;
+    if (auto pq = dynamic_cast<const faiss::IndexIVFPQ*>(base)) {
+        merged = std::make_shared<faiss::IndexIVFPQ>(*pq);
+    } else if (auto sq = dynamic_cast<const faiss::IndexIVFScalarQuantizer*>(base)) {
+        merged = std::make_shared<faiss::IndexIVFScalarQuantizer>(*sq);
+    } else if (auto flat = dynamic_cast<const faiss::IndexIVFFlat*>(base)) {
+        merged = std::make_shared<faiss::IndexIVFFlat>(*flat);
+    } else {
+        KNOWHERE_THROW_MSG("unsupported ivf index to merge");
+    }
+
+    // the copy shares quantizer and inverted lists with base, detach them before anything could throw
+    merged->quantizer = nullptr;
+    merged->own_fields = false;
+    merged->invlists = nullptr;
+    merged->own_invlists = false;
+
+    merged->quantizer = faiss::clone_index(base->quantizer);
+    merged->own_fields = true;
+    merged->replace_invlists(new faiss::ArrayInvertedLists(base->nlist, base->code_size), true);
+    merged->ntotal = 0;
+    return merged;
+}
+
+void
+CopyInvertedLists(const faiss::IndexIVF* src, faiss::IndexIVF* dst, const std::vector<int64_t>& offset_map,
+                  bool with_codes) {
+    auto src_lists = src->invlists;
+    auto dst_lists = dst->invlists;
+    std::vector<faiss::Index::idx_t> ids;
+    std::vector<uint8_t> codes;
+    for (size_t list_no = 0; list_no < src->nlist; ++list_no) {
+        size_t list_size = src_lists->list_size(list_no);
+        if (list_size == 0) {
+            continue;
+        }
+
+        faiss::InvertedLists::ScopedIds src_ids(src_lists, list_no);
+        std::unique_ptr<faiss::InvertedLists::ScopedCodes> src_codes;
+        if (with_codes) {
+            src_codes = std::make_unique<faiss::InvertedLists::ScopedCodes>(src_lists, list_no);
+        }
+
+        // deleted rows are skipped, offsets of live rows are remapped
+        ids.clear();
+        codes.clear();
+        for (size_t i = 0; i < list_size; ++i) {
+            auto offset = src_ids[i];
+            if (offset < 0 || offset >= (int64_t)offset_map.size() || offset_map[offset] < 0) {
+                continue;
+            }
+            ids.push_back(offset_map[offset]);
+            if (with_codes) {
+                auto code = src_codes->get() + i * src->code_size;
+                codes.insert(codes.end(), code, code + src->code_size);
+            }
+        }
+
+        if (ids.empty()) {
+            continue;
+        }
+        if (with_codes) {
+            dst_lists->add_entries(list_no, ids.size(), ids.data(), codes.data());
+        } else {
+            dst_lists->add_entries_without_codes(list_no, ids.size(), ids.data());
+        }
+        dst->ntotal += ids.size();
+    }
+}
+
+// assign the live rows of source to the lists of dst by its quantizer
+void
+AddLiveRows(const IVFMergeSource& source, size_t source_index, faiss::IndexIVF* dst, bool with_codes,
+            const VectorLoader& vector_loader) {
+    std::vector<faiss::Index::idx_t> ids;
+    ids.reserve(source.count_);
+    for (auto offset : source.offset_map_) {
+        if (offset >= 0) {
+            ids.push_back(offset);
+        }
+    }
+
+    std::vector<float> vectors;
+    for (size_t live = 0; live < ids.size();) {
+        vectors.clear();
+        vector_loader(source_index, live, vectors);
+        size_t rows = std::min(vectors.size() / dst->d, ids.size() - live);
+        if (rows == 0) {
+            KNOWHERE_THROW_MSG("no vector of source " + std::to_string(source_index) + " is loaded");
+        }
+
+        // an offset index keeps the codes in raw file, only the ids are added into the lists
+        if (with_codes) {
+            dst->add_with_ids(rows, vectors.data(), ids.data() + live);
+        } else {
+            dst->add_with_ids_without_codes(rows, vectors.data(), ids.data() + live);
+        }
+        live += rows;
+    }
+}
+
+}  // namespace
+
+bool
+SupportMerge(const IndexType& type) {
+    return type == IndexEnum::INDEX_FAISS_IVFFLAT || type == IndexEnum::INDEX_FAISS_IVFSQ8 ||
+           type == IndexEnum::INDEX_FAISS_IVFPQ;
+}
+
+VecIndexPtr
+MergeIVF(const std::vector<IVFMergeSource>& sources, const IndexLoader& index_loader,
+         const VectorLoader& vector_loader) {
+    // the more rows the base has, the fewer rows are assigned again
+    size_t base = sources.size();
+    for (size_t i = 0; i < sources.size(); ++i) {
+        auto& source = sources[i];
+        if (source.indexed_ && source.count_ > 0 && (base == sources.size() || source.count_ > sources[base].count_)) {
+            base = i;
+        }
+    }
+    if (base == sources.size()) {
+        KNOWHERE_THROW_MSG("no trained ivf index to merge");
+    }
+
+    auto base_index = index_loader(base);
+    auto base_ivf = GetFaissIVF(base_index);
+    if (base_ivf == nullptr) {
+        KNOWHERE_THROW_MSG("source " + std::to_string(base) + " has no trained ivf index to merge");
+    }
+    IndexType type = base_index->index_type();
+    bool offset_index = (std::dynamic_pointer_cast<IVF_NM>(base_index) != nullptr);
+    std::shared_ptr<faiss::IndexIVF> merged = CloneEmptyIVF(base_ivf);
+
+    int64_t copied = 0, assigned = 0;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        auto& source = sources[i];
+        if (source.count_ <= 0) {
+            continue;
+        }
+
+        VecIndexPtr index;
+        if (i == base) {
+            index = std::move(base_index);
+        } else if (source.indexed_) {
+            index = index_loader(i);
+        }
+
+        // the codes of an offset index are stored in raw file, only the ids are in the inverted lists
+        auto ivf = GetFaissIVF(index);
+        if (ivf != nullptr && index->index_type() == type &&
+            (std::dynamic_pointer_cast<IVF_NM>(index) != nullptr) == offset_index &&
+            (i == base || IsSameQuantizer(ivf, merged.get()))) {
+            CopyInvertedLists(ivf, merged.get(), source.offset_map_, !offset_index);
+            copied += source.count_;
+        } else {
+            index = nullptr;
+            AddLiveRows(source, i, merged.get(), !offset_index, vector_loader);
+            assigned += source.count_;
+        }
+    }
+    LOG_KNOWHERE_DEBUG_ << "Merge " << type << " index: " << copied << " rows copied, " << assigned
+                        << " rows assigned";
+
+    VecIndexPtr result;
+    if (offset_index) {
+        result = std::make_shared<IVF_NM>(merged);
+    } else if (type == IndexEnum::INDEX_FAISS_IVFSQ8) {
+        result = std::make_shared<IVFSQ>(merged);
+    } else if (type == IndexEnum::INDEX_FAISS_IVFPQ) {
+        result = std::make_shared<IVFPQ>(merged);
+    } else {
+        result = std::make_shared<IVF>(merged);
+    }
+    result->UpdateIndexSize();
+    return result;
+}
+
+}  // namespace merger
+}  // namespace knowhere
+}  // namespace milvus
@@ -0,0 +1,54 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "knowhere/index/vector_index/VecIndex.h"
+
+namespace milvus {
+namespace knowhere {
+namespace merger {
+
+// one of the segments to be merged, the ids stored in its index are row offsets of its own segment
+struct IVFMergeSource {
+    std::vector<int64_t> offset_map_;  // row offset in source -> row offset in merged, -1 for deleted rows
+    int64_t count_ = 0;                // live row count
+    bool indexed_ = false;             // whether the source has an index file of the merged index type
+};
+
+// check whether the index type could be merged by MergeIVF()
+extern bool
+SupportMerge(const IndexType& type);
+
+// load the index of the i-th source, nullptr if the source has no index
+using IndexLoader = std::function<VecIndexPtr(size_t source_index)>;
+
+// load float vectors of the live rows of the i-th source from the live_begin-th live row, at least one row,
+// the number of rows is decided by the loader
+using VectorLoader = std::function<void(size_t source_index, int64_t live_begin, std::vector<float>& vectors)>;
+
+// Merge IVF_FLAT/IVF_SQ8/IVF_PQ indexes into one index without training. The indexed source with most live rows
+// is the base, its trained quantizer and codec are copied into the merged index. The inverted lists of a source
+// sharing the base quantizer are copied with ids remapped. Each segment is usually trained on its own, so the
+// rows of the other sources are read by vector loader, assigned to the base lists and encoded by the base codec.
+// The source indexes are loaded one by one, each is released once its lists are copied.
+// Throw if no source has a trained index, then the merged segment is left for the build index task.
+// Note: like a built index, the merged IVF_FLAT index has no raw data attached, it is used for serialization.
+extern VecIndexPtr
+MergeIVF(const std::vector<IVFMergeSource>& sources, const IndexLoader& index_loader,
+         const VectorLoader& vector_loader);
+
+}  // namespace merger
+}  // namespace knowhere
+}  // namespace milvus
@@ -52,6 +52,9 @@ constexpr const char* search_k = "search_k";
 // PQ Params
 constexpr const char* PQM = "PQM";
 
+// IVF PQ fast scan Params
+constexpr const char* refine_factor = "refine_factor";
+
 // NGT Params
 constexpr const char* edge_size = "edge_size";
 // NGT Search Params
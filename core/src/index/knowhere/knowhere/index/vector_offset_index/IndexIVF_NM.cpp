@@ -314,15 +314,12 @@ IVF_NM::GenParams(const Config& config) {
 void
 IVF_NM::QueryImpl(int64_t n, const float* query, int64_t k, float* distances, int64_t* labels, const Config& config,
                   const faiss::ConcurrentBitsetPtr& bitset) {
+    // the search parameters are passed per call, the shared index is not modified
     auto params = GenParams(config);
     auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
-    ivf_index->nprobe = params->nprobe;
+    params->nprobe = std::min(params->nprobe, ivf_index->invlists->nlist);
+    params->parallel_mode = (params->nprobe > 1 && n <= 4) ? 1 : 0;
     stdclock::time_point before = stdclock::now();
-    if (params->nprobe > 1 && n <= 4) {
-        ivf_index->parallel_mode = 1;
-    } else {
-        ivf_index->parallel_mode = 0;
-    }
     bool is_sq8 = (index_type_ == IndexEnum::INDEX_FAISS_IVFSQ8) ? true : false;
 
 #ifndef MILVUS_GPU_VERSION
@@ -332,7 +329,7 @@ IVF_NM::QueryImpl(int64_t n, const float* query, int64_t k, float* distances, in
 #endif
 
     ivf_index->search_without_codes(n, reinterpret_cast<const float*>(query), data, prefix_sum, is_sq8, k, distances,
-                                    labels, bitset);
+                                    labels, bitset, params.get());
     stdclock::time_point after = stdclock::now();
     double search_cost = (std::chrono::duration<double, std::micro>(after - before)).count();
     LOG_KNOWHERE_DEBUG_ << "IVF_NM search cost: " << search_cost
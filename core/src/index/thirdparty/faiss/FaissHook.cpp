@@ -26,6 +26,9 @@ fvec_func_ptr fvec_L2sqr = fvec_L2sqr_avx;
 fvec_func_ptr fvec_L1 = fvec_L1_avx;
 fvec_func_ptr fvec_Linf = fvec_Linf_avx;
 
+fvec_tile_func_ptr fvec_inner_product_4x8 = fvec_inner_product_4x8_avx;
+fvec_tile_func_ptr fvec_L2sqr_4x8 = fvec_L2sqr_4x8_avx;
+
 sq_get_distance_computer_func_ptr sq_get_distance_computer = sq_get_distance_computer_avx;
 sq_sel_quantizer_func_ptr sq_sel_quantizer = sq_select_quantizer_avx;
 sq_sel_inv_list_scanner_func_ptr sq_sel_inv_list_scanner = sq_select_inverted_list_scanner_avx;
@@ -66,6 +69,10 @@ bool hook_init(std::string& cpu_flag) {
         fvec_L1 = fvec_L1_avx512;
         fvec_Linf = fvec_Linf_avx512;
 
+        /* for brute force search */
+        fvec_inner_product_4x8 = fvec_inner_product_4x8_avx512;
+        fvec_L2sqr_4x8 = fvec_L2sqr_4x8_avx512;
+
         /* for IVFSQ */
         sq_get_distance_computer = sq_get_distance_computer_avx512;
         sq_sel_quantizer = sq_select_quantizer_avx512;
@@ -79,6 +86,10 @@ bool hook_init(std::string& cpu_flag) {
         fvec_L1 = fvec_L1_avx;
         fvec_Linf = fvec_Linf_avx;
 
+        /* for brute force search */
+        fvec_inner_product_4x8 = fvec_inner_product_4x8_avx;
+        fvec_L2sqr_4x8 = fvec_L2sqr_4x8_avx;
+
         /* for IVFSQ */
         sq_get_distance_computer = sq_get_distance_computer_avx;
         sq_sel_quantizer = sq_select_quantizer_avx;
@@ -92,6 +103,10 @@ bool hook_init(std::string& cpu_flag) {
         fvec_L1 = fvec_L1_sse;
         fvec_Linf = fvec_Linf_sse;
 
+        /* for brute force search */
+        fvec_inner_product_4x8 = fvec_inner_product_4x8_sse;
+        fvec_L2sqr_4x8 = fvec_L2sqr_4x8_sse;
+
         /* for IVFSQ */
         sq_get_distance_computer = sq_get_distance_computer_ref;
         sq_sel_quantizer = sq_select_quantizer_ref;
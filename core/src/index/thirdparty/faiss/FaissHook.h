@@ -14,6 +14,9 @@ namespace faiss {
 
 typedef float (*fvec_func_ptr)(const float*, const float*, size_t);
 
+/// distances between 4 queries and 8 base vectors, dis[i * 8 + j] is for query i and base vector j
+typedef void (*fvec_tile_func_ptr)(const float*, const float*, size_t, float*);
+
 typedef SQDistanceComputer* (*sq_get_distance_computer_func_ptr)(MetricType, QuantizerType, size_t, const std::vector<float>&);
 typedef Quantizer* (*sq_sel_quantizer_func_ptr)(QuantizerType, size_t, const std::vector<float>&);
 typedef InvertedListScanner* (*sq_sel_inv_list_scanner_func_ptr)(MetricType, const ScalarQuantizer*, const Index*, size_t, bool, bool);
@@ -27,6 +30,9 @@ extern fvec_func_ptr fvec_L2sqr;
 extern fvec_func_ptr fvec_L1;
 extern fvec_func_ptr fvec_Linf;
 
+extern fvec_tile_func_ptr fvec_inner_product_4x8;
+extern fvec_tile_func_ptr fvec_L2sqr_4x8;
+
 extern sq_get_distance_computer_func_ptr sq_get_distance_computer;
 extern sq_sel_quantizer_func_ptr sq_sel_quantizer;
 extern sq_sel_inv_list_scanner_func_ptr sq_sel_inv_list_scanner;
@@ -142,6 +142,14 @@ void IndexBinaryIVF::set_direct_map_type (DirectMap::Type type)
 void IndexBinaryIVF::search(idx_t n, const uint8_t *x, idx_t k,
                             int32_t *distances, idx_t *labels,
                             ConcurrentBitsetPtr bitset) const {
+  search_with_parameters(n, x, k, distances, labels, nullptr, bitset);
+}
+
+void IndexBinaryIVF::search_with_parameters(idx_t n, const uint8_t *x, idx_t k,
+                                            int32_t *distances, idx_t *labels,
+                                            const IVFSearchParameters *params,
+                                            ConcurrentBitsetPtr bitset) const {
+  size_t nprobe = params ? params->nprobe : this->nprobe;
   std::unique_ptr<idx_t[]> idx(new idx_t[n * nprobe]);
   std::unique_ptr<int32_t[]> coarse_dis(new int32_t[n * nprobe]);
 
@@ -153,7 +161,7 @@ void IndexBinaryIVF::search(idx_t n, const uint8_t *x, idx_t k,
   invlists->prefetch_lists(idx.get(), n * nprobe);
 
   search_preassigned(n, x, k, idx.get(), coarse_dis.get(),
-                     distances, labels, false, nullptr, bitset);
+                     distances, labels, false, params, bitset);
   indexIVF_stats.search_time += getmillisecs() - t0;
 }
 
@@ -847,6 +855,7 @@ void IndexBinaryIVF::search_preassigned(idx_t n, const uint8_t *x, idx_t k,
                                         const IVFSearchParameters *params,
                                         ConcurrentBitsetPtr bitset
                                         ) const {
+    size_t nprobe = params ? params->nprobe : this->nprobe;
     if (metric_type == METRIC_Jaccard || metric_type == METRIC_Tanimoto) {
         if (use_heap) {
             float *D = new float[k * n];
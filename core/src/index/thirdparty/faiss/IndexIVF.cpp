@@ -318,6 +318,15 @@ void IndexIVF::search (idx_t n, const float *x, idx_t k,
                        float *distances, idx_t *labels,
                        ConcurrentBitsetPtr bitset) const
 {
+    search_with_parameters (n, x, k, distances, labels, nullptr, bitset);
+}
+
+void IndexIVF::search_with_parameters (idx_t n, const float *x, idx_t k,
+                                       float *distances, idx_t *labels,
+                                       const IVFSearchParameters *params,
+                                       ConcurrentBitsetPtr bitset) const
+{
+    size_t nprobe = params ? params->nprobe : this->nprobe;
     std::unique_ptr<idx_t[]> idx(new idx_t[n * nprobe]);
     std::unique_ptr<float[]> coarse_dis(new float[n * nprobe]);
 
@@ -329,9 +338,8 @@ void IndexIVF::search (idx_t n, const float *x, idx_t k,
     invlists->prefetch_lists (idx.get(), n * nprobe);
 
     search_preassigned (n, x, k, idx.get(), coarse_dis.get(),
-                        distances, labels, false, nullptr, bitset);
+                        distances, labels, false, params, bitset);
     indexIVF_stats.search_time += getmillisecs() - t0;
-
     // nprobe logging
     if (LOG_DEBUG_) {
         auto ids = idx.get();
@@ -352,8 +360,10 @@ void IndexIVF::search (idx_t n, const float *x, idx_t k,
 void IndexIVF::search_without_codes (idx_t n, const float *x, 
                                      const uint8_t *arranged_codes, std::vector<size_t> prefix_sum, 
                                      bool is_sq8, idx_t k, float *distances, idx_t *labels,
-                                     ConcurrentBitsetPtr bitset) 
+                                     ConcurrentBitsetPtr bitset,
+                                     const IVFSearchParameters *params)
 {
+    size_t nprobe = params ? params->nprobe : this->nprobe;
     std::unique_ptr<idx_t[]> idx(new idx_t[n * nprobe]);
     std::unique_ptr<float[]> coarse_dis(new float[n * nprobe]);
 
@@ -365,7 +375,7 @@ void IndexIVF::search_without_codes (idx_t n, const float *x,
     invlists->prefetch_lists (idx.get(), n * nprobe);
 
     search_preassigned_without_codes (n, x, arranged_codes, prefix_sum, is_sq8, k, idx.get(), coarse_dis.get(),
-                                      distances, labels, false, nullptr, bitset);
+                                      distances, labels, false, params, bitset);
     indexIVF_stats.search_time += getmillisecs() - t0;
 
     // nprobe loggingss
@@ -430,8 +440,9 @@ void IndexIVF::search_preassigned (idx_t n, const float *x, idx_t k,
 
     bool interrupt = false;
 
-    int pmode = this->parallel_mode & ~PARALLEL_MODE_NO_HEAP_INIT;
-    bool do_heap_init = !(this->parallel_mode & PARALLEL_MODE_NO_HEAP_INIT);
+    int parallel_mode = (params && params->parallel_mode >= 0) ? params->parallel_mode : this->parallel_mode;
+    int pmode = parallel_mode & ~PARALLEL_MODE_NO_HEAP_INIT;
+    bool do_heap_init = !(parallel_mode & PARALLEL_MODE_NO_HEAP_INIT);
 
     // don't start parallel section if single query
     bool do_parallel =
@@ -635,8 +646,9 @@ void IndexIVF::search_preassigned_without_codes (idx_t n, const float *x,
 
     bool interrupt = false;
 
-    int pmode = this->parallel_mode & ~PARALLEL_MODE_NO_HEAP_INIT;
-    bool do_heap_init = !(this->parallel_mode & PARALLEL_MODE_NO_HEAP_INIT);
+    int parallel_mode = (params && params->parallel_mode >= 0) ? params->parallel_mode : this->parallel_mode;
+    int pmode = parallel_mode & ~PARALLEL_MODE_NO_HEAP_INIT;
+    bool do_heap_init = !(parallel_mode & PARALLEL_MODE_NO_HEAP_INIT);
 
     // don't start parallel section if single query
     bool do_parallel =
@@ -1253,7 +1265,7 @@ void IndexIVFStats::reset()
 }
 
 
-IndexIVFStats indexIVF_stats;
+thread_local IndexIVFStats indexIVF_stats;
 
 void InvertedListScanner::scan_codes_range (size_t ,
                        const uint8_t *,
@@ -66,9 +66,14 @@ struct Level1Quantizer {
 
 
 
+/** Per-call search parameters, they override the fields of the index
+ * so that concurrent searches with different settings don't race on
+ * a shared index.
+ */
 struct IVFSearchParameters {
-    size_t nprobe;            ///< number of probes at query time
-    size_t max_codes;         ///< max nb of codes to visit to do a query
+    size_t nprobe = 1;        ///< number of probes at query time
+    size_t max_codes = 0;     ///< max nb of codes to visit to do a query
+    int parallel_mode = -1;   ///< parallel mode, -1 to use the index's
     virtual ~IVFSearchParameters () {}
 };
 
@@ -210,11 +215,19 @@ struct IndexIVF: Index, Level1Quantizer {
                  float *distances, idx_t *labels,
                  ConcurrentBitsetPtr bitset = nullptr) const override;
 
+    /** Similar to search, the search parameters of the index are
+     *  overridden by params (if not nullptr), the index is not modified */
+    void search_with_parameters (idx_t n, const float *x, idx_t k,
+                                 float *distances, idx_t *labels,
+                                 const IVFSearchParameters *params,
+                                 ConcurrentBitsetPtr bitset = nullptr) const;
+
     /** Similar to search, but does not store codes **/
     void search_without_codes (idx_t n, const float *x, 
                                const uint8_t *arranged_codes, std::vector<size_t> prefix_sum, 
                                bool is_sq8, idx_t k, float *distances, idx_t *labels,
-                               ConcurrentBitsetPtr bitset = nullptr);
+                               ConcurrentBitsetPtr bitset = nullptr,
+                               const IVFSearchParameters *params = nullptr);
 
 #if 0
     /** get raw vectors by ids */
@@ -411,8 +424,8 @@ struct IndexIVFStats {
     void reset ();
 };
 
-// global var that collects them all
-extern IndexIVFStats indexIVF_stats;
+// collects the stats of the searches run by the calling thread
+extern thread_local IndexIVFStats indexIVF_stats;
 
 
 } // namespace faiss
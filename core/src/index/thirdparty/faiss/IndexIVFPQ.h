@@ -20,8 +20,8 @@
 namespace faiss {
 
 struct IVFPQSearchParameters: IVFSearchParameters {
-    size_t scan_table_threshold;   ///< use table computation or on-the-fly?
-    int polysemous_ht;             ///< Hamming thresh for polysemous filtering
+    size_t scan_table_threshold = 0;   ///< use table computation or on-the-fly?
+    int polysemous_ht = 0;             ///< Hamming thresh for polysemous filtering
     ~IVFPQSearchParameters () {}
 };
 
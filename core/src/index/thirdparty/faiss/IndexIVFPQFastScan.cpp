@@ -0,0 +1,387 @@
+
+// -*- c++ -*-
+
+#include <faiss/IndexIVFPQFastScan.h>
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <immintrin.h>
+#endif
+
+#include <faiss/FaissHook.h>
+#include <faiss/utils/Heap.h>
+#include <faiss/impl/FaissAssert.h>
+#include <faiss/impl/AuxIndexStructures.h>
+
+namespace faiss {
+
+/*****************************************
+ * IndexIVFPQFastScan implementation
+ ******************************************/
+
+IndexIVFPQFastScan::IndexIVFPQFastScan (Index * quantizer, size_t d, size_t nlist,
+                                        size_t M, MetricType metric):
+    IndexIVFPQ (quantizer, d, nlist, M, 4, metric),
+    k_factor (1),
+    refine_data (nullptr)
+{
+    // the distance tables are computed per list, no precomputed tables
+    use_precomputed_table = -1;
+    replace_invlists (new BlockInvertedLists (nlist, code_size), true);
+}
+
+IndexIVFPQFastScan::IndexIVFPQFastScan ():
+    k_factor (1),
+    refine_data (nullptr)
+{
+    use_precomputed_table = -1;
+}
+
+void IndexIVFPQFastScan::set_refine_data (const float *xb)
+{
+    refine_data = xb;
+}
+
+void IndexIVFPQFastScan::reconstruct_from_offset (int64_t list_no, int64_t offset,
+                                                  float* recons) const
+{
+    // the code is unpacked to a copy, it is released with the scoped object
+    InvertedLists::ScopedCodes code (invlists, list_no, offset);
+    pq.decode (code.get(), recons);
+
+    if (by_residual) {
+        std::vector<float> centroid (d);
+        quantizer->reconstruct (list_no, centroid.data());
+        for (int i = 0; i < d; ++i) {
+            recons[i] += centroid[i];
+        }
+    }
+}
+
+void IndexIVFPQFastScan::merge_from (IndexIVF &, idx_t)
+{
+    FAISS_THROW_MSG ("merge_from not implemented for IndexIVFPQFastScan");
+}
+
+
+namespace {
+
+template<class C>
+void refine_results (size_t d, MetricType metric, const float *xi,
+                     const float *xb, size_t k2, const idx_t *cand,
+                     size_t k, float *simi, idx_t *idxi)
+{
+    heap_heapify<C> (k, simi, idxi);
+    for (size_t j = 0; j < k2; j++) {
+        idx_t id = cand[j];
+        if (id < 0) {
+            // the candidates are sorted, the remaining slots are empty
+            break;
+        }
+        const float *y = xb + id * d;
+        float dis = metric == METRIC_INNER_PRODUCT ?
+            fvec_inner_product (xi, y, d) : fvec_L2sqr (xi, y, d);
+        if (C::cmp (simi[0], dis)) {
+            heap_swap_top<C> (k, simi, idxi, dis, id);
+        }
+    }
+    heap_reorder<C> (k, simi, idxi);
+}
+
+} // anonymous namespace
+
+
+void IndexIVFPQFastScan::search_preassigned (idx_t n, const float *x, idx_t k,
+                                             const idx_t *assign,
+                                             const float *centroid_dis,
+                                             float *distances, idx_t *labels,
+                                             bool store_pairs,
+                                             const IVFSearchParameters *params,
+                                             ConcurrentBitsetPtr bitset) const
+{
+    size_t kf = k_factor;
+    auto fs_params = dynamic_cast<const IVFPQFastScanSearchParameters *> (params);
+    if (fs_params && fs_params->k_factor > 0) {
+        kf = fs_params->k_factor;
+    }
+
+    if (refine_data == nullptr || kf <= 1 || store_pairs) {
+        IndexIVF::search_preassigned (n, x, k, assign, centroid_dis,
+                                      distances, labels, store_pairs, params, bitset);
+        return;
+    }
+
+    // collect k * k_factor candidates with the PQ distances, the bitset
+    // is applied there, then re-rank them with the raw vectors
+    idx_t k2 = k * kf;
+    std::vector<float> dis2 (n * k2);
+    std::vector<idx_t> lab2 (n * k2);
+    IndexIVF::search_preassigned (n, x, k2, assign, centroid_dis,
+                                  dis2.data(), lab2.data(), false, params, bitset);
+
+#pragma omp parallel for if (n > 1)
+    for (idx_t i = 0; i < n; i++) {
+        if (metric_type == METRIC_INNER_PRODUCT) {
+            refine_results<CMin<float, idx_t>> (d, metric_type, x + i * d, refine_data,
+                                                k2, lab2.data() + i * k2,
+                                                k, distances + i * k, labels + i * k);
+        } else {
+            refine_results<CMax<float, idx_t>> (d, metric_type, x + i * d, refine_data,
+                                                k2, lab2.data() + i * k2,
+                                                k, distances + i * k, labels + i * k);
+        }
+    }
+}
+
+
+/*****************************************
+ * fast-scan kernel
+ ******************************************/
+
+namespace {
+
+/* Sums the quantized table entries of the 32 codes of a block and returns
+ * a mask with bit j set if the sum of code j is <= qthresh. lut holds 16
+ * entries per sub-quantizer, M2 is the number of sub-quantizers in the
+ * block layout. */
+uint32_t pq4_block_mask (const uint8_t *block, const uint8_t *lut,
+                         size_t M2, int qthresh)
+{
+#ifdef __SSSE3__
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i mask4 = _mm_set1_epi8 (0x0f);
+    __m128i acc0 = zero, acc1 = zero, acc2 = zero, acc3 = zero;
+
+    for (size_t m = 0; m < M2; m++) {
+        __m128i tab = _mm_loadu_si128 ((const __m128i *)(lut + m * 16));
+        __m128i c = _mm_loadu_si128 ((const __m128i *)(block + m * 16));
+        __m128i dlo = _mm_shuffle_epi8 (tab, _mm_and_si128 (c, mask4));
+        __m128i dhi = _mm_shuffle_epi8 (tab, _mm_and_si128 (_mm_srli_epi16 (c, 4), mask4));
+        // widen to 16 bits, the sums of 255 * M2 fit for M2 <= 256 and saturate beyond
+        acc0 = _mm_adds_epu16 (acc0, _mm_unpacklo_epi8 (dlo, zero));
+        acc1 = _mm_adds_epu16 (acc1, _mm_unpackhi_epi8 (dlo, zero));
+        acc2 = _mm_adds_epu16 (acc2, _mm_unpacklo_epi8 (dhi, zero));
+        acc3 = _mm_adds_epu16 (acc3, _mm_unpackhi_epi8 (dhi, zero));
+    }
+
+    // sum <= qthresh iff the saturated difference is 0
+    const __m128i th = _mm_set1_epi16 ((short)qthresh);
+    __m128i le0 = _mm_cmpeq_epi16 (_mm_subs_epu16 (acc0, th), zero);
+    __m128i le1 = _mm_cmpeq_epi16 (_mm_subs_epu16 (acc1, th), zero);
+    __m128i le2 = _mm_cmpeq_epi16 (_mm_subs_epu16 (acc2, th), zero);
+    __m128i le3 = _mm_cmpeq_epi16 (_mm_subs_epu16 (acc3, th), zero);
+    uint32_t lo = _mm_movemask_epi8 (_mm_packs_epi16 (le0, le1));
+    uint32_t hi = _mm_movemask_epi8 (_mm_packs_epi16 (le2, le3));
+    return lo | (hi << 16);
+#else
+    uint32_t mask = 0;
+    for (int j = 0; j < 32; j++) {
+        int shift = j < 16 ? 0 : 4;
+        int sum = 0;
+        for (size_t m = 0; m < M2; m++) {
+            sum += lut[m * 16 + ((block[m * 16 + (j & 15)] >> shift) & 15)];
+        }
+        if (sum <= qthresh) {
+            mask |= 1u << j;
+        }
+    }
+    return mask;
+#endif
+}
+
+
+template<MetricType METRIC_TYPE, class C>
+struct IVFPQFastScanScanner: InvertedListScanner {
+    const IndexIVFPQFastScan & ivfpq;
+    const ProductQuantizer & pq;
+    bool store_pairs;
+
+    size_t M2;          // nb of sub-quantizers in the block layout
+    size_t block_size;
+
+    const float *qi;
+    idx_t key;
+    float dis0;                    // coarse part of the distance
+    std::vector<float> sim_table;  // size M * 16
+    std::vector<float> residual;
+
+    // quantized tables, cost >= lut_bias + lut_scale * sum of entries
+    // where the cost is the distance for L2 and -similarity for IP
+    std::vector<uint8_t> lut;      // size M2 * 16
+    float lut_bias, lut_scale;
+
+    IVFPQFastScanScanner (const IndexIVFPQFastScan & ivfpq, bool store_pairs):
+        ivfpq (ivfpq), pq (ivfpq.pq), store_pairs (store_pairs),
+        M2 (ivfpq.code_size * 2),
+        block_size (BlockInvertedLists::n_per_block * ivfpq.code_size),
+        qi (nullptr), key (-1), dis0 (0),
+        sim_table (pq.M * 16), residual (ivfpq.d),
+        lut (M2 * 16), lut_bias (0), lut_scale (1)
+    {
+        FAISS_THROW_IF_NOT (pq.ksub == 16);
+    }
+
+    static float cost (float dis) {
+        return METRIC_TYPE == METRIC_L2 ? dis : -dis;
+    }
+
+    void set_query (const float *query) override {
+        qi = query;
+        if (METRIC_TYPE == METRIC_INNER_PRODUCT) {
+            pq.compute_inner_prod_table (qi, sim_table.data());
+        } else if (!ivfpq.by_residual) {
+            pq.compute_distance_table (qi, sim_table.data());
+        }
+    }
+
+    void set_list (idx_t list_no, float coarse_dis) override {
+        key = list_no;
+        dis0 = 0;
+        if (ivfpq.by_residual) {
+            if (METRIC_TYPE == METRIC_INNER_PRODUCT) {
+                dis0 = coarse_dis;
+            } else {
+                ivfpq.quantizer->compute_residual (qi, residual.data(), list_no);
+                pq.compute_distance_table (residual.data(), sim_table.data());
+            }
+        }
+        quantize_tables ();
+    }
+
+    /// shift each table by its min, then round down with a common scale
+    void quantize_tables () {
+        std::vector<float> mins (pq.M);
+        float max_span = 0;
+        lut_bias = cost (dis0);
+        for (size_t m = 0; m < pq.M; m++) {
+            const float *tab = sim_table.data() + m * 16;
+            float mn = cost (tab[0]), mx = cost (tab[0]);
+            for (size_t j = 1; j < 16; j++) {
+                mn = std::min (mn, cost (tab[j]));
+                mx = std::max (mx, cost (tab[j]));
+            }
+            mins[m] = mn;
+            lut_bias += mn;
+            max_span = std::max (max_span, mx - mn);
+        }
+        lut_scale = max_span > 0 ? max_span / 255 : 1;
+        float inv_scale = 1 / lut_scale;
+        for (size_t m = 0; m < pq.M; m++) {
+            const float *tab = sim_table.data() + m * 16;
+            for (size_t j = 0; j < 16; j++) {
+                float q = std::floor ((cost (tab[j]) - mins[m]) * inv_scale);
+                lut[m * 16 + j] = (uint8_t)std::min (std::max (q, 0.0f), 255.0f);
+            }
+        }
+        // the padding sub-quantizer of an odd M keeps zero entries
+    }
+
+    /// max sum of quantized entries that may beat the heap top, -1 if none
+    int quantized_threshold (float heap_top) const {
+        float t = (cost (heap_top) - lut_bias) / lut_scale;
+        if (t < -1) {
+            return -1;
+        }
+        // one unit of slack for the rounding of the tables
+        return t >= 65534 ? 65535 : (int)std::floor (t) + 1;
+    }
+
+    float distance_in_block (const uint8_t *block, size_t j) const {
+        int shift = j < 16 ? 0 : 4;
+        const uint8_t *c = block + (j & 15);
+        const float *tab = sim_table.data();
+        float dis = dis0;
+        for (size_t m = 0; m < pq.M; m++) {
+            dis += tab[(c[m * 16] >> shift) & 15];
+            tab += 16;
+        }
+        return dis;
+    }
+
+    float distance_to_code (const uint8_t *code) const override {
+        const float *tab = sim_table.data();
+        float dis = dis0;
+        for (size_t m = 0; m < pq.M; m++) {
+            dis += tab[(code[m >> 1] >> ((m & 1) * 4)) & 15];
+            tab += 16;
+        }
+        return dis;
+    }
+
+    size_t scan_codes (size_t ncode,
+                       const uint8_t *codes,
+                       const idx_t *ids,
+                       float *heap_sim, idx_t *heap_ids,
+                       size_t k,
+                       ConcurrentBitsetPtr bitset) const override
+    {
+        size_t nup = 0;
+        const size_t bs = BlockInvertedLists::n_per_block;
+        for (size_t j0 = 0; j0 < ncode; j0 += bs, codes += block_size) {
+            int qthresh = quantized_threshold (heap_sim[0]);
+            if (qthresh < 0) {
+                // the heap top only gets better, no code of the list can enter
+                break;
+            }
+            uint32_t mask = pq4_block_mask (codes, lut.data(), M2, qthresh);
+            if (ncode - j0 < bs) {
+                mask &= (1u << (ncode - j0)) - 1;
+            }
+            while (mask) {
+                size_t j = __builtin_ctz (mask);
+                mask &= mask - 1;
+                float dis = distance_in_block (codes, j);
+                if (C::cmp (heap_sim[0], dis)) {
+                    idx_t id = store_pairs ? lo_build (key, j0 + j) : ids[j0 + j];
+                    if (bitset != nullptr && bitset->test ((ConcurrentBitset::id_type_t)id)) {
+                        continue;
+                    }
+                    heap_swap_top<C> (k, heap_sim, heap_ids, dis, id);
+                    nup++;
+                }
+            }
+        }
+        return nup;
+    }
+
+    void scan_codes_range (size_t ncode,
+                           const uint8_t *codes,
+                           const idx_t *ids,
+                           float radius,
+                           RangeQueryResult & rres,
+                           ConcurrentBitsetPtr bitset = nullptr) const override
+    {
+        const size_t bs = BlockInvertedLists::n_per_block;
+        for (size_t j = 0; j < ncode; j++) {
+            float dis = distance_in_block (codes + j / bs * block_size, j % bs);
+            if (C::cmp (radius, dis)) {
+                idx_t id = store_pairs ? lo_build (key, j) : ids[j];
+                if (bitset != nullptr && bitset->test ((ConcurrentBitset::id_type_t)id)) {
+                    continue;
+                }
+                rres.add (dis, id);
+            }
+        }
+    }
+};
+
+} // anonymous namespace
+
+InvertedListScanner *
+IndexIVFPQFastScan::get_InvertedListScanner (bool store_pairs) const
+{
+    if (metric_type == METRIC_INNER_PRODUCT) {
+        return new IVFPQFastScanScanner
+            <METRIC_INNER_PRODUCT, CMin<float, idx_t>> (*this, store_pairs);
+    } else if (metric_type == METRIC_L2) {
+        return new IVFPQFastScanScanner
+            <METRIC_L2, CMax<float, idx_t>> (*this, store_pairs);
+    }
+    return nullptr;
+}
+
+} // namespace faiss
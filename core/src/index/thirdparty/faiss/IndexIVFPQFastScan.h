@@ -0,0 +1,68 @@
+
+// -*- c++ -*-
+
+#pragma once
+
+#include <faiss/IndexIVFPQ.h>
+
+
+namespace faiss {
+
+struct IVFPQFastScanSearchParameters: IVFSearchParameters {
+    size_t k_factor = 0;    ///< overrides the index k_factor if > 0
+    ~IVFPQFastScanSearchParameters () {}
+};
+
+
+/** IVFPQ with 4-bit codes that are scanned 32 at a time
+ *
+ * The codes are stored in a BlockInvertedLists. For each inverted list
+ * the distance tables of the query are quantized to 8 bits, so that the
+ * 16 entries of a sub-quantizer fit in a SIMD register and are looked up
+ * with a byte shuffle (pshufb) for the 32 codes of a block at once. The
+ * quantized sums are lower bounds of the PQ distances, only the codes
+ * that may enter the result heap get their exact PQ distance computed.
+ *
+ * The results can be refined with the raw vectors: k * k_factor
+ * candidates are collected and re-ranked with exact distances. The raw
+ * vectors are not owned by the index and are addressed by id, so this
+ * requires that ids are the row numbers of the raw vectors.
+ */
+struct IndexIVFPQFastScan: IndexIVFPQ {
+    /// factor between k requested in search and the k collected before
+    /// refinement, refinement is off if <= 1 or without refine_data
+    size_t k_factor;
+
+    /// raw vectors used for refinement, size ntotal * d, not owned
+    const float *refine_data;
+
+    IndexIVFPQFastScan (
+            Index * quantizer, size_t d, size_t nlist,
+            size_t M, MetricType metric = METRIC_L2);
+
+    /// use the raw vectors xb for refinement (nullptr to disable)
+    void set_refine_data (const float *xb);
+
+    void reconstruct_from_offset (int64_t list_no, int64_t offset,
+                                  float* recons) const override;
+
+    /// not supported, the codes of other are not in the block layout
+    void merge_from (IndexIVF &other, idx_t add_id) override;
+
+    void search_preassigned (idx_t n, const float *x, idx_t k,
+                             const idx_t *assign,
+                             const float *centroid_dis,
+                             float *distances, idx_t *labels,
+                             bool store_pairs,
+                             const IVFSearchParameters *params=nullptr,
+                             ConcurrentBitsetPtr bitset = nullptr
+                             ) const override;
+
+    InvertedListScanner *get_InvertedListScanner (bool store_pairs)
+        const override;
+
+    IndexIVFPQFastScan ();
+};
+
+
+} // namespace faiss
@@ -205,13 +205,23 @@ void IndexRHNSW::train(idx_t n, const float* x)
 void IndexRHNSW::search (idx_t n, const float *x, idx_t k,
                         float *distances, idx_t *labels, ConcurrentBitsetPtr bitset) const
 
+{
+    search_with_ef (n, x, k, distances, labels, 0, bitset);
+}
+
+void IndexRHNSW::search_with_ef (idx_t n, const float *x, idx_t k,
+                                 float *distances, idx_t *labels, int ef,
+                                 ConcurrentBitsetPtr bitset) const
 {
     FAISS_THROW_IF_NOT_MSG(storage,
        "Please use IndexHSNWFlat (or variants) instead of IndexRHNSW directly");
     size_t nreorder = 0;
+    if (ef <= 0) {
+        ef = hnsw.efSearch;
+    }
 
     idx_t check_period = InterruptCallback::get_period_hint (
-          hnsw.max_level * d * hnsw.efSearch);
+          hnsw.max_level * d * ef);
 
     for (idx_t i0 = 0; i0 < n; i0 += check_period) {
         idx_t i1 = std::min(i0 + check_period, n);
@@ -230,7 +240,7 @@ void IndexRHNSW::search (idx_t n, const float *x, idx_t k,
 
                 maxheap_heapify (k, simi, idxi);
 
-                hnsw.searchKnn(*dis, k, idxi, simi, bitset);
+                hnsw.searchKnn(*dis, k, idxi, simi, bitset, ef);
 
                 maxheap_reorder (k, simi, idxi);
 
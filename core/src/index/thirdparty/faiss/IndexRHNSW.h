@@ -94,6 +94,11 @@ struct IndexRHNSW : Index {
                  float *distances, idx_t *labels,
                  ConcurrentBitsetPtr bitset = nullptr) const override;
 
+    /// Similar to search, ef overrides hnsw.efSearch if positive, the index is not modified
+    void search_with_ef (idx_t n, const float *x, idx_t k,
+                         float *distances, idx_t *labels, int ef,
+                         ConcurrentBitsetPtr bitset = nullptr) const;
+
     void reconstruct(idx_t key, float* recons) const override;
 
     void reset () override;
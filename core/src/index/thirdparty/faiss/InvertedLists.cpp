@@ -484,6 +484,128 @@ bool ReadOnlyArrayInvertedLists::is_readonly() const {
     return true;
 }
 
+/*****************************************************************
+ * BlockInvertedLists implementation
+ *****************************************************************/
+
+const size_t BlockInvertedLists::n_per_block;
+
+BlockInvertedLists::BlockInvertedLists (size_t nlist, size_t code_size):
+    InvertedLists (nlist, code_size),
+    block_size (n_per_block * code_size)
+{
+    ids.resize (nlist);
+    codes.resize (nlist);
+}
+
+size_t BlockInvertedLists::list_size (size_t list_no) const
+{
+    assert (list_no < nlist);
+    return ids[list_no].size();
+}
+
+const uint8_t * BlockInvertedLists::get_codes (size_t list_no) const
+{
+    assert (list_no < nlist);
+    return codes[list_no].data();
+}
+
+const InvertedLists::idx_t * BlockInvertedLists::get_ids (size_t list_no) const
+{
+    assert (list_no < nlist);
+    return ids[list_no].data();
+}
+
+const uint8_t * BlockInvertedLists::get_single_code (
+           size_t list_no, size_t offset) const
+{
+    assert (offset < ids[list_no].size());
+    uint8_t * code = new uint8_t [code_size];
+    unpack_code (list_no, offset, code);
+    return code;
+}
+
+void BlockInvertedLists::release_codes (
+           size_t list_no, const uint8_t *codes_in) const
+{
+    // only the copies made by get_single_code are owned by the caller
+    if (codes_in != codes[list_no].data()) {
+        delete [] codes_in;
+    }
+}
+
+size_t BlockInvertedLists::add_entries (
+           size_t list_no, size_t n_entry,
+           const idx_t* ids_in, const uint8_t *code)
+{
+    if (n_entry == 0) return 0;
+    assert (list_no < nlist);
+    size_t o = ids [list_no].size();
+    resize (list_no, o + n_entry);
+    memcpy (&ids[list_no][o], ids_in, sizeof (ids_in[0]) * n_entry);
+    for (size_t i = 0; i < n_entry; i++) {
+        pack_code (list_no, o + i, code + i * code_size);
+    }
+    return o;
+}
+
+void BlockInvertedLists::update_entries (
+      size_t list_no, size_t offset, size_t n_entry,
+      const idx_t *ids_in, const uint8_t *codes_in)
+{
+    assert (list_no < nlist);
+    assert (n_entry + offset <= ids[list_no].size());
+    memcpy (&ids[list_no][offset], ids_in, sizeof(ids_in[0]) * n_entry);
+    for (size_t i = 0; i < n_entry; i++) {
+        pack_code (list_no, offset + i, codes_in + i * code_size);
+    }
+}
+
+void BlockInvertedLists::resize (size_t list_no, size_t new_size)
+{
+    size_t old_size = ids[list_no].size();
+    size_t n_block = (new_size + n_per_block - 1) / n_per_block;
+
+    // clear the entries dropped from the last kept block, padding stays 0
+    std::vector<uint8_t> zero (code_size);
+    for (size_t i = new_size; i < std::min (old_size, n_block * n_per_block); i++) {
+        pack_code (list_no, i, zero.data());
+    }
+    ids[list_no].resize (new_size);
+    codes[list_no].resize (n_block * block_size);
+}
+
+void BlockInvertedLists::pack_code (
+      size_t list_no, size_t offset, const uint8_t *code)
+{
+    uint8_t *block = codes[list_no].data() + offset / n_per_block * block_size;
+    size_t j = offset % n_per_block;
+    int shift = j < 16 ? 0 : 4;
+    uint8_t keep = 0xf0 >> shift;
+    block += j & 15;
+    for (size_t m = 0; m < code_size * 2; m++) {
+        uint8_t c = (code[m >> 1] >> ((m & 1) * 4)) & 15;
+        block[m * 16] = (block[m * 16] & keep) | (c << shift);
+    }
+}
+
+void BlockInvertedLists::unpack_code (
+      size_t list_no, size_t offset, uint8_t *code) const
+{
+    const uint8_t *block = codes[list_no].data() + offset / n_per_block * block_size;
+    size_t j = offset % n_per_block;
+    int shift = j < 16 ? 0 : 4;
+    block += j & 15;
+    memset (code, 0, code_size);
+    for (size_t m = 0; m < code_size * 2; m++) {
+        uint8_t c = (block[m * 16] >> shift) & 15;
+        code[m >> 1] |= c << ((m & 1) * 4);
+    }
+}
+
+BlockInvertedLists::~BlockInvertedLists ()
+{}
+
 /*****************************************************************
  * Meta-inverted list implementations
  *****************************************************************/
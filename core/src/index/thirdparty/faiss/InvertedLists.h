@@ -300,6 +300,54 @@ struct ReadOnlyArrayInvertedLists: InvertedLists {
     bool is_valid();
 };
 
+/** inverted lists of 4-bit codes stored in blocks of 32 entries, the
+ * layout read by the fast-scan kernels of IndexIVFPQFastScan
+ *
+ * In a block, each sub-quantizer takes 16 bytes: byte j holds the code
+ * of entry j in its low nibble and the code of entry j + 16 in its high
+ * nibble. The last block of a list is padded. The codes given to and
+ * returned by the entry functions are plain 4-bit PQ codes of code_size
+ * bytes, only get_codes returns the blocked layout.
+ */
+struct BlockInvertedLists: InvertedLists {
+    static const size_t n_per_block = 32;
+
+    size_t block_size;  ///< size of a block in bytes, n_per_block * code_size
+
+    std::vector < std::vector<uint8_t> > codes; // blocked codes, size nlist
+    std::vector < std::vector<idx_t> > ids;  ///< Inverted lists for indexes
+
+    BlockInvertedLists (size_t nlist, size_t code_size);
+
+    size_t list_size(size_t list_no) const override;
+
+    /// @return codes    size ceil(list_size / n_per_block) * block_size
+    const uint8_t * get_codes (size_t list_no) const override;
+    const idx_t * get_ids (size_t list_no) const override;
+
+    /// the code is unpacked to a copy that is freed by release_codes
+    const uint8_t * get_single_code (
+           size_t list_no, size_t offset) const override;
+    void release_codes (size_t list_no, const uint8_t *codes) const override;
+
+    size_t add_entries (
+           size_t list_no, size_t n_entry,
+           const idx_t* ids, const uint8_t *code) override;
+
+    void update_entries (size_t list_no, size_t offset, size_t n_entry,
+                         const idx_t *ids, const uint8_t *code) override;
+
+    void resize (size_t list_no, size_t new_size) override;
+
+    /// write code into the block layout of entry offset
+    void pack_code (size_t list_no, size_t offset, const uint8_t *code);
+
+    /// read the code of entry offset from the block layout
+    void unpack_code (size_t list_no, size_t offset, uint8_t *code) const;
+
+    virtual ~BlockInvertedLists ();
+};
+
 /*****************************************************************
  * Meta-inverted lists
  *
@@ -387,7 +387,8 @@ void RHNSW::prune_neighbors(DistanceComputer& ptdis,
 
 void RHNSW::searchKnn(DistanceComputer& qdis, int k,
             idx_t *I, float *D,
-            ConcurrentBitsetPtr bitset) const {
+            ConcurrentBitsetPtr bitset,
+            int ef) const {
   if (levels.size() == 0)
     return;
   int ep = entry_point;
@@ -412,7 +413,7 @@ void RHNSW::searchKnn(DistanceComputer& qdis, int k,
       }
     }
   }
-  std::priority_queue<Node, std::vector<Node>, CompareByFirst> top_candidates = search_base_layer(qdis, ep, std::max(efSearch, k), dist, bitset);
+  std::priority_queue<Node, std::vector<Node>, CompareByFirst> top_candidates = search_base_layer(qdis, ep, std::max(ef > 0 ? ef : efSearch, k), dist, bitset);
   while (top_candidates.size() > k)
     top_candidates.pop();
   int i = 0;
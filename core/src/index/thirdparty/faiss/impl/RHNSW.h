@@ -236,9 +236,11 @@ struct RHNSW {
                        const int maxM, int *ret, int &ret_len);
 
   /// search interface inspired by hnswlib
+  /// ef overrides efSearch if positive
   void searchKnn(DistanceComputer& qdis, int k,
                  idx_t *I, float *D,
-                 ConcurrentBitsetPtr bitset = nullptr) const;
+                 ConcurrentBitsetPtr bitset = nullptr,
+                 int ef = 0) const;
 
   size_t cal_size();
 
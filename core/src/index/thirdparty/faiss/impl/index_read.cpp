@@ -29,6 +29,7 @@
 #include <faiss/IndexIVF.h>
 #include <faiss/IndexIVFPQ.h>
 #include <faiss/IndexIVFPQR.h>
+#include <faiss/IndexIVFPQFastScan.h>
 #include <faiss/Index2Layer.h>
 #include <faiss/IndexIVFFlat.h>
 #include <faiss/IndexIVFSpectralHash.h>
@@ -226,6 +227,22 @@ InvertedLists *read_InvertedLists (IOReader *f, int io_flags) {
         READANDCHECK((uint8_t *) ails->pin_readonly_codes->data, n * code_size);
 #endif
         return ails;
+    } else if (h == fourcc ("ilbl")) {
+        size_t nlist, code_size;
+        READ1 (nlist);
+        READ1 (code_size);
+        auto bils = new BlockInvertedLists (nlist, code_size);
+        std::vector<size_t> sizes;
+        READVECTOR (sizes);
+        FAISS_THROW_IF_NOT (sizes.size() == nlist);
+        for (size_t i = 0; i < nlist; i++) {
+            if (sizes[i] > 0) {
+                bils->resize (i, sizes[i]);
+                READANDCHECK (bils->codes[i].data(), bils->codes[i].size());
+                READANDCHECK (bils->ids[i].data(), sizes[i]);
+            }
+        }
+        return bils;
     } else if (h == fourcc ("ilar") && !(io_flags & IO_FLAG_MMAP)) {
         auto ails = new ArrayInvertedLists (0, 0);
         READ1 (ails->nlist);
@@ -754,6 +771,15 @@ Index *read_index (IOReader *f, int io_flags) {
         READVECTOR (ivsp->trained);
         read_InvertedLists (ivsp, f, io_flags);
         idx = ivsp;
+    } else if(h == fourcc ("IwPf")) {
+        IndexIVFPQFastScan * ivfs = new IndexIVFPQFastScan ();
+        read_ivf_header (ivfs, f);
+        READ1 (ivfs->by_residual);
+        READ1 (ivfs->code_size);
+        read_ProductQuantizer (&ivfs->pq, f);
+        read_InvertedLists (ivfs, f, io_flags);
+        READ1 (ivfs->k_factor);
+        idx = ivfs;
     } else if(h == fourcc ("IvPQ") || h == fourcc ("IvQR") ||
               h == fourcc ("IwPQ") || h == fourcc ("IwQR")) {
 
@@ -29,6 +29,7 @@
 #include <faiss/IndexIVF.h>
 #include <faiss/IndexIVFPQ.h>
 #include <faiss/IndexIVFPQR.h>
+#include <faiss/IndexIVFPQFastScan.h>
 #include <faiss/Index2Layer.h>
 #include <faiss/IndexIVFFlat.h>
 #include <faiss/IndexIVFSpectralHash.h>
@@ -241,6 +242,25 @@ void write_InvertedLists (const InvertedLists *ils, IOWriter *f) {
                 WRITEANDCHECK (ails->ids[i].data(), n);
             }
         }
+    } else if (const auto & bils =
+               dynamic_cast<const BlockInvertedLists *>(ils)) {
+        uint32_t h = fourcc ("ilbl");
+        WRITE1 (h);
+        WRITE1 (bils->nlist);
+        WRITE1 (bils->code_size);
+        std::vector<size_t> sizes;
+        for (size_t i = 0; i < bils->nlist; i++) {
+            sizes.push_back (bils->ids[i].size());
+        }
+        WRITEVECTOR (sizes);
+        // the codes are stored in the block layout, padding included
+        for (size_t i = 0; i < bils->nlist; i++) {
+            size_t n = bils->ids[i].size();
+            if (n > 0) {
+                WRITEANDCHECK (bils->codes[i].data(), bils->codes[i].size());
+                WRITEANDCHECK (bils->ids[i].data(), n);
+            }
+        }
     } else if (const auto & oa =
             dynamic_cast<const ReadOnlyArrayInvertedLists *>(ils)) {
         uint32_t h = fourcc("iloa");
@@ -515,6 +535,16 @@ void write_index (const Index *idx, IOWriter *f) {
         WRITE1 (ivsp->threshold_type);
         WRITEVECTOR (ivsp->trained);
         write_InvertedLists (ivsp->invlists, f);
+    } else if(const IndexIVFPQFastScan * ivfs =
+              dynamic_cast<const IndexIVFPQFastScan *> (idx)) {
+        uint32_t h = fourcc ("IwPf");
+        WRITE1 (h);
+        write_ivf_header (ivfs, f);
+        WRITE1 (ivfs->by_residual);
+        WRITE1 (ivfs->code_size);
+        write_ProductQuantizer (&ivfs->pq, f);
+        write_InvertedLists (ivfs->invlists, f);
+        WRITE1 (ivfs->k_factor);
     } else if(const IndexIVFPQ * ivpq =
               dynamic_cast<const IndexIVFPQ *> (idx)) {
         const IndexIVFPQR * ivfpqr = dynamic_cast<const IndexIVFPQR *> (idx);
@@ -159,6 +159,36 @@ class ConcurrentBitset {
         return *this;
     }
 
+    // this = this & ~bitset, the argument is left unchanged
+    ConcurrentBitset&
+    and_not(const ConcurrentBitset& bitset) {
+        auto u8_1 = mutable_data();
+        auto u8_2 = bitset.data();
+        auto u64_1 = reinterpret_cast<uint64_t*>(u8_1);
+        auto u64_2 = reinterpret_cast<const uint64_t*>(u8_2);
+
+        size_t n8 = bitset_.size();
+        size_t n64 = n8 / 8;
+
+        for (size_t i = 0; i < n64; i++) {
+            u64_1[i] &= ~u64_2[i];
+        }
+
+        size_t remain = n8 % 8;
+        u8_1 += n64 * 8;
+        u8_2 += n64 * 8;
+        for (size_t i = 0; i < remain; i++) {
+            u8_1[i] &= ~u8_2[i];
+        }
+
+        return *this;
+    }
+
+    // clear all bits, so that the bitset can be reused
+    void
+    reset() {
+        memset(mutable_data(), 0, bitset_.size());
+    }
 
     bool
     test(id_type_t id) {
@@ -138,129 +138,99 @@ void fvec_renorm_L2 (size_t d, size_t nx, float * __restrict x)
 
 int parallel_policy_threshold = 65535;
 
-/* Find the nearest neighbors for nx queries in a set of ny vectors */
-static void knn_inner_product_sse (const float * x,
-                        const float * y,
-                        size_t d, size_t nx, size_t ny,
-                        float_minheap_array_t * res,
-                        ConcurrentBitsetPtr bitset = nullptr)
+/* Scan base vectors [j0, j1) for nq (<= 4) queries, the heap of query i is at val + i * k.
+ * Full tiles of 4 queries x 8 base vectors are computed by the register blocked kernel,
+ * the 8 bits of a tile are tested at once and 64 filtered vectors are skipped by one word.
+ * The heaps are updated after a tile is computed, so that the kernel runs without branches. */
+template <class C>
+static void knn_scan_tiles (const float * x, size_t nq,
+                            const float * y, size_t d,
+                            size_t j0, size_t j1,
+                            size_t k, float * val, int64_t * ids,
+                            const ConcurrentBitset * bitset,
+                            fvec_func_ptr dis_func,
+                            fvec_tile_func_ptr tile_func)
 {
-    size_t k = res->k;
-    size_t thread_max_num = omp_get_max_threads();
-
-    if (ny > parallel_policy_threshold || (nx < thread_max_num / 2 && ny >= thread_max_num * 32)) {
-        size_t block_x = std::min(
-                get_L3_Size() / (d * sizeof(float) + thread_max_num * k * (sizeof(float) + sizeof(int64_t))),
-                nx);
-        if (block_x == 0) {
-            block_x = 1;
-        }
-
-        size_t all_heap_size = block_x * k * thread_max_num;
-        float *value = new float[all_heap_size];
-        int64_t *labels = new int64_t[all_heap_size];
-
-        for (size_t x_from = 0, x_to; x_from < nx; x_from = x_to) {
-            x_to = std::min(nx, x_from + block_x);
-            int size = x_to - x_from;
-            int thread_heap_size = size * k;
-
-            // init heap
-            for (size_t i = 0; i < all_heap_size; i++) {
-                value[i] = -1.0 / 0.0;
-                labels[i] = -1;
-            }
-
-#pragma omp parallel for schedule(static)
-            for (size_t j = 0; j < ny; j++) {
-                if(!bitset || !bitset->test(j)) {
-                    size_t thread_no = omp_get_thread_num();
-                    const float *y_j = y + j * d;
-                    const float *x_i = x + x_from * d;
-                    for (size_t i = 0; i < size; i++) {
-                        float disij = fvec_inner_product (x_i, y_j, d);
-                        float * val_ = value + thread_no * thread_heap_size + i * k;
-                        int64_t * ids_ = labels + thread_no * thread_heap_size + i * k;
-                        if (disij > val_[0]) {
-                            minheap_swap_top (k, val_, ids_, disij, j);
-                        }
-                        x_i += d;
+    const uint8_t * bits = bitset ? bitset->data() : nullptr;
+    float dis[32];
+
+    size_t j = j0;
+    while (j < j1) {
+        // unaligned head or tail is computed one by one
+        if (j % 8 != 0 || j + 8 > j1) {
+            if (!bits || !((bits[j >> 3] >> (j & 7)) & 1)) {
+                for (size_t i = 0; i < nq; i++) {
+                    float disij = dis_func (x + i * d, y + j * d, d);
+                    if (C::cmp (val[i * k], disij)) {
+                        heap_swap_top<C> (k, val + i * k, ids + i * k, disij, j);
                     }
                 }
             }
+            j++;
+            continue;
+        }
 
-            // merge heap
-            for (size_t t = 1; t < thread_max_num; t++) {
-                for (size_t i = 0; i < size; i++) {
-                    float * __restrict value_x = value + i * k;
-                    int64_t * __restrict labels_x = labels + i * k;
-                    float *value_x_t = value_x + t * thread_heap_size;
-                    int64_t *labels_x_t = labels_x + t * thread_heap_size;
-                    for (size_t j = 0; j < k; j++) {
-                        if (value_x_t[j] > value_x[0]) {
-                            minheap_swap_top (k, value_x, labels_x, value_x_t[j], labels_x_t[j]);
-                        }
-                    }
+        uint8_t filtered = 0;
+        if (bits) {
+            if (j % 64 == 0 && j + 64 <= j1) {
+                uint64_t word;
+                memcpy (&word, bits + (j >> 3), sizeof(word));
+                if (word == ~(uint64_t)0) {
+                    j += 64;
+                    continue;
                 }
             }
-
-            // sort
-            for (size_t i = 0; i < size; i++) {
-                float * value_x = value + i * k;
-                int64_t * labels_x = labels + i * k;
-                minheap_reorder (k, value_x, labels_x);
+            filtered = bits[j >> 3];
+            if (filtered == 0xff) {
+                j += 8;
+                continue;
             }
-
-            // copy result
-            memcpy(res->val + x_from * k, value, thread_heap_size * sizeof(float));
-            memcpy(res->ids + x_from * k, labels, thread_heap_size * sizeof(int64_t));
         }
-        delete[] value;
-        delete[] labels;
-
-    } else {
-        float * value = res->val;
-        int64_t * labels = res->ids;
-
-#pragma omp parallel for
-        for (size_t i = 0; i < nx; i++) {
-            const float *x_i = x + i * d;
-            const float *y_j = y;
-
-            float * __restrict val_ = value  + i * k;
-            int64_t * __restrict ids_ = labels  + i * k;
-
-            for (size_t j = 0; j < k; j++) {
-                val_[j] = -1.0 / 0.0;
-                ids_[j] = -1;
-            }
 
-            for (size_t j = 0; j < ny; j++) {
-                if (!bitset || !bitset->test(j)) {
-                    float disij = fvec_inner_product (x_i, y_j, d);
-                    if (disij > val_[0]) {
-                        minheap_swap_top (k, val_, ids_, disij, j);
+        const float * y_j = y + j * d;
+        if (nq == 4) {
+            tile_func (x, y_j, d, dis);
+        } else {
+            for (size_t i = 0; i < nq; i++) {
+                for (size_t t = 0; t < 8; t++) {
+                    if (!((filtered >> t) & 1)) {
+                        dis[i * 8 + t] = dis_func (x + i * d, y_j + t * d, d);
                     }
                 }
-                y_j += d;
             }
+        }
 
-            minheap_reorder (k, val_, ids_);
+        for (size_t i = 0; i < nq; i++) {
+            float * val_i = val + i * k;
+            int64_t * ids_i = ids + i * k;
+            for (size_t t = 0; t < 8; t++) {
+                if (!((filtered >> t) & 1) && C::cmp (val_i[0], dis[i * 8 + t])) {
+                    heap_swap_top<C> (k, val_i, ids_i, dis[i * 8 + t], j + t);
+                }
+            }
         }
+        j += 8;
     }
 }
 
-static void knn_L2sqr_sse (
-                const float * x,
-                const float * y,
-                size_t d, size_t nx, size_t ny,
-                float_maxheap_array_t * res,
-                ConcurrentBitsetPtr bitset = nullptr)
+/* Find the nearest neighbors for nx queries in a set of ny vectors,
+ * C is CMax for L2 distance and CMin for inner product */
+template <class C>
+static void knn_sse (const float * x,
+                     const float * y,
+                     size_t d, size_t nx, size_t ny,
+                     HeapArray<C> * res,
+                     ConcurrentBitsetPtr bitset,
+                     float init_value,
+                     fvec_func_ptr dis_func,
+                     fvec_tile_func_ptr tile_func)
 {
     size_t k = res->k;
     size_t thread_max_num = omp_get_max_threads();
+    const ConcurrentBitset * bs = bitset.get();
 
-    if (ny > parallel_policy_threshold || (nx < thread_max_num / 2 && ny >= thread_max_num * 32)) {
+    // base vectors are split among threads if there are too few groups of 4 queries to keep all threads busy
+    if (ny > parallel_policy_threshold || (nx < 4 * thread_max_num && ny >= thread_max_num * 32)) {
         size_t block_x = std::min(
                 get_L3_Size() / (d * sizeof(float) + thread_max_num * k * (sizeof(float) + sizeof(int64_t))),
                 nx);
@@ -272,6 +242,10 @@ static void knn_L2sqr_sse (
         float *value = new float[all_heap_size];
         int64_t *labels = new int64_t[all_heap_size];
 
+        // base vectors are split by 64, so that the tiles and the bitset words are aligned
+        size_t block_y = 64;
+        size_t y_blocks = (ny + block_y - 1) / block_y;
+
         for (size_t x_from = 0, x_to; x_from < nx; x_from = x_to) {
             x_to = std::min(nx, x_from + block_x);
             int size = x_to - x_from;
@@ -279,25 +253,20 @@ static void knn_L2sqr_sse (
 
             // init heap
             for (size_t i = 0; i < all_heap_size; i++) {
-                value[i] = 1.0 / 0.0;
+                value[i] = init_value;
                 labels[i] = -1;
             }
 
 #pragma omp parallel for schedule(static)
-            for (size_t j = 0; j < ny; j++) {
-                if(!bitset || !bitset->test(j)) {
-                    size_t thread_no = omp_get_thread_num();
-                    const float *y_j = y + j * d;
-                    const float *x_i = x + x_from * d;
-                    for (size_t i = 0; i < size; i++) {
-                        float disij = fvec_L2sqr (x_i, y_j, d);
-                        float * val_ = value + thread_no * thread_heap_size + i * k;
-                        int64_t * ids_ = labels + thread_no * thread_heap_size + i * k;
-                        if (disij < val_[0]) {
-                            maxheap_swap_top (k, val_, ids_, disij, j);
-                        }
-                        x_i += d;
-                    }
+            for (size_t b = 0; b < y_blocks; b++) {
+                size_t thread_no = omp_get_thread_num();
+                size_t j0 = b * block_y;
+                size_t j1 = std::min(ny, j0 + block_y);
+                for (int i = 0; i < size; i += 4) {
+                    size_t nq = std::min(4, size - i);
+                    size_t heap_offset = thread_no * thread_heap_size + i * k;
+                    knn_scan_tiles<C> (x + (x_from + i) * d, nq, y, d, j0, j1, k,
+                                       value + heap_offset, labels + heap_offset, bs, dis_func, tile_func);
                 }
             }
 
@@ -309,8 +278,8 @@ static void knn_L2sqr_sse (
                     float *value_x_t = value_x + t * thread_heap_size;
                     int64_t *labels_x_t = labels_x + t * thread_heap_size;
                     for (size_t j = 0; j < k; j++) {
-                        if (value_x_t[j] < value_x[0]) {
-                            maxheap_swap_top (k, value_x, labels_x, value_x_t[j], labels_x_t[j]);
+                        if (C::cmp (value_x[0], value_x_t[j])) {
+                            heap_swap_top<C> (k, value_x, labels_x, value_x_t[j], labels_x_t[j]);
                         }
                     }
                 }
@@ -320,7 +289,7 @@ static void knn_L2sqr_sse (
             for (size_t i = 0; i < size; i++) {
                 float * value_x = value + i * k;
                 int64_t * labels_x = labels + i * k;
-                maxheap_reorder (k, value_x, labels_x);
+                heap_reorder<C> (k, value_x, labels_x);
             }
 
             // copy result
@@ -331,38 +300,54 @@ static void knn_L2sqr_sse (
         delete[] labels;
 
     } else {
-
         float * value = res->val;
         int64_t * labels = res->ids;
 
+        // a thread searches 4 queries together, so that the tile kernel is used whenever nx >= 4
+        size_t group = 4;
+        size_t groups = (nx + group - 1) / group;
+
 #pragma omp parallel for
-        for (size_t i = 0; i < nx; i++) {
-            const float *x_i = x + i * d;
-            const float *y_j = y;
+        for (size_t g = 0; g < groups; g++) {
+            size_t i0 = g * group;
+            size_t nq = std::min(group, nx - i0);
 
-            float * __restrict val_ = value  + i * k;
-            int64_t * __restrict ids_ = labels  + i * k;
+            float * __restrict val_ = value + i0 * k;
+            int64_t * __restrict ids_ = labels + i0 * k;
 
-            for (size_t j = 0; j < k; j++) {
-                val_[j] = 1.0 / 0.0;
+            for (size_t j = 0; j < nq * k; j++) {
+                val_[j] = init_value;
                 ids_[j] = -1;
             }
 
-            for (size_t j = 0; j < ny; j++) {
-                if (!bitset || !bitset->test(j)) {
-                    float disij = fvec_L2sqr (x_i, y_j, d);
-                    if (disij < val_[0]) {
-                        maxheap_swap_top (k, val_, ids_, disij, j);
-                    }
-                }
-                y_j += d;
-            }
+            knn_scan_tiles<C> (x + i0 * d, nq, y, d, 0, ny, k, val_, ids_, bs, dis_func, tile_func);
 
-            maxheap_reorder (k, val_, ids_);
+            for (size_t i = 0; i < nq; i++) {
+                heap_reorder<C> (k, val_ + i * k, ids_ + i * k);
+            }
         }
     }
 }
 
+static void knn_inner_product_sse (const float * x,
+                        const float * y,
+                        size_t d, size_t nx, size_t ny,
+                        float_minheap_array_t * res,
+                        ConcurrentBitsetPtr bitset = nullptr)
+{
+    knn_sse (x, y, d, nx, ny, res, bitset, -1.0 / 0.0, fvec_inner_product, fvec_inner_product_4x8);
+}
+
+static void knn_L2sqr_sse (
+                const float * x,
+                const float * y,
+                size_t d, size_t nx, size_t ny,
+                float_maxheap_array_t * res,
+                ConcurrentBitsetPtr bitset = nullptr)
+{
+    knn_sse (x, y, d, nx, ny, res, bitset, 1.0 / 0.0, fvec_L2sqr, fvec_L2sqr_4x8);
+}
+
 /** Find the nearest neighbors for nx queries in a set of ny vectors */
 static void knn_inner_product_blas (
         const float * x,
@@ -44,6 +44,20 @@ float fvec_Linf_sse (
         const float * x,
         const float * y,
         size_t d);
+
+/// distances between 4 queries and 8 base vectors, both stored contiguously,
+/// dis[i * 8 + j] is the distance between query i and base vector j
+void fvec_L2sqr_4x8_sse (
+        const float * x,
+        const float * y,
+        size_t d,
+        float * dis);
+
+void fvec_inner_product_4x8_sse (
+        const float * x,
+        const float * y,
+        size_t d,
+        float * dis);
 #endif
 
 float fvec_jaccard (
@@ -376,6 +376,31 @@ float fvec_inner_product_sse (const float * x,
     return  _mm_cvtss_f32 (msum1);
 }
 
+// the tile is computed pair by pair, the register blocked versions are for avx and avx512
+void fvec_L2sqr_4x8_sse (const float * x,
+                         const float * y,
+                         size_t d,
+                         float * dis)
+{
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 8; j++) {
+            dis[i * 8 + j] = fvec_L2sqr_sse (x + i * d, y + j * d, d);
+        }
+    }
+}
+
+void fvec_inner_product_4x8_sse (const float * x,
+                                 const float * y,
+                                 size_t d,
+                                 float * dis)
+{
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 8; j++) {
+            dis[i * 8 + j] = fvec_inner_product_sse (x + i * d, y + j * d, d);
+        }
+    }
+}
+
 #endif /* defined(__SSE__) */
 
 //#elif defined(__aarch64__)
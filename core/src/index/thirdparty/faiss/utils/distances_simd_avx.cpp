@@ -186,6 +186,117 @@ float fvec_Linf_avx (const float* x, const float* y, size_t d) {
     return  _mm_cvtss_f32 (msum2);
 }
 
+// reduce the 8 lanes and add the tail dimensions (d < 8) in the same order as fvec_L2sqr_avx
+static inline float L2sqr_reduce_avx (__m256 msum1, const float* x, const float* y, size_t d) {
+    __m128 msum2 = _mm256_extractf128_ps(msum1, 1);
+    msum2 +=       _mm256_extractf128_ps(msum1, 0);
+
+    if (d >= 4) {
+        __m128 mx = _mm_loadu_ps (x); x += 4;
+        __m128 my = _mm_loadu_ps (y); y += 4;
+        const __m128 a_m_b1 = mx - my;
+        msum2 += a_m_b1 * a_m_b1;
+        d -= 4;
+    }
+
+    if (d > 0) {
+        __m128 mx = masked_read (d, x);
+        __m128 my = masked_read (d, y);
+        __m128 a_m_b1 = mx - my;
+        msum2 += a_m_b1 * a_m_b1;
+    }
+
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    return  _mm_cvtss_f32 (msum2);
+}
+
+// reduce the 8 lanes and add the tail dimensions (d < 8) in the same order as fvec_inner_product_avx
+static inline float inner_product_reduce_avx (__m256 msum1, const float* x, const float* y, size_t d) {
+    __m128 msum2 = _mm256_extractf128_ps(msum1, 1);
+    msum2 +=       _mm256_extractf128_ps(msum1, 0);
+
+    if (d >= 4) {
+        __m128 mx = _mm_loadu_ps (x); x += 4;
+        __m128 my = _mm_loadu_ps (y); y += 4;
+        msum2 = _mm_add_ps (msum2, _mm_mul_ps (mx, my));
+        d -= 4;
+    }
+
+    if (d > 0) {
+        __m128 mx = masked_read (d, x);
+        __m128 my = masked_read (d, y);
+        msum2 = _mm_add_ps (msum2, _mm_mul_ps (mx, my));
+    }
+
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    return  _mm_cvtss_f32 (msum2);
+}
+
+/* 4 queries x 8 base vectors are computed by sub-tiles of 4 x 2, the 8 accumulators and
+ * 4 query registers fit in the 16 ymm registers, each loaded vector is used 2 or 4 times */
+
+void fvec_L2sqr_4x8_avx (const float* x, const float* y, size_t d, float* dis) {
+    size_t d8 = d & ~(size_t)7;
+    for (size_t j = 0; j < 8; j += 2) {
+        const float* y0 = y + j * d;
+        const float* y1 = y0 + d;
+        __m256 msum[4][2];
+        for (size_t i = 0; i < 4; i++) {
+            msum[i][0] = _mm256_setzero_ps();
+            msum[i][1] = _mm256_setzero_ps();
+        }
+
+        for (size_t l = 0; l < d8; l += 8) {
+            __m256 my0 = _mm256_loadu_ps (y0 + l);
+            __m256 my1 = _mm256_loadu_ps (y1 + l);
+            for (size_t i = 0; i < 4; i++) {
+                __m256 mx = _mm256_loadu_ps (x + i * d + l);
+                const __m256 a_m_b0 = mx - my0;
+                const __m256 a_m_b1 = mx - my1;
+                msum[i][0] += a_m_b0 * a_m_b0;
+                msum[i][1] += a_m_b1 * a_m_b1;
+            }
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            const float* x_i = x + i * d + d8;
+            dis[i * 8 + j] = L2sqr_reduce_avx (msum[i][0], x_i, y0 + d8, d - d8);
+            dis[i * 8 + j + 1] = L2sqr_reduce_avx (msum[i][1], x_i, y1 + d8, d - d8);
+        }
+    }
+}
+
+void fvec_inner_product_4x8_avx (const float* x, const float* y, size_t d, float* dis) {
+    size_t d8 = d & ~(size_t)7;
+    for (size_t j = 0; j < 8; j += 2) {
+        const float* y0 = y + j * d;
+        const float* y1 = y0 + d;
+        __m256 msum[4][2];
+        for (size_t i = 0; i < 4; i++) {
+            msum[i][0] = _mm256_setzero_ps();
+            msum[i][1] = _mm256_setzero_ps();
+        }
+
+        for (size_t l = 0; l < d8; l += 8) {
+            __m256 my0 = _mm256_loadu_ps (y0 + l);
+            __m256 my1 = _mm256_loadu_ps (y1 + l);
+            for (size_t i = 0; i < 4; i++) {
+                __m256 mx = _mm256_loadu_ps (x + i * d + l);
+                msum[i][0] = _mm256_add_ps (msum[i][0], _mm256_mul_ps (mx, my0));
+                msum[i][1] = _mm256_add_ps (msum[i][1], _mm256_mul_ps (mx, my1));
+            }
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            const float* x_i = x + i * d + d8;
+            dis[i * 8 + j] = inner_product_reduce_avx (msum[i][0], x_i, y0 + d8, d - d8);
+            dis[i * 8 + j + 1] = inner_product_reduce_avx (msum[i][1], x_i, y1 + d8, d - d8);
+        }
+    }
+}
+
 #else
 
 float fvec_inner_product_avx(const float* x, const float* y, size_t d) {
@@ -208,6 +319,14 @@ float fvec_Linf_avx (const float* x, const float* y, size_t d) {
     return 0.0;
 }
 
+void fvec_L2sqr_4x8_avx (const float* x, const float* y, size_t d, float* dis) {
+    FAISS_ASSERT(false);
+}
+
+void fvec_inner_product_4x8_avx (const float* x, const float* y, size_t d, float* dis) {
+    FAISS_ASSERT(false);
+}
+
 #endif
 
 } // namespace faiss
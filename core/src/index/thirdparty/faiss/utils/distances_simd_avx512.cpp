@@ -219,6 +219,148 @@ fvec_Linf_avx512(const float* x, const float* y, size_t d) {
     return  _mm_cvtss_f32 (msum2);
 }
 
+// reduce the 16 lanes and add the tail dimensions (d < 16) in the same order as fvec_L2sqr_avx512
+static inline float
+L2sqr_reduce_avx512(__m512 msum0, const float* x, const float* y, size_t d) {
+    __m256 msum1 = _mm512_extractf32x8_ps(msum0, 1);
+    msum1 +=       _mm512_extractf32x8_ps(msum0, 0);
+
+    if (d >= 8) {
+        __m256 mx = _mm256_loadu_ps (x); x += 8;
+        __m256 my = _mm256_loadu_ps (y); y += 8;
+        const __m256 a_m_b1 = mx - my;
+        msum1 += a_m_b1 * a_m_b1;
+        d -= 8;
+    }
+
+    __m128 msum2 = _mm256_extractf128_ps(msum1, 1);
+    msum2 +=       _mm256_extractf128_ps(msum1, 0);
+
+    if (d >= 4) {
+        __m128 mx = _mm_loadu_ps (x); x += 4;
+        __m128 my = _mm_loadu_ps (y); y += 4;
+        const __m128 a_m_b1 = mx - my;
+        msum2 += a_m_b1 * a_m_b1;
+        d -= 4;
+    }
+
+    if (d > 0) {
+        __m128 mx = masked_read (d, x);
+        __m128 my = masked_read (d, y);
+        __m128 a_m_b1 = mx - my;
+        msum2 += a_m_b1 * a_m_b1;
+    }
+
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    return  _mm_cvtss_f32 (msum2);
+}
+
+// reduce the 16 lanes and add the tail dimensions (d < 16) in the same order as fvec_inner_product_avx512
+static inline float
+inner_product_reduce_avx512(__m512 msum0, const float* x, const float* y, size_t d) {
+    __m256 msum1 = _mm512_extractf32x8_ps(msum0, 1);
+    msum1 +=       _mm512_extractf32x8_ps(msum0, 0);
+
+    if (d >= 8) {
+        __m256 mx = _mm256_loadu_ps (x); x += 8;
+        __m256 my = _mm256_loadu_ps (y); y += 8;
+        msum1 = _mm256_add_ps (msum1, _mm256_mul_ps (mx, my));
+        d -= 8;
+    }
+
+    __m128 msum2 = _mm256_extractf128_ps(msum1, 1);
+    msum2 +=       _mm256_extractf128_ps(msum1, 0);
+
+    if (d >= 4) {
+        __m128 mx = _mm_loadu_ps (x); x += 4;
+        __m128 my = _mm_loadu_ps (y); y += 4;
+        msum2 = _mm_add_ps (msum2, _mm_mul_ps (mx, my));
+        d -= 4;
+    }
+
+    if (d > 0) {
+        __m128 mx = masked_read (d, x);
+        __m128 my = masked_read (d, y);
+        msum2 = _mm_add_ps (msum2, _mm_mul_ps (mx, my));
+    }
+
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    msum2 = _mm_hadd_ps (msum2, msum2);
+    return  _mm_cvtss_f32 (msum2);
+}
+
+/* 4 queries x 8 base vectors are computed by sub-tiles of 4 x 4, the 16 accumulators and
+ * 4 query registers fit in the 32 zmm registers, each loaded vector is used 4 times */
+
+void
+fvec_L2sqr_4x8_avx512(const float* x, const float* y, size_t d, float* dis) {
+    size_t d16 = d & ~(size_t)15;
+    for (size_t j = 0; j < 8; j += 4) {
+        const float* y_j = y + j * d;
+        __m512 msum[4][4];
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t t = 0; t < 4; t++) {
+                msum[i][t] = _mm512_setzero_ps();
+            }
+        }
+
+        for (size_t l = 0; l < d16; l += 16) {
+            __m512 mx[4];
+            for (size_t i = 0; i < 4; i++) {
+                mx[i] = _mm512_loadu_ps (x + i * d + l);
+            }
+            for (size_t t = 0; t < 4; t++) {
+                __m512 my = _mm512_loadu_ps (y_j + t * d + l);
+                for (size_t i = 0; i < 4; i++) {
+                    const __m512 a_m_b1 = mx[i] - my;
+                    msum[i][t] += a_m_b1 * a_m_b1;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t t = 0; t < 4; t++) {
+                dis[i * 8 + j + t] = L2sqr_reduce_avx512(msum[i][t], x + i * d + d16, y_j + t * d + d16, d - d16);
+            }
+        }
+    }
+}
+
+void
+fvec_inner_product_4x8_avx512(const float* x, const float* y, size_t d, float* dis) {
+    size_t d16 = d & ~(size_t)15;
+    for (size_t j = 0; j < 8; j += 4) {
+        const float* y_j = y + j * d;
+        __m512 msum[4][4];
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t t = 0; t < 4; t++) {
+                msum[i][t] = _mm512_setzero_ps();
+            }
+        }
+
+        for (size_t l = 0; l < d16; l += 16) {
+            __m512 mx[4];
+            for (size_t i = 0; i < 4; i++) {
+                mx[i] = _mm512_loadu_ps (x + i * d + l);
+            }
+            for (size_t t = 0; t < 4; t++) {
+                __m512 my = _mm512_loadu_ps (y_j + t * d + l);
+                for (size_t i = 0; i < 4; i++) {
+                    msum[i][t] = _mm512_add_ps (msum[i][t], _mm512_mul_ps (mx[i], my));
+                }
+            }
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t t = 0; t < 4; t++) {
+                dis[i * 8 + j + t] =
+                    inner_product_reduce_avx512(msum[i][t], x + i * d + d16, y_j + t * d + d16, d - d16);
+            }
+        }
+    }
+}
+
 #else
 
 float
@@ -245,6 +387,16 @@ fvec_Linf_avx512(const float* x, const float* y, size_t d) {
     return 0.0;
 }
 
+void
+fvec_L2sqr_4x8_avx512(const float* x, const float* y, size_t d, float* dis) {
+    FAISS_ASSERT(false);
+}
+
+void
+fvec_inner_product_4x8_avx512(const float* x, const float* y, size_t d, float* dis) {
+    FAISS_ASSERT(false);
+}
+
 #endif
 
 } // namespace faiss
@@ -0,0 +1,68 @@
+
+// -*- c++ -*-
+
+#include <faiss/utils/half_float.h>
+
+#include <cstring>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+#include <faiss/impl/ScalarQuantizerOp.h>
+
+namespace faiss {
+
+void fvec_to_fp16 (uint16_t * dst, const float * src, size_t n)
+{
+    size_t i = 0;
+#ifdef __F16C__
+    for (; i + 8 <= n; i += 8) {
+        __m256 xf = _mm256_loadu_ps (src + i);
+        __m128i xh = _mm256_cvtps_ph (xf, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        _mm_storeu_si128 ((__m128i*)(dst + i), xh);
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = encode_fp16 (src[i]);
+    }
+}
+
+void fp16_to_fvec (float * dst, const uint16_t * src, size_t n)
+{
+    size_t i = 0;
+#ifdef __F16C__
+    for (; i + 8 <= n; i += 8) {
+        __m128i xh = _mm_loadu_si128 ((const __m128i*)(src + i));
+        _mm256_storeu_ps (dst + i, _mm256_cvtph_ps (xh));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = decode_fp16 (src[i]);
+    }
+}
+
+/* bf16 is the high half of a float, the loops below are plain integer
+ * operations without branches so that the compiler vectorizes them */
+
+void fvec_to_bf16 (uint16_t * dst, const float * src, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x;
+        memcpy (&x, src + i, sizeof (x));
+        // round to nearest even, NaN gets the quiet bit so that it doesn't become infinity
+        uint32_t rounded = (x + 0x7fffu + ((x >> 16) & 1u)) >> 16;
+        uint32_t nan = (x >> 16) | 0x40u;
+        dst[i] = (uint16_t)(((x & 0x7fffffffu) > 0x7f800000u) ? nan : rounded);
+    }
+}
+
+void bf16_to_fvec (float * dst, const uint16_t * src, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x = (uint32_t)src[i] << 16;
+        memcpy (dst + i, &x, sizeof (x));
+    }
+}
+
+} // namespace faiss
@@ -0,0 +1,26 @@
+
+// -*- c++ -*-
+
+/* Conversions between float vectors and the 16-bit float formats
+ * used to store raw vectors, fp16 (IEEE half) and bf16 (bfloat16). */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace faiss {
+
+/// convert n floats to fp16, rounding to nearest even
+void fvec_to_fp16 (uint16_t * dst, const float * src, size_t n);
+
+/// convert n fp16 values to floats, the conversion is exact
+void fp16_to_fvec (float * dst, const uint16_t * src, size_t n);
+
+/// convert n floats to bf16, rounding to nearest even, NaN is kept quiet
+void fvec_to_bf16 (uint16_t * dst, const float * src, size_t n);
+
+/// convert n bf16 values to floats, the conversion is exact
+void bf16_to_fvec (float * dst, const uint16_t * src, size_t n);
+
+} // namespace faiss
@@ -1059,10 +1059,12 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         return cur_c;
     };
 
+    // ef overrides ef_ if positive, so concurrent searches with different ef don't modify the index
     std::priority_queue<std::pair<dist_t, labeltype >>
-    searchKnn(const void *query_data, size_t k, faiss::ConcurrentBitsetPtr bitset) const {
+    searchKnn(const void *query_data, size_t k, faiss::ConcurrentBitsetPtr bitset, size_t ef = 0) const {
         std::priority_queue<std::pair<dist_t, labeltype >> result;
         if (cur_element_count == 0) return result;
+        if (ef == 0) ef = ef_;
 
         tableint currObj = enterpoint_node_;
         dist_t curdist = fstdistfunc_(query_data, getDataByInternalId(enterpoint_node_), dist_func_param_);
@@ -1094,12 +1096,12 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst> top_candidates;
         if (bitset != nullptr) {
             std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
-                top_candidates1 = searchBaseLayerST<true>(currObj, query_data, std::max(ef_, k), bitset);
+                top_candidates1 = searchBaseLayerST<true>(currObj, query_data, std::max(ef, k), bitset);
             top_candidates.swap(top_candidates1);
         }
         else{
             std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
-                top_candidates1 = searchBaseLayerST<false>(currObj, query_data, std::max(ef_, k), bitset);
+                top_candidates1 = searchBaseLayerST<false>(currObj, query_data, std::max(ef, k), bitset);
             top_candidates.swap(top_candidates1);
         }
         while (top_candidates.size() > k) {
@@ -1115,11 +1117,11 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
     template <typename Comp>
     std::vector<std::pair<dist_t, labeltype>>
-    searchKnn(const void* query_data, size_t k, Comp comp, faiss::ConcurrentBitsetPtr bitset) {
+    searchKnn(const void* query_data, size_t k, Comp comp, faiss::ConcurrentBitsetPtr bitset, size_t ef = 0) {
         std::vector<std::pair<dist_t, labeltype>> result;
         if (cur_element_count == 0) return result;
 
-        auto ret = searchKnn(query_data, k, bitset);
+        auto ret = searchKnn(query_data, k, bitset, ef);
 
         while (!ret.empty()) {
             result.push_back(ret.top());
@@ -15,6 +15,7 @@
 #include "knowhere/index/IndexType.h"
 #include "knowhere/index/vector_index/IndexIVF.h"
 #include "knowhere/index/vector_index/IndexIVFPQ.h"
+#include "knowhere/index/vector_index/IndexIVFPQFastScan.h"
 #include "knowhere/index/vector_index/IndexIVFSQ.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #include "knowhere/index/vector_offset_index/IndexIVF_NM.h"
@@ -43,6 +44,8 @@ IndexFactory(const milvus::knowhere::IndexType& type, const milvus::knowhere::In
             return std::make_shared<milvus::knowhere::IVF>();
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ) {
             return std::make_shared<milvus::knowhere::IVFPQ>();
+        } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN) {
+            return std::make_shared<milvus::knowhere::IVFPQFastScan>();
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8) {
             return std::make_shared<milvus::knowhere::IVFSQ>();
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8H) {
@@ -112,6 +115,17 @@ class ParamGenerator {
                 {milvus::knowhere::INDEX_FILE_SLICE_SIZE_IN_MEGABYTE, 4},
                 {milvus::knowhere::meta::DEVICEID, DEVICEID},
             };
+        } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN) {
+            return milvus::knowhere::Config{
+                {milvus::knowhere::meta::DIM, DIM},
+                {milvus::knowhere::meta::TOPK, K},
+                {milvus::knowhere::IndexParams::nlist, 100},
+                {milvus::knowhere::IndexParams::nprobe, 4},
+                {milvus::knowhere::IndexParams::m, 16},
+                {milvus::knowhere::Metric::TYPE, milvus::knowhere::Metric::L2},
+                {milvus::knowhere::INDEX_FILE_SLICE_SIZE_IN_MEGABYTE, 4},
+                {milvus::knowhere::meta::DEVICEID, DEVICEID},
+            };
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8 ||
                    type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8H) {
             return milvus::knowhere::Config{
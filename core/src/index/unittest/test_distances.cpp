@@ -0,0 +1,229 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <faiss/FaissHook.h>
+#include <faiss/utils/ConcurrentBitset.h>
+#include <faiss/utils/distances.h>
+#include <faiss/utils/distances_avx.h>
+#include <faiss/utils/distances_avx512.h>
+
+/* The brute force search computes full tiles of 4 queries x 8 base vectors by the register blocked kernels,
+ * these tests compare it with a scalar scan. */
+
+namespace {
+
+constexpr size_t K = 10;
+
+float
+ScalarL2sqr(const float* x, const float* y, size_t d) {
+    double res = 0;
+    for (size_t i = 0; i < d; i++) {
+        double diff = x[i] - y[i];
+        res += diff * diff;
+    }
+    return res;
+}
+
+float
+ScalarInnerProduct(const float* x, const float* y, size_t d) {
+    double res = 0;
+    for (size_t i = 0; i < d; i++) {
+        res += static_cast<double>(x[i]) * y[i];
+    }
+    return res;
+}
+
+std::vector<float>
+RandomVectors(size_t n, size_t d, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> data(n * d);
+    for (auto& value : data) {
+        value = dist(gen);
+    }
+    return data;
+}
+
+void
+CheckTileFunc(faiss::fvec_tile_func_ptr tile_func, decltype(&ScalarL2sqr) scalar_func, size_t d) {
+    auto x = RandomVectors(4, d, 100 + d);
+    auto y = RandomVectors(8, d, 200 + d);
+    float dis[32];
+    tile_func(x.data(), y.data(), d, dis);
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 8; j++) {
+            float expect = scalar_func(x.data() + i * d, y.data() + j * d, d);
+            ASSERT_NEAR(dis[i * 8 + j], expect, 1e-4 * (1 + std::fabs(expect)))
+                << "d " << d << " at " << i << ", " << j;
+        }
+    }
+}
+
+enum class BitsetPattern { NONE, RANDOM, FULL_WORD, FULL_BYTE, MOSTLY_FILTERED };
+
+faiss::ConcurrentBitsetPtr
+MakeBitset(BitsetPattern pattern, size_t ny) {
+    if (pattern == BitsetPattern::NONE) {
+        return nullptr;
+    }
+
+    auto bitset = std::make_shared<faiss::ConcurrentBitset>(ny);
+    std::mt19937 gen(ny);
+    for (size_t j = 0; j < ny; j++) {
+        bool filtered = false;
+        switch (pattern) {
+            case BitsetPattern::RANDOM:
+                filtered = gen() % 3 == 0;
+                break;
+            case BitsetPattern::FULL_WORD:
+                // the second 64-bit word is all set, and the bits around it are not
+                filtered = j >= 64 && j < 128;
+                break;
+            case BitsetPattern::FULL_BYTE:
+                // whole bytes and a partial byte
+                filtered = (j >= 8 && j < 16) || (j >= 72 && j < 80) || j % 13 == 0;
+                break;
+            default:
+                // fewer vectors left than k
+                filtered = j % 50 != 7;
+                break;
+        }
+        if (filtered) {
+            bitset->set(j);
+        }
+    }
+    return bitset;
+}
+
+// nearest neighbors of each query by the scalar scan, -1 is padded if there are less than k candidates
+template <class C>
+void
+ScalarKnn(const float* x, const float* y, size_t d, size_t nx, size_t ny, const faiss::ConcurrentBitsetPtr& bitset,
+          decltype(&ScalarL2sqr) scalar_func, std::vector<float>& val, std::vector<int64_t>& ids) {
+    val.resize(nx * K);
+    ids.resize(nx * K);
+    for (size_t i = 0; i < nx; i++) {
+        std::vector<std::pair<float, int64_t>> candidates;
+        for (size_t j = 0; j < ny; j++) {
+            if (bitset == nullptr || !bitset->test(j)) {
+                candidates.emplace_back(scalar_func(x + i * d, y + j * d, d), j);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const std::pair<float, int64_t>& a, const std::pair<float, int64_t>& b) {
+                      return C::cmp(b.first, a.first);
+                  });
+        for (size_t r = 0; r < K; r++) {
+            val[i * K + r] = r < candidates.size() ? candidates[r].first : 0;
+            ids[i * K + r] = r < candidates.size() ? candidates[r].second : -1;
+        }
+    }
+}
+
+// distances may differ slightly in the last bits, so ids are checked by their scalar distance instead of equality
+void
+CheckKnn(const float* x, const float* y, size_t d, size_t nx, size_t ny, const faiss::ConcurrentBitsetPtr& bitset,
+         decltype(&ScalarL2sqr) scalar_func, const float* val, const int64_t* ids, const std::vector<float>& ref_val,
+         const std::vector<int64_t>& ref_ids, const std::string& msg) {
+    for (size_t i = 0; i < nx; i++) {
+        for (size_t r = 0; r < K; r++) {
+            size_t pos = i * K + r;
+            if (ref_ids[pos] == -1) {
+                ASSERT_EQ(ids[pos], -1) << msg << " query " << i << " rank " << r;
+                continue;
+            }
+            ASSERT_GE(ids[pos], 0) << msg << " query " << i << " rank " << r;
+            ASSERT_LT(ids[pos], static_cast<int64_t>(ny)) << msg;
+            ASSERT_TRUE(bitset == nullptr || !bitset->test(ids[pos])) << msg << " filtered id " << ids[pos];
+            float tolerance = 1e-4 * (1 + std::fabs(ref_val[pos]));
+            ASSERT_NEAR(val[pos], ref_val[pos], tolerance) << msg << " query " << i << " rank " << r;
+            float id_dis = scalar_func(x + i * d, y + ids[pos] * d, d);
+            ASSERT_NEAR(id_dis, ref_val[pos], tolerance) << msg << " query " << i << " rank " << r;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(DISTANCES_TEST, tile_kernels) {
+    std::vector<size_t> dims = {1, 3, 4, 7, 8, 15, 16, 17, 33, 64, 100, 128};
+    for (auto d : dims) {
+        CheckTileFunc(faiss::fvec_L2sqr_4x8_sse, ScalarL2sqr, d);
+        CheckTileFunc(faiss::fvec_inner_product_4x8_sse, ScalarInnerProduct, d);
+        if (faiss::support_avx2()) {
+            CheckTileFunc(faiss::fvec_L2sqr_4x8_avx, ScalarL2sqr, d);
+            CheckTileFunc(faiss::fvec_inner_product_4x8_avx, ScalarInnerProduct, d);
+        }
+        if (faiss::support_avx512()) {
+            CheckTileFunc(faiss::fvec_L2sqr_4x8_avx512, ScalarL2sqr, d);
+            CheckTileFunc(faiss::fvec_inner_product_4x8_avx512, ScalarInnerProduct, d);
+        }
+    }
+}
+
+TEST(DISTANCES_TEST, knn_scan_tiles) {
+    std::string cpu_flag;
+    faiss::hook_init(cpu_flag);
+
+    const size_t d = 19;
+    // nq not a multiple of 4 and ny not a multiple of 8 or 64
+    std::vector<size_t> nxs = {1, 3, 4, 5, 7, 8, 13};
+    std::vector<size_t> nys = {5, 8, 63, 64, 130, 200, 1000};
+    std::vector<BitsetPattern> patterns = {BitsetPattern::NONE, BitsetPattern::RANDOM, BitsetPattern::FULL_WORD,
+                                           BitsetPattern::FULL_BYTE, BitsetPattern::MOSTLY_FILTERED};
+    // the default threshold splits the queries among threads for small ny, 0 always splits the base vectors
+    std::vector<int> thresholds = {faiss::parallel_policy_threshold, 0};
+
+    int saved_threshold = faiss::parallel_policy_threshold;
+    for (auto threshold : thresholds) {
+        faiss::parallel_policy_threshold = threshold;
+        for (auto nx : nxs) {
+            ASSERT_LT(nx, faiss::distance_compute_blas_threshold);
+            auto x = RandomVectors(nx, d, nx);
+            for (auto ny : nys) {
+                auto y = RandomVectors(ny, d, 1000 + ny);
+                for (size_t p = 0; p < patterns.size(); p++) {
+                    auto bitset = MakeBitset(patterns[p], ny);
+                    std::string msg = "threshold " + std::to_string(threshold) + " nx " + std::to_string(nx) +
+                                      " ny " + std::to_string(ny) + " pattern " + std::to_string(p);
+                    std::vector<float> ref_val, val(nx * K);
+                    std::vector<int64_t> ref_ids, ids(nx * K);
+
+                    faiss::float_maxheap_array_t l2_res = {nx, K, ids.data(), val.data()};
+                    faiss::knn_L2sqr(x.data(), y.data(), d, nx, ny, &l2_res, bitset);
+                    ScalarKnn<faiss::CMax<float, int64_t>>(x.data(), y.data(), d, nx, ny, bitset, ScalarL2sqr,
+                                                           ref_val, ref_ids);
+                    CheckKnn(x.data(), y.data(), d, nx, ny, bitset, ScalarL2sqr, val.data(), ids.data(), ref_val,
+                             ref_ids, "L2 " + msg);
+
+                    faiss::float_minheap_array_t ip_res = {nx, K, ids.data(), val.data()};
+                    faiss::knn_inner_product(x.data(), y.data(), d, nx, ny, &ip_res, bitset);
+                    ScalarKnn<faiss::CMin<float, int64_t>>(x.data(), y.data(), d, nx, ny, bitset,
+                                                           ScalarInnerProduct, ref_val, ref_ids);
+                    CheckKnn(x.data(), y.data(), d, nx, ny, bitset, ScalarInnerProduct, val.data(), ids.data(),
+                             ref_val, ref_ids, "IP " + msg);
+                }
+            }
+        }
+    }
+    faiss::parallel_policy_threshold = saved_threshold;
+}
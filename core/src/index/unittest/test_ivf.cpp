@@ -13,8 +13,16 @@
 
 #include <fiu-control.h>
 #include <fiu/fiu-local.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <faiss/IndexFlat.h>
+#include <faiss/IndexIVFPQFastScan.h>
 
 #ifdef MILVUS_GPU_VERSION
 #include <faiss/gpu/GpuIndexIVFFlat.h>
@@ -25,8 +33,10 @@
 #include "knowhere/index/IndexType.h"
 #include "knowhere/index/vector_index/IndexIVF.h"
 #include "knowhere/index/vector_index/IndexIVFPQ.h"
+#include "knowhere/index/vector_index/IndexIVFPQFastScan.h"
 #include "knowhere/index/vector_index/IndexIVFSQ.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/IndexMerger.h"
 
 #ifdef MILVUS_GPU_VERSION
 #include "knowhere/index/vector_index/gpu/IndexGPUIVF.h"
@@ -86,6 +96,7 @@ INSTANTIATE_TEST_CASE_P(
         std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8H, milvus::knowhere::IndexMode::MODE_GPU),
 #endif
         std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ, milvus::knowhere::IndexMode::MODE_CPU),
+        std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN, milvus::knowhere::IndexMode::MODE_CPU),
         std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, milvus::knowhere::IndexMode::MODE_CPU)));
 
 TEST_P(IVFTest, ivf_basic_cpu) {
@@ -213,6 +224,188 @@ TEST_P(IVFTest, ivf_serialize) {
     }
 }
 
+TEST_P(IVFTest, ivf_pq_fastscan_refine) {
+    if (index_type_ != milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+    auto binaryset = index_->Serialize(conf_);
+
+    // without raw data the refine factor is ignored
+    conf_[milvus::knowhere::IndexParams::refine_factor] = 4;
+    index_->Load(binaryset);
+    auto result = index_->Query(query_dataset, conf_, nullptr);
+    AssertAnns(result, nq, k);
+
+    auto raw_size = nb * dim * static_cast<int64_t>(sizeof(float));
+    std::shared_ptr<uint8_t[]> raw_data(new uint8_t[raw_size]);
+    memcpy(raw_data.get(), xb.data(), raw_size);
+    binaryset.Append(RAW_DATA, raw_data, raw_size);
+    index_->Load(binaryset);
+    index_->UpdateIndexSize();
+    EXPECT_GT(index_->Size(), raw_size);
+
+    // refined distances are exact, the query itself comes first with distance 0
+    auto refined = index_->Query(query_dataset, conf_, nullptr);
+    AssertAnns(refined, nq, k);
+    auto distances = refined->Get<float*>(milvus::knowhere::meta::DISTANCE);
+    for (int64_t i = 0; i < nq; ++i) {
+        EXPECT_FLOAT_EQ(distances[i * k], 0.0f);
+    }
+
+    faiss::ConcurrentBitsetPtr concurrent_bitset_ptr = std::make_shared<faiss::ConcurrentBitset>(nb);
+    for (int64_t i = 0; i < nq; ++i) {
+        concurrent_bitset_ptr->set(i);
+    }
+    auto result_bs = index_->Query(query_dataset, conf_, concurrent_bitset_ptr);
+    AssertAnns(result_bs, nq, k, CheckMode::CHECK_NOT_EQUAL);
+}
+
+TEST_P(IVFTest, ivf_pq_fastscan_exact) {
+    if (index_type_ != milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN) {
+        return;
+    }
+
+    // without refinement the fast scan returns the PQ distances of an IVFPQ with the same quantizer and PQ,
+    // the lists are scanned 32 codes at a time, so the list sizes are not multiples of 32
+    const int64_t nlist = 8, m = 16, nprobe = 4;
+    std::vector<faiss::MetricType> metrics = {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT};
+    std::vector<int64_t> counts = {31, 33, 100, 1000, nb - 5};
+    for (auto metric : metrics) {
+        for (auto count : counts) {
+            faiss::IndexIVFPQFastScan fastscan(new faiss::IndexFlat(dim, metric), dim, nlist, m, metric);
+            fastscan.own_fields = true;
+            fastscan.train(nb, xb.data());
+            fastscan.add(count, xb.data());
+            fastscan.nprobe = nprobe;
+
+            faiss::IndexIVFPQ ref(fastscan.quantizer, dim, nlist, m, 4, metric);
+            ref.pq = fastscan.pq;
+            ref.by_residual = fastscan.by_residual;
+            ref.use_precomputed_table = -1;
+            ref.is_trained = true;
+            ref.add(count, xb.data());
+            ref.nprobe = nprobe;
+
+            bool partial_block = false;
+            for (int64_t list = 0; list < nlist; ++list) {
+                ASSERT_EQ(fastscan.invlists->list_size(list), ref.invlists->list_size(list));
+                partial_block |= fastscan.invlists->list_size(list) % 32 != 0;
+            }
+            ASSERT_TRUE(partial_block);
+
+            // no filter, every third row filtered, and fewer rows left than k
+            std::vector<faiss::ConcurrentBitsetPtr> bitsets = {nullptr};
+            for (int64_t step : {3, 50}) {
+                auto bitset = std::make_shared<faiss::ConcurrentBitset>(count);
+                for (int64_t i = 0; i < count; ++i) {
+                    if ((step == 3) == (i % step == 0)) {
+                        bitset->set(i);
+                    }
+                }
+                bitsets.push_back(bitset);
+            }
+
+            for (size_t b = 0; b < bitsets.size(); ++b) {
+                auto& bitset = bitsets[b];
+                std::string msg = "metric " + std::to_string(metric) + " count " + std::to_string(count) +
+                                  " bitset " + std::to_string(b);
+                std::vector<float> dis(nq * k);
+                std::vector<int64_t> ids(nq * k);
+                fastscan.search(nq, xq.data(), k, dis.data(), ids.data(), bitset);
+
+                // all candidates of the probed lists, to check the distance of each returned id
+                int64_t all = std::max<int64_t>(count, k);
+                std::vector<float> ref_dis(nq * all);
+                std::vector<int64_t> ref_ids(nq * all);
+                ref.search(nq, xq.data(), all, ref_dis.data(), ref_ids.data(), bitset);
+
+                for (int64_t i = 0; i < nq; ++i) {
+                    std::unordered_map<int64_t, float> candidates;
+                    for (int64_t j = 0; j < all && ref_ids[i * all + j] != -1; ++j) {
+                        candidates[ref_ids[i * all + j]] = ref_dis[i * all + j];
+                    }
+                    for (int64_t r = 0; r < k; ++r) {
+                        auto id = ids[i * k + r];
+                        auto expect = ref_dis[i * all + r];
+                        if (ref_ids[i * all + r] == -1) {
+                            ASSERT_EQ(id, -1) << msg << " query " << i << " rank " << r;
+                            continue;
+                        }
+                        float tolerance = 1e-4 * (1 + std::fabs(expect));
+                        ASSERT_NEAR(dis[i * k + r], expect, tolerance) << msg << " query " << i << " rank " << r;
+                        ASSERT_TRUE(bitset == nullptr || !bitset->test(id)) << msg << " filtered id " << id;
+                        auto it = candidates.find(id);
+                        ASSERT_NE(it, candidates.end()) << msg << " unknown id " << id;
+                        ASSERT_NEAR(it->second, expect, tolerance) << msg << " query " << i << " rank " << r;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_P(IVFTest, ivf_merge) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU || !milvus::knowhere::merger::SupportMerge(index_type_)) {
+        return;
+    }
+
+    // two segments trained on their own rows, the rows of the second are assigned to the lists of the first
+    const int64_t half = nb / 2;
+    std::vector<milvus::knowhere::VecIndexPtr> indexes;
+    std::vector<milvus::knowhere::merger::IVFMergeSource> sources(2);
+    for (int64_t i = 0; i < 2; ++i) {
+        auto index = IndexFactory(index_type_, index_mode_);
+        auto dataset = milvus::knowhere::GenDataset(half, dim, xb.data() + i * half * dim);
+        index->Train(dataset, conf_);
+        index->AddWithoutIds(dataset, conf_);
+        indexes.push_back(index);
+
+        sources[i].count_ = half;
+        sources[i].indexed_ = true;
+        for (int64_t j = 0; j < half; ++j) {
+            sources[i].offset_map_.push_back(i * half + j);
+        }
+    }
+
+    std::vector<size_t> loaded;
+    auto loader = [&](size_t i) -> milvus::knowhere::VecIndexPtr {
+        loaded.push_back(i);
+        return indexes[i];
+    };
+    int64_t assigned = 0;
+    auto vector_loader = [&](size_t i, int64_t live_begin, std::vector<float>& vectors) {
+        int64_t rows = std::min<int64_t>(100, half - live_begin);
+        auto begin = xb.begin() + (i * half + live_begin) * dim;
+        vectors.assign(begin, begin + rows * dim);
+        assigned += rows;
+    };
+
+    auto merged = milvus::knowhere::merger::MergeIVF(sources, loader, vector_loader);
+    ASSERT_NE(merged, nullptr);
+    EXPECT_EQ(merged->Count(), nb);
+    EXPECT_EQ(loaded, std::vector<size_t>({0, 1}));
+    EXPECT_EQ(assigned, half);
+
+    auto binaryset = merged->Serialize(conf_);
+    index_->Load(binaryset);
+    EXPECT_EQ(index_->Count(), nb);
+    auto result = index_->Query(query_dataset, conf_, nullptr);
+    AssertAnns(result, nq, k);
+
+    // the rows of the second segment are found by their merged offsets
+    auto query = milvus::knowhere::GenDataset(nq, dim, xb.data() + half * dim);
+    result = index_->Query(query, conf_, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    int64_t hit = 0;
+    for (int64_t i = 0; i < nq; ++i) {
+        hit += (ids[i * k] == half + i) ? 1 : 0;
+    }
+    EXPECT_GE(hit, nq * 9 / 10);
+}
+
 TEST_P(IVFTest, ivf_slice) {
     fiu_init(0);
     {
@@ -13,8 +13,10 @@
 
 #include <fiu-control.h>
 #include <fiu/fiu-local.h>
+#include <algorithm>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #ifdef MILVUS_GPU_VERSION
 #include <faiss/gpu/GpuIndexIVFFlat.h>
@@ -24,6 +26,7 @@
 #include "knowhere/common/Timer.h"
 #include "knowhere/index/IndexType.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/IndexMerger.h"
 #include "knowhere/index/vector_offset_index/IndexIVF_NM.h"
 
 #ifdef MILVUS_GPU_VERSION
@@ -161,3 +164,145 @@ TEST_P(IVFNMCPUTest, ivf_slice) {
     auto result = index_->Query(query_dataset, conf_, nullptr);
     AssertAnns(result, nq, k);
 }
+
+TEST_P(IVFNMCPUTest, ivf_merge) {
+    assert(!xb.empty());
+
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+
+    // the first source has 2 deleted rows, the second source has all rows, the third is empty
+    const int64_t deleted = 2;
+    std::vector<milvus::knowhere::merger::IVFMergeSource> sources(3);
+    sources[0].count_ = nb - deleted;
+    sources[0].indexed_ = true;
+    for (int64_t i = 0; i < nb; ++i) {
+        sources[0].offset_map_.push_back(i < deleted ? -1 : i - deleted);
+        sources[1].offset_map_.push_back(nb - deleted + i);
+    }
+    sources[1].count_ = nb;
+    sources[1].indexed_ = true;
+
+    // the live rows of the sources, read in small batches
+    const int64_t batch = 100;
+    std::vector<int64_t> assigned(sources.size(), 0);
+    auto vector_loader = [&](size_t i, int64_t live_begin, std::vector<float>& vectors) {
+        int64_t begin = (i == 0) ? deleted + live_begin : live_begin;
+        int64_t rows = std::min(batch, sources[i].count_ - live_begin);
+        vectors.assign(xb.begin() + begin * dim, xb.begin() + (begin + rows) * dim);
+        assigned[i] += rows;
+    };
+
+    std::vector<float> merged_raw(xb.begin() + deleted * dim, xb.end());
+    merged_raw.insert(merged_raw.end(), xb.begin(), xb.end());
+    auto check_merged = [&](const milvus::knowhere::VecIndexPtr& merged) {
+        ASSERT_NE(merged, nullptr);
+        EXPECT_EQ(merged->Count(), 2 * nb - deleted);
+
+        milvus::knowhere::BinarySet bs = merged->Serialize(conf_);
+        milvus::knowhere::BinaryPtr bptr = std::make_shared<milvus::knowhere::Binary>();
+        bptr->data = std::shared_ptr<uint8_t[]>((uint8_t*)merged_raw.data(), [&](uint8_t*) {});
+        bptr->size = merged_raw.size() * sizeof(float);
+        bs.Append(RAW_DATA, bptr);
+
+        auto merged_index = std::make_shared<milvus::knowhere::IVF_NM>();
+        merged_index->Load(bs);
+
+        // the query vector is either found in first source, or in second source
+        auto result = merged_index->Query(query_dataset, conf_, nullptr);
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq; ++i) {
+            auto id = ids[i * k];
+            if (i < deleted) {
+                ASSERT_EQ(id, nb - deleted + i);
+            } else {
+                ASSERT_TRUE(id == i - deleted || id == nb - deleted + i);
+            }
+        }
+    };
+
+    // both sources share the trained quantizer, the lists are copied, the source with more rows is the base
+    std::vector<size_t> loaded;
+    auto loader = [&](size_t i) -> milvus::knowhere::VecIndexPtr {
+        loaded.push_back(i);
+        return index_;
+    };
+    check_merged(milvus::knowhere::merger::MergeIVF(sources, loader, vector_loader));
+    EXPECT_EQ(loaded, std::vector<size_t>({1, 0}));
+    EXPECT_EQ(assigned, std::vector<int64_t>({0, 0, 0}));
+
+    // a source trained independently has another quantizer, its rows are assigned to the lists of the base
+    auto other_index = IndexFactoryNM(index_type_, index_mode_);
+    auto other_dataset = milvus::knowhere::GenDataset(nb / 2, dim, xb.data() + (nb / 2) * dim);
+    other_index->Train(other_dataset, conf_);
+    other_index->AddWithoutIds(base_dataset, conf_);
+    auto mixed_loader = [&](size_t i) -> milvus::knowhere::VecIndexPtr { return (i == 0) ? index_ : other_index; };
+    check_merged(milvus::knowhere::merger::MergeIVF(sources, mixed_loader, vector_loader));
+    EXPECT_EQ(assigned, std::vector<int64_t>({nb - deleted, 0, 0}));
+
+    // a source without index
+    std::fill(assigned.begin(), assigned.end(), 0);
+    sources[1].indexed_ = false;
+    auto partial_loader = [&](size_t i) -> milvus::knowhere::VecIndexPtr { return (i == 0) ? index_ : nullptr; };
+    check_merged(milvus::knowhere::merger::MergeIVF(sources, partial_loader, vector_loader));
+    EXPECT_EQ(assigned, std::vector<int64_t>({0, nb, 0}));
+
+    // no source has index
+    sources[0].indexed_ = false;
+    ASSERT_ANY_THROW(milvus::knowhere::merger::MergeIVF(sources, partial_loader, vector_loader));
+}
+
+TEST_P(IVFNMCPUTest, ivf_concurrent_query) {
+    assert(!xb.empty());
+
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+
+    milvus::knowhere::BinarySet bs = index_->Serialize(conf_);
+    milvus::knowhere::BinaryPtr bptr = std::make_shared<milvus::knowhere::Binary>();
+    bptr->data = std::shared_ptr<uint8_t[]>((uint8_t*)xb.data(), [&](uint8_t*) {});
+    bptr->size = xb.size() * sizeof(float);
+    bs.Append(RAW_DATA, bptr);
+    index_->Load(bs);
+
+    // queries with different nprobe on one shared index must not see each other's settings
+    std::vector<milvus::knowhere::Config> confs = {conf_, conf_};
+    confs[0][milvus::knowhere::IndexParams::nprobe] = 1;
+    confs[1][milvus::knowhere::IndexParams::nprobe] = 100;
+
+    auto query_ids = [&](const milvus::knowhere::Config& conf) {
+        auto result = index_->Query(query_dataset, conf, nullptr);
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        return std::vector<int64_t>(ids, ids + nq * k);
+    };
+    std::vector<std::vector<int64_t>> expects = {query_ids(confs[0]), query_ids(confs[1])};
+    ASSERT_NE(expects[0], expects[1]);
+
+    const int64_t thread_num = 8, loop = 20;
+    std::vector<int64_t> mismatches(thread_num, 0);
+    std::vector<std::thread> threads;
+    for (int64_t t = 0; t < thread_num; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int64_t i = 0; i < loop; ++i) {
+                auto pos = (t + i) % 2;
+                if (query_ids(confs[pos]) != expects[pos]) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto mismatch : mismatches) {
+        ASSERT_EQ(mismatch, 0);
+    }
+}
@@ -100,7 +100,9 @@ TEST(STRUCTUREDINDEXSORT_TEST, test_serialize_and_load) {
     binaryset.Append("index_length", length_data, bin_length->size);
 
     structuredIndexSort.Load(binaryset);
-    EXPECT_EQ(n * sizeof(milvus::knowhere::IndexStructure<int>), (int)structuredIndexSort.Size());
+    // sorted data, row order values and min/max of one zone map block
+    EXPECT_EQ(n * sizeof(milvus::knowhere::IndexStructure<int>) + n * sizeof(int) + 2 * sizeof(int),
+              (int)structuredIndexSort.Size());
     EXPECT_EQ(true, structuredIndexSort.IsBuilt());
     std::sort(p, p + n);
     const std::vector<milvus::knowhere::IndexStructure<int>> const_index_data = structuredIndexSort.GetData();
@@ -268,3 +270,97 @@ TEST(STRUCTUREDINDEXSORT_TEST, test_double_border_range) {
     }
     free(p);
 }
+
+TEST(STRUCTUREDINDEXSORT_TEST, test_in_place) {
+    int range = 100, n = 1000, *p = nullptr;
+    gen_rand_data(range, n, p);
+    milvus::knowhere::StructuredIndexSort<int> structuredIndexSort((size_t)n, p);  // Build default
+
+    // bits set before are kept
+    faiss::ConcurrentBitset bitset(n);
+    bitset.set(0);
+    int lb = 20, ub = 30;
+    structuredIndexSort.Range(&lb, false, &ub, true, bitset);
+    for (auto i = 0; i < n; ++i) {
+        bool expect = (i == 0) || (*(p + i) > lb && *(p + i) <= ub);
+        ASSERT_EQ(expect, bitset.test(i));
+    }
+
+    // one side unbounded
+    bitset.reset();
+    structuredIndexSort.Range(nullptr, false, &ub, false, bitset);
+    for (auto i = 0; i < n; ++i) {
+        ASSERT_EQ(*(p + i) < ub, bitset.test(i));
+    }
+
+    // empty range
+    bitset.reset();
+    structuredIndexSort.Range(&ub, true, &lb, true, bitset);
+    structuredIndexSort.Range(&lb, false, &lb, true, bitset);
+    for (auto i = 0; i < n; ++i) {
+        ASSERT_FALSE(bitset.test(i));
+    }
+
+    std::vector<int> values = {*p, *(p + n - 1)};
+    bitset.reset();
+    structuredIndexSort.In(values.size(), values.data(), bitset);
+    for (auto i = 0; i < n; ++i) {
+        ASSERT_EQ(*(p + i) == values[0] || *(p + i) == values[1], bitset.test(i));
+    }
+
+    // and_not keeps the bits which are not set in the other bitset
+    faiss::ConcurrentBitset other(n);
+    structuredIndexSort.Range(&lb, true, nullptr, false, other);
+    bitset.and_not(other);
+    for (auto i = 0; i < n; ++i) {
+        ASSERT_EQ((*(p + i) == values[0] || *(p + i) == values[1]) && *(p + i) < lb, bitset.test(i));
+    }
+    free(p);
+}
+
+TEST(STRUCTUREDINDEXSORT_TEST, test_zone_map) {
+    // timestamp-like values, increasing with row offset, some rows share the same value
+    int64_t n = milvus::knowhere::ZONE_MAP_BLOCK_SIZE * 5 + 13;
+    std::vector<int64_t> values(n);
+    for (int64_t i = 0; i < n; ++i) {
+        values[i] = 1000 + i / 3;
+    }
+    // a few rows out of order make their blocks partially covered
+    values[10] = 0;
+    values[n - 1] = 0;
+    milvus::knowhere::StructuredIndexSort<int64_t> structuredIndexSort((size_t)n, values.data());
+
+    auto check = [&](const int64_t* lb, bool lb_inclusive, const int64_t* ub, bool ub_inclusive) {
+        faiss::ConcurrentBitset bitset(n);
+        structuredIndexSort.Range(lb, lb_inclusive, ub, ub_inclusive, bitset);
+        for (int64_t i = 0; i < n; ++i) {
+            bool expect = true;
+            if (lb != nullptr) {
+                expect = expect && (lb_inclusive ? values[i] >= *lb : values[i] > *lb);
+            }
+            if (ub != nullptr) {
+                expect = expect && (ub_inclusive ? values[i] <= *ub : values[i] < *ub);
+            }
+            ASSERT_EQ(expect, bitset.test(i)) << "row " << i;
+        }
+    };
+
+    int64_t lower = 1000 + 100, upper = 1000 + n / 3 - 100, zero = 0;
+    check(&lower, true, &upper, false);
+    check(&lower, false, &upper, true);
+    check(&lower, true, nullptr, false);
+    check(nullptr, false, &upper, true);
+    check(&zero, true, &zero, true);
+    check(nullptr, false, nullptr, false);
+    check(&upper, true, &lower, true);
+
+    // terms with duplicates and values not in the index
+    std::vector<int64_t> terms = {values[n / 2], 0, values[n / 2], 5, values[n - 2], 999999};
+    auto res = structuredIndexSort.In(terms.size(), terms.data());
+    auto not_res = structuredIndexSort.NotIn(terms.size(), terms.data());
+    for (int64_t i = 0; i < n; ++i) {
+        bool expect = std::find(terms.begin(), terms.end(), values[i]) != terms.end();
+        ASSERT_EQ(expect, res->test(i));
+        ASSERT_EQ(!expect, not_res->test(i));
+    }
+}
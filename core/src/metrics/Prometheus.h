@@ -14,6 +14,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -29,37 +30,60 @@ namespace milvus {
 class ScopedTimer {
  public:
     explicit ScopedTimer(std::function<void(double)> callback) : callback_(callback) {
-        start_ = std::chrono::system_clock::now();
+        start_ = std::chrono::steady_clock::now();
     }
 
+    // the duration is in seconds, with microsecond resolution
     ~ScopedTimer() {
-        auto end = std::chrono::system_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(end - start_).count();
-        callback_(duration);
+        auto end = std::chrono::steady_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start_).count();
+        callback_(duration / 1e6);
     }
 
  private:
     std::function<void(double)> callback_;
-    std::chrono::time_point<std::chrono::system_clock> start_;
+    std::chrono::time_point<std::chrono::steady_clock> start_;
 };
 
 class Prometheus {
  public:
+    using Collector = std::function<std::vector<prometheus::MetricFamily>()>;
+
     prometheus::Registry&
     registry() {
         return *registry_;
     }
 
+    // the metrics aggregated outside of registry are exported by collector
+    void
+    RegisterCollector(const Collector& collector) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        collectors_.push_back(collector);
+    }
+
     std::string
     GetMetrics() {
+        std::vector<Collector> collectors;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            collectors = collectors_;
+        }
+
+        auto families = registry_->Collect();
+        for (auto& collector : collectors) {
+            auto collected = collector();
+            families.insert(families.end(), collected.begin(), collected.end());
+        }
+
         std::ostringstream ss;
         prometheus::TextSerializer serializer;
-        serializer.Serialize(ss, registry_->Collect());
+        serializer.Serialize(ss, families);
         return ss.str();
     }
 
  private:
-    std::vector<std::weak_ptr<prometheus::Collectable>> collectables_;
+    std::mutex mutex_;
+    std::vector<Collector> collectors_;
     std::shared_ptr<prometheus::Registry> registry_ = std::make_shared<prometheus::Registry>();
 };
 
@@ -0,0 +1,178 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "metrics/SearchMetrics.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "metrics/Prometheus.h"
+
+namespace milvus {
+
+namespace {
+
+// upper bounds of histogram buckets in microseconds
+const std::vector<int64_t> BUCKET_BOUNDS_US = {50,      100,     250,     500,     1000,     2500,
+                                               5000,    10000,   25000,   50000,   100000,   250000,
+                                               500000,  1000000, 2500000, 5000000, 10000000};
+
+const char*
+StageName(SearchStage stage) {
+    switch (stage) {
+        case SearchStage::REQUEST_QUEUE:
+            return "request_queue";
+        case SearchStage::SCHEDULER_WAIT:
+            return "scheduler_wait";
+        case SearchStage::SELECT_SEGMENT:
+            return "select_segment";
+        case SearchStage::LOAD:
+            return "load";
+        case SearchStage::FILTER:
+            return "filter";
+        case SearchStage::VECTOR_SEARCH:
+            return "vector_search";
+        case SearchStage::REDUCE:
+            return "reduce";
+        case SearchStage::FETCH_ENTITY:
+            return "fetch_entity";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace
+
+SearchMetrics&
+SearchMetrics::GetInstance() {
+    static SearchMetrics instance;
+    return instance;
+}
+
+SearchMetrics::SearchMetrics() {
+    prometheus.RegisterCollector([this]() { return Collect(); });
+}
+
+SearchMetrics::ThreadBufferHolder::~ThreadBufferHolder() {
+    if (buffer_ != nullptr) {
+        SearchMetrics::GetInstance().Retire(buffer_);
+    }
+}
+
+SearchMetrics::ThreadBuffer&
+SearchMetrics::LocalBuffer() {
+    thread_local ThreadBufferHolder holder;
+    if (holder.buffer_ == nullptr) {
+        holder.buffer_ = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(holder.buffer_);
+    }
+    return *holder.buffer_;
+}
+
+void
+SearchMetrics::Retire(const ThreadBufferPtr& buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex_);
+        Merge(retired_, buffer->histograms_);
+    }
+    buffers_.erase(std::remove(buffers_.begin(), buffers_.end(), buffer), buffers_.end());
+}
+
+void
+SearchMetrics::Merge(HistogramMap& target, const HistogramMap& source) {
+    for (auto& [labels, data] : source) {
+        auto& merged = target[labels];
+        merged.bucket_counts_.resize(data.bucket_counts_.size(), 0);
+        for (size_t i = 0; i < data.bucket_counts_.size(); ++i) {
+            merged.bucket_counts_[i] += data.bucket_counts_[i];
+        }
+        merged.count_ += data.count_;
+        merged.sum_ += data.sum_;
+    }
+}
+
+void
+SearchMetrics::Erase(HistogramMap& histograms, const std::string& collection) {
+    for (auto iter = histograms.begin(); iter != histograms.end();) {
+        iter = (std::get<1>(iter->first) == collection) ? histograms.erase(iter) : std::next(iter);
+    }
+}
+
+void
+SearchMetrics::RemoveCollection(const std::string& collection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Erase(retired_, collection);
+    for (auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex_);
+        Erase(buffer->histograms_, collection);
+    }
+}
+
+void
+SearchMetrics::Observe(SearchStage stage, const std::string& collection, const std::string& index_type,
+                       int64_t microseconds) {
+    auto& buffer = LocalBuffer();
+    auto bucket = std::lower_bound(BUCKET_BOUNDS_US.begin(), BUCKET_BOUNDS_US.end(), microseconds) -
+                  BUCKET_BOUNDS_US.begin();
+
+    std::lock_guard<std::mutex> lock(buffer.mutex_);
+    auto& data = buffer.histograms_[LabelsT(stage, collection, index_type)];
+    if (data.bucket_counts_.empty()) {
+        data.bucket_counts_.resize(BUCKET_BOUNDS_US.size() + 1, 0);
+    }
+    ++data.bucket_counts_[bucket];
+    ++data.count_;
+    data.sum_ += microseconds;
+}
+
+std::vector<prometheus::MetricFamily>
+SearchMetrics::Collect() {
+    HistogramMap histograms;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        histograms = retired_;
+        for (auto& buffer : buffers_) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex_);
+            Merge(histograms, buffer->histograms_);
+        }
+    }
+
+    prometheus::MetricFamily family;
+    family.name = "milvus_search_stage_latency_seconds";
+    family.help = "latency of search stages";
+    family.type = prometheus::MetricType::Histogram;
+    for (auto& [labels, data] : histograms) {
+        prometheus::ClientMetric metric;
+        metric.label = {{"stage", StageName(std::get<0>(labels))},
+                        {"collection", std::get<1>(labels)},
+                        {"index_type", std::get<2>(labels)}};
+        metric.histogram.sample_count = data.count_;
+        metric.histogram.sample_sum = data.sum_ / 1e6;
+
+        uint64_t cumulative_count = 0;
+        for (size_t i = 0; i < data.bucket_counts_.size(); ++i) {
+            cumulative_count += data.bucket_counts_[i];
+            prometheus::ClientMetric::Histogram::Bucket bucket;
+            bucket.cumulative_count = cumulative_count;
+            bucket.upper_bound = (i < BUCKET_BOUNDS_US.size()) ? BUCKET_BOUNDS_US[i] / 1e6
+                                                               : std::numeric_limits<double>::infinity();
+            metric.histogram.bucket.push_back(bucket);
+        }
+        family.metric.emplace_back(std::move(metric));
+    }
+
+    return {family};
+}
+
+}  // namespace milvus
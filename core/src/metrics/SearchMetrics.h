@@ -0,0 +1,130 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <prometheus/metric_family.h>
+
+namespace milvus {
+
+enum class SearchStage {
+    REQUEST_QUEUE = 0,  // search request waits in request queue
+    SCHEDULER_WAIT,     // search task waits in scheduler
+    SELECT_SEGMENT,     // pick segments and buffered entities to search
+    LOAD,               // load segment from disk to cpu
+    FILTER,             // scalar field filtering
+    VECTOR_SEARCH,      // vector index search
+    REDUCE,             // reduce results of all segments
+    FETCH_ENTITY,       // get entities of result ids
+};
+
+// Latency histograms of search stages, labeled by stage, collection and index type.
+// Each thread aggregates its observations into a thread local buffer, the buffers are merged when collected.
+class SearchMetrics {
+ public:
+    static SearchMetrics&
+    GetInstance();
+
+    void
+    Observe(SearchStage stage, const std::string& collection, const std::string& index_type, int64_t microseconds);
+
+    std::vector<prometheus::MetricFamily>
+    Collect();
+
+    // forget the series of a dropped collection
+    void
+    RemoveCollection(const std::string& collection);
+
+ private:
+    SearchMetrics();
+
+    using LabelsT = std::tuple<SearchStage, std::string, std::string>;
+
+    struct HistogramData {
+        std::vector<uint64_t> bucket_counts_;  // the last one is +Inf
+        uint64_t count_ = 0;
+        int64_t sum_ = 0;  // microseconds
+    };
+    using HistogramMap = std::map<LabelsT, HistogramData>;
+
+    struct ThreadBuffer {
+        std::mutex mutex_;  // only contended while collecting
+        HistogramMap histograms_;
+    };
+    using ThreadBufferPtr = std::shared_ptr<ThreadBuffer>;
+
+    struct ThreadBufferHolder {
+        ThreadBufferPtr buffer_;
+        ~ThreadBufferHolder();
+    };
+
+    ThreadBuffer&
+    LocalBuffer();
+
+    void
+    Retire(const ThreadBufferPtr& buffer);
+
+    static void
+    Merge(HistogramMap& target, const HistogramMap& source);
+
+    static void
+    Erase(HistogramMap& histograms, const std::string& collection);
+
+ private:
+    std::mutex mutex_;
+    std::vector<ThreadBufferPtr> buffers_;
+    HistogramMap retired_;  // data of exited threads
+};
+
+// Observe the elapsed time of a search stage when stopped or destroyed
+class SearchStageTimer {
+ public:
+    SearchStageTimer(SearchStage stage, std::string collection, std::string index_type = "")
+        : stage_(stage),
+          collection_(std::move(collection)),
+          index_type_(std::move(index_type)),
+          start_(std::chrono::steady_clock::now()) {
+    }
+
+    ~SearchStageTimer() {
+        Stop();
+    }
+
+    void
+    Stop() {
+        if (stopped_) {
+            return;
+        }
+        stopped_ = true;
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        SearchMetrics::GetInstance().Observe(
+            stage_, collection_, index_type_, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+ private:
+    SearchStage stage_;
+    std::string collection_;
+    std::string index_type_;
+    std::chrono::steady_clock::time_point start_;
+    bool stopped_ = false;
+};
+
+}  // namespace milvus
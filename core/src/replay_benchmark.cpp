@@ -0,0 +1,224 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <getopt.h>
+#include <unistd.h>
+#include <cstring>
+#include <experimental/filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "db/Constants.h"
+#include "db/DBFactory.h"
+#include "db/snapshot/Snapshots.h"
+#include "db/transcript/ScriptBenchmark.h"
+#include "easyloggingpp/easylogging++.h"
+#include "index/archive/KnowhereResource.h"
+#include "scheduler/SchedInst.h"
+#include "utils/CommonUtil.h"
+#include "utils/Json.h"
+#include "utils/Status.h"
+#include "value/config/ConfigMgr.h"
+#include "value/config/ServerConfig.h"
+#include "value/status/StatusMgr.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+namespace {
+
+void
+print_help(const std::string& app_name) {
+    std::cout << std::endl << "Usage: " << app_name << " [OPTIONS]" << std::endl;
+    std::cout << R"(
+  Options:
+   -h --help                   Print this help.
+   -c --conf_file   filename   Read configuration from the file.
+   -s --script      path       Transcript folder to replay.
+   -d --data_path   path       Fresh data folder of the replay, overrides storage.path of configuration.
+   -x --speed       factor     0: as fast as possible(default), 1: original pace, N: N times faster.
+   -t --concurrency number     Number of replay workers, default is 1.
+   -r --report      filename   Write the benchmark report to the file.
+   -b --base        filename   Compare the report with this base report.
+                               Without --script, compare the existing --report file with it.
+)" << std::endl;
+}
+
+milvus::Status
+ReadReport(const std::string& path, milvus::json& report) {
+    try {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return milvus::Status(milvus::SERVER_UNEXPECTED_ERROR, "Failed to open report file: " + path);
+        }
+        file >> report;
+    } catch (std::exception& ex) {
+        return milvus::Status(milvus::SERVER_UNEXPECTED_ERROR, "Failed to read report " + path + ": " + ex.what());
+    }
+    return milvus::Status::OK();
+}
+
+milvus::Status
+WriteReport(const std::string& path, const milvus::json& report) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return milvus::Status(milvus::SERVER_UNEXPECTED_ERROR, "Failed to open report file: " + path);
+    }
+    file << report.dump(4) << std::endl;
+    return milvus::Status::OK();
+}
+
+milvus::Status
+RunBenchmark(const std::string& config_filename, const std::string& data_path, const std::string& script_path,
+             const milvus::engine::BenchmarkOptions& options, milvus::json& report) {
+    namespace fs = std::experimental::filesystem;
+    if (fs::exists(data_path) && !fs::is_empty(data_path)) {
+        return milvus::Status(milvus::SERVER_UNEXPECTED_ERROR, "Data path is not empty: " + data_path);
+    }
+
+    try {
+        milvus::StatusMgr::GetInstance().Init();
+        milvus::ConfigMgr::GetInstance().Init();
+        milvus::ConfigMgr::GetInstance().LoadFile(config_filename);
+        milvus::ConfigMgr::GetInstance().Set("storage.path", data_path, false);
+    } catch (std::exception& ex) {
+        return milvus::Status(milvus::SERVER_UNEXPECTED_ERROR,
+                              "Load configuration file " + config_filename + " failed: " + ex.what());
+    }
+
+    auto status = milvus::engine::KnowhereResource::Initialize();
+    if (!status.ok()) {
+        return status;
+    }
+    milvus::engine::snapshot::Snapshots::GetInstance().StartService();
+    milvus::scheduler::StartSchedulerService();
+
+    // wal and transcript are disabled, the replay only measures the actions
+    milvus::engine::DBOptions opt;
+    opt.meta_.backend_uri_ = milvus::config.general.meta_uri();
+    opt.meta_.path_ = data_path + milvus::engine::DB_FOLDER;
+    opt.auto_flush_interval_ = milvus::config.storage.auto_flush_interval();
+    opt.insert_buffer_size_ = milvus::config.cache.insert_buffer_size();
+    opt.merge_buffer_size_ = milvus::config.cache.merge_buffer_size();
+
+    milvus::engine::DBPtr db;
+    status = milvus::CommonUtil::CreateDirectory(opt.meta_.path_);
+    if (status.ok()) {
+        try {
+            db = milvus::engine::DBFactory::BuildDB(opt);
+            status = db->Start();
+        } catch (std::exception& ex) {
+            std::string msg = "Failed to open database: " + std::string(ex.what());
+            status = milvus::Status(milvus::SERVER_UNEXPECTED_ERROR, msg);
+        }
+    }
+
+    if (status.ok()) {
+        milvus::engine::ScriptBenchmark benchmark(options);
+        status = benchmark.Run(db, script_path, report);
+    }
+
+    if (db != nullptr) {
+        db->Stop();
+    }
+    milvus::scheduler::StopSchedulerService();
+    milvus::engine::snapshot::Snapshots::GetInstance().StopService();
+    return status;
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+    static struct option long_options[] = {{"conf_file", required_argument, nullptr, 'c'},
+                                           {"script", required_argument, nullptr, 's'},
+                                           {"data_path", required_argument, nullptr, 'd'},
+                                           {"speed", required_argument, nullptr, 'x'},
+                                           {"concurrency", required_argument, nullptr, 't'},
+                                           {"report", required_argument, nullptr, 'r'},
+                                           {"base", required_argument, nullptr, 'b'},
+                                           {"help", no_argument, nullptr, 'h'},
+                                           {nullptr, 0, nullptr, 0}};
+
+    int option_index = 0;
+    std::string app_name = argv[0];
+    std::string config_filename, script_path, data_path, report_filename, base_filename;
+    milvus::engine::BenchmarkOptions options;
+
+    int value;
+    while ((value = getopt_long(argc, argv, "c:s:d:x:t:r:b:h", long_options, &option_index)) != -1) {
+        switch (value) {
+            case 'c':
+                config_filename = optarg;
+                break;
+            case 's':
+                script_path = optarg;
+                break;
+            case 'd':
+                data_path = optarg;
+                break;
+            case 'x':
+                options.speed_ = atof(optarg);
+                break;
+            case 't':
+                options.concurrency_ = atol(optarg);
+                break;
+            case 'r':
+                report_filename = optarg;
+                break;
+            case 'b':
+                base_filename = optarg;
+                break;
+            case 'h':
+                print_help(app_name);
+                return EXIT_SUCCESS;
+            default:
+                print_help(app_name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    milvus::json report;
+    milvus::Status status;
+    if (!script_path.empty()) {
+        if (config_filename.empty() || data_path.empty()) {
+            print_help(app_name);
+            return EXIT_FAILURE;
+        }
+
+        status = RunBenchmark(config_filename, data_path, script_path, options, report);
+        if (status.ok() && !report_filename.empty()) {
+            status = WriteReport(report_filename, report);
+        }
+        if (status.ok() && base_filename.empty()) {
+            std::cout << report.dump(4) << std::endl;
+        }
+    } else if (!report_filename.empty() && !base_filename.empty()) {
+        status = ReadReport(report_filename, report);
+    } else {
+        print_help(app_name);
+        return EXIT_FAILURE;
+    }
+
+    if (status.ok() && !base_filename.empty()) {
+        milvus::json base;
+        status = ReadReport(base_filename, base);
+        if (status.ok()) {
+            milvus::engine::ScriptBenchmark::Compare(base, report, std::cout);
+        }
+    }
+
+    if (!status.ok()) {
+        std::cerr << status.message() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -10,17 +10,32 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include "scheduler/CPUBuilder.h"
+
+#include <omp.h>
+#include <algorithm>
+
 #include "utils/Log.h"
 
 namespace milvus {
 namespace scheduler {
 
+CPUBuilder::CPUBuilder(int64_t builder_num, int64_t thread_budget) {
+    if (thread_budget <= 0) {
+        thread_budget = std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+    }
+    builder_num_ = std::max<int64_t>(std::min(builder_num, thread_budget), 1);
+    omp_thread_num_ = std::max<int64_t>(thread_budget / builder_num_, 1);
+}
+
 void
 CPUBuilder::Start() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (not running_) {
         running_ = true;
-        thread_ = std::thread(&CPUBuilder::worker_function, this);
+        LOG_SERVER_DEBUG_ << "Start " << builder_num_ << " cpu builders, " << omp_thread_num_ << " threads each";
+        for (int64_t i = 0; i < builder_num_; ++i) {
+            threads_.emplace_back(&CPUBuilder::worker_function, this);
+        }
     }
 }
 
@@ -28,8 +43,13 @@ void
 CPUBuilder::Stop() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (running_) {
-        this->Put(nullptr);
-        thread_.join();
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            this->Put(nullptr);
+        }
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
         running_ = false;
     }
 }
@@ -46,6 +66,9 @@ CPUBuilder::Put(const TaskPtr& task) {
 void
 CPUBuilder::worker_function() {
     SetThreadName("cpubuilder_thread");
+
+    // the setting only affects the parallel regions started by this thread
+    omp_set_num_threads(omp_thread_num_);
     while (running_) {
         std::unique_lock<std::mutex> lock(queue_mutex_);
         queue_cv_.wait(lock, [&] { return not queue_.empty(); });
@@ -16,15 +16,18 @@
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "task/Task.h"
 
 namespace milvus {
 namespace scheduler {
 
+// Run several index builds concurrently. The OpenMP threads of all builds share one budget:
+// builder_num * omp threads per build <= thread_budget, thread_budget 0 means all cpu cores.
 class CPUBuilder {
  public:
-    CPUBuilder() = default;
+    explicit CPUBuilder(int64_t builder_num = 1, int64_t thread_budget = 0);
 
     void
     Start();
@@ -42,7 +45,9 @@ class CPUBuilder {
  private:
     bool running_ = false;
     std::mutex mutex_;
-    std::thread thread_;
+    std::vector<std::thread> threads_;
+    int64_t builder_num_ = 1;
+    int64_t omp_thread_num_ = 1;
 
     std::queue<TaskPtr> queue_;
     std::condition_variable queue_cv_;
@@ -157,7 +157,7 @@ class CPUBuilderInst {
         if (instance == nullptr) {
             std::lock_guard<std::mutex> lock(mutex_);
             if (instance == nullptr) {
-                instance = std::make_shared<CPUBuilder>();
+                instance = std::make_shared<CPUBuilder>(config.engine.builder_num(), config.engine.omp_thread_num());
             }
         }
         return instance;
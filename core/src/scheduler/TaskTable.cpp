@@ -174,7 +174,7 @@ TaskTable::PickToLoad(uint64_t limit) {
         } else if (table_[index]->state == TaskTableItemState::LOADED) {
             cross = true;
             ++loaded_count;
-            if (loaded_count >= 1) {
+            if (loaded_count >= prefetch_num_) {
                 return std::vector<uint64_t>();
             }
         } else if (table_[index]->state == TaskTableItemState::START) {
@@ -118,6 +118,12 @@ class TaskTable : public interface::dumpable {
         subscriber_ = std::move(subscriber);
     }
 
+    // max number of loaded tasks waiting for execution, loaders stop picking when reached
+    inline void
+    SetPrefetchNum(uint64_t prefetch_num) {
+        prefetch_num_ = prefetch_num;
+    }
+
     void
     Put(TaskPtr task, TaskTableItemPtr from = nullptr);
 
@@ -224,6 +230,8 @@ class TaskTable : public interface::dumpable {
     // pick from (last_finish_ + 1)
     // init with -1, pick from (last_finish_ + 1) = 0
     uint64_t last_finish_ = -1;
+
+    uint64_t prefetch_num_ = 1;
 };
 
 }  // namespace scheduler
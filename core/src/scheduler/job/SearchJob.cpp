@@ -10,36 +10,173 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include "scheduler/job/SearchJob.h"
+#include "db/SnapshotUtils.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #include "scheduler/task/SearchTask.h"
 #include "utils/Log.h"
 
+#include <algorithm>
+
 namespace milvus {
 namespace scheduler {
 
 SearchJob::SearchJob(const server::ContextPtr& context, const engine::snapshot::ScopedSnapshotT& snapshot,
                      engine::DBOptions options, const query::QueryPtr& query_ptr,
-                     const engine::snapshot::IDS_TYPE& segment_ids)
+                     const engine::snapshot::IDS_TYPE& segment_ids, const engine::MemChunkViews& mem_chunks,
+                     const engine::PendingDeleteIdsPtr& delete_ids)
     : Job(JobType::SEARCH),
       context_(context),
       snapshot_(snapshot),
       options_(options),
       query_ptr_(query_ptr),
-      segment_ids_(segment_ids) {
+      segment_ids_(segment_ids),
+      mem_chunks_(mem_chunks),
+      delete_ids_(delete_ids) {
 }
 
+namespace {
+
+// queries reduced by one parallel iteration
+constexpr int64_t REDUCE_QUERIES_PER_BLOCK = 16;
+
+void
+ReduceQueries(const std::vector<SearchTaskResult>& results, size_t nq, size_t q_begin, size_t q_end, size_t buf_k,
+              bool ascending, engine::ResultIds& ids, engine::ResultDistances& distances) {
+    std::vector<size_t> strides(results.size(), 0);
+    for (size_t i = 0; i < results.size(); ++i) {
+        strides[i] = (results[i].k_ > 0) ? results[i].ids_.size() / nq : 0;
+    }
+
+    // heap of result indexes, the one with best head distance on top, tie broken by result index
+    std::vector<size_t> cursors(results.size(), 0);
+    std::vector<size_t> heap;
+    heap.reserve(results.size());
+    size_t q = q_begin;
+    auto worse = [&](size_t a, size_t b) {
+        float dis_a = results[a].distances_[strides[a] * q + cursors[a]];
+        float dis_b = results[b].distances_[strides[b] * q + cursors[b]];
+        if (dis_a != dis_b) {
+            return ascending ? dis_a > dis_b : dis_a < dis_b;
+        }
+        return a > b;
+    };
+
+    for (; q < q_end; ++q) {
+        heap.clear();
+        for (size_t i = 0; i < results.size(); ++i) {
+            cursors[i] = 0;
+            if (results[i].k_ > 0 && results[i].ids_[strides[i] * q] != -1) {
+                heap.push_back(i);
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), worse);
+
+        size_t buf_offset = buf_k * q;
+        for (size_t j = 0; j < buf_k && !heap.empty(); ++j) {
+            std::pop_heap(heap.begin(), heap.end(), worse);
+            size_t i = heap.back();
+            size_t offset = strides[i] * q + cursors[i];
+            ids[buf_offset + j] = results[i].ids_[offset];
+            distances[buf_offset + j] = results[i].distances_[offset];
+
+            // -1 means no more result in this task
+            ++cursors[i];
+            if (cursors[i] < static_cast<size_t>(results[i].k_) && results[i].ids_[offset + 1] != -1) {
+                std::push_heap(heap.begin(), heap.end(), worse);
+            } else {
+                heap.pop_back();
+            }
+        }
+    }
+}
+
+}  // namespace
+
 void
 SearchJob::OnCreateTasks(JobTasks& tasks) {
     for (auto& id : segment_ids_) {
-        auto task = std::make_shared<SearchTask>(context_, snapshot_, options_, query_ptr_, id);
+        auto task = std::make_shared<SearchTask>(context_, snapshot_, options_, query_ptr_, id, delete_ids_);
         task->job_ = this;
+        task->result_index_ = tasks.size();
         tasks.emplace_back(task);
     }
+
+    // all buffered chunks are searched by one task, they are small and scanned by brute force
+    if (!mem_chunks_.empty()) {
+        auto task = std::make_shared<SearchTask>(context_, snapshot_, options_, query_ptr_, mem_chunks_);
+        task->job_ = this;
+        task->result_index_ = tasks.size();
+        tasks.emplace_back(task);
+    }
+
+    task_results_.clear();
+    task_results_.resize(tasks.size());
+}
+
+void
+SearchJob::ReduceResults() {
+    if (query_ptr_ == nullptr || query_ptr_->vectors.empty()) {
+        return;
+    }
+
+    // TODO(yukun): Remove hardcode here
+    auto vector_param = query_ptr_->vectors.begin()->second;
+    size_t nq = vector_param->nq;
+    size_t topk = vector_param->topk;
+
+    bool has_result = std::any_of(task_results_.begin(), task_results_.end(),
+                                  [](const SearchTaskResult& result) { return result.k_ > 0; });
+    if (!has_result) {
+        return;
+    }
+
+    // distance -- value 0 means two vectors equal, ascending reduce, L2/HAMMING/JACCARD/TONIMOTO ...
+    // similarity -- infinity value means two vectors equal, descending reduce, IP
+    // the metric may be omitted in search params, then the segments are searched with the index metric
+    std::string metric_type;
+    auto status = engine::GetSearchMetricType(snapshot_, query_ptr_, vector_param, metric_type);
+    if (!status.ok()) {
+        LOG_ENGINE_WARNING_ << "Failed to get metric type for reduce: " << status.message();
+    }
+    bool ascending = (metric_type != knowhere::Metric::IP);
+
+    query_result_ = std::make_shared<engine::QueryResult>();
+    query_result_->row_num_ = nq;
+    ReduceTopk(task_results_, nq, topk, ascending, query_result_->result_ids_, query_result_->result_distances_);
+
+    // release memory of task results
+    std::vector<SearchTaskResult>().swap(task_results_);
+}
+
+void
+SearchJob::ReduceTopk(const std::vector<SearchTaskResult>& results, size_t nq, size_t topk, bool ascending,
+                      engine::ResultIds& ids, engine::ResultDistances& distances) {
+    size_t total_k = 0;
+    for (auto& result : results) {
+        total_k += std::max<int64_t>(result.k_, 0);
+    }
+    size_t buf_k = std::min(topk, total_k);
+    ids.assign(nq * buf_k, -1);
+    distances.assign(nq * buf_k, 0.0);
+    if (nq == 0 || buf_k == 0) {
+        return;
+    }
+
+    // each block of queries writes its own part of ids/distances
+    int64_t block_num = (static_cast<int64_t>(nq) + REDUCE_QUERIES_PER_BLOCK - 1) / REDUCE_QUERIES_PER_BLOCK;
+#pragma omp parallel for if (block_num > 1)
+    for (int64_t i = 0; i < block_num; ++i) {
+        size_t begin = i * REDUCE_QUERIES_PER_BLOCK;
+        size_t end = std::min<size_t>(begin + REDUCE_QUERIES_PER_BLOCK, nq);
+        ReduceQueries(results, nq, begin, end, buf_k, ascending, ids, distances);
+    }
 }
 
 json
 SearchJob::Dump() const {
     json ret{
         {"number_of_search_segment", segment_ids_.size()},
+        {"number_of_search_mem_chunk", mem_chunks_.size()},
     };
     auto base = Job::Dump();
     ret.insert(base.begin(), base.end());
@@ -30,6 +30,13 @@
 namespace milvus {
 namespace scheduler {
 
+// search result of one task, ids and distances are nq * topk, the first k_ of each query are valid
+struct SearchTaskResult {
+    engine::ResultIds ids_;
+    engine::ResultDistances distances_;
+    int64_t k_ = 0;
+};
+
 // struct SearchTimeStat {
 //    double query_time = 0.0;
 //    double map_uids_time = 0.0;
@@ -40,7 +47,8 @@ class SearchJob : public Job {
  public:
     SearchJob(const server::ContextPtr& context, const engine::snapshot::ScopedSnapshotT& snapshot,
               engine::DBOptions options, const query::QueryPtr& query_ptr,
-              const engine::snapshot::IDS_TYPE& segment_ids);
+              const engine::snapshot::IDS_TYPE& segment_ids, const engine::MemChunkViews& mem_chunks = {},
+              const engine::PendingDeleteIdsPtr& delete_ids = nullptr);
 
  public:
     json
@@ -71,11 +79,26 @@ class SearchJob : public Job {
         return segment_ids_;
     }
 
-    std::mutex&
-    mutex() {
-        return mutex_;
+    const engine::MemChunkViews&
+    mem_chunks() {
+        return mem_chunks_;
+    }
+
+    // each task writes its own result slot, no lock is required
+    SearchTaskResult&
+    task_result(size_t index) {
+        return task_results_[index];
     }
 
+    // merge results of all tasks into query_result(), called after all tasks finished
+    void
+    ReduceResults();
+
+    // k-way merge of task results, queries are reduced in parallel
+    static void
+    ReduceTopk(const std::vector<SearchTaskResult>& results, size_t nq, size_t topk, bool ascending,
+               engine::ResultIds& ids, engine::ResultDistances& distances);
+
  protected:
     void
     OnCreateTasks(JobTasks& tasks) override;
@@ -88,6 +111,10 @@ class SearchJob : public Job {
     query::QueryPtr query_ptr_;
     engine::QueryResultPtr query_result_;
     engine::snapshot::IDS_TYPE segment_ids_;
+    engine::MemChunkViews mem_chunks_;
+    engine::PendingDeleteIdsPtr delete_ids_;
+
+    std::vector<SearchTaskResult> task_results_;
 };
 
 using SearchJobPtr = std::shared_ptr<SearchJob>;
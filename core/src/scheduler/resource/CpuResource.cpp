@@ -11,6 +11,7 @@
 
 #include "scheduler/resource/CpuResource.h"
 #include "knowhere/index/vector_index/helpers/BuilderSuspend.h"
+#include "value/config/ServerConfig.h"
 
 #include <utility>
 
@@ -25,6 +26,7 @@ operator<<(std::ostream& out, const CpuResource& resource) {
 
 CpuResource::CpuResource(std::string name, uint64_t device_id, bool enable_executor)
     : Resource(std::move(name), ResourceType::CPU, device_id, enable_executor) {
+    SetWorkers(config.engine.loader_num(), config.engine.executor_num(), config.engine.prefetch_num());
 }
 
 void
@@ -34,12 +36,20 @@ CpuResource::Load(TaskPtr task) {
 
 void
 CpuResource::Execute(TaskPtr task) {
-    if (task->Type() == TaskType::SearchTask) {
-        knowhere::BuilderSuspend();
+    // index building is suspended while any executor is searching
+    bool search = (task->Type() == TaskType::SearchTask);
+    if (search) {
+        std::lock_guard<std::mutex> lock(search_mutex_);
+        if (search_count_++ == 0) {
+            knowhere::BuilderSuspend();
+        }
     }
     task->Execute();
-    if (task->Type() == TaskType::SearchTask) {
-        knowhere::BuildResume();
+    if (search) {
+        std::lock_guard<std::mutex> lock(search_mutex_);
+        if (--search_count_ == 0) {
+            knowhere::BuildResume();
+        }
     }
 }
 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 
 #include "Resource.h"
@@ -31,6 +32,10 @@ class CpuResource : public Resource {
 
     void
     Execute(TaskPtr task) override;
+
+ private:
+    std::mutex search_mutex_;
+    int64_t search_count_ = 0;
 };
 
 }  // namespace scheduler
@@ -14,6 +14,7 @@
 #include "scheduler/Utils.h"
 #include "scheduler/task/FinishedTask.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <utility>
@@ -54,12 +55,23 @@ Resource::Resource(std::string name, ResourceType type, uint64_t device_id, bool
     });
 }
 
+void
+Resource::SetWorkers(uint64_t loader_num, uint64_t executor_num, uint64_t prefetch_num) {
+    loader_num_ = std::max<uint64_t>(loader_num, 1);
+    executor_num_ = std::max<uint64_t>(executor_num, 1);
+    task_table_.SetPrefetchNum(std::max<uint64_t>(prefetch_num, 1));
+}
+
 void
 Resource::Start() {
     running_ = true;
-    loader_thread_ = std::thread(&Resource::loader_function, this);
+    for (uint64_t i = 0; i < loader_num_; ++i) {
+        loader_threads_.emplace_back(&Resource::loader_function, this);
+    }
     if (enable_executor_) {
-        executor_thread_ = std::thread(&Resource::executor_function, this);
+        for (uint64_t i = 0; i < executor_num_; ++i) {
+            executor_threads_.emplace_back(&Resource::executor_function, this, i);
+        }
     }
 }
 
@@ -67,10 +79,16 @@ void
 Resource::Stop() {
     running_ = false;
     WakeupLoader();
-    loader_thread_.join();
+    for (auto& thread : loader_threads_) {
+        thread.join();
+    }
+    loader_threads_.clear();
     if (enable_executor_) {
         WakeupExecutor();
-        executor_thread_.join();
+        for (auto& thread : executor_threads_) {
+            thread.join();
+        }
+        executor_threads_.clear();
     }
 }
 
@@ -78,18 +96,18 @@ void
 Resource::WakeupLoader() {
     {
         std::lock_guard<std::mutex> lock(load_mutex_);
-        load_flag_ = true;
+        ++load_seq_;
     }
-    load_cv_.notify_one();
+    load_cv_.notify_all();
 }
 
 void
 Resource::WakeupExecutor() {
     {
         std::lock_guard<std::mutex> lock(exec_mutex_);
-        exec_flag_ = true;
+        ++exec_seq_;
     }
-    exec_cv_.notify_one();
+    exec_cv_.notify_all();
 }
 
 json
@@ -99,10 +117,12 @@ Resource::Dump() const {
         {"name", name_},
         {"type", ToString(type_)},
         {"task_average_cost", TaskAvgCost()},
-        {"task_total_cost", total_cost_},
-        {"total_tasks", total_task_},
+        {"task_total_cost", total_cost_.load()},
+        {"total_tasks", total_task_.load()},
         {"running", running_},
         {"enable_executor", enable_executor_},
+        {"loader_num", loader_num_},
+        {"executor_num", executor_num_},
     };
     return ret;
 }
@@ -116,11 +136,25 @@ TaskTableItemPtr
 Resource::pick_task_load() {
     auto indexes = task_table_.PickToLoad(10);
     for (auto index : indexes) {
+        // several loaders may pick the same build index task, only the one got a build place can load it
+        auto task = task_table_[index]->task;
+        bool build_index = (task->Type() == TaskType::BuildIndexTask && name() == "cpu");
+        if (build_index && !BuildMgrInst::GetInstance()->Take()) {
+            continue;
+        }
+
         // try to set one task loading, then return
         if (task_table_.Load(index)) {
+            if (build_index) {
+                LOG_SERVER_DEBUG_ << name() << " load BuildIndexTask";
+            }
             return task_table_.at(index);
         }
-        // else try next
+
+        // else give back the build place and try next
+        if (build_index) {
+            BuildMgrInst::GetInstance()->Put();
+        }
     }
     return nullptr;
 }
@@ -154,20 +188,17 @@ Resource::pick_task_execute() {
 void
 Resource::loader_function() {
     SetThreadName("taskloader_th");
+    uint64_t seen_seq = 0;
     while (running_) {
         std::unique_lock<std::mutex> lock(load_mutex_);
-        load_cv_.wait(lock, [&] { return load_flag_; });
-        load_flag_ = false;
+        load_cv_.wait(lock, [&] { return load_seq_ != seen_seq; });
+        seen_seq = load_seq_;
         lock.unlock();
         while (true) {
             auto task_item = pick_task_load();
             if (task_item == nullptr) {
                 break;
             }
-            if (task_item->task->Type() == TaskType::BuildIndexTask && name() == "cpu") {
-                BuildMgrInst::GetInstance()->Take();
-                LOG_SERVER_DEBUG_ << name() << " load BuildIndexTask";
-            }
             Load(task_item->task);
             task_item->Loaded();
             if (task_item->from) {
@@ -184,16 +215,17 @@ Resource::loader_function() {
 }
 
 void
-Resource::executor_function() {
+Resource::executor_function(uint64_t worker_index) {
     SetThreadName("taskexecutor_th");
-    if (subscriber_) {
+    if (subscriber_ && worker_index == 0) {
         auto event = std::make_shared<StartUpEvent>(shared_from_this());
         subscriber_(std::static_pointer_cast<Event>(event));
     }
+    uint64_t seen_seq = 0;
     while (running_) {
         std::unique_lock<std::mutex> lock(exec_mutex_);
-        exec_cv_.wait(lock, [&] { return exec_flag_; });
-        exec_flag_ = false;
+        exec_cv_.wait(lock, [&] { return exec_seq_ != seen_seq; });
+        seen_seq = exec_seq_;
         lock.unlock();
         while (true) {
             auto task_item = pick_task_execute();
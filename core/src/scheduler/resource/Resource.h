@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <memory>
@@ -42,25 +43,25 @@ enum class ResourceType {
 class Resource : public Node, public std::enable_shared_from_this<Resource> {
  public:
     /*
-     * Start loader and executor if enable;
+     * Start loaders and executors if enable;
      */
     void
     Start();
 
     /*
-     * Stop loader and executor, join it, blocking util thread exited;
+     * Stop loaders and executors, join them, blocking util threads exited;
      */
     void
     Stop();
 
     /*
-     * wake up loader;
+     * wake up loaders;
      */
     void
     WakeupLoader();
 
     /*
-     * wake up executor;
+     * wake up executors;
      */
     void
     WakeupExecutor();
@@ -107,10 +108,11 @@ class Resource : public Node, public std::enable_shared_from_this<Resource> {
     // TODO(wxyu): need double ?
     inline uint64_t
     TaskAvgCost() const {
-        if (total_task_ == 0) {
+        uint64_t total_task = total_task_;
+        if (total_task == 0) {
             return 0;
         }
-        return total_cost_ / total_task_;
+        return total_cost_ / total_task;
     }
 
     inline uint64_t
@@ -124,6 +126,13 @@ class Resource : public Node, public std::enable_shared_from_this<Resource> {
  protected:
     Resource(std::string name, ResourceType type, uint64_t device_id, bool enable_executor);
 
+    /*
+     * Set number of loader/executor threads and the number of loaded tasks waiting for execution;
+     * Called by inherit class before Start;
+     */
+    void
+    SetWorkers(uint64_t loader_num, uint64_t executor_num, uint64_t prefetch_num);
+
     /*
      * Implementation by inherit class;
      * Blocking function;
@@ -155,16 +164,17 @@ class Resource : public Node, public std::enable_shared_from_this<Resource> {
 
  private:
     /*
-     * Only called by load thread;
+     * Only called by load threads;
      */
     void
     loader_function();
 
     /*
-     * Only called by worker thread;
+     * Only called by worker threads;
+     * Workers pick tasks from the same task table, an idle worker takes any loaded task;
      */
     void
-    executor_function();
+    executor_function(uint64_t worker_index);
 
  protected:
     uint64_t device_id_;
@@ -175,18 +185,21 @@ class Resource : public Node, public std::enable_shared_from_this<Resource> {
 
     TaskTable task_table_;
 
-    uint64_t total_cost_ = 0;
-    uint64_t total_task_ = 0;
+    std::atomic<uint64_t> total_cost_{0};
+    std::atomic<uint64_t> total_task_{0};
 
     std::function<void(EventPtr)> subscriber_ = nullptr;
 
     bool running_ = false;
     bool enable_executor_ = true;
-    std::thread loader_thread_;
-    std::thread executor_thread_;
-
-    bool load_flag_ = false;
-    bool exec_flag_ = false;
+    uint64_t loader_num_ = 1;
+    uint64_t executor_num_ = 1;
+    std::vector<std::thread> loader_threads_;
+    std::vector<std::thread> executor_threads_;
+
+    // increased by each wakeup, every worker compares it with the last value it has seen
+    uint64_t load_seq_ = 0;
+    uint64_t exec_seq_ = 0;
     std::mutex load_mutex_;
     std::mutex exec_mutex_;
     std::condition_variable load_cv_;
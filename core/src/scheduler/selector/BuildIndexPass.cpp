@@ -25,6 +25,7 @@ BuildIndexPass::Init() {
     build_gpus_ = ParseGPUDevices(config.gpu.build_index_devices());
     cpu_type_list_ = {knowhere::IndexEnum::INDEX_FAISS_BIN_IDMAP,
                       knowhere::IndexEnum::INDEX_FAISS_BIN_IVFFLAT,
+                      knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN,
                       knowhere::IndexEnum::INDEX_NSG,
 #ifdef MILVUS_SUPPORT_SPTAG
                       knowhere::IndexEnum::INDEX_SPTAG_KDT_RNT,
@@ -19,10 +19,12 @@
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include "db/Utils.h"
 #include "db/engine/ExecutionEngineImpl.h"
+#include "metrics/SearchMetrics.h"
 #include "scheduler/SchedInst.h"
 #include "utils/Log.h"
 #include "utils/TimeRecorder.h"
@@ -32,20 +34,40 @@ namespace scheduler {
 
 SearchTask::SearchTask(const server::ContextPtr& context, engine::snapshot::ScopedSnapshotT snapshot,
                        const engine::DBOptions& options, const query::QueryPtr& query_ptr,
-                       engine::snapshot::ID_TYPE segment_id)
+                       engine::snapshot::ID_TYPE segment_id, const engine::PendingDeleteIdsPtr& delete_ids)
     : Task(TaskType::SearchTask),
       context_(context),
       snapshot_(snapshot),
       options_(options),
       query_ptr_(query_ptr),
-      segment_id_(segment_id) {
+      segment_id_(segment_id),
+      delete_ids_(delete_ids),
+      create_time_(std::chrono::steady_clock::now()) {
+    CreateExecEngine();
+}
+
+SearchTask::SearchTask(const server::ContextPtr& context, engine::snapshot::ScopedSnapshotT snapshot,
+                       const engine::DBOptions& options, const query::QueryPtr& query_ptr,
+                       const engine::MemChunkViews& mem_chunks)
+    : Task(TaskType::SearchTask),
+      context_(context),
+      snapshot_(snapshot),
+      options_(options),
+      query_ptr_(query_ptr),
+      segment_id_(0),
+      mem_chunks_(mem_chunks),
+      create_time_(std::chrono::steady_clock::now()) {
     CreateExecEngine();
 }
 
 void
 SearchTask::CreateExecEngine() {
     if (execution_engine_ == nullptr && query_ptr_ != nullptr) {
-        execution_engine_ = engine::EngineFactory::Build(snapshot_, options_.meta_.path_, segment_id_);
+        if (mem_chunks_.empty()) {
+            execution_engine_ = engine::EngineFactory::Build(snapshot_, options_.meta_.path_, segment_id_);
+        } else {
+            execution_engine_ = engine::EngineFactory::Build(snapshot_, mem_chunks_);
+        }
     }
 }
 
@@ -54,6 +76,7 @@ SearchTask::Dump() const {
     json ret{
         {"type", "SearchTask"},
         {"segment_id", segment_id_},
+        {"mem_chunks", mem_chunks_.size()},
     };
 
     return ret;
@@ -62,12 +85,18 @@ SearchTask::Dump() const {
 Status
 SearchTask::OnLoad(LoadType type, uint8_t device_id) {
     TimeRecorder rc("SearchTask::OnLoad " + std::to_string(segment_id_));
+    if (type == LoadType::DISK2CPU) {
+        auto wait_time = std::chrono::steady_clock::now() - create_time_;
+        SearchMetrics::GetInstance().Observe(SearchStage::SCHEDULER_WAIT, query_ptr_->collection_id, IndexType(),
+                                             std::chrono::duration_cast<std::chrono::microseconds>(wait_time).count());
+    }
     Status stat = Status::OK();
     std::string error_msg;
     std::string type_str;
 
     try {
         if (type == LoadType::DISK2CPU) {
+            SearchStageTimer load_timer(SearchStage::LOAD, query_ptr_->collection_id, IndexType());
             engine::ExecutionEngineContext context;
             context.query_ptr_ = query_ptr_;
             stat = execution_engine_->Load(context);
@@ -124,41 +153,37 @@ SearchTask::OnExecute() {
         /* step 2: search */
         engine::ExecutionEngineContext context;
         context.query_ptr_ = query_ptr_;
+        context.delete_ids_ = delete_ids_;
         STATUS_CHECK(execution_engine_->Search(context));
 
         rc.RecordSection("search done");
 
-        /* step 3: pick up topk result */
+        /* step 3: keep topk result, results of all tasks are reduced after the job finished */
         // TODO(yukun): Remove hardcode here
         auto vector_param = context.query_ptr_->vectors.begin()->second;
         auto topk = vector_param->topk;
-        auto segment_ptr = snapshot_->GetSegmentCommitBySegmentId(segment_id_);
-        auto spec_k = segment_ptr->GetRowCount() < topk ? segment_ptr->GetRowCount() : topk;
-        int64_t nq = vector_param->nq;
-        if (spec_k == 0) {
-            LOG_ENGINE_WARNING_ << LogOut("[%s][%ld] Searching in an empty segment. segment id = %d", "search", 0,
-                                          segment_ptr->GetID());
+        int64_t row_count = 0;
+        if (mem_chunks_.empty()) {
+            row_count = snapshot_->GetSegmentCommitBySegmentId(segment_id_)->GetRowCount();
         } else {
-            std::unique_lock<std::mutex> lock(search_job->mutex());
-            if (!search_job->query_result()) {
-                search_job->query_result() = std::make_shared<engine::QueryResult>();
-                search_job->query_result()->row_num_ = nq;
+            for (auto& view : mem_chunks_) {
+                row_count += view.chunk_->count_;
             }
-            if (vector_param->metric_type == "IP") {
-                ascending_reduce_ = false;
-            }
-            SearchTask::MergeTopkToResultSet(context.query_result_->result_ids_,
-                                             context.query_result_->result_distances_, spec_k, nq, topk,
-                                             ascending_reduce_, search_job->query_result()->result_ids_,
-                                             search_job->query_result()->result_distances_);
-
-            LOG_ENGINE_DEBUG_ << "Merged result: "
-                              << "nq = " << nq << ", topk = " << topk
-                              << ", len of ids = " << context.query_result_->result_ids_.size()
-                              << ", len of distance = " << context.query_result_->result_distances_.size();
+        }
+        auto spec_k = row_count < topk ? row_count : topk;
+        if (spec_k == 0) {
+            LOG_ENGINE_WARNING_ << LogOut("[%s][%ld] Searching in an empty segment. segment id = %ld", "search", 0,
+                                          segment_id_);
+        } else if (context.query_result_ == nullptr || context.query_result_->result_ids_.empty()) {
+            LOG_ENGINE_DEBUG_ << LogOut("[%s][%d] Search result is empty.", "search", 0);
+        } else {
+            auto& task_result = search_job->task_result(result_index_);
+            task_result.ids_.swap(context.query_result_->result_ids_);
+            task_result.distances_.swap(context.query_result_->result_distances_);
+            task_result.k_ = spec_k;
         }
 
-        rc.RecordSection("reduce topk done");
+        rc.RecordSection("keep topk done");
     } catch (std::exception& ex) {
         LOG_ENGINE_ERROR_ << LogOut("[%s][%ld] SearchTask encounter exception: %s", "search", 0, ex.what());
         return Status(SERVER_UNEXPECTED_ERROR, ex.what());
@@ -169,71 +194,32 @@ SearchTask::OnExecute() {
 }
 
 void
-SearchTask::MergeTopkToResultSet(const engine::ResultIds& src_ids, const engine::ResultDistances& src_distances,
-                                 size_t src_k, size_t nq, size_t topk, bool ascending, engine::ResultIds& tar_ids,
-                                 engine::ResultDistances& tar_distances) {
-    if (src_ids.empty()) {
-        LOG_ENGINE_DEBUG_ << LogOut("[%s][%d] Search result is empty.", "search", 0);
+SearchTask::RemoveDuplicatedIds(size_t nq, engine::ResultIds& ids, engine::ResultDistances& distances) {
+    if (nq == 0 || ids.empty()) {
         return;
     }
 
-    size_t tar_k = tar_ids.size() / nq;
-    size_t buf_k = std::min(topk, src_k + tar_k);
-
-    engine::ResultIds buf_ids(nq * buf_k, -1);
-    engine::ResultDistances buf_distances(nq * buf_k, 0.0);
-
-    for (uint64_t i = 0; i < nq; i++) {
-        size_t buf_k_j = 0, src_k_j = 0, tar_k_j = 0;
-        size_t buf_idx, src_idx, tar_idx;
-
-        size_t buf_k_multi_i = buf_k * i;
-        size_t src_k_multi_i = topk * i;
-        size_t tar_k_multi_i = tar_k * i;
-
-        while (buf_k_j < buf_k && src_k_j < src_k && tar_k_j < tar_k) {
-            src_idx = src_k_multi_i + src_k_j;
-            tar_idx = tar_k_multi_i + tar_k_j;
-            buf_idx = buf_k_multi_i + buf_k_j;
-
-            if ((tar_ids[tar_idx] == -1) ||  // initialized value
-                (ascending && src_distances[src_idx] < tar_distances[tar_idx]) ||
-                (!ascending && src_distances[src_idx] > tar_distances[tar_idx])) {
-                buf_ids[buf_idx] = src_ids[src_idx];
-                buf_distances[buf_idx] = src_distances[src_idx];
-                src_k_j++;
-            } else {
-                buf_ids[buf_idx] = tar_ids[tar_idx];
-                buf_distances[buf_idx] = tar_distances[tar_idx];
-                tar_k_j++;
+    size_t topk = ids.size() / nq;
+    std::unordered_set<engine::idx_t> id_set;
+    for (size_t i = 0; i < nq; i++) {
+        id_set.clear();
+        size_t offset = i * topk;
+        size_t valid_k = 0;
+        for (size_t j = 0; j < topk; j++) {
+            auto id = ids[offset + j];
+            if (id == -1 || id_set.find(id) != id_set.end()) {
+                continue;
             }
-            buf_k_j++;
+            id_set.insert(id);
+            ids[offset + valid_k] = id;
+            distances[offset + valid_k] = distances[offset + j];
+            valid_k++;
         }
-
-        if (buf_k_j < buf_k) {
-            if (src_k_j < src_k) {
-                while (buf_k_j < buf_k && src_k_j < src_k) {
-                    buf_idx = buf_k_multi_i + buf_k_j;
-                    src_idx = src_k_multi_i + src_k_j;
-                    buf_ids[buf_idx] = src_ids[src_idx];
-                    buf_distances[buf_idx] = src_distances[src_idx];
-                    src_k_j++;
-                    buf_k_j++;
-                }
-            } else {
-                while (buf_k_j < buf_k && tar_k_j < tar_k) {
-                    buf_idx = buf_k_multi_i + buf_k_j;
-                    tar_idx = tar_k_multi_i + tar_k_j;
-                    buf_ids[buf_idx] = tar_ids[tar_idx];
-                    buf_distances[buf_idx] = tar_distances[tar_idx];
-                    tar_k_j++;
-                    buf_k_j++;
-                }
-            }
+        for (; valid_k < topk; valid_k++) {
+            ids[offset + valid_k] = -1;
+            distances[offset + valid_k] = 0.0;
         }
     }
-    tar_ids.swap(buf_ids);
-    tar_distances.swap(buf_distances);
 }
 
 int64_t
@@ -279,6 +265,10 @@ SearchTask::IndexType() {
     if (!index_type_.empty()) {
         return index_type_;
     }
+    if (!mem_chunks_.empty()) {
+        index_type_ = "FLAT";  // buffered entities are searched by brute force
+        return index_type_;
+    }
     auto seg_visitor = engine::SegmentVisitor::Build(snapshot_, segment_id_);
     index_type_ = "FLAT";
 
@@ -292,7 +282,7 @@ SearchTask::IndexType() {
             if (!field_visitor) {
                 continue;
             }
-            if (type == engine::DataType::VECTOR_FLOAT || type == engine::DataType::VECTOR_BINARY) {
+            if (engine::utils::IsVectorType(type)) {
                 auto fe_visitor = field_visitor->GetElementVisitor(engine::FieldElementType::FET_INDEX);
                 if (fe_visitor) {
                     auto element = fe_visitor->GetElement();
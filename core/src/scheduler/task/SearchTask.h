@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -28,7 +29,12 @@ class SearchTask : public Task {
  public:
     explicit SearchTask(const server::ContextPtr& context, engine::snapshot::ScopedSnapshotT snapshot,
                         const engine::DBOptions& options, const query::QueryPtr& query_ptr,
-                        engine::snapshot::ID_TYPE segment_id);
+                        engine::snapshot::ID_TYPE segment_id, const engine::PendingDeleteIdsPtr& delete_ids = nullptr);
+
+    // search the entities buffered in memory
+    explicit SearchTask(const server::ContextPtr& context, engine::snapshot::ScopedSnapshotT snapshot,
+                        const engine::DBOptions& options, const query::QueryPtr& query_ptr,
+                        const engine::MemChunkViews& mem_chunks);
 
     json
     Dump() const override;
@@ -39,10 +45,9 @@ class SearchTask : public Task {
     Status
     OnExecute() override;
 
+    // an entity could be found in both memory and new flushed segment, keep the first one
     static void
-    MergeTopkToResultSet(const engine::ResultIds& src_ids, const engine::ResultDistances& src_distances, size_t src_k,
-                         size_t nq, size_t topk, bool ascending, engine::ResultIds& tar_ids,
-                         engine::ResultDistances& tar_distances);
+    RemoveDuplicatedIds(size_t nq, engine::ResultIds& ids, engine::ResultDistances& distances);
 
     int64_t
     nq();
@@ -67,13 +72,15 @@ class SearchTask : public Task {
     const engine::DBOptions& options_;
     query::QueryPtr query_ptr_;
     engine::snapshot::ID_TYPE segment_id_;
+    engine::MemChunkViews mem_chunks_;
+    engine::PendingDeleteIdsPtr delete_ids_;  // masked in the segment, the mem chunks have their own blacklists
     std::string index_type_;
+    std::chrono::steady_clock::time_point create_time_;
 
     engine::ExecutionEnginePtr execution_engine_;
 
-    // distance -- value 0 means two vectors equal, ascending reduce, L2/HAMMING/JACCARD/TONIMOTO ...
-    // similarity -- infinity value means two vectors equal, descending reduce, IP
-    bool ascending_reduce_ = true;
+    // index of result slot in the search job
+    size_t result_index_ = 0;
 };
 
 }  // namespace scheduler
@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "segment/IdIndex.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace milvus {
+namespace segment {
+
+IdIndex::IdIndex(const engine::idx_t* uids, int64_t count) {
+    if (uids == nullptr || count <= 0) {
+        return;
+    }
+
+    offsets_.resize(count);
+    std::iota(offsets_.begin(), offsets_.end(), 0);
+    std::stable_sort(offsets_.begin(), offsets_.end(),
+                     [&](engine::offset_t a, engine::offset_t b) { return uids[a] < uids[b]; });
+
+    ids_.resize(count);
+    for (int64_t i = 0; i < count; ++i) {
+        ids_[i] = uids[offsets_[i]];
+    }
+}
+
+IdIndex::IdIndex(std::vector<engine::idx_t>&& ids, std::vector<engine::offset_t>&& offsets)
+    : ids_(std::move(ids)), offsets_(std::move(offsets)) {
+}
+
+bool
+IdIndex::Find(engine::idx_t uid, engine::offset_t& offset) const {
+    auto iter = std::lower_bound(ids_.begin(), ids_.end(), uid);
+    if (iter == ids_.end() || *iter != uid) {
+        return false;
+    }
+
+    offset = offsets_[iter - ids_.begin()];
+    return true;
+}
+
+void
+IdIndex::FindAll(engine::idx_t uid, std::vector<engine::offset_t>& offsets) const {
+    auto range = std::equal_range(ids_.begin(), ids_.end(), uid);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        offsets.push_back(offsets_[iter - ids_.begin()]);
+    }
+}
+
+int64_t
+IdIndex::Size() {
+    return ids_.size() * sizeof(engine::idx_t) + offsets_.size() * sizeof(engine::offset_t);
+}
+
+}  // namespace segment
+}  // namespace milvus
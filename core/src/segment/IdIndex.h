@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "cache/DataObj.h"
+#include "db/Types.h"
+
+namespace milvus {
+namespace segment {
+
+// uids of a segment sorted in ascending order, each one with its offset in the segment
+// the uids never change after the segment is serialized, so the index lives as long as the segment
+class IdIndex : public cache::DataObj {
+ public:
+    IdIndex(const engine::idx_t* uids, int64_t count);
+
+    IdIndex(std::vector<engine::idx_t>&& ids, std::vector<engine::offset_t>&& offsets);
+
+    // return false if the uid is not in this segment
+    // if the uid is duplicated, the smallest offset is returned
+    bool
+    Find(engine::idx_t uid, engine::offset_t& offset) const;
+
+    // get all offsets of the uid, user specified uids could be duplicated
+    void
+    FindAll(engine::idx_t uid, std::vector<engine::offset_t>& offsets) const;
+
+    const std::vector<engine::idx_t>&
+    GetIds() const {
+        return ids_;
+    }
+
+    const std::vector<engine::offset_t>&
+    GetOffsets() const {
+        return offsets_;
+    }
+
+    int64_t
+    GetCount() const {
+        return ids_.size();
+    }
+
+    int64_t
+    Size() override;
+
+    // No copy and move
+    IdIndex(const IdIndex&) = delete;
+    IdIndex(IdIndex&&) = delete;
+
+    IdIndex&
+    operator=(const IdIndex&) = delete;
+    IdIndex&
+    operator=(IdIndex&&) = delete;
+
+ private:
+    std::vector<engine::idx_t> ids_;
+    std::vector<engine::offset_t> offsets_;
+};
+
+using IdIndexPtr = std::shared_ptr<IdIndex>;
+
+}  // namespace segment
+}  // namespace milvus
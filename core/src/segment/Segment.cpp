@@ -17,6 +17,7 @@
 
 #include "segment/Segment.h"
 #include "db/SnapshotUtils.h"
+#include "db/Utils.h"
 #include "db/snapshot/Snapshots.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #include "segment/Utils.h"
@@ -110,14 +111,8 @@ Segment::AddField(const snapshot::FieldPtr& field) {
             return Status(DB_ERROR, msg);
         }
 
-        int64_t field_width = 0;
         int64_t dimension = params[knowhere::meta::DIM];
-        if (ftype == DataType::VECTOR_BINARY) {
-            field_width += (dimension / 8);
-        } else {
-            field_width += (dimension * sizeof(float));
-        }
-        AddField(name, ftype, field_width);
+        AddField(name, ftype, utils::GetVectorRowSize(ftype, dimension));
     } else {
         AddField(name, ftype);
     }
@@ -155,6 +150,8 @@ Segment::AddField(const std::string& field_name, DataType field_type, int64_t fi
             real_field_width = sizeof(uint64_t);
             break;
         case DataType::VECTOR_FLOAT:
+        case DataType::VECTOR_FLOAT16:
+        case DataType::VECTOR_BFLOAT16:
         case DataType::VECTOR_BINARY: {
             if (field_width <= 0) {
                 std::string msg = "vecor field dimension required: " + field_name;
@@ -274,6 +271,13 @@ Segment::AppendChunk(const DataChunkPtr& chunk_ptr, int64_t from, int64_t to) {
         int64_t add_bytes = add_count * width_iter.second;
         int64_t previous_bytes = row_count_ * width_iter.second;
         int64_t target_bytes = previous_bytes + add_bytes;
+        if (data.use_count() > 1) {
+            // the data is shared with the first appended chunk, copy it before growing
+            auto copy_data = std::make_shared<BinaryData>();
+            copy_data->data_.reserve(target_bytes);
+            copy_data->data_ = data->data_;
+            data = copy_data;
+        }
         if (data->data_.size() < target_bytes) {
             data->data_.resize(target_bytes);
         }
@@ -314,11 +318,11 @@ Segment::DeleteEntity(std::vector<offset_t>& offsets) {
             continue;
         }
 
+        // the field data might be shared with a DataChunk or cache, replace it instead of modifying in place
         auto& data = pair.second;
-
-        std::vector<uint8_t> new_data;
-        segment::CopyDataWithRanges(data->data_, width, copy_ranges, new_data);
-        data->data_.swap(new_data);
+        auto new_data = std::make_shared<BinaryData>();
+        segment::CopyDataWithRanges(data->data_, width, copy_ranges, new_data->data_);
+        data = new_data;
     }
 
     // reset row count
@@ -26,6 +26,7 @@
 #include "db/snapshot/Resources.h"
 #include "segment/DeletedDocs.h"
 #include "segment/IdBloomFilter.h"
+#include "segment/IdIndex.h"
 
 namespace milvus {
 namespace engine {
@@ -143,6 +144,16 @@ class Segment {
         id_bloom_filter_ptr_ = ptr;
     }
 
+    segment::IdIndexPtr
+    GetIdIndex() const {
+        return id_index_ptr_;
+    }
+
+    void
+    SetIdIndex(const segment::IdIndexPtr& ptr) {
+        id_index_ptr_ = ptr;
+    }
+
  private:
     FIELD_TYPE_MAP field_types_;
     FIELD_WIDTH_MAP fixed_fields_width_;
@@ -155,6 +166,7 @@ class Segment {
 
     segment::DeletedDocsPtr deleted_docs_ptr_ = nullptr;
     segment::IdBloomFilterPtr id_bloom_filter_ptr_ = nullptr;
+    segment::IdIndexPtr id_index_ptr_ = nullptr;
 };
 
 }  // namespace engine
@@ -114,14 +114,8 @@ SegmentReader::Initialize() {
                 return Status(DB_ERROR, msg);
             }
 
-            int64_t field_width = 0;
             int64_t dimension = params[knowhere::meta::DIM];
-            if (ftype == engine::DataType::VECTOR_BINARY) {
-                field_width = (dimension / 8);
-            } else {
-                field_width = (dimension * sizeof(float));
-            }
-            segment_ptr_->AddField(name, ftype, field_width);
+            segment_ptr_->AddField(name, ftype, engine::utils::GetVectorRowSize(ftype, dimension));
         } else {
             segment_ptr_->AddField(name, ftype);
         }
@@ -207,6 +201,58 @@ SegmentReader::LoadFields() {
     return Status::OK();
 }
 
+Status
+SegmentReader::ReadFieldRowCount(const std::string& field_name, int64_t& row_count, bool& ranged) {
+    try {
+        int64_t field_width = 0;
+        STATUS_CHECK(segment_ptr_->GetFixedFieldWidth(field_name, field_width));
+        if (field_width <= 0) {
+            return Status(DB_ERROR, "Invalid field width");
+        }
+
+        std::string file_path;
+        STATUS_CHECK(GetFieldFilePath(field_name, file_path));
+
+        int64_t num_bytes = 0, chunk_size = 0;
+        auto& ss_codec = codec::Codec::instance();
+        STATUS_CHECK(ss_codec.GetBlockFormat()->ReadSize(fs_ptr_, file_path, num_bytes, chunk_size));
+        if (num_bytes % field_width != 0) {
+            return Status(DB_ERROR, "Illegal file size of field " + field_name);
+        }
+        row_count = num_bytes / field_width;
+        ranged = (chunk_size > 0);
+    } catch (std::exception& e) {
+        std::string err_msg = "Failed to read field row count: " + std::string(e.what());
+        LOG_ENGINE_ERROR_ << err_msg;
+        return Status(DB_ERROR, err_msg);
+    }
+    return Status::OK();
+}
+
+Status
+SegmentReader::LoadFieldRows(const std::string& field_name, int64_t offset, int64_t count,
+                             engine::BinaryDataPtr& raw) {
+    try {
+        int64_t field_width = 0;
+        STATUS_CHECK(segment_ptr_->GetFixedFieldWidth(field_name, field_width));
+        if (field_width <= 0) {
+            return Status(DB_ERROR, "Invalid field width");
+        }
+
+        std::string file_path;
+        STATUS_CHECK(GetFieldFilePath(field_name, file_path));
+
+        auto& ss_codec = codec::Codec::instance();
+        STATUS_CHECK(
+            ss_codec.GetBlockFormat()->Read(fs_ptr_, file_path, offset * field_width, count * field_width, raw));
+    } catch (std::exception& e) {
+        std::string err_msg = "Failed to load field rows: " + std::string(e.what());
+        LOG_ENGINE_ERROR_ << err_msg;
+        return Status(DB_ERROR, err_msg);
+    }
+    return Status::OK();
+}
+
 Status
 SegmentReader::LoadEntities(const std::string& field_name, const std::vector<int64_t>& offsets,
                             engine::BinaryDataPtr& raw) {
@@ -419,6 +465,10 @@ SegmentReader::LoadVectorIndex(const std::string& field_name, knowhere::VecIndex
                 int64_t dimension = json[knowhere::meta::DIM];
                 engine::BinaryDataPtr raw;
                 STATUS_CHECK(LoadField(field_name, raw, false));
+                auto ftype = static_cast<engine::DataType>(field->GetFtype());
+                if (engine::utils::IsHalfFloatVectorType(ftype)) {
+                    STATUS_CHECK(engine::utils::DecodeHalfFloatVectors(ftype, raw, raw));
+                }
 
                 // load uids
                 std::shared_ptr<std::vector<int64_t>> uids_ptr = std::make_shared<std::vector<int64_t>>();
@@ -428,7 +478,7 @@ SegmentReader::LoadVectorIndex(const std::string& field_name, knowhere::VecIndex
 
                 // construct IDMAP index
                 knowhere::VecIndexFactory& vec_index_factory = knowhere::VecIndexFactory::GetInstance();
-                if (field->GetFtype() == engine::DataType::VECTOR_FLOAT) {
+                if (!engine::utils::IsBinaryVectorType(ftype)) {
                     index_ptr = vec_index_factory.CreateVecIndex(knowhere::IndexEnum::INDEX_FAISS_IDMAP,
                                                                  knowhere::IndexMode::MODE_CPU);
                 } else {
@@ -468,7 +518,14 @@ SegmentReader::LoadVectorIndex(const std::string& field_name, knowhere::VecIndex
         if (engine::utils::RequireRawFile(index_type)) {
             engine::BinaryDataPtr fixed_data;
             auto status = segment_ptr_->GetFixedFieldData(field_name, fixed_data);
-            if (status.ok()) {
+            auto ftype = static_cast<engine::DataType>(field->GetFtype());
+            if (engine::utils::IsHalfFloatVectorType(ftype)) {
+                // the index reads float vectors, half float raw data is decoded here
+                STATUS_CHECK(LoadField(field_name, fixed_data, false));
+                STATUS_CHECK(engine::utils::DecodeHalfFloatVectors(ftype, fixed_data, fixed_data));
+                STATUS_CHECK(ss_codec.GetVectorIndexFormat()->ConvertRaw(fixed_data, raw_data));
+                recorder.RecordSection("decode half float raw data");
+            } else if (status.ok()) {
                 STATUS_CHECK(ss_codec.GetVectorIndexFormat()->ConvertRaw(fixed_data, raw_data));
             } else if (auto visitor = field_visitor->GetElementVisitor(engine::FieldElementType::FET_RAW)) {
                 auto file_path =
@@ -691,6 +748,60 @@ SegmentReader::LoadDeletedDocs(segment::DeletedDocsPtr& deleted_docs_ptr) {
     return Status::OK();
 }
 
+Status
+SegmentReader::LoadIdIndex(segment::IdIndexPtr& id_index_ptr) {
+    try {
+        TimeRecorderAuto recorder("SegmentReader::LoadIdIndex");
+
+        id_index_ptr = segment_ptr_->GetIdIndex();
+        if (id_index_ptr != nullptr) {
+            return Status::OK();  // already exist
+        }
+
+        // the cache key is the id index file path, or the uid raw file path with index postfix if no index file
+        auto uid_field_visitor = segment_visitor_->GetFieldVisitor(engine::FIELD_UID);
+        std::string file_path;
+        bool has_file = false;
+        auto visitor = uid_field_visitor->GetElementVisitor(engine::FieldElementType::FET_ID_INDEX);
+        if (visitor && visitor->GetFile()) {
+            file_path =
+                engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, visitor->GetFile());
+            has_file = std::experimental::filesystem::exists(file_path + codec::IdIndexFormat::FilePostfix());
+        } else {
+            auto raw_visitor = uid_field_visitor->GetElementVisitor(engine::FieldElementType::FET_RAW);
+            file_path =
+                engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, raw_visitor->GetFile()) +
+                codec::IdIndexFormat::FilePostfix();
+        }
+
+        // if the data is in cache, no need to read file
+        auto data_obj = cache::CpuCacheMgr::GetInstance().GetItem(file_path);
+        if (data_obj == nullptr) {
+            if (has_file) {
+                auto& ss_codec = codec::Codec::instance();
+                STATUS_CHECK(ss_codec.GetIdIndexFormat()->Read(fs_ptr_, file_path, id_index_ptr));
+            } else {
+                engine::idx_t* uids_address = nullptr;
+                int64_t id_count = 0;
+                STATUS_CHECK(LoadUids(&uids_address, id_count));
+                id_index_ptr = std::make_shared<segment::IdIndex>(uids_address, id_count);
+            }
+            cache::CpuCacheMgr::GetInstance().InsertItem(file_path, id_index_ptr);  // put into cache
+        } else {
+            id_index_ptr = std::static_pointer_cast<segment::IdIndex>(data_obj);
+        }
+
+        if (id_index_ptr) {
+            segment_ptr_->SetIdIndex(id_index_ptr);
+        }
+    } catch (std::exception& e) {
+        std::string err_msg = "Failed to load id index: " + std::string(e.what());
+        LOG_ENGINE_ERROR_ << err_msg;
+        return Status(DB_ERROR, err_msg);
+    }
+    return Status::OK();
+}
+
 Status
 SegmentReader::ReadDeletedDocsSize(size_t& size) {
     try {
@@ -745,6 +856,21 @@ SegmentReader::GetSegmentPath() {
     return seg_path;
 }
 
+Status
+SegmentReader::GetFieldFilePath(const std::string& field_name, std::string& file_path) {
+    auto field_visitor = segment_visitor_->GetFieldVisitor(field_name);
+    if (field_visitor == nullptr) {
+        return Status(DB_ERROR, "Invalid field name");
+    }
+
+    auto raw_visitor = field_visitor->GetElementVisitor(engine::FieldElementType::FET_RAW);
+    if (raw_visitor == nullptr || raw_visitor->GetFile() == nullptr) {
+        return Status(DB_FILE_NOT_FOUND, "File of field " + field_name + " is not found");
+    }
+    file_path = engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, raw_visitor->GetFile());
+    return Status::OK();
+}
+
 Status
 SegmentReader::GetTempIndexPath(const std::string& field_name, std::string& path) {
     if (segment_visitor_ == nullptr) {
@@ -812,6 +938,16 @@ SegmentReader::ClearCache() {
                 engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, visitor->GetFile());
             cache::CpuCacheMgr::GetInstance().EraseItem(file_path);
         }
+
+        if (auto visitor = uid_field_visitor->GetElementVisitor(engine::FieldElementType::FET_ID_INDEX)) {
+            std::string file_path =
+                engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, visitor->GetFile());
+            cache::CpuCacheMgr::GetInstance().EraseItem(file_path);
+        } else if (auto visitor = uid_field_visitor->GetElementVisitor(engine::FieldElementType::FET_RAW)) {
+            std::string file_path =
+                engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, visitor->GetFile());
+            cache::CpuCacheMgr::GetInstance().EraseItem(file_path + codec::IdIndexFormat::FilePostfix());
+        }
     }
 
     // erase raw data and index data from cache
@@ -43,6 +43,14 @@ class SegmentReader {
     Status
     LoadFields();
 
+    // read the row count of a field from file header, ranged is false if the file can't be read by ranges
+    Status
+    ReadFieldRowCount(const std::string& field_name, int64_t& row_count, bool& ranged);
+
+    // load rows [offset, offset + count) of a field from file, the data is neither got from nor put into cache
+    Status
+    LoadFieldRows(const std::string& field_name, int64_t offset, int64_t count, engine::BinaryDataPtr& raw);
+
     Status
     LoadEntities(const std::string& field_name, const std::vector<int64_t>& offsets, engine::BinaryDataPtr& raw);
 
@@ -74,6 +82,10 @@ class SegmentReader {
     Status
     LoadDeletedDocs(segment::DeletedDocsPtr& deleted_docs_ptr);
 
+    // load the sorted uid index, if the segment has no id index file, build it from uids
+    Status
+    LoadIdIndex(segment::IdIndexPtr& id_index_ptr);
+
     Status
     ReadDeletedDocsSize(size_t& size);
 
@@ -117,6 +129,9 @@ class SegmentReader {
     Status
     Initialize();
 
+    Status
+    GetFieldFilePath(const std::string& field_name, std::string& file_path);
+
     Status
     GetTempIndexPath(const std::string& field_name, std::string& path);
 
@@ -23,12 +23,14 @@
 
 #include "SegmentReader.h"
 #include "codecs/Codec.h"
+#include "db/SnapshotUtils.h"
 #include "db/Utils.h"
 #include "db/snapshot/ResourceHelper.h"
 #include "storage/disk/DiskIOReader.h"
 #include "storage/disk/DiskIOWriter.h"
 #include "storage/disk/DiskOperation.h"
 #include "utils/CommonUtil.h"
+#include "utils/Exception.h"
 #include "utils/Log.h"
 #include "utils/SignalHandler.h"
 #include "utils/TimeRecorder.h"
@@ -86,6 +88,9 @@ SegmentWriter::Serialize() {
     // write UID's bloom filter
     STATUS_CHECK(WriteBloomFilter());
 
+    // write UID's id index
+    STATUS_CHECK(WriteIdIndex());
+
     return Status::OK();
 }
 
@@ -101,6 +106,12 @@ Status
 SegmentWriter::WriteFields() {
     TimeRecorderAuto recorder("SegmentWriter::WriteFields");
 
+    // uids of merged segments are kept in memory for bloom filter and id index, other fields are streamed
+    bool merging = !merge_sources_.empty();
+    if (merging) {
+        STATUS_CHECK(segment_ptr_->SetFixedFieldData(engine::FIELD_UID, merged_uids_));
+    }
+
     auto& field_visitors_map = segment_visitor_->GetFieldVisitors();
     for (auto& iter : field_visitors_map) {
         const engine::snapshot::FieldPtr& field = iter.second->GetField();
@@ -113,7 +124,11 @@ SegmentWriter::WriteFields() {
             auto segment_file = element_visitor->GetFile();
             std::string file_path =
                 engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, segment_file);
-            STATUS_CHECK(WriteField(file_path, raw_data));
+            if (merging && name != engine::FIELD_UID) {
+                STATUS_CHECK(WriteMergedField(file_path, name));
+            } else {
+                STATUS_CHECK(WriteField(file_path, raw_data));
+            }
 
             auto file_size = milvus::CommonUtil::GetFileSize(file_path);
             segment_file->SetSize(file_size);
@@ -180,6 +195,41 @@ SegmentWriter::WriteBloomFilter(const std::string& file_path, const IdBloomFilte
     return Status::OK();
 }
 
+Status
+SegmentWriter::WriteIdIndex() {
+    TimeRecorder recorder("SegmentWriter::WriteIdIndex");
+
+    // collections created by old version have no id index element, the index is built in memory while loading
+    auto uid_field_visitor = segment_visitor_->GetFieldVisitor(engine::FIELD_UID);
+    auto id_index_visitor = uid_field_visitor->GetElementVisitor(engine::FieldElementType::FET_ID_INDEX);
+    if (id_index_visitor == nullptr || id_index_visitor->GetFile() == nullptr) {
+        return Status::OK();
+    }
+
+    engine::BinaryDataPtr uid_data;
+    STATUS_CHECK(segment_ptr_->GetFixedFieldData(engine::FIELD_UID, uid_data));
+
+    auto uids = reinterpret_cast<engine::idx_t*>(uid_data->data_.data());
+    int64_t row_count = segment_ptr_->GetRowCount();
+    auto id_index_ptr = std::make_shared<segment::IdIndex>(uids, row_count);
+    segment_ptr_->SetIdIndex(id_index_ptr);
+
+    recorder.RecordSection("Initialize id index");
+
+    auto segment_file = id_index_visitor->GetFile();
+    std::string file_path = engine::snapshot::GetResPath<engine::snapshot::SegmentFile>(dir_collections_, segment_file);
+
+    auto& ss_codec = codec::Codec::instance();
+    STATUS_CHECK(ss_codec.GetIdIndexFormat()->Write(fs_ptr_, file_path, id_index_ptr));
+
+    auto file_size = milvus::CommonUtil::GetFileSize(file_path + codec::IdIndexFormat::FilePostfix());
+    segment_file->SetSize(file_size);
+
+    LOG_ENGINE_DEBUG_ << "Serialize id index file size: " << file_size;
+
+    return Status::OK();
+}
+
 Status
 SegmentWriter::WriteDeletedDocs() {
     auto& field_visitors_map = segment_visitor_->GetFieldVisitors();
@@ -239,45 +289,55 @@ SegmentWriter::Merge(const SegmentReaderPtr& segment_reader) {
 
     TimeRecorder recorder("SegmentWriter::Merge");
 
-    // load raw data
-    // After load fields, the data has been cached in segment.
-    status = segment_reader->LoadFields();
-    if (!status.ok()) {
-        return status;
+    // the raw data isn't loaded, only the row count is read from file header
+    MergeSource source;
+    source.reader_ = segment_reader;
+    STATUS_CHECK(segment_reader->ReadFieldRowCount(engine::FIELD_UID, source.row_count_, source.ranged_));
+    auto& field_visitors_map = segment_visitor_->GetFieldVisitors();
+    for (auto& iter : field_visitors_map) {
+        std::string name = iter.second->GetField()->GetName();
+        int64_t row_count = 0;
+        bool ranged = true;
+        STATUS_CHECK(segment_reader->ReadFieldRowCount(name, row_count, ranged));
+        if (row_count != source.row_count_) {
+            return Status(DB_ERROR, "Row count of field " + name + " mismatch in " + segment_reader->GetSegmentPath());
+        }
+        source.ranged_ = source.ranged_ && ranged;
     }
 
-    // merge deleted docs (Note: this step must before merge raw data)
     // Note: deleted docs file could not exist, that means the segment has no deleted entities
     segment::DeletedDocsPtr src_deleted_docs;
     segment_reader->LoadDeletedDocs(src_deleted_docs);
-
-    engine::SegmentPtr src_segment;
-    status = segment_reader->GetSegment(src_segment);
-    if (!status.ok()) {
-        return status;
+    if (src_deleted_docs) {
+        for (auto offset : src_deleted_docs->GetDeletedDocs()) {
+            if (offset >= 0 && offset < source.row_count_) {
+                source.deleted_.push_back(offset);
+            }
+        }
+        std::sort(source.deleted_.begin(), source.deleted_.end());
+        source.deleted_.erase(std::unique(source.deleted_.begin(), source.deleted_.end()), source.deleted_.end());
     }
+    source.begin_ = RowCount();
+    source.live_count_ = source.row_count_ - source.deleted_.size();
 
-    recorder.RecordSection("load data");
+    recorder.RecordSection("load deleted docs");
 
-    // the source segment may be used in search, we can't change its data, so copy a new segment for merging
-    engine::SegmentPtr duplicated_segment = std::make_shared<engine::Segment>();
-    src_segment->CopyOutRawData(duplicated_segment);
-    if (src_deleted_docs) {
-        std::vector<engine::offset_t> delete_ids = src_deleted_docs->GetDeletedDocs();
-        duplicated_segment->DeleteEntity(delete_ids);
+    // the uids are required by bloom filter and id index
+    if (merged_uids_ == nullptr) {
+        merged_uids_ = std::make_shared<engine::BinaryData>();
+    }
+    int64_t uid_batch = MergeBatchRows(source, sizeof(engine::idx_t));
+    for (int64_t live = 0; live < source.live_count_;) {
+        engine::BinaryDataPtr raw;
+        int64_t rows = std::min(uid_batch, source.live_count_ - live);
+        STATUS_CHECK(ReadLiveRows(source, engine::FIELD_UID, live, rows, raw));
+        merged_uids_->data_.insert(merged_uids_->data_.end(), raw->data_.begin(), raw->data_.end());
+        live += raw->Size() / sizeof(engine::idx_t);
     }
 
-    recorder.RecordSection("delete entities");
-
-    // convert to DataChunk
-    engine::DataChunkPtr chunk = std::make_shared<engine::DataChunk>();
-    duplicated_segment->ShareToChunkData(chunk);
+    recorder.RecordSection("load uids");
 
-    // do merge
-    status = AddChunk(chunk);
-    if (!status.ok()) {
-        return status;
-    }
+    merge_sources_.emplace_back(std::move(source));
 
     // clear cache of merged segment
     segment_reader->ClearCache();
@@ -289,8 +349,193 @@ SegmentWriter::Merge(const SegmentReaderPtr& segment_reader) {
     return Status::OK();
 }
 
+bool
+SegmentWriter::HasMergeableIndex(const MergeSource& source, const std::string& field_name,
+                                 engine::snapshot::ID_TYPE element_id) const {
+    auto field_visitor = source.reader_->GetSegmentVisitor()->GetFieldVisitor(field_name);
+    auto index_visitor =
+        field_visitor ? field_visitor->GetElementVisitor(engine::FieldElementType::FET_INDEX) : nullptr;
+    return index_visitor && index_visitor->GetFile() && index_visitor->GetElement()->GetID() == element_id;
+}
+
+int64_t
+SegmentWriter::MergeBatchRows(const MergeSource& source, int64_t field_width) const {
+    // a file of old version is read as a whole, since each ranged read has to verify the whole data
+    if (!source.ranged_) {
+        return std::max<int64_t>(source.row_count_, 1);
+    }
+    return std::max<int64_t>(merge_buffer_size_ / field_width, 1);
+}
+
+Status
+SegmentWriter::ReadLiveRows(const MergeSource& source, const std::string& field_name, int64_t live_begin,
+                            int64_t max_rows, engine::BinaryDataPtr& raw) {
+    int64_t width = 0;
+    STATUS_CHECK(segment_ptr_->GetFixedFieldWidth(field_name, width));
+
+    // deleted offset minus its index is the count of live rows before it, which is ascending,
+    // the live row is behind the deleted rows having no more than live_begin live rows before them
+    auto& deleted = source.deleted_;
+    int64_t low = 0, high = deleted.size();
+    while (low < high) {
+        int64_t mid = (low + high) / 2;
+        if (deleted[mid] - mid <= live_begin) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    int64_t begin = live_begin + low;
+    int64_t count = std::min(max_rows, source.row_count_ - begin);
+    if (live_begin < 0 || count <= 0) {
+        return Status(DB_ERROR, "Invalid live row offset to read");
+    }
+    STATUS_CHECK(source.reader_->LoadFieldRows(field_name, begin, count, raw));
+    if (raw == nullptr || raw->Size() != count * width) {
+        return Status(DB_ERROR, "Failed to read rows of field " + field_name);
+    }
+
+    // drop the deleted rows in place, the live rows between deleted rows are moved together
+    auto data = raw->data_.data();
+    int64_t target = 0, from = 0;
+    for (size_t i = low; from < count; ++i) {
+        int64_t to = (i < deleted.size()) ? std::min<int64_t>(deleted[i] - begin, count) : count;
+        if (to > from && target != from) {
+            memmove(data + target * width, data + from * width, (to - from) * width);
+        }
+        target += to - from;
+        from = to + 1;
+    }
+    raw->data_.resize(target * width);
+
+    return Status::OK();
+}
+
+Status
+SegmentWriter::WriteMergedField(const std::string& file_path, const std::string& field_name) {
+    int64_t width = 0;
+    STATUS_CHECK(segment_ptr_->GetFixedFieldWidth(field_name, width));
+
+    // the live rows of merged segments are appended to file piece by piece
+    size_t index = 0;
+    int64_t live = 0;
+    auto get_piece = [&](engine::BinaryDataPtr& piece) -> Status {
+        while (index < merge_sources_.size() && live >= merge_sources_[index].live_count_) {
+            ++index;
+            live = 0;
+        }
+        if (index >= merge_sources_.size()) {
+            return Status(DB_ERROR, "No more rows to merge for field " + field_name);
+        }
+
+        auto& source = merge_sources_[index];
+        int64_t rows = std::min(MergeBatchRows(source, width), source.live_count_ - live);
+        STATUS_CHECK(ReadLiveRows(source, field_name, live, rows, piece));
+        live += piece->Size() / width;
+        return Status::OK();
+    };
+
+    auto& ss_codec = codec::Codec::instance();
+    return ss_codec.GetBlockFormat()->Write(fs_ptr_, file_path, RowCount() * width, get_piece);
+}
+
+Status
+SegmentWriter::MergeVectorIndexes(std::vector<std::string>& field_names) {
+    field_names.clear();
+    auto& field_visitors_map = segment_visitor_->GetFieldVisitors();
+    for (auto& iter : field_visitors_map) {
+        const engine::snapshot::FieldPtr& field = iter.second->GetField();
+        auto index_visitor = iter.second->GetElementVisitor(engine::FieldElementType::FET_INDEX);
+        if (!engine::IsVectorField(field) || index_visitor == nullptr ||
+            !knowhere::merger::SupportMerge(index_visitor->GetElement()->GetTypeName())) {
+            continue;
+        }
+
+        auto& field_name = field->GetName();
+        auto element_id = index_visitor->GetElement()->GetID();
+
+        // map row offsets of merged segments to the new segment, deleted rows are mapped to -1
+        std::vector<knowhere::merger::IVFMergeSource> sources(merge_sources_.size());
+        for (size_t i = 0; i < merge_sources_.size(); ++i) {
+            auto& source = merge_sources_[i];
+            sources[i].indexed_ = HasMergeableIndex(source, field_name, element_id);
+            auto& offset_map = sources[i].offset_map_;
+            offset_map.resize(source.row_count_, 0);
+            for (auto offset : source.deleted_) {
+                offset_map[offset] = -1;
+            }
+            int64_t live_count = 0;
+            for (auto& offset : offset_map) {
+                if (offset >= 0) {
+                    offset = source.begin_ + live_count++;
+                }
+            }
+            sources[i].count_ = live_count;
+        }
+
+        // if no segment has index file, the merged segment is left for build index task,
+        // otherwise the rows of segments without index file are assigned to the lists of an indexed segment
+        if (std::none_of(sources.begin(), sources.end(),
+                         [](const knowhere::merger::IVFMergeSource& source) { return source.indexed_; })) {
+            continue;
+        }
+
+        // the indexes are loaded one at a time, and not kept by cache or segment reader
+        auto loader = [&](size_t i) -> knowhere::VecIndexPtr {
+            auto& reader = merge_sources_[i].reader_;
+            knowhere::VecIndexPtr index;
+            auto status = reader->LoadVectorIndex(field_name, index);
+            if (!status.ok()) {
+                throw Exception(status.code(), status.message());
+            }
+            reader->ClearIndexCache(field_name);
+            engine::SegmentPtr segment;
+            reader->GetSegment(segment);
+            segment->GetVectorIndice().erase(field_name);
+            return index;
+        };
+
+        // the vectors are read from the source segments batch by batch, like writing the merged field
+        auto field_type = static_cast<engine::DataType>(field->GetFtype());
+        auto vector_loader = [&](size_t i, int64_t live_begin, std::vector<float>& vectors) {
+            auto& source = merge_sources_[i];
+            int64_t width = 0;
+            engine::BinaryDataPtr raw;
+            auto status = segment_ptr_->GetFixedFieldWidth(field_name, width);
+            if (status.ok()) {
+                status = ReadLiveRows(source, field_name, live_begin, MergeBatchRows(source, width), raw);
+            }
+            if (status.ok() && engine::utils::IsHalfFloatVectorType(field_type)) {
+                status = engine::utils::DecodeHalfFloatVectors(field_type, raw, raw);
+            }
+            if (!status.ok()) {
+                throw Exception(status.code(), status.message());
+            }
+            auto data = reinterpret_cast<const float*>(raw->data_.data());
+            vectors.assign(data, data + raw->Size() / sizeof(float));
+        };
+
+        try {
+            TimeRecorder recorder("SegmentWriter::MergeVectorIndexes: " + field_name);
+            auto index = knowhere::merger::MergeIVF(sources, loader, vector_loader);
+            STATUS_CHECK(segment_ptr_->SetVectorIndex(field_name, index));
+            field_names.push_back(field_name);
+        } catch (std::exception& e) {
+            // not a fatal error, the index will be built by build index task
+            LOG_ENGINE_WARNING_ << "Failed to merge vector index of field " << field_name << ": " << e.what();
+        }
+    }
+
+    return Status::OK();
+}
+
 size_t
 SegmentWriter::RowCount() {
+    if (!merge_sources_.empty()) {
+        auto& last = merge_sources_.back();
+        return last.begin_ + last.live_count_;
+    }
     return segment_ptr_->GetRowCount();
 }
 
@@ -22,8 +22,10 @@
 #include <unordered_map>
 #include <vector>
 
+#include "db/Constants.h"
 #include "db/SnapshotVisitor.h"
 #include "db/Types.h"
+#include "knowhere/index/vector_index/helpers/IndexMerger.h"
 #include "segment/Segment.h"
 #include "segment/SegmentReader.h"
 #include "storage/FSHandler.h"
@@ -51,9 +53,22 @@ class SegmentWriter {
     Status
     Serialize();
 
+    // the raw data of merged segment is streamed into new files in Serialize(), only the uids are kept in memory
     Status
     Merge(const SegmentReaderPtr& segment_reader);
 
+    // the rows of one field read from a merged segment at a time are limited by the buffer size
+    void
+    SetMergeBufferSize(int64_t size) {
+        merge_buffer_size_ = size;
+    }
+
+    // merge the IVF indexes of merged segments into new indexes without training, only if all the segments are
+    // indexed with one quantizer. The fields whose index are merged are returned, other fields need to build index
+    // as usual
+    Status
+    MergeVectorIndexes(std::vector<std::string>& field_names);
+
     size_t
     RowCount();
 
@@ -88,6 +103,12 @@ class SegmentWriter {
         return segment_visitor_;
     }
 
+    // the visitor must point to the same segment, with more segment files
+    void
+    SetSegmentVisitor(const engine::SegmentVisitorPtr& segment_visitor) {
+        segment_visitor_ = segment_visitor;
+    }
+
  private:
     Status
     Initialize();
@@ -104,6 +125,34 @@ class SegmentWriter {
     Status
     WriteDeletedDocs();
 
+    Status
+    WriteIdIndex();
+
+    // a merged segment, its deleted rows are dropped while streaming
+    struct MergeSource {
+        SegmentReaderPtr reader_;
+        std::vector<engine::offset_t> deleted_;  // sorted offsets of deleted rows
+        int64_t row_count_ = 0;
+        int64_t begin_ = 0;  // merged row offset of the first live row
+        int64_t live_count_ = 0;
+        bool ranged_ = true;  // false if the files are written by old version and can't be read by ranges
+    };
+
+    bool
+    HasMergeableIndex(const MergeSource& source, const std::string& field_name,
+                      engine::snapshot::ID_TYPE element_id) const;
+
+    // read live rows of a merged segment from the live_begin-th live row, no more than max_rows rows
+    Status
+    ReadLiveRows(const MergeSource& source, const std::string& field_name, int64_t live_begin, int64_t max_rows,
+                 engine::BinaryDataPtr& raw);
+
+    Status
+    WriteMergedField(const std::string& file_path, const std::string& field_name);
+
+    int64_t
+    MergeBatchRows(const MergeSource& source, int64_t field_width) const;
+
  private:
     engine::SegmentVisitorPtr segment_visitor_;
     storage::FSHandlerPtr fs_ptr_;
@@ -111,6 +160,10 @@ class SegmentWriter {
 
     std::string dir_root_;
     std::string dir_collections_;
+
+    std::vector<MergeSource> merge_sources_;
+    engine::BinaryDataPtr merged_uids_;
+    int64_t merge_buffer_size_ = engine::DEFAULT_MERGE_BUFFER_SIZE;
 };
 
 using SegmentWriterPtr = std::shared_ptr<SegmentWriter>;
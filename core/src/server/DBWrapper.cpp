@@ -40,6 +40,7 @@ DBWrapper::StartService() {
 
     opt.auto_flush_interval_ = config.storage.auto_flush_interval();
     opt.insert_buffer_size_ = config.cache.insert_buffer_size();
+    opt.merge_buffer_size_ = config.cache.merge_buffer_size();
 
     if (not config.cluster.enable()) {
         opt.mode_ = engine::DBOptions::MODE::SINGLE;
@@ -32,7 +32,9 @@
 #include "server/web_impl/WebServer.h"
 #include "src/version.h"
 #include "value/config/ConfigMgr.h"
-//#include "storage/s3/S3ClientWrapper.h"
+#ifdef MILVUS_WITH_AWS
+#include "storage/s3/S3ClientWrapper.h"
+#endif
 #include <yaml-cpp/yaml.h>
 #include "tracing/TracerUtil.h"
 #include "utils/Log.h"
@@ -280,11 +282,13 @@ Server::StartService() {
     grpc::GrpcServer::GetInstance().Start();
     web::WebServer::GetInstance().Start();
 
-    // stat = storage::S3ClientWrapper::GetInstance().StartService();
-    // if (!stat.ok()) {
-    //     LOG_SERVER_ERROR_ << "S3Client start service fail: " << stat.message();
-    //     goto FAIL;
-    // }
+#ifdef MILVUS_WITH_AWS
+    stat = storage::S3ClientWrapper::GetInstance().StartService();
+    if (!stat.ok()) {
+        LOG_SERVER_ERROR_ << "S3Client start service fail: " << stat.message();
+        goto FAIL;
+    }
+#endif
 
     return Status::OK();
 FAIL:
@@ -311,7 +315,9 @@ Server::StopService() {
     // Note: if any request comning before GrpcServer::Stop() but DBWrapper has been stopped, the request will
     //   get error message "Milvus server is shutdown!"
 
-    // storage::S3ClientWrapper::GetInstance().StopService();
+#ifdef MILVUS_WITH_AWS
+    storage::S3ClientWrapper::GetInstance().StopService();
+#endif
     TimerManager::Stop();
 
     DBWrapper::GetInstance().StopService();
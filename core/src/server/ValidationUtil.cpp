@@ -191,6 +191,7 @@ ValidateVectorIndexType(std::string& index_type, bool is_binary) {
         knowhere::IndexEnum::INDEX_FAISS_IDMAP,
         knowhere::IndexEnum::INDEX_FAISS_IVFFLAT,
         knowhere::IndexEnum::INDEX_FAISS_IVFPQ,
+        knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN,
         knowhere::IndexEnum::INDEX_FAISS_IVFSQ8,
 #ifdef MILVUS_GPU_VERSION
         knowhere::IndexEnum::INDEX_FAISS_IVFSQ8H,
@@ -300,6 +301,24 @@ ValidateIndexParams(const milvus::json& index_params, int64_t dimension, const s
             LOG_SERVER_ERROR_ << msg;
             return Status(SERVER_INVALID_ARGUMENT, msg);
         }
+    } else if (index_type == knowhere::IndexEnum::INDEX_FAISS_IVFPQ_FASTSCAN) {
+        auto status = CheckParameterRange(index_params, knowhere::IndexParams::nlist, 1, 65536);
+        if (!status.ok()) {
+            return status;
+        }
+
+        status = CheckParameterExistence(index_params, knowhere::IndexParams::m);
+        if (!status.ok()) {
+            return status;
+        }
+
+        // the codes are always 4 bits, only 'm' needs the special check
+        int64_t m_value = index_params[knowhere::IndexParams::m];
+        if (!milvus::knowhere::IVFPQConfAdapter::CheckCPUPQParams(dimension, m_value)) {
+            std::string msg = "Invalid m, dimension cannot be divided by m ";
+            LOG_SERVER_ERROR_ << msg;
+            return Status(SERVER_INVALID_ARGUMENT, msg);
+        }
     } else if (index_type == knowhere::IndexEnum::INDEX_NSG) {
         auto status = CheckParameterRange(index_params, knowhere::IndexParams::search_length, 10, 300);
         if (!status.ok()) {
@@ -31,14 +31,18 @@ Context::SetTraceContext(const tracing::TraceContextPtr& trace_context) {
 std::shared_ptr<Context>
 Context::Child(const std::string& operation_name) const {
     auto new_context = std::make_shared<Context>(req_id_);
-    new_context->SetTraceContext(trace_context_->Child(operation_name));
+    if (trace_context_ != nullptr) {
+        new_context->SetTraceContext(trace_context_->Child(operation_name));
+    }
     return new_context;
 }
 
 std::shared_ptr<Context>
 Context::Follower(const std::string& operation_name) const {
     auto new_context = std::make_shared<Context>(req_id_);
-    new_context->SetTraceContext(trace_context_->Follower(operation_name));
+    if (trace_context_ != nullptr) {
+        new_context->SetTraceContext(trace_context_->Follower(operation_name));
+    }
     return new_context;
 }
 
@@ -80,7 +84,9 @@ ContextChild::~ContextChild() {
 void
 ContextChild::Finish() {
     if (context_) {
-        context_->GetTraceContext()->GetSpan()->Finish();
+        if (context_->GetTraceContext()) {
+            context_->GetTraceContext()->GetSpan()->Finish();
+        }
         context_ = nullptr;
     }
 }
@@ -93,7 +99,7 @@ ContextFollower::ContextFollower(const ContextPtr& context, const std::string& o
 }
 
 ContextFollower::~ContextFollower() {
-    if (context_) {
+    if (context_ && context_->GetTraceContext()) {
         context_->GetTraceContext()->GetSpan()->Finish();
     }
 }
@@ -101,7 +107,9 @@ ContextFollower::~ContextFollower() {
 void
 ContextFollower::Finish() {
     if (context_) {
-        context_->GetTraceContext()->GetSpan()->Finish();
+        if (context_->GetTraceContext()) {
+            context_->GetTraceContext()->GetSpan()->Finish();
+        }
         context_ = nullptr;
     }
 }
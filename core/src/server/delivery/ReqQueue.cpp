@@ -16,6 +16,7 @@
 
 #include <fiu/fiu-local.h>
 #include <unistd.h>
+#include <chrono>
 #include <queue>
 #include <utility>
 
@@ -55,6 +56,9 @@ ReqQueue::TakeReq() {
 
 Status
 ReqQueue::PutReq(const BaseReqPtr& req_ptr) {
+    if (req_ptr != nullptr) {
+        req_ptr->SetEnqueueTime(std::chrono::steady_clock::now());
+    }
     std::unique_lock<std::mutex> lock(mtx);
     full_.wait(lock, [this] { return (queue_.size() < capacity_); });
     auto status = ScheduleReq(req_ptr, queue_);
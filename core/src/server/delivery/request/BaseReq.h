@@ -15,6 +15,7 @@
 #include "server/delivery/request/Types.h"
 #include "utils/Status.h"
 
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <string>
@@ -74,6 +75,17 @@ class BaseReq {
     void
     SetStatus(const Status& status);
 
+    // time the request is put into the request queue
+    void
+    SetEnqueueTime(const std::chrono::steady_clock::time_point& time) {
+        enqueue_time_ = time;
+    }
+
+    const std::chrono::steady_clock::time_point&
+    enqueue_time() const {
+        return enqueue_time_;
+    }
+
  protected:
     virtual Status
     OnPreExecute();
@@ -90,6 +102,7 @@ class BaseReq {
     std::string req_group_;
     bool async_;
     Status status_;
+    std::chrono::steady_clock::time_point enqueue_time_ = std::chrono::steady_clock::now();
 
  private:
     mutable std::mutex finish_mtx_;
@@ -97,16 +97,12 @@ CreateCollectionReq::OnExecute() {
             }
 
             // validate vector field dimension
-            if (field_type == engine::DataType::VECTOR_FLOAT || field_type == engine::DataType::VECTOR_BINARY) {
+            if (engine::utils::IsVectorType(field_type)) {
                 if (!field_params.contains(engine::PARAM_DIMENSION)) {
                     return Status(SERVER_INVALID_VECTOR_DIMENSION, "Dimension not defined in field_params");
                 } else {
                     auto dim = field_params[engine::PARAM_DIMENSION].get<int64_t>();
-                    if (field_type == engine::DataType::VECTOR_FLOAT) {
-                        STATUS_CHECK(ValidateDimension(dim, false));
-                    } else {
-                        STATUS_CHECK(ValidateDimension(dim, true));
-                    }
+                    STATUS_CHECK(ValidateDimension(dim, engine::utils::IsBinaryVectorType(field_type)));
                 }
             }
 
@@ -0,0 +1,262 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "server/delivery/request/SearchCombineReq.h"
+#include "server/DBWrapper.h"
+#include "utils/Log.h"
+#include "utils/TimeRecorder.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace milvus {
+namespace server {
+
+namespace {
+
+int64_t
+GetQueryNq(const SearchReqPtr& req) {
+    auto& query_ptr = req->query_ptr();
+    if (query_ptr == nullptr || query_ptr->vectors.empty() || query_ptr->vectors.begin()->second == nullptr) {
+        return 0;
+    }
+    return query_ptr->vectors.begin()->second->query_vector.vector_count;
+}
+
+bool
+IsSameGeneralQuery(const query::GeneralQueryPtr& left, const query::GeneralQueryPtr& right) {
+    if (left == right) {
+        return true;
+    }
+    if (left == nullptr || right == nullptr) {
+        return false;
+    }
+
+    // a node is either a leaf or a binary query
+    if ((left->leaf == nullptr) != (right->leaf == nullptr)) {
+        return false;
+    }
+    if (left->leaf != nullptr) {
+        auto& l_leaf = left->leaf;
+        auto& r_leaf = right->leaf;
+        if (l_leaf->vector_placeholder != r_leaf->vector_placeholder || l_leaf->query_boost != r_leaf->query_boost) {
+            return false;
+        }
+        if ((l_leaf->term_query == nullptr) != (r_leaf->term_query == nullptr) ||
+            (l_leaf->term_query && l_leaf->term_query->json_obj != r_leaf->term_query->json_obj)) {
+            return false;
+        }
+        if ((l_leaf->range_query == nullptr) != (r_leaf->range_query == nullptr) ||
+            (l_leaf->range_query && l_leaf->range_query->json_obj != r_leaf->range_query->json_obj)) {
+            return false;
+        }
+        return true;
+    }
+
+    auto& l_bin = left->bin;
+    auto& r_bin = right->bin;
+    if (l_bin == nullptr || r_bin == nullptr) {
+        return l_bin == r_bin;
+    }
+    return l_bin->relation == r_bin->relation && l_bin->is_not == r_bin->is_not &&
+           l_bin->query_boost == r_bin->query_boost && IsSameGeneralQuery(l_bin->left_query, r_bin->left_query) &&
+           IsSameGeneralQuery(l_bin->right_query, r_bin->right_query);
+}
+
+bool
+IsSameVectorQuery(const query::VectorQueryPtr& left, const query::VectorQueryPtr& right) {
+    if (left == nullptr || right == nullptr) {
+        return false;
+    }
+
+    return left->field_name == right->field_name && left->topk == right->topk &&
+           left->metric_type == right->metric_type && left->boost == right->boost &&
+           left->extra_params == right->extra_params &&
+           left->query_vector.float_data.empty() == right->query_vector.float_data.empty() &&
+           left->query_vector.binary_data.empty() == right->query_vector.binary_data.empty();
+}
+
+// the combined query belongs to no single request, it runs under its own context
+ContextPtr
+CreateCombinedContext(const std::vector<SearchReqPtr>& requests) {
+    std::string req_id = "combined";
+    for (auto& req : requests) {
+        if (req->context() != nullptr) {
+            req_id += "-" + req->context()->ReqID();
+        }
+    }
+    auto context = std::make_shared<Context>(req_id);
+    context->SetReqType(ReqType::kSearch);
+    return context;
+}
+
+}  // namespace
+
+SearchCombineReq::SearchCombineReq(const SearchReqPtr& req, int64_t max_nq)
+    : BaseReq(nullptr, ReqType::kSearch), max_nq_(max_nq) {
+    requests_.push_back(req);
+    total_nq_ = GetQueryNq(req);
+}
+
+SearchCombineReqPtr
+SearchCombineReq::Create(const SearchReqPtr& req, int64_t max_nq) {
+    return std::shared_ptr<SearchCombineReq>(new SearchCombineReq(req, max_nq));
+}
+
+bool
+SearchCombineReq::CanCombine(const SearchReqPtr& req) {
+    if (req == nullptr || total_nq_ + GetQueryNq(req) > max_nq_) {
+        return false;
+    }
+    return CanCombine(requests_.front(), req);
+}
+
+bool
+SearchCombineReq::CanCombine(const SearchReqPtr& left, const SearchReqPtr& right) {
+    if (left == nullptr || right == nullptr) {
+        return false;
+    }
+
+    auto& l_query = left->query_ptr();
+    auto& r_query = right->query_ptr();
+    if (l_query == nullptr || r_query == nullptr) {
+        return false;
+    }
+
+    // output fields are fetched by result ids, such requests are not combined
+    if (left->json_params() != right->json_params() || left->json_params().contains("fields")) {
+        return false;
+    }
+
+    if (l_query->collection_id != r_query->collection_id || l_query->partitions != r_query->partitions ||
+        l_query->field_names != r_query->field_names || l_query->index_fields != r_query->index_fields ||
+        l_query->metric_types != r_query->metric_types || l_query->index_type != r_query->index_type) {
+        return false;
+    }
+
+    if (l_query->vectors.size() != 1 || r_query->vectors.size() != 1 ||
+        l_query->vectors.begin()->first != r_query->vectors.begin()->first ||
+        !IsSameVectorQuery(l_query->vectors.begin()->second, r_query->vectors.begin()->second)) {
+        return false;
+    }
+
+    return IsSameGeneralQuery(l_query->root, r_query->root);
+}
+
+void
+SearchCombineReq::Combine(const SearchReqPtr& req) {
+    requests_.push_back(req);
+    total_nq_ += GetQueryNq(req);
+}
+
+Status
+SearchCombineReq::OnExecute() {
+    std::string hdr = "SearchCombineReq(collection=" + requests_.front()->query_ptr()->collection_id +
+                      ", requests=" + std::to_string(requests_.size()) + ", nq=" + std::to_string(total_nq_) + ")";
+    LOG_SERVER_DEBUG_ << hdr << " begin";
+    TimeRecorderAuto rc(hdr);
+
+    // each request waited in the queue since it was put, not since the combined request was created
+    for (auto& req : requests_) {
+        req->ObserveQueueTime();
+    }
+
+    std::vector<SearchReqPtr> valid_requests;
+    size_t validated = 0;
+    bool finished = false;
+    try {
+        // the invalid requests are finished with their own error
+        for (; validated < requests_.size(); ++validated) {
+            auto& req = requests_[validated];
+            auto status = req->Validate();
+            if (status.ok()) {
+                valid_requests.push_back(req);
+            } else {
+                FinishRequests({req}, status);
+            }
+        }
+        if (valid_requests.empty()) {
+            return Status::OK();
+        }
+
+        // concatenate query vectors into one query
+        auto& first_query = valid_requests.front()->query_ptr();
+        auto query_ptr = std::make_shared<query::Query>(*first_query);
+        auto placeholder = first_query->vectors.begin()->first;
+        auto vector_query = std::make_shared<query::VectorQuery>(*first_query->vectors.begin()->second);
+        vector_query->query_vector = query::VectorRecord();
+        for (auto& req : valid_requests) {
+            auto& record = req->query_ptr()->vectors.begin()->second->query_vector;
+            auto& combined = vector_query->query_vector;
+            combined.vector_count += record.vector_count;
+            combined.float_data.insert(combined.float_data.end(), record.float_data.begin(), record.float_data.end());
+            combined.binary_data.insert(combined.binary_data.end(), record.binary_data.begin(),
+                                        record.binary_data.end());
+        }
+        query_ptr->vectors.clear();
+        query_ptr->vectors.insert(std::make_pair(placeholder, vector_query));
+        rc.RecordSection("combine queries");
+
+        // each request traces the combined query in its own span
+        std::vector<std::shared_ptr<ContextChild>> tracers;
+        for (auto& req : valid_requests) {
+            tracers.emplace_back(std::make_shared<ContextChild>(req->context(), hdr));
+        }
+        auto result = std::make_shared<engine::QueryResult>();
+        auto status = DBWrapper::DB()->Query(CreateCombinedContext(valid_requests), query_ptr, result);
+        tracers.clear();
+        if (!status.ok()) {
+            FinishRequests(valid_requests, status);
+            finished = true;
+            return status;
+        }
+
+        // split result, each query has topk items
+        size_t total_count = vector_query->query_vector.vector_count;
+        size_t topk = (total_count > 0) ? result->result_ids_.size() / total_count : 0;
+        size_t offset = 0;
+        for (auto& req : valid_requests) {
+            auto& req_result = req->result();
+            size_t count = req->query_ptr()->vectors.begin()->second->query_vector.vector_count;
+            req_result->row_num_ = count;
+            req_result->result_ids_.assign(result->result_ids_.begin() + offset * topk,
+                                           result->result_ids_.begin() + (offset + count) * topk);
+            req_result->result_distances_.assign(result->result_distances_.begin() + offset * topk,
+                                                 result->result_distances_.begin() + (offset + count) * topk);
+            offset += count;
+        }
+        FinishRequests(valid_requests, Status::OK());
+        finished = true;
+        rc.RecordSection("split result");
+    } catch (std::exception& ex) {
+        Status status(SERVER_UNEXPECTED_ERROR, ex.what());
+        if (!finished) {
+            FinishRequests(valid_requests, status);
+            FinishRequests(std::vector<SearchReqPtr>(requests_.begin() + validated, requests_.end()), status);
+        }
+        return status;
+    }
+
+    return Status::OK();
+}
+
+void
+SearchCombineReq::FinishRequests(const std::vector<SearchReqPtr>& requests, const Status& status) {
+    for (auto& req : requests) {
+        req->SetStatus(status);
+        req->Done();
+    }
+}
+
+}  // namespace server
+}  // namespace milvus
@@ -0,0 +1,60 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "server/delivery/request/BaseReq.h"
+#include "server/delivery/request/SearchReq.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace milvus {
+namespace server {
+
+// several queued search requests with same collection, partitions, query and params are executed as one query,
+// the query vectors are concatenated and the result is split back to each request
+class SearchCombineReq : public BaseReq {
+ public:
+    static std::shared_ptr<SearchCombineReq>
+    Create(const SearchReqPtr& req, int64_t max_nq);
+
+    // check whether the request could be combined, the total nq can't exceed max_nq
+    bool
+    CanCombine(const SearchReqPtr& req);
+
+    static bool
+    CanCombine(const SearchReqPtr& left, const SearchReqPtr& right);
+
+    void
+    Combine(const SearchReqPtr& req);
+
+ protected:
+    SearchCombineReq(const SearchReqPtr& req, int64_t max_nq);
+
+    Status
+    OnExecute() override;
+
+ private:
+    void
+    FinishRequests(const std::vector<SearchReqPtr>& requests, const Status& status);
+
+ private:
+    std::vector<SearchReqPtr> requests_;
+    int64_t max_nq_ = 0;
+    int64_t total_nq_ = 0;
+};
+
+using SearchCombineReqPtr = std::shared_ptr<SearchCombineReq>;
+
+}  // namespace server
+}  // namespace milvus
@@ -12,6 +12,7 @@
 #include "server/delivery/request/SearchReq.h"
 #include "db/SnapshotUtils.h"
 #include "db/Utils.h"
+#include "metrics/SearchMetrics.h"
 #include "server/DBWrapper.h"
 #include "server/ValidationUtil.h"
 #include "utils/CommonUtil.h"
@@ -19,6 +20,7 @@
 #include "utils/TimeRecorder.h"
 
 #include <fiu/fiu-local.h>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -47,104 +49,118 @@ SearchReq::Create(const ContextPtr& context, const query::QueryPtr& query_ptr, c
 }
 
 Status
-SearchReq::OnExecute() {
-    try {
-        fiu_do_on("SearchReq.OnExecute.throw_std_exception", throw std::exception());
-        std::string hdr = "SearchReq(collection=" + query_ptr_->collection_id + ")";
-        LOG_SERVER_DEBUG_ << hdr << " begin";
-        TimeRecorderAuto rc(hdr);
-
-        STATUS_CHECK(ValidateCollectionName(query_ptr_->collection_id));
-        STATUS_CHECK(ValidatePartitionTags(query_ptr_->partitions, false));
+SearchReq::Validate() {
+    STATUS_CHECK(ValidateCollectionName(query_ptr_->collection_id));
+    STATUS_CHECK(ValidatePartitionTags(query_ptr_->partitions, false));
+
+    // step 2: check table existence
+    // only process root table, ignore partition table
+    engine::snapshot::CollectionPtr collection;
+    engine::snapshot::FieldElementMappings fields_schema;
+    auto status = DBWrapper::DB()->GetCollectionInfo(query_ptr_->collection_id, collection, fields_schema);
+    fiu_do_on("SearchReq.OnExecute.describe_table_fail", status = Status(milvus::SERVER_UNEXPECTED_ERROR, ""));
+    if (!status.ok()) {
+        if (status.code() == DB_NOT_FOUND) {
+            return Status(SERVER_COLLECTION_NOT_EXIST, "Collection not exist: " + query_ptr_->collection_id);
+        } else {
+            return status;
+        }
+    }
 
-        // step 2: check table existence
-        // only process root table, ignore partition table
-        engine::snapshot::CollectionPtr collection;
-        engine::snapshot::FieldElementMappings fields_schema;
-        auto status = DBWrapper::DB()->GetCollectionInfo(query_ptr_->collection_id, collection, fields_schema);
-        fiu_do_on("SearchReq.OnExecute.describe_table_fail", status = Status(milvus::SERVER_UNEXPECTED_ERROR, ""));
-        if (!status.ok()) {
-            if (status.code() == DB_NOT_FOUND) {
-                return Status(SERVER_COLLECTION_NOT_EXIST, "Collection not exist: " + query_ptr_->collection_id);
-            } else {
-                return status;
+    // step 4: Get field info
+    std::unordered_map<std::string, engine::DataType> field_types;
+    for (auto& schema : fields_schema) {
+        auto field = schema.first;
+        field_types.insert(std::make_pair(field->GetName(), field->GetFtype()));
+        if (engine::IsVectorField(field)) {
+            // check dim
+            int64_t dimension = field->GetParams()[engine::PARAM_DIMENSION];
+            auto vector_query = query_ptr_->vectors.begin()->second;
+            if (vector_query->field_name != field->GetName()) {
+                return Status(SERVER_INVALID_ARGUMENT,
+                              "DSL vector query field name: " + vector_query->field_name + " is wrong");
             }
-        }
 
-        // step 4: Get field info
-        std::unordered_map<std::string, engine::DataType> field_types;
-        for (auto& schema : fields_schema) {
-            auto field = schema.first;
-            field_types.insert(std::make_pair(field->GetName(), field->GetFtype()));
-            if (field->GetFtype() == engine::DataType::VECTOR_FLOAT ||
-                field->GetFtype() == engine::DataType::VECTOR_BINARY) {
-                // check dim
-                int64_t dimension = field->GetParams()[engine::PARAM_DIMENSION];
-                auto vector_query = query_ptr_->vectors.begin()->second;
-                if (vector_query->field_name != field->GetName()) {
-                    return Status(SERVER_INVALID_ARGUMENT,
-                                  "DSL vector query field name: " + vector_query->field_name + " is wrong");
+            if (!vector_query->query_vector.binary_data.empty()) {
+                if (vector_query->query_vector.binary_data.size() !=
+                    vector_query->query_vector.vector_count * dimension / 8) {
+                    return Status(SERVER_INVALID_ARGUMENT, "query vector dim not match");
                 }
-
-                if (!vector_query->query_vector.binary_data.empty()) {
-                    if (vector_query->query_vector.binary_data.size() !=
-                        vector_query->query_vector.vector_count * dimension / 8) {
-                        return Status(SERVER_INVALID_ARGUMENT, "query vector dim not match");
-                    }
-                } else if (!vector_query->query_vector.float_data.empty()) {
-                    if (vector_query->query_vector.float_data.size() !=
-                        vector_query->query_vector.vector_count * dimension) {
-                        return Status(SERVER_INVALID_ARGUMENT, "query vector dim not match");
-                    }
+            } else if (!vector_query->query_vector.float_data.empty()) {
+                if (vector_query->query_vector.float_data.size() !=
+                    vector_query->query_vector.vector_count * dimension) {
+                    return Status(SERVER_INVALID_ARGUMENT, "query vector dim not match");
                 }
+            }
 
-                // validate search metric type and DataType match
-                bool is_binary = (field->GetFtype() != engine::DataType::VECTOR_FLOAT);
-                if (query_ptr_->metric_types.find(field->GetName()) != query_ptr_->metric_types.end()) {
-                    auto metric_type = query_ptr_->metric_types.at(field->GetName());
-                    STATUS_CHECK(ValidateSearchMetricType(metric_type, is_binary));
-                }
+            // validate search metric type and DataType match
+            bool is_binary = engine::IsBinaryVectorField(field);
+            if (query_ptr_->metric_types.find(field->GetName()) != query_ptr_->metric_types.end()) {
+                auto metric_type = query_ptr_->metric_types.at(field->GetName());
+                STATUS_CHECK(ValidateSearchMetricType(metric_type, is_binary));
+            }
 
-                // check index type
-                engine::CollectionIndex index;
-                status = DBWrapper::DB()->DescribeIndex(query_ptr_->collection_id, field->GetName(), index);
-                if (!index.index_type_.empty()) {
-                    if (engine::IsVectorField(field)) {
-                        STATUS_CHECK(ValidateVectorIndexType(index.index_type_, engine::IsBinaryVectorField(field)));
-                    } else {
-                        STATUS_CHECK(ValidateStructuredIndexType(index.index_type_));
-                    }
+            // check index type
+            engine::CollectionIndex index;
+            status = DBWrapper::DB()->DescribeIndex(query_ptr_->collection_id, field->GetName(), index);
+            if (!index.index_type_.empty()) {
+                if (engine::IsVectorField(field)) {
+                    STATUS_CHECK(ValidateVectorIndexType(index.index_type_, engine::IsBinaryVectorField(field)));
+                } else {
+                    STATUS_CHECK(ValidateStructuredIndexType(index.index_type_));
                 }
             }
         }
+    }
 
-        // step 5: check field names
-        if (json_params_.contains("fields")) {
-            if (json_params_["fields"].is_array()) {
-                for (auto& name : json_params_["fields"]) {
-                    std::string valid_name = name.get<std::string>();
-                    status = ValidateFieldName(valid_name);
-                    if (!status.ok()) {
-                        return status;
-                    }
-                    bool find_field_name = false;
-                    for (const auto& schema : fields_schema) {
-                        if (valid_name == schema.first->GetName()) {
-                            find_field_name = true;
-                            field_mappings_.insert(schema);
-                            break;
-                        }
-                    }
-                    if (not find_field_name) {
-                        return Status{SERVER_INVALID_FIELD_NAME, "Field: " + valid_name + " not exist"};
+    // step 5: check field names
+    if (json_params_.contains("fields")) {
+        if (json_params_["fields"].is_array()) {
+            for (auto& name : json_params_["fields"]) {
+                std::string valid_name = name.get<std::string>();
+                status = ValidateFieldName(valid_name);
+                if (!status.ok()) {
+                    return status;
+                }
+                bool find_field_name = false;
+                for (const auto& schema : fields_schema) {
+                    if (valid_name == schema.first->GetName()) {
+                        find_field_name = true;
+                        field_mappings_.insert(schema);
+                        break;
                     }
-                    query_ptr_->field_names.emplace_back(valid_name);
                 }
+                if (not find_field_name) {
+                    return Status{SERVER_INVALID_FIELD_NAME, "Field: " + valid_name + " not exist"};
+                }
+                query_ptr_->field_names.emplace_back(valid_name);
             }
         }
+    }
+
+    return Status::OK();
+}
+
+void
+SearchReq::ObserveQueueTime() {
+    auto wait_time = std::chrono::steady_clock::now() - enqueue_time();
+    SearchMetrics::GetInstance().Observe(SearchStage::REQUEST_QUEUE, query_ptr_->collection_id, "",
+                                         std::chrono::duration_cast<std::chrono::microseconds>(wait_time).count());
+}
+
+Status
+SearchReq::OnExecute() {
+    ObserveQueueTime();
+    try {
+        fiu_do_on("SearchReq.OnExecute.throw_std_exception", throw std::exception());
+        std::string hdr = "SearchReq(collection=" + query_ptr_->collection_id + ")";
+        LOG_SERVER_DEBUG_ << hdr << " begin";
+        TimeRecorderAuto rc(hdr);
+
+        STATUS_CHECK(Validate());
 
         result_->row_num_ = 0;
-        status = DBWrapper::DB()->Query(context_, query_ptr_, result_);
+        auto status = DBWrapper::DB()->Query(context_, query_ptr_, result_);
 
 #ifdef ENABLE_CPU_PROFILING
         ProfilerStop();
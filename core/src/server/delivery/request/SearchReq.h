@@ -28,6 +28,29 @@ class SearchReq : public BaseReq {
     Create(const ContextPtr& context, const query::QueryPtr& query_ptr, const milvus::json& json_params,
            engine::snapshot::FieldElementMappings& collection_mappings, engine::QueryResultPtr& result);
 
+    // check collection, vector dimension, metric type and output fields of the query
+    Status
+    Validate();
+
+    // observe the time the request waited in the request queue
+    void
+    ObserveQueueTime();
+
+    const query::QueryPtr&
+    query_ptr() const {
+        return query_ptr_;
+    }
+
+    const milvus::json&
+    json_params() const {
+        return json_params_;
+    }
+
+    engine::QueryResultPtr&
+    result() {
+        return result_;
+    }
+
  protected:
     SearchReq(const ContextPtr& context, const query::QueryPtr& query_ptr, const milvus::json& json_params,
               engine::snapshot::FieldElementMappings& collection_mappings, engine::QueryResultPtr& result);
@@ -42,5 +65,7 @@ class SearchReq : public BaseReq {
     engine::QueryResultPtr& result_;
 };
 
+using SearchReqPtr = std::shared_ptr<SearchReq>;
+
 }  // namespace server
 }  // namespace milvus
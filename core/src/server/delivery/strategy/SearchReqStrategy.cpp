@@ -10,6 +10,7 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include "server/delivery/strategy/SearchReqStrategy.h"
+#include "server/delivery/request/SearchCombineReq.h"
 #include "utils/CommonUtil.h"
 #include "utils/Error.h"
 #include "utils/Log.h"
@@ -23,6 +24,7 @@ namespace milvus {
 namespace server {
 
 SearchReqStrategy::SearchReqStrategy() {
+    search_combine_nq_ = config.engine.search_combine_nq();
     ConfigMgr::GetInstance().Attach("engine.search_combine_nq", this);
 }
 
@@ -38,6 +40,30 @@ SearchReqStrategy::ReScheduleQueue(const BaseReqPtr& req, std::queue<BaseReqPtr>
         return Status(SERVER_UNSUPPORTED_ERROR, msg);
     }
 
+    // the request waiting at queue tail is combined with the new one, so that concurrent small queries are
+    // executed as one query and traverse segments only once
+    auto search_req = std::dynamic_pointer_cast<SearchReq>(req);
+    if (search_combine_nq_ > 0 && search_req != nullptr && !queue.empty()) {
+        BaseReqPtr& last_req = queue.back();
+        auto combine_req = std::dynamic_pointer_cast<SearchCombineReq>(last_req);
+        if (combine_req != nullptr) {
+            if (combine_req->CanCombine(search_req)) {
+                combine_req->Combine(search_req);
+                return Status::OK();
+            }
+        } else {
+            auto last_search_req = std::dynamic_pointer_cast<SearchReq>(last_req);
+            if (SearchCombineReq::CanCombine(last_search_req, search_req)) {
+                combine_req = SearchCombineReq::Create(last_search_req, search_combine_nq_);
+                if (combine_req->CanCombine(search_req)) {
+                    combine_req->Combine(search_req);
+                    last_req = combine_req;
+                    return Status::OK();
+                }
+            }
+        }
+    }
+
     queue.push(req);
 
     return Status::OK();
@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "db/Utils.h"
 #include "query/QueryUtil.h"
 #include "server/ValidationUtil.h"
 #include "server/context/ConnectionContext.h"
@@ -302,8 +303,8 @@ CopyDataChunkToEntity(const engine::DataChunkPtr& data_chunk,
                 memcpy(vector_row_record->mutable_binary_data()->data(), binary_vector.data(), binary_vector.size());
             }
 
-        } else if (type == engine::DataType::VECTOR_FLOAT) {
-            // add float vector data
+        } else if (type == engine::DataType::VECTOR_FLOAT || engine::utils::IsHalfFloatVectorType(type)) {
+            // add float vector data, half float vectors are already converted to float
             std::vector<float> float_vector;
             auto vector_size = single_size * sizeof(int8_t) / sizeof(float);
             float_vector.resize(vector_size);
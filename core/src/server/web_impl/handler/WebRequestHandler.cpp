@@ -259,7 +259,9 @@ WebRequestHandler::CopyData2Json(const milvus::engine::DataChunkPtr& data_chunk,
                     entity_json[name] = binary_vector;
                     break;
                 }
-                case engine::DataType::VECTOR_FLOAT: {
+                case engine::DataType::VECTOR_FLOAT:
+                case engine::DataType::VECTOR_FLOAT16:
+                case engine::DataType::VECTOR_BFLOAT16: {
                     std::vector<float> float_vector;
                     auto dim = (data->data_.size() * sizeof(int8_t) / sizeof(float)) / id_size;
                     float_vector.resize(dim);
@@ -661,7 +663,8 @@ WebRequestHandler::ProcessLeafQueryJson(const nlohmann::json& json, milvus::quer
             vector_query->query_vector.vector_count = values.size();
             for (auto& vector_records : values) {
                 if (field_type_.find(vector_name) != field_type_.end()) {
-                    if (field_type_.at(vector_name) == engine::DataType::VECTOR_FLOAT) {
+                    if (field_type_.at(vector_name) == engine::DataType::VECTOR_FLOAT ||
+                        engine::utils::IsHalfFloatVectorType(field_type_.at(vector_name))) {
                         for (auto& data : vector_records) {
                             vector_query->query_vector.float_data.emplace_back(data.get<float>());
                         }
@@ -872,7 +875,9 @@ WebRequestHandler::Search(const std::string& collection_name, const nlohmann::js
                             one_entity_json[field_name] = double_value;
                             break;
                         }
-                        case engine::DataType::VECTOR_FLOAT: {
+                        case engine::DataType::VECTOR_FLOAT:
+                        case engine::DataType::VECTOR_FLOAT16:
+                        case engine::DataType::VECTOR_BFLOAT16: {
                             std::vector<float> float_vector;
                             auto dim =
                                 field_data.at(field_name)->data_.size() / (result->result_ids_.size() * sizeof(float));
@@ -1689,8 +1694,10 @@ WebRequestHandler::InsertEntity(const OString& collection_name, const milvus::se
                     break;
                 }
                 case engine::DataType::VECTOR_FLOAT:
+                case engine::DataType::VECTOR_FLOAT16:
+                case engine::DataType::VECTOR_BFLOAT16:
                 case engine::DataType::VECTOR_BINARY: {
-                    bool is_bin = !(field_types.at(field_name) == engine::DataType::VECTOR_FLOAT);
+                    bool is_bin = engine::utils::IsBinaryVectorType(field_types.at(field_name));
                     CopyRowVectorFromJson(entity.value(), field_name, offset, row_num, is_bin, chunk_data);
                     break;
                 }
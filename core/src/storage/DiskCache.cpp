@@ -0,0 +1,325 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "storage/DiskCache.h"
+
+#include <crc32c/crc32c.h>
+#include <fiu/fiu-local.h>
+
+#include <algorithm>
+#include <cstring>
+#include <experimental/filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "log/Log.h"
+#include "utils/Error.h"
+
+namespace milvus {
+namespace storage {
+
+namespace {
+
+namespace fs = std::experimental::filesystem;
+
+constexpr const char* META_SUFFIX = ".meta";
+constexpr const char* TEMP_SUFFIX = ".tmp";
+constexpr int64_t CHECKSUM_BUFFER_SIZE = 1024 * 1024;
+
+// a file written by the codecs starts with the magic bytes and ends with the crc32c sum of all bytes before it
+constexpr const char* CODEC_MAGIC = "Milvus";
+constexpr int64_t CODEC_MAGIC_SIZE = 6;
+constexpr int64_t CODEC_SUM_SIZE = sizeof(uint32_t);
+
+bool
+EndsWith(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void
+RemoveFile(const std::string& file_path) {
+    std::error_code ec;
+    fs::remove(file_path, ec);
+}
+
+Status
+WriteMeta(const std::string& file_path, const std::string& key, int64_t size) {
+    std::ofstream meta(file_path + META_SUFFIX, std::ios::trunc);
+    meta << key << std::endl << size << std::endl;
+    meta.close();
+    if (!meta.good()) {
+        return Status(SERVER_CANNOT_CREATE_FILE, "Failed to write cache meta: " + file_path + META_SUFFIX);
+    }
+    return Status::OK();
+}
+
+bool
+ReadMeta(const std::string& meta_path, std::string& key, int64_t& size) {
+    std::ifstream meta(meta_path);
+    std::getline(meta, key);
+    meta >> size;
+    return !meta.fail() && !key.empty();
+}
+
+}  // namespace
+
+DiskCache::DiskCache(const std::string& cache_path, int64_t capacity) : cache_path_(cache_path), capacity_(capacity) {
+}
+
+Status
+DiskCache::Load() {
+    // key, file path, size, last write time of the files to reuse
+    std::vector<std::tuple<std::string, std::string, int64_t, fs::file_time_type>> reused;
+    try {
+        fs::create_directories(cache_path_);
+
+        std::vector<std::string> data_files;
+        for (auto& entry : fs::directory_iterator(cache_path_)) {
+            std::string path = entry.path().string();
+            if (EndsWith(path, TEMP_SUFFIX)) {
+                RemoveFile(path);  // left by an interrupted fetch
+            } else if (!EndsWith(path, META_SUFFIX)) {
+                data_files.push_back(path);
+            }
+        }
+
+        // the files are not read here, their checksum is verified on first use
+        for (auto& data_path : data_files) {
+            std::string key;
+            int64_t size = 0;
+            std::error_code ec;
+            auto real_size = fs::file_size(data_path, ec);
+            if (!ec && ReadMeta(data_path + META_SUFFIX, key, size) && FilePath(key) == data_path &&
+                static_cast<int64_t>(real_size) == size) {
+                reused.emplace_back(key, data_path, size, fs::last_write_time(data_path));
+                continue;
+            }
+            LOG_STORAGE_WARNING_ << "Remove invalid cache file: " << data_path;
+            RemoveFile(data_path);
+            RemoveFile(data_path + META_SUFFIX);
+        }
+
+        // meta files without data file
+        for (auto& entry : fs::directory_iterator(cache_path_)) {
+            std::string path = entry.path().string();
+            if (EndsWith(path, META_SUFFIX) && !fs::exists(path.substr(0, path.size() - strlen(META_SUFFIX)))) {
+                RemoveFile(path);
+            }
+        }
+    } catch (std::exception& ex) {
+        std::string msg = "Failed to load disk cache " + cache_path_ + ": " + ex.what();
+        LOG_STORAGE_ERROR_ << msg;
+        return Status(SERVER_UNEXPECTED_ERROR, msg);
+    }
+
+    // the latest written file is the most recently used
+    std::sort(reused.begin(), reused.end(),
+              [](const auto& a, const auto& b) { return std::get<3>(a) < std::get<3>(b); });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : reused) {
+        Admit(std::get<0>(item), std::get<1>(item), std::get<2>(item), false);
+    }
+    Evict("");
+
+    LOG_STORAGE_INFO_ << "Disk cache " << cache_path_ << " reuses " << items_.size() << " files, " << size_
+                      << " bytes";
+    return Status::OK();
+}
+
+Status
+DiskCache::Get(const std::string& key, const FetchFunc& fetch, std::string& file_path) {
+    std::string path = FilePath(key);
+    int64_t size = 0;
+    bool verify = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        fetch_cv_.wait(lock, [&] { return fetching_.find(key) == fetching_.end(); });
+        auto it = items_.find(key);
+        if (it != items_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru_it_);
+            if (it->second.verified_) {
+                file_path = it->second.file_path_;
+                return Status::OK();
+            }
+            verify = true;
+            size = it->second.size_;
+        }
+        fetching_.insert(key);
+    }
+
+    // a file of the previous run is verified once without lock, a broken one is fetched again
+    if (verify) {
+        auto status = CheckSum(path, size);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = items_.find(key);
+        if (status.ok() && it != items_.end()) {
+            it->second.verified_ = true;
+            fetching_.erase(key);
+            fetch_cv_.notify_all();
+            file_path = path;
+            return Status::OK();
+        }
+        if (!status.ok()) {
+            LOG_STORAGE_WARNING_ << "Fetch the broken cache file again: " << status.message();
+            Remove(key);
+        }
+    }
+
+    // fetch without lock, so that different objects are fetched concurrently
+    std::string temp_path = path + TEMP_SUFFIX;
+    auto status = fetch(key, temp_path);
+    fiu_do_on("DiskCache.Get.fetch_fail", status = Status(SERVER_UNEXPECTED_ERROR, "Fetch failed"));
+    if (status.ok()) {
+        std::error_code ec;
+        size = fs::file_size(temp_path, ec);
+        if (ec) {
+            std::string msg = "Failed to get size of cache file " + temp_path + ": " + ec.message();
+            status = Status(SERVER_CANNOT_READ_FILE, msg);
+        }
+    }
+    if (status.ok()) {
+        status = WriteMeta(path, key, size);
+    }
+    if (status.ok()) {
+        std::error_code ec;
+        fs::rename(temp_path, path, ec);
+        if (ec) {
+            std::string msg = "Failed to rename cache file " + temp_path + ": " + ec.message();
+            status = Status(SERVER_CANNOT_CREATE_FILE, msg);
+        }
+    }
+    if (!status.ok()) {
+        RemoveFile(temp_path);
+        RemoveFile(path + META_SUFFIX);
+        LOG_STORAGE_ERROR_ << "Failed to cache " << key << ": " << status.message();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    fetching_.erase(key);
+    fetch_cv_.notify_all();
+    if (!status.ok()) {
+        return status;
+    }
+
+    Admit(key, path, size, true);
+    Evict(key);
+    file_path = path;
+    return Status::OK();
+}
+
+bool
+DiskCache::Exist(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.find(key) != items_.end();
+}
+
+void
+DiskCache::Erase(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Remove(key);
+}
+
+int64_t
+DiskCache::Size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+std::string
+DiskCache::FilePath(const std::string& key) const {
+    // hash of the key keeps the folder flat, the file name of the key is kept for debugging
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>()(key);
+    auto pos = key.find_last_of('/');
+    ss << "_" << (pos == std::string::npos ? key : key.substr(pos + 1));
+    return (fs::path(cache_path_) / ss.str()).string();
+}
+
+void
+DiskCache::Admit(const std::string& key, const std::string& file_path, int64_t size, bool verified) {
+    lru_.push_front(key);
+    auto& item = items_[key];
+    item.file_path_ = file_path;
+    item.size_ = size;
+    item.verified_ = verified;
+    item.lru_it_ = lru_.begin();
+    size_ += size;
+}
+
+void
+DiskCache::Evict(const std::string& keep_key) {
+    // a reader which has opened an evicted file can still read it until the file is closed
+    while (size_ > capacity_ && !lru_.empty()) {
+        auto key = lru_.back();
+        if (key == keep_key) {
+            break;
+        }
+        LOG_STORAGE_DEBUG_ << "Evict cache file " << items_[key].file_path_;
+        Remove(key);
+    }
+}
+
+void
+DiskCache::Remove(const std::string& key) {
+    auto it = items_.find(key);
+    if (it == items_.end()) {
+        return;
+    }
+    RemoveFile(it->second.file_path_ + META_SUFFIX);
+    RemoveFile(it->second.file_path_);
+    size_ -= it->second.size_;
+    lru_.erase(it->second.lru_it_);
+    items_.erase(it);
+}
+
+Status
+DiskCache::CheckSum(const std::string& file_path, int64_t size) {
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file.is_open()) {
+        return Status(SERVER_CANNOT_OPEN_FILE, "Failed to open cache file: " + file_path);
+    }
+
+    // only the files written by the codecs carry a checksum, the others are checked by size
+    char magic[CODEC_MAGIC_SIZE];
+    if (size < CODEC_MAGIC_SIZE + CODEC_SUM_SIZE || !file.read(magic, CODEC_MAGIC_SIZE) ||
+        strncmp(magic, CODEC_MAGIC, CODEC_MAGIC_SIZE) != 0) {
+        return Status::OK();
+    }
+
+    file.seekg(0);
+    std::vector<uint8_t> buffer(CHECKSUM_BUFFER_SIZE);
+    uint32_t sum = 0;
+    for (int64_t remain = size - CODEC_SUM_SIZE; remain > 0;) {
+        auto count = std::min<int64_t>(remain, buffer.size());
+        if (!file.read(reinterpret_cast<char*>(buffer.data()), count)) {
+            return Status(SERVER_CANNOT_READ_FILE, "Failed to read cache file: " + file_path);
+        }
+        sum = crc32c::Extend(sum, buffer.data(), count);
+        remain -= count;
+    }
+
+    uint32_t record = 0;
+    if (!file.read(reinterpret_cast<char*>(&record), CODEC_SUM_SIZE)) {
+        return Status(SERVER_CANNOT_READ_FILE, "Failed to read cache file: " + file_path);
+    }
+    if (sum != record) {
+        return Status(SERVER_FILE_SUM_BYTES_ERROR, "Wrong sum bytes of cache file: " + file_path);
+    }
+    return Status::OK();
+}
+
+}  // namespace storage
+}  // namespace milvus
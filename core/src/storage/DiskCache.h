@@ -0,0 +1,101 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "utils/Status.h"
+
+namespace milvus {
+namespace storage {
+
+// Size-bounded cache of remote objects on local disk, items are evicted in LRU order.
+// Each cached file has a meta file beside it recording the object key and file size, so that files left by
+// a previous run are reused. A reused file is verified on its first use by the crc32c sum which the codecs
+// append to every file (see codecs/ExtraFileInfo.h), and fetched again if it is broken.
+class DiskCache {
+ public:
+    // download the object into the file
+    using FetchFunc = std::function<Status(const std::string& key, const std::string& file_path)>;
+
+    DiskCache(const std::string& cache_path, int64_t capacity);
+
+    // scan the cache folder, reuse the files matching their meta and remove the others
+    Status
+    Load();
+
+    // get the local file of the object, fetch it into cache if missing
+    // concurrent calls for the same key wait for one fetch
+    Status
+    Get(const std::string& key, const FetchFunc& fetch, std::string& file_path);
+
+    bool
+    Exist(const std::string& key);
+
+    void
+    Erase(const std::string& key);
+
+    int64_t
+    Size();
+
+    int64_t
+    Capacity() const {
+        return capacity_;
+    }
+
+ private:
+    struct CacheItem {
+        std::string file_path_;
+        int64_t size_ = 0;
+        bool verified_ = true;  // false for a file of the previous run until its checksum is verified
+        std::list<std::string>::iterator lru_it_;
+    };
+
+    std::string
+    FilePath(const std::string& key) const;
+
+    void
+    Admit(const std::string& key, const std::string& file_path, int64_t size, bool verified);
+
+    void
+    Evict(const std::string& keep_key);
+
+    void
+    Remove(const std::string& key);
+
+    static Status
+    CheckSum(const std::string& file_path, int64_t size);
+
+ private:
+    const std::string cache_path_;
+    const int64_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable fetch_cv_;
+    std::list<std::string> lru_;  // front is the most recently used
+    std::unordered_map<std::string, CacheItem> items_;
+    std::unordered_set<std::string> fetching_;
+    int64_t size_ = 0;
+};
+
+using DiskCachePtr = std::shared_ptr<DiskCache>;
+
+}  // namespace storage
+}  // namespace milvus
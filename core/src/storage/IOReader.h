@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -33,6 +34,13 @@ class IOReader {
 
     virtual void
     Close() = 0;
+
+    // map the whole file into memory, the mapping is released along with the last copy of returned pointer
+    // return nullptr if the storage doesn't support memory mapping
+    virtual std::shared_ptr<uint8_t[]>
+    Map(const std::string& name, int64_t& length) {
+        return nullptr;
+    }
 };
 
 using IOReaderPtr = std::shared_ptr<IOReader>;
@@ -11,6 +11,13 @@
 
 #include "storage/disk/DiskIOReader.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/Log.h"
+
 namespace milvus {
 namespace storage {
 
@@ -50,5 +57,32 @@ DiskIOReader::Close() {
     fs_.close();
 }
 
+std::shared_ptr<uint8_t[]>
+DiskIOReader::Map(const std::string& name, int64_t& length) {
+    length = 0;
+    int fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    // the mapping stays valid after the file descriptor closed
+    int64_t size = file_stat.st_size;
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOG_STORAGE_WARNING_ << "Failed to map file: " << name << ", errno: " << errno;
+        return nullptr;
+    }
+
+    length = size;
+    return std::shared_ptr<uint8_t[]>(static_cast<uint8_t*>(addr), [size](uint8_t* p) { munmap(p, size); });
+}
+
 }  // namespace storage
 }  // namespace milvus
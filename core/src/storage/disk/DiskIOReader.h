@@ -48,6 +48,9 @@ class DiskIOReader : public IOReader {
     void
     Close() override;
 
+    std::shared_ptr<uint8_t[]>
+    Map(const std::string& name, int64_t& length) override;
+
  public:
     std::string name_;
     std::fstream fs_;
@@ -9,7 +9,10 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <algorithm>
+#include <cstdio>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include <aws/core/Aws.h>
@@ -22,6 +25,7 @@
 #include <aws/s3/model/DeleteBucketRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
+#include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
 
 namespace milvus {
@@ -30,7 +34,7 @@ namespace storage {
 /*
  * This is a class that represents a S3 Client which is used to mimic the put/get operations of a actual s3 client.
  * During a put object, the body of the request is stored as well as the metadata of the request. This data is then
- * populated into a get object result when a get operation is called.
+ * populated into a get object result when a get operation is called, a ranged get returns the part of the body.
  */
 class S3ClientMock : public Aws::S3::S3Client {
  public:
@@ -54,31 +58,62 @@ class S3ClientMock : public Aws::S3::S3Client {
     PutObject(const Aws::S3::Model::PutObjectRequest& request) const override {
         Aws::String key = request.GetKey();
         std::shared_ptr<Aws::IOStream> body = request.GetBody();
-        aws_map_[key] = body;
+        Aws::String body_str((Aws::IStreamBufIterator(*body)), Aws::IStreamBufIterator());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            aws_map_[key] = std::move(body_str);
+        }
 
         Aws::S3::Model::PutObjectResult result;
         return Aws::S3::Model::PutObjectOutcome(std::move(result));
     }
 
+    Aws::S3::Model::HeadObjectOutcome
+    HeadObject(const Aws::S3::Model::HeadObjectRequest& request) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = aws_map_.find(request.GetKey());
+        if (it == aws_map_.end()) {
+            return Aws::S3::Model::HeadObjectOutcome();
+        }
+
+        Aws::S3::Model::HeadObjectResult result;
+        result.SetContentLength(it->second.length());
+        return Aws::S3::Model::HeadObjectOutcome(std::move(result));
+    }
+
     Aws::S3::Model::GetObjectOutcome
     GetObject(const Aws::S3::Model::GetObjectRequest& request) const override {
         auto factory = request.GetResponseStreamFactory();
         Aws::Utils::Stream::ResponseStream resp_stream(factory);
 
-        try {
-            std::shared_ptr<Aws::IOStream> body = aws_map_.at(request.GetKey());
-            Aws::String body_str((Aws::IStreamBufIterator(*body)), Aws::IStreamBufIterator());
-
-            resp_stream.GetUnderlyingStream().write(body_str.c_str(), body_str.length());
-            resp_stream.GetUnderlyingStream().flush();
-            Aws::AmazonWebServiceResult<Aws::Utils::Stream::ResponseStream> awsStream(
-                std::move(resp_stream), Aws::Http::HeaderValueCollection());
+        Aws::String body_str;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = aws_map_.find(request.GetKey());
+            if (it == aws_map_.end()) {
+                return Aws::S3::Model::GetObjectOutcome();
+            }
+            body_str = it->second;
+        }
 
-            Aws::S3::Model::GetObjectResult result(std::move(awsStream));
-            return Aws::S3::Model::GetObjectOutcome(std::move(result));
-        } catch (...) {
-            return Aws::S3::Model::GetObjectOutcome();
+        // range is in form of "bytes=first-last", both inclusive
+        if (request.RangeHasBeenSet()) {
+            int64_t first = 0, last = 0;
+            if (sscanf(request.GetRange().c_str(), "bytes=%ld-%ld", &first, &last) != 2 || first > last ||
+                first >= static_cast<int64_t>(body_str.length())) {
+                return Aws::S3::Model::GetObjectOutcome();
+            }
+            last = std::min(last, static_cast<int64_t>(body_str.length()) - 1);
+            body_str = body_str.substr(first, last - first + 1);
         }
+
+        resp_stream.GetUnderlyingStream().write(body_str.c_str(), body_str.length());
+        resp_stream.GetUnderlyingStream().flush();
+        Aws::AmazonWebServiceResult<Aws::Utils::Stream::ResponseStream> awsStream(std::move(resp_stream),
+                                                                                  Aws::Http::HeaderValueCollection());
+
+        Aws::S3::Model::GetObjectResult result(std::move(awsStream));
+        return Aws::S3::Model::GetObjectOutcome(std::move(result));
     }
 
     Aws::S3::Model::ListObjectsOutcome
@@ -92,13 +127,17 @@ class S3ClientMock : public Aws::S3::S3Client {
     Aws::S3::Model::DeleteObjectOutcome
     DeleteObject(const Aws::S3::Model::DeleteObjectRequest& request) const override {
         Aws::String key = request.GetKey();
-        aws_map_.erase(key);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            aws_map_.erase(key);
+        }
         Aws::S3::Model::DeleteObjectResult result;
         Aws::S3::Model::DeleteObjectOutcome(std::move(result));
         return result;
     }
 
-    mutable Aws::Map<Aws::String, std::shared_ptr<Aws::IOStream>> aws_map_;
+    mutable std::mutex mutex_;
+    mutable Aws::Map<Aws::String, Aws::String> aws_map_;
 };
 
 }  // namespace storage
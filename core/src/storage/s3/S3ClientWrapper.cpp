@@ -15,12 +15,23 @@
 #include <aws/s3/model/DeleteBucketRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
+#include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
+#include <fcntl.h>
 #include <fiu/fiu-local.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <utility>
 
 #include "storage/s3/S3ClientMock.h"
@@ -32,6 +43,44 @@
 namespace milvus {
 namespace storage {
 
+namespace {
+
+using PartFunc = std::function<Status(int64_t part_offset, int64_t part_length)>;
+
+// split [offset, offset + length) into parts, and call func on the parts from at most S3_DOWNLOAD_THREADS threads
+Status
+ForEachPart(int64_t offset, int64_t length, const PartFunc& func) {
+    int64_t part_count = (length + S3_DOWNLOAD_PART_SIZE - 1) / S3_DOWNLOAD_PART_SIZE;
+    std::atomic<int64_t> next_part(0);
+    std::mutex status_mutex;
+    Status status = Status::OK();
+
+    auto worker = [&]() {
+        for (int64_t part = next_part++; part < part_count; part = next_part++) {
+            int64_t part_offset = offset + part * S3_DOWNLOAD_PART_SIZE;
+            auto part_status = func(part_offset, std::min(S3_DOWNLOAD_PART_SIZE, offset + length - part_offset));
+            if (!part_status.ok()) {
+                std::lock_guard<std::mutex> lock(status_mutex);
+                status = part_status;
+                next_part = part_count;  // stop other workers
+                break;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int64_t i = 1; i < std::min(part_count, S3_DOWNLOAD_THREADS); ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return status;
+}
+
+}  // namespace
+
 Status
 S3ClientWrapper::StartService() {
     bool s3_enable = config.storage.s3_enable();
@@ -42,10 +91,20 @@ S3ClientWrapper::StartService() {
     }
 
     s3_address_ = config.storage.s3_address();
-    s3_port_ = config.storage.s3_port();
+    s3_port_ = std::to_string(config.storage.s3_port());
     s3_access_key_ = config.storage.s3_access_key();
     s3_secret_key_ = config.storage.s3_secret_key();
     s3_bucket_ = config.storage.s3_bucket();
+    std::string cache_path = config.storage.s3_cache_path();
+    int64_t cache_capacity = config.storage.s3_cache_capacity();
+
+    bool mock_enable = false;
+    fiu_do_on("S3ClientWrapper.StartService.mock_enable", mock_enable = true);
+    if (!mock_enable && (s3_access_key_.empty() || s3_secret_key_.empty())) {
+        std::string msg = "storage.s3_access_key and storage.s3_secret_key must be set when storage.s3_enable is true";
+        LOG_STORAGE_ERROR_ << msg;
+        return Status(SERVER_INVALID_ARGUMENT, msg);
+    }
 
     Aws::InitAPI(options_);
 
@@ -57,12 +116,15 @@ S3ClientWrapper::StartService() {
         std::make_shared<Aws::S3::S3Client>(Aws::Auth::AWSCredentials(s3_access_key_, s3_secret_key_), cfg,
                                             Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Always, false);
 
-    bool mock_enable = false;
-    fiu_do_on("S3ClientWrapper.StartService.mock_enable", mock_enable = true);
     if (mock_enable) {
         client_ptr_ = std::make_shared<S3ClientMock>();
     }
 
+    if (!cache_path.empty() && cache_capacity > 0) {
+        disk_cache_ = std::make_shared<DiskCache>(cache_path, cache_capacity);
+        STATUS_CHECK(disk_cache_->Load());
+    }
+
     std::cout << "S3 service connection check ...... " << std::flush;
     Status stat = CreateBucket();
     std::cout << (stat.ok() ? "OK" : "FAIL") << std::endl;
@@ -72,6 +134,7 @@ S3ClientWrapper::StartService() {
 void
 S3ClientWrapper::StopService() {
     client_ptr_ = nullptr;
+    disk_cache_ = nullptr;
     Aws::ShutdownAPI(options_);
 }
 
@@ -138,6 +201,10 @@ S3ClientWrapper::PutObjectFile(const std::string& object_name, const std::string
         return Status(SERVER_UNEXPECTED_ERROR, err.GetMessage());
     }
 
+    if (disk_cache_ != nullptr) {
+        disk_cache_->Erase(object_name);
+    }
+
     LOG_STORAGE_DEBUG_ << "PutObjectFile '" << file_path << "' successfully!";
     return Status::OK();
 }
@@ -160,12 +227,50 @@ S3ClientWrapper::PutObjectStr(const std::string& object_name, const std::string&
         return Status(SERVER_UNEXPECTED_ERROR, err.GetMessage());
     }
 
+    if (disk_cache_ != nullptr) {
+        disk_cache_->Erase(object_name);
+    }
+
     LOG_STORAGE_DEBUG_ << "PutObjectStr successfully!";
     return Status::OK();
 }
 
 Status
 S3ClientWrapper::GetObjectFile(const std::string& object_name, const std::string& file_path) {
+    int64_t length = 0;
+    STATUS_CHECK(GetObjectLength(object_name, length));
+    if (length > S3_DOWNLOAD_PART_SIZE) {
+        int fd = open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::string str = "Failed to create file '" + file_path + "'";
+            LOG_STORAGE_ERROR_ << "ERROR: " << str;
+            return Status(SERVER_CANNOT_CREATE_FILE, str);
+        }
+
+        // parts are written to their position, a thread holds one part in memory
+        auto status = ForEachPart(0, length, [&](int64_t part_offset, int64_t part_length) {
+            std::vector<char> buffer(part_length);
+            STATUS_CHECK(GetPart(object_name, part_offset, part_length, buffer.data()));
+            int64_t written = 0;
+            while (written < part_length) {
+                auto ret = pwrite(fd, buffer.data() + written, part_length - written, part_offset + written);
+                if (ret <= 0) {
+                    return Status(SERVER_CANNOT_CREATE_FILE, "Failed to write file '" + file_path + "'");
+                }
+                written += ret;
+            }
+            return Status::OK();
+        });
+        close(fd);
+        if (!status.ok()) {
+            LOG_STORAGE_ERROR_ << "ERROR: GetObjectFile: " << status.message();
+            return status;
+        }
+
+        LOG_STORAGE_DEBUG_ << "GetObjectFile '" << file_path << "' in parallel successfully!";
+        return Status::OK();
+    }
+
     Aws::S3::Model::GetObjectRequest request;
     request.WithBucket(s3_bucket_).WithKey(object_name);
 
@@ -210,6 +315,68 @@ S3ClientWrapper::GetObjectStr(const std::string& object_name, std::string& conte
     return Status::OK();
 }
 
+Status
+S3ClientWrapper::GetObjectLength(const std::string& object_name, int64_t& length) {
+    Aws::S3::Model::HeadObjectRequest request;
+    request.WithBucket(s3_bucket_).WithKey(object_name);
+
+    auto outcome = client_ptr_->HeadObject(request);
+
+    fiu_do_on("S3ClientWrapper.GetObjectLength.outcome.fail", outcome = Aws::S3::Model::HeadObjectOutcome());
+    if (!outcome.IsSuccess()) {
+        auto err = outcome.GetError();
+        LOG_STORAGE_ERROR_ << "ERROR: HeadObject: " << err.GetExceptionName() << ": " << err.GetMessage();
+        return Status(SERVER_UNEXPECTED_ERROR, err.GetMessage());
+    }
+
+    length = outcome.GetResult().GetContentLength();
+    return Status::OK();
+}
+
+Status
+S3ClientWrapper::GetObjectRange(const std::string& object_name, int64_t offset, int64_t length, void* buffer) {
+    auto data = static_cast<char*>(buffer);
+    if (length <= S3_DOWNLOAD_PART_SIZE) {
+        return GetPart(object_name, offset, length, data);
+    }
+
+    // each part is read into its position of the buffer directly
+    return ForEachPart(offset, length, [&](int64_t part_offset, int64_t part_length) {
+        return GetPart(object_name, part_offset, part_length, data + (part_offset - offset));
+    });
+}
+
+Status
+S3ClientWrapper::GetPart(const std::string& object_name, int64_t offset, int64_t length, char* buffer) {
+    if (length <= 0) {
+        return Status::OK();
+    }
+
+    Aws::S3::Model::GetObjectRequest request;
+    request.WithBucket(s3_bucket_).WithKey(object_name);
+    request.SetRange("bytes=" + std::to_string(offset) + "-" + std::to_string(offset + length - 1));
+
+    auto outcome = client_ptr_->GetObject(request);
+
+    fiu_do_on("S3ClientWrapper.GetPart.outcome.fail", outcome = Aws::S3::Model::GetObjectOutcome());
+    if (!outcome.IsSuccess()) {
+        auto err = outcome.GetError();
+        LOG_STORAGE_ERROR_ << "ERROR: GetObject: " << err.GetExceptionName() << ": " << err.GetMessage();
+        return Status(SERVER_UNEXPECTED_ERROR, err.GetMessage());
+    }
+
+    auto& retrieved_part = outcome.GetResultWithOwnership().GetBody();
+    retrieved_part.read(buffer, length);
+    if (retrieved_part.gcount() != length) {
+        std::string str = "Object '" + object_name + "' is shorter than range " + std::to_string(offset) + "-" +
+                          std::to_string(offset + length - 1);
+        LOG_STORAGE_ERROR_ << "ERROR: " << str;
+        return Status(SERVER_UNEXPECTED_ERROR, str);
+    }
+
+    return Status::OK();
+}
+
 Status
 S3ClientWrapper::ListObjects(std::vector<std::string>& object_list, const std::string& prefix) {
     Aws::S3::Model::ListObjectsRequest request;
@@ -257,6 +424,10 @@ S3ClientWrapper::DeleteObject(const std::string& object_name) {
         return Status(SERVER_UNEXPECTED_ERROR, err.GetMessage());
     }
 
+    if (disk_cache_ != nullptr) {
+        disk_cache_->Erase(object_name);
+    }
+
     LOG_STORAGE_DEBUG_ << "DeleteObject '" << object_name << "' successfully!";
     return Status::OK();
 }
@@ -316,6 +487,9 @@ S3ClientWrapper::Move(const std::string& tar_name, const std::string& src_name)
         return Status(SERVER_UNEXPECTED_ERROR, err.GetMessage());
     }
 
+    if (disk_cache_ != nullptr) {
+        disk_cache_->Erase(tar_name);
+    }
     STATUS_CHECK(DeleteObject(src_name));
 
     return Status::OK();
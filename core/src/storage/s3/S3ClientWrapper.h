@@ -17,11 +17,16 @@
 #include <string>
 #include <vector>
 
+#include "storage/DiskCache.h"
 #include "utils/Status.h"
 
 namespace milvus {
 namespace storage {
 
+// objects larger than one part are downloaded by ranged GETs in parallel
+constexpr int64_t S3_DOWNLOAD_PART_SIZE = 8 * 1024 * 1024;
+constexpr int64_t S3_DOWNLOAD_THREADS = 8;
+
 class S3ClientWrapper {
  public:
     static S3ClientWrapper&
@@ -48,6 +53,11 @@ class S3ClientWrapper {
     Status
     GetObjectStr(const std::string& object_key, std::string& content);
     Status
+    GetObjectLength(const std::string& object_key, int64_t& length);
+    // read [offset, offset + length) of the object into buffer, large range is split into parallel parts
+    Status
+    GetObjectRange(const std::string& object_key, int64_t offset, int64_t length, void* buffer);
+    Status
     ListObjects(std::vector<std::string>& object_list, const std::string& prefix = "");
     Status
     DeleteObject(const std::string& object_key);
@@ -58,6 +68,21 @@ class S3ClientWrapper {
     Status
     Move(const std::string& tar_name, const std::string& src_name);
 
+    // local disk cache in front of S3, nullptr if disabled
+    DiskCachePtr
+    GetDiskCache() const {
+        return disk_cache_;
+    }
+    void
+    SetDiskCache(const DiskCachePtr& disk_cache) {
+        disk_cache_ = disk_cache;
+    }
+
+ private:
+    // ranged GET of [offset, offset + length)
+    Status
+    GetPart(const std::string& object_key, int64_t offset, int64_t length, char* buffer);
+
  private:
     std::shared_ptr<Aws::S3::S3Client> client_ptr_;
     Aws::SDKOptions options_;
@@ -67,6 +92,8 @@ class S3ClientWrapper {
     std::string s3_access_key_;
     std::string s3_secret_key_;
     std::string s3_bucket_;
+
+    DiskCachePtr disk_cache_;
 };
 
 }  // namespace storage
@@ -10,35 +10,136 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include "storage/s3/S3IOReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "log/Log.h"
+#include "storage/disk/DiskIOReader.h"
 #include "storage/s3/S3ClientWrapper.h"
 
 namespace milvus {
 namespace storage {
 
+namespace {
+
+Status
+GetCachedFile(const std::string& name, std::string& file_path) {
+    auto& wrapper = S3ClientWrapper::GetInstance();
+    auto fetch = [&wrapper](const std::string& key, const std::string& path) {
+        return wrapper.GetObjectFile(key, path);
+    };
+    return wrapper.GetDiskCache()->Get(name, fetch, file_path);
+}
+
+}  // namespace
+
 bool
 S3IOReader::Open(const std::string& name) {
     name_ = name;
     pos_ = 0;
-    return (S3ClientWrapper::GetInstance().GetObjectStr(name_, buffer_).ok());
+    length_ = 0;
+    buffer_.clear();
+    buffer_offset_ = 0;
+
+    auto& wrapper = S3ClientWrapper::GetInstance();
+    if (wrapper.GetDiskCache() == nullptr) {
+        return wrapper.GetObjectLength(name_, length_).ok();
+    }
+
+    // the cached file could be evicted before it is opened, get it again in that case
+    for (int i = 0; i < 2 && !fs_.is_open(); ++i) {
+        std::string file_path;
+        if (!GetCachedFile(name_, file_path).ok()) {
+            return false;
+        }
+        fs_.clear();
+        fs_.open(file_path, std::ios::in | std::ios::binary);
+    }
+    if (!fs_.is_open()) {
+        return false;
+    }
+
+    fs_.seekg(0, fs_.end);
+    length_ = fs_.tellg();
+    fs_.seekg(0, fs_.beg);
+    return true;
 }
 
 void
 S3IOReader::Read(void* ptr, int64_t size) {
-    memcpy(ptr, buffer_.data() + pos_, size);
+    if (fs_.is_open()) {
+        fs_.read(reinterpret_cast<char*>(ptr), size);
+        pos_ += size;
+        return;
+    }
+
+    if (pos_ < 0 || pos_ + size > length_) {
+        LOG_STORAGE_ERROR_ << "Read beyond the end of object " << name_ << ", pos: " << pos_ << ", size: " << size;
+        return;
+    }
+
+    auto& wrapper = S3ClientWrapper::GetInstance();
+    if (pos_ < buffer_offset_ || pos_ + size > buffer_offset_ + static_cast<int64_t>(buffer_.size())) {
+        if (size >= S3_READ_AHEAD_SIZE) {
+            // large read goes to the caller's memory directly
+            auto status = wrapper.GetObjectRange(name_, pos_, size, ptr);
+            if (!status.ok()) {
+                LOG_STORAGE_ERROR_ << "Failed to read object " << name_ << ": " << status.message();
+            }
+            pos_ += size;
+            return;
+        }
+
+        buffer_.resize(std::min(S3_READ_AHEAD_SIZE, length_ - pos_));
+        buffer_offset_ = pos_;
+        auto status = wrapper.GetObjectRange(name_, buffer_offset_, buffer_.size(), &buffer_[0]);
+        if (!status.ok()) {
+            LOG_STORAGE_ERROR_ << "Failed to read object " << name_ << ": " << status.message();
+            buffer_.clear();
+            return;
+        }
+    }
+
+    memcpy(ptr, buffer_.data() + (pos_ - buffer_offset_), size);
+    pos_ += size;
 }
 
 void
 S3IOReader::Seekg(int64_t pos) {
     pos_ = pos;
+    if (fs_.is_open()) {
+        fs_.seekg(pos);
+    }
 }
 
 int64_t
 S3IOReader::Length() {
-    return buffer_.length();
+    return length_;
 }
 
 void
 S3IOReader::Close() {
+    if (fs_.is_open()) {
+        fs_.close();
+    }
+    std::string().swap(buffer_);
+}
+
+std::shared_ptr<uint8_t[]>
+S3IOReader::Map(const std::string& name, int64_t& length) {
+    length = 0;
+    if (S3ClientWrapper::GetInstance().GetDiskCache() == nullptr) {
+        return nullptr;
+    }
+
+    // map the cached file, the mapping stays valid after the file is evicted
+    std::string file_path;
+    if (!GetCachedFile(name, file_path).ok()) {
+        return nullptr;
+    }
+    DiskIOReader reader;
+    return reader.Map(file_path, length);
 }
 
 }  // namespace storage
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <fstream>
 #include <memory>
 #include <string>
 #include "storage/IOReader.h"
@@ -18,6 +19,12 @@
 namespace milvus {
 namespace storage {
 
+// small reads are served from a buffer filled by one ranged GET
+constexpr int64_t S3_READ_AHEAD_SIZE = 1024 * 1024;
+
+// Read object from the local disk cache when it is enabled, the object is downloaded into the cache on open.
+// Otherwise read by ranged GETs, the object is never held in memory as a whole.
+
 class S3IOReader : public IOReader {
  public:
     S3IOReader() = default;
@@ -47,10 +54,16 @@ class S3IOReader : public IOReader {
     void
     Close() override;
 
+    std::shared_ptr<uint8_t[]>
+    Map(const std::string& name, int64_t& length) override;
+
  public:
     std::string name_;
-    std::string buffer_;
-    int64_t pos_;
+    int64_t pos_ = 0;
+    int64_t length_ = 0;
+    std::fstream fs_;            // cached file
+    std::string buffer_;         // read ahead buffer
+    int64_t buffer_offset_ = 0;  // object offset of the buffer
 };
 
 using S3IOReaderPtr = std::shared_ptr<S3IOReader>;
@@ -129,6 +129,7 @@ InitConfig() {
         Size_(cache.cache_size, _MODIFIABLE, 0, std::numeric_limits<int64_t>::max(), 4 * GB, is_cachesize_valid),
         Floating(cache.cpu_cache_threshold, 0.0, 1.0, 0.7),
         Size(cache.insert_buffer_size, 0, std::numeric_limits<int64_t>::max(), 1 * GB),
+        Size(cache.merge_buffer_size, 1 * MB, std::numeric_limits<int64_t>::max(), 64 * MB),
         Bool(cache.cache_insert_data, false),
         String(cache.preload_collection, ""),
         Size(cache.max_concurrent_insert_request_size, 256 * MB, std::numeric_limits<int64_t>::max(), 2 * GB),
@@ -161,12 +162,28 @@ InitConfig() {
         Integer(engine.search_combine_nq, 0, std::numeric_limits<int64_t>::max(), 64),
         Integer(engine.use_blas_threshold, 0, std::numeric_limits<int64_t>::max(), 16385),
         Integer(engine.omp_thread_num, 0, std::numeric_limits<int64_t>::max(), 0),
+        Integer(engine.executor_num, 1, 1024, 4),
+        Integer(engine.loader_num, 1, 1024, 2),
+        Integer(engine.prefetch_num, 1, 1024, 4),
+        Integer(engine.builder_num, 1, 1024, 2),
+        Integer(engine.snapshot_warmup_num, 0, 1024, 8),
+        Integer(engine.operation_executor_num, 1, 1024, 8),
         Enum(engine.clustering_type, &ClusteringMap, ClusteringType::K_MEANS),
         Enum(engine.simd_type, &SimdMap, SimdType::AUTO),
         Bool(engine.stat_optimizer_enable, true),
 
         Bool(system.lock.enable, true),
 
+        /* storage, only used when built with MILVUS_WITH_AWS */
+        Bool(storage.s3_enable, false),
+        String(storage.s3_address, "127.0.0.1"),
+        Integer(storage.s3_port, 1, 65535, 9000),
+        String(storage.s3_access_key, ""),
+        String(storage.s3_secret_key, ""),
+        String(storage.s3_bucket, "milvus-bucket"),
+        String(storage.s3_cache_path, ""),
+        Size(storage.s3_cache_capacity, 0, std::numeric_limits<int64_t>::max(), 0),
+
         Bool(transcript.enable, false),
         String(transcript.replay, ""),
     };
@@ -250,9 +267,42 @@ network:
 #                      | flushes data to disk.                                      |            |                 |
 #                      | 0 means disable the regular flush.                         |            |                 |
 #----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_enable            | Whether to store the segment files in S3 compatible        | Boolean    | false           |
+#                      | object storage instead of the local path. Only works       |            |                 |
+#                      | when Milvus is built with MILVUS_WITH_AWS.                 |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_address           | IP address of the S3 service.                              | IP         | 127.0.0.1       |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_port              | Port of the S3 service, range [1, 65535].                  | Integer    | 9000            |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_access_key        | Access key of the S3 service, it must be set when          | String     |                 |
+#                      | s3_enable is true.                                         |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_secret_key        | Secret key of the S3 service, it must be set when          | String     |                 |
+#                      | s3_enable is true.                                         |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_bucket            | Bucket storing the segment files, it is created if it      | String     | milvus-bucket   |
+#                      | does not exist.                                            |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_cache_path        | Local folder caching the files read from S3. The files     | Path       |                 |
+#                      | left by the previous run are reused. The cache is          |            |                 |
+#                      | disabled if it is empty.                                   |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# s3_cache_capacity    | Disk space used by the S3 cache, the least recently used   | String     | 0               |
+#                      | files are removed beyond it. The cache is disabled if it   |            |                 |
+#                      | is 0.                                                      |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
 storage:
   path: @storage.path@
   auto_flush_interval: @storage.auto_flush_interval@
+  s3_enable: @storage.s3_enable@
+  s3_address: @storage.s3_address@
+  s3_port: @storage.s3_port@
+  s3_access_key: @storage.s3_access_key@
+  s3_secret_key: @storage.s3_secret_key@
+  s3_bucket: @storage.s3_bucket@
+  s3_cache_path: @storage.s3_cache_path@
+  s3_cache_capacity: @storage.s3_cache_capacity@
 
 #----------------------+------------------------------------------------------------+------------+-----------------+
 # WAL Config           | Description                                                | Type       | Default         |
@@ -279,6 +329,10 @@ wal:
 #                      | The sum of 'insert_buffer_size' and 'cache_size'           |            |                 |
 #                      | must be less than system memory size.                      |            |                 |
 #----------------------+------------------------------------------------------------+------------+-----------------+
+# merge_buffer_size    | Buffer size used to read each field of merged segments in  | String     | 64MB            |
+#                      | segment merge and compaction. The peak memory of one merge |            |                 |
+#                      | task is about twice of this size besides the entity ids.   |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
 # preload_collection   | A comma-separated list of collection names that need to    | StringList |                 |
 #                      | be pre-loaded when Milvus server starts up.                |            |                 |
 #                      | '*' means preload all existing tables (single-quote or     |            |                 |
@@ -293,9 +347,44 @@ wal:
 cache:
   cache_size: @cache.cache_size@
   insert_buffer_size: @cache.insert_buffer_size@
+  merge_buffer_size: @cache.merge_buffer_size@
   preload_collection: @cache.preload_collection@
   max_concurrent_insert_request_size: @cache.max_concurrent_insert_request_size@
 
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# Engine Config        | Description                                                | Type       | Default         |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# executor_num         | Number of threads executing search tasks on CPU,           | Integer    | 4               |
+#                      | range [1, 1024].                                           |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# loader_num           | Number of threads loading the segments of search tasks     | Integer    | 2               |
+#                      | into CPU memory, range [1, 1024].                          |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# prefetch_num         | Number of loaded search tasks that may wait for an         | Integer    | 4               |
+#                      | executor, the loaders pause when so many tasks are         |            |                 |
+#                      | loaded ahead, range [1, 1024].                             |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# builder_num          | Number of segment indexes built concurrently on CPU, the   | Integer    | 2               |
+#                      | CPU threads are split among them, range [1, 1024].         |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# snapshot_warmup_num  | Number of threads loading the snapshots of collections     | Integer    | 8               |
+#                      | in background at startup, range [0, 1024]. 0 disables      |            |                 |
+#                      | the warm-up, a snapshot is then loaded on first access.    |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+# operation_executor_num |                                                          |            |                 |
+#                      | Number of threads applying snapshot operations such as     | Integer    | 8               |
+#                      | flush, merge and build index. The operations of a          |            |                 |
+#                      | collection are applied in order by one of them, range      |            |                 |
+#                      | [1, 1024].                                                 |            |                 |
+#----------------------+------------------------------------------------------------+------------+-----------------+
+engine:
+  executor_num: @engine.executor_num@
+  loader_num: @engine.loader_num@
+  prefetch_num: @engine.prefetch_num@
+  builder_num: @engine.builder_num@
+  snapshot_warmup_num: @engine.snapshot_warmup_num@
+  operation_executor_num: @engine.operation_executor_num@
+
 #----------------------+------------------------------------------------------------+------------+-----------------+
 # GPU Config           | Description                                                | Type       | Default         |
 #----------------------+------------------------------------------------------------+------------+-----------------+
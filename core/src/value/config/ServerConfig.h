@@ -89,12 +89,21 @@ struct ServerConfig {
     struct Storage {
         String path;
         Integer auto_flush_interval;
+        Bool s3_enable;
+        String s3_address;
+        Integer s3_port;
+        String s3_access_key;
+        String s3_secret_key;
+        String s3_bucket;
+        String s3_cache_path;
+        Integer s3_cache_capacity;
     } storage;
 
     struct Cache {
         Integer cache_size;
         Floating cpu_cache_threshold;
         Integer insert_buffer_size;
+        Integer merge_buffer_size;
         Bool cache_insert_data;
         String preload_collection;
         Integer max_concurrent_insert_request_size;
@@ -106,6 +115,12 @@ struct ServerConfig {
         Integer search_combine_nq;
         Integer use_blas_threshold;
         Integer omp_thread_num;
+        Integer executor_num;
+        Integer loader_num;
+        Integer prefetch_num;
+        Integer builder_num;
+        Integer snapshot_warmup_num;
+        Integer operation_executor_num;
         Integer clustering_type;
         Integer simd_type;
         Bool stat_optimizer_enable;
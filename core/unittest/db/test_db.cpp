@@ -14,9 +14,12 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
 #include <experimental/filesystem>
 #include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 #include "cache/CpuCacheMgr.h"
 #include "db/SnapshotUtils.h"
@@ -27,7 +30,9 @@
 #include "db/snapshot/IterateHandler.h"
 #include "db/snapshot/InActiveResourcesGCEvent.h"
 #include "db/snapshot/ResourceHelper.h"
+#include "db/IndexBuildTracker.h"
 #include "db/SegmentTaskTracker.h"
+#include "db/engine/SearchStrategy.h"
 #include "db/utils.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #include "segment/Segment.h"
@@ -87,7 +92,8 @@ CreateCollection2(std::shared_ptr<DB> db, const std::string& collection_name, bo
 }
 
 milvus::Status
-CreateCollection3(std::shared_ptr<DB> db, const std::string& collection_name, const LSN_TYPE& lsn) {
+CreateCollection3(std::shared_ptr<DB> db, const std::string& collection_name, const LSN_TYPE& lsn,
+                  milvus::engine::DataType vector_type = milvus::engine::DataType::VECTOR_FLOAT) {
     CreateCollectionContext context;
     context.lsn = lsn;
     auto collection_schema = std::make_shared<Collection>(collection_name);
@@ -95,7 +101,7 @@ CreateCollection3(std::shared_ptr<DB> db, const std::string& collection_name, co
 
     milvus::json params;
     params[milvus::knowhere::meta::DIM] = COLLECTION_DIM;
-    auto vector_field = std::make_shared<Field>("float_vector", 0, milvus::engine::DataType::VECTOR_FLOAT, params);
+    auto vector_field = std::make_shared<Field>("float_vector", 0, vector_type, params);
     context.fields_schema[vector_field] = {};
 
     std::unordered_map<std::string, milvus::engine::DataType> attr_type = {
@@ -509,6 +515,331 @@ TEST_F(DBTest, QueryTest) {
     ASSERT_EQ(result->row_num_, nq);
 }
 
+TEST_F(DBTest, QueryUnflushedTest) {
+    std::string collection_name = "test_collection_query_unflushed";
+    auto status = CreateCollection3(db_, collection_name, 0);
+    ASSERT_TRUE(status.ok());
+
+    // insert entities without flush
+    const uint64_t entity_count = 1000;
+    milvus::engine::DataChunkPtr data_chunk;
+    BuildEntities2(entity_count, 0, data_chunk);
+    std::vector<uint8_t> first_vector(sizeof(float) * COLLECTION_DIM);
+    memcpy(first_vector.data(), data_chunk->fixed_fields_["float_vector"]->data_.data(),
+           sizeof(float) * COLLECTION_DIM);
+    status = db_->Insert(collection_name, "", data_chunk);
+    ASSERT_TRUE(status.ok());
+
+    milvus::engine::IDNumbers entity_ids;
+    milvus::engine::utils::GetIDFromChunk(data_chunk, entity_ids);
+    ASSERT_EQ(entity_ids.size(), entity_count);
+
+    auto query = [&](milvus::engine::QueryResultPtr& result) {
+        milvus::server::ContextPtr ctx1;
+        milvus::query::QueryPtr query_ptr = std::make_shared<milvus::query::Query>();
+        result = std::make_shared<milvus::engine::QueryResult>();
+
+        std::vector<std::string> field_names;
+        std::vector<std::string> partitions;
+        BuildQueryPtr(collection_name, 1, 10, field_names, partitions, query_ptr);
+        auto& records = query_ptr->vectors["placeholder_1"]->query_vector;
+        records.float_data.clear();
+        records.float_data.resize(1 * COLLECTION_DIM);
+        memcpy(records.float_data.data(), first_vector.data(), sizeof(float) * COLLECTION_DIM);
+        return db_->Query(ctx1, query_ptr, result);
+    };
+
+    // unflushed entities are searchable
+    milvus::engine::QueryResultPtr result;
+    status = query(result);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(result->row_num_, 1);
+    ASSERT_EQ(result->result_ids_[0], entity_ids[0]);
+
+    std::vector<bool> valid_row;
+    milvus::engine::DataChunkPtr entity_data_chunk;
+    status = db_->GetEntityByID(collection_name, {entity_ids[0], entity_ids[1]}, {"float_vector"}, valid_row,
+                                entity_data_chunk);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(entity_data_chunk->count_, 2);
+    ASSERT_TRUE(valid_row[0]);
+    ASSERT_TRUE(valid_row[1]);
+
+    // entities deleted in buffer are invisible
+    status = db_->DeleteEntityByID(collection_name, {entity_ids[0]});
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    status = query(result);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_NE(result->result_ids_[0], entity_ids[0]);
+
+    status = db_->GetEntityByID(collection_name, {entity_ids[0]}, {"float_vector"}, valid_row, entity_data_chunk);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(entity_data_chunk->count_, 0);
+    ASSERT_FALSE(valid_row[0]);
+
+    // no duplicated result after flush
+    status = db_->Flush(collection_name);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    status = query(result);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    std::set<milvus::engine::idx_t> id_set;
+    for (auto id : result->result_ids_) {
+        if (id >= 0) {
+            ASSERT_TRUE(id_set.insert(id).second);
+        }
+    }
+}
+
+TEST_F(DBTest, QueryPendingDeleteTest) {
+    std::string collection_name = "test_collection_query_pending_delete";
+    auto status = CreateCollection3(db_, collection_name, 0);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    const int64_t entity_count = 1000;
+    milvus::engine::DataChunkPtr data_chunk;
+    BuildEntities2(entity_count, 0, data_chunk);
+    std::vector<float> vectors(entity_count * COLLECTION_DIM);
+    memcpy(vectors.data(), data_chunk->fixed_fields_["float_vector"]->data_.data(), vectors.size() * sizeof(float));
+    status = db_->Insert(collection_name, "", data_chunk);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    milvus::engine::IDNumbers entity_ids;
+    milvus::engine::utils::GetIDFromChunk(data_chunk, entity_ids);
+    ASSERT_EQ(entity_ids.size(), static_cast<size_t>(entity_count));
+
+    status = db_->Flush(collection_name);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    // the int64 field of the i-th entity is i, all entities pass the filter
+    const int64_t topk = 10;
+    auto query = [&](int64_t target, milvus::engine::QueryResultPtr& result) {
+        milvus::server::ContextPtr ctx1;
+        milvus::query::QueryPtr query_ptr = std::make_shared<milvus::query::Query>();
+        result = std::make_shared<milvus::engine::QueryResult>();
+
+        std::vector<std::string> field_names;
+        std::vector<std::string> partitions;
+        BuildQueryPtr(collection_name, 1, topk, field_names, partitions, query_ptr);
+        std::vector<int64_t> term_value(entity_count);
+        for (int64_t i = 0; i < entity_count; i++) {
+            term_value[i] = i;
+        }
+        query_ptr->root->bin->left_query->leaf->term_query->json_obj = {{"int64", {{"values", term_value}}}};
+
+        auto& records = query_ptr->vectors["placeholder_1"]->query_vector;
+        records.float_data.assign(vectors.begin() + target * COLLECTION_DIM,
+                                  vectors.begin() + (target + 1) * COLLECTION_DIM);
+        return db_->Query(ctx1, query_ptr, result);
+    };
+
+    const int64_t target = 5;
+    milvus::engine::QueryResultPtr result;
+    status = query(target, result);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(result->result_ids_[0], entity_ids[target]);
+
+    // the entities of the flushed segment are deleted in buffer, they are invisible before the next flush
+    std::vector<milvus::engine::idx_t> delete_ids = {entity_ids[target], entity_ids[target + 1]};
+    status = db_->DeleteEntityByID(collection_name, delete_ids);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    auto check_deleted = [&]() {
+        status = query(target, result);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        ASSERT_EQ(result->result_ids_.size(), static_cast<size_t>(topk));
+        for (auto id : result->result_ids_) {
+            ASSERT_NE(id, entity_ids[target]);
+            ASSERT_NE(id, entity_ids[target + 1]);
+        }
+
+        std::vector<bool> valid_row;
+        milvus::engine::DataChunkPtr entity_data_chunk;
+        status = db_->GetEntityByID(collection_name, {entity_ids[target], entity_ids[target + 2]}, {"float_vector"},
+                                    valid_row, entity_data_chunk);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        ASSERT_FALSE(valid_row[0]);
+        ASSERT_TRUE(valid_row[1]);
+    };
+    check_deleted();
+
+    // same result after the deletion applied to the segment
+    status = db_->Flush(collection_name);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    check_deleted();
+}
+
+TEST_F(DBTest, FilteredSearchTest) {
+    std::string collection_name = "test_collection_filtered_search";
+    auto status = CreateCollection3(db_, collection_name, 0);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    const int64_t entity_count = 10000;
+    milvus::engine::DataChunkPtr data_chunk;
+    BuildEntities2(entity_count, 0, data_chunk);
+    std::vector<float> vectors(entity_count * COLLECTION_DIM);
+    memcpy(vectors.data(), data_chunk->fixed_fields_["float_vector"]->data_.data(), vectors.size() * sizeof(float));
+    status = db_->Insert(collection_name, "", data_chunk);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    milvus::engine::IDNumbers entity_ids;
+    milvus::engine::utils::GetIDFromChunk(data_chunk, entity_ids);
+    ASSERT_EQ(entity_ids.size(), static_cast<size_t>(entity_count));
+
+    status = db_->Flush(collection_name);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    // the filter decides the search strategy of graph index
+    milvus::engine::CollectionIndex index;
+    index.index_name_ = "hnsw_index";
+    index.index_type_ = milvus::knowhere::IndexEnum::INDEX_HNSW;
+    index.metric_name_ = milvus::knowhere::Metric::L2;
+    index.extra_params_ = {{"M", 16}, {"efConstruction", 200}};
+    status = db_->CreateIndex(dummy_context_, collection_name, "float_vector", index);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    // the int64 field of the i-th entity is i, the term query keeps the first pass_count entities
+    const int64_t topk = 10;
+    auto query = [&](int64_t pass_count, int64_t target, milvus::engine::QueryResultPtr& result) {
+        milvus::server::ContextPtr ctx1;
+        milvus::query::QueryPtr query_ptr = std::make_shared<milvus::query::Query>();
+        result = std::make_shared<milvus::engine::QueryResult>();
+
+        std::vector<std::string> field_names;
+        std::vector<std::string> partitions;
+        BuildQueryPtr(collection_name, 1, topk, field_names, partitions, query_ptr);
+        std::vector<int64_t> term_value(pass_count);
+        for (int64_t i = 0; i < pass_count; i++) {
+            term_value[i] = i;
+        }
+        query_ptr->root->bin->left_query->leaf->term_query->json_obj = {{"int64", {{"values", term_value}}}};
+
+        auto& vector_query = query_ptr->vectors["placeholder_1"];
+        vector_query->extra_params = {{"ef", 64}};
+        auto& records = vector_query->query_vector;
+        records.float_data.assign(vectors.begin() + target * COLLECTION_DIM,
+                                  vectors.begin() + (target + 1) * COLLECTION_DIM);
+        return db_->Query(ctx1, query_ptr, result);
+    };
+
+    auto check_result = [&](int64_t pass_count, int64_t target, const milvus::engine::QueryResultPtr& result) {
+        ASSERT_EQ(result->row_num_, 1);
+        ASSERT_EQ(result->result_ids_.size(), static_cast<size_t>(topk));
+        ASSERT_EQ(result->result_ids_[0], entity_ids[target]);
+        std::set<milvus::engine::idx_t> pass_ids(entity_ids.begin(), entity_ids.begin() + pass_count);
+        std::set<milvus::engine::idx_t> id_set;
+        for (auto id : result->result_ids_) {
+            ASSERT_TRUE(pass_ids.find(id) != pass_ids.end()) << "id " << id << " doesn't pass the filter";
+            ASSERT_TRUE(id_set.insert(id).second);
+        }
+    };
+
+    // few entities pass the filter, the rows are gathered and searched by brute force, the result is exact
+    {
+        const int64_t pass_count = 20, target = 7;
+        std::vector<std::pair<float, milvus::engine::idx_t>> expect;
+        for (int64_t i = 0; i < pass_count; i++) {
+            float dis = 0;
+            for (int64_t j = 0; j < COLLECTION_DIM; j++) {
+                float diff = vectors[i * COLLECTION_DIM + j] - vectors[target * COLLECTION_DIM + j];
+                dis += diff * diff;
+            }
+            expect.emplace_back(dis, entity_ids[i]);
+        }
+        std::sort(expect.begin(), expect.end());
+
+        milvus::engine::QueryResultPtr result;
+        status = query(pass_count, target, result);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        check_result(pass_count, target, result);
+        for (int64_t i = 0; i < topk; i++) {
+            ASSERT_EQ(result->result_ids_[i], expect[i].second);
+        }
+    }
+
+    // most entities pass the filter, the index is searched for more results and the filtered ones are dropped
+    {
+        const int64_t pass_count = 9000;
+        for (int64_t target : {0, 4321, 8999}) {
+            milvus::engine::QueryResultPtr result;
+            status = query(pass_count, target, result);
+            ASSERT_TRUE(status.ok()) << status.ToString();
+            check_result(pass_count, target, result);
+        }
+    }
+}
+
+TEST_F(DBTest, HalfFloatVectorTest) {
+    auto check = [&](milvus::engine::DataType vector_type, float precision) {
+        std::string collection_name = "test_collection_half_float_" + std::to_string(static_cast<int>(vector_type));
+        auto status = CreateCollection3(db_, collection_name, 0, vector_type);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+
+        // vectors are inserted as float
+        const uint64_t entity_count = 1000;
+        milvus::engine::DataChunkPtr data_chunk;
+        BuildEntities2(entity_count, 0, data_chunk);
+        std::vector<float> vectors(entity_count * COLLECTION_DIM);
+        memcpy(vectors.data(), data_chunk->fixed_fields_["float_vector"]->data_.data(),
+               vectors.size() * sizeof(float));
+        status = db_->Insert(collection_name, "", data_chunk);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+
+        milvus::engine::IDNumbers entity_ids;
+        milvus::engine::utils::GetIDFromChunk(data_chunk, entity_ids);
+        ASSERT_EQ(entity_ids.size(), entity_count);
+
+        auto query = [&]() {
+            milvus::server::ContextPtr ctx1;
+            milvus::query::QueryPtr query_ptr = std::make_shared<milvus::query::Query>();
+            auto result = std::make_shared<milvus::engine::QueryResult>();
+
+            std::vector<std::string> field_names;
+            std::vector<std::string> partitions;
+            BuildQueryPtr(collection_name, 1, 10, field_names, partitions, query_ptr);
+            auto& records = query_ptr->vectors["placeholder_1"]->query_vector;
+            records.float_data.assign(vectors.begin(), vectors.begin() + COLLECTION_DIM);
+            status = db_->Query(ctx1, query_ptr, result);
+            ASSERT_TRUE(status.ok()) << status.ToString();
+            ASSERT_EQ(result->row_num_, 1);
+            ASSERT_EQ(result->result_ids_[0], entity_ids[0]);
+        };
+
+        // vectors are returned as float, rounded to the precision of the storage type
+        auto get_entities = [&]() {
+            std::vector<bool> valid_row;
+            milvus::engine::DataChunkPtr entity_chunk;
+            status = db_->GetEntityByID(collection_name, entity_ids, {"float_vector"}, valid_row, entity_chunk);
+            ASSERT_TRUE(status.ok()) << status.ToString();
+            auto& data = entity_chunk->fixed_fields_["float_vector"];
+            ASSERT_EQ(data->Size(), vectors.size() * sizeof(float));
+            auto values = reinterpret_cast<const float*>(data->data_.data());
+            for (size_t i = 0; i < vectors.size(); ++i) {
+                ASSERT_NEAR(values[i], vectors[i], std::fabs(vectors[i]) * precision + 1e-6);
+            }
+        };
+
+        // buffered entities
+        query();
+        get_entities();
+
+        // flushed entities, the raw data is stored in 16 bits
+        status = db_->Flush(collection_name);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        query();
+        get_entities();
+
+        int64_t row_count = 0;
+        status = db_->CountEntities(collection_name, row_count);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        ASSERT_EQ(row_count, entity_count);
+    };
+
+    check(milvus::engine::DataType::VECTOR_FLOAT16, 1.0f / 1024);
+    check(milvus::engine::DataType::VECTOR_BFLOAT16, 1.0f / 128);
+}
+
 TEST_F(DBTest, InsertTest) {
     auto do_insert = [&](bool autogen_id, bool provide_id) -> void {
         CreateCollectionContext context;
@@ -1638,6 +1969,104 @@ TEST_F(DBTest, LoadTest) {
     ASSERT_GE(cache_mgr.CacheUsage(), total_size);
 }
 
+namespace {
+class MockCacheObj : public milvus::cache::DataObj {
+ public:
+    explicit MockCacheObj(int64_t size) : size_(size) {
+    }
+
+    int64_t
+    Size() override {
+        return size_;
+    }
+
+ private:
+    int64_t size_;
+};
+}  // namespace
+
+TEST(CacheTest, ScanResistantTest) {
+    const int64_t item_size = 1024;
+    milvus::cache::Cache<milvus::cache::DataObjPtr> cache(100 * item_size, 1UL << 32, "[CACHE TEST]", 4);
+
+    // hot items are hit after insert, they are promoted into protected list
+    for (int64_t i = 0; i < 20; ++i) {
+        std::string key = "hot_" + std::to_string(i);
+        cache.insert(key, std::make_shared<MockCacheObj>(item_size));
+        ASSERT_NE(cache.get(key), nullptr);
+    }
+
+    // a scan of items only accessed once can't flush the hot items
+    for (int64_t i = 0; i < 1000; ++i) {
+        cache.insert("scan_" + std::to_string(i), std::make_shared<MockCacheObj>(item_size));
+        ASSERT_LE(cache.usage(), cache.capacity());
+    }
+    for (int64_t i = 0; i < 20; ++i) {
+        ASSERT_TRUE(cache.exists("hot_" + std::to_string(i)));
+    }
+    ASSERT_EQ(cache.get("scan_0"), nullptr);
+
+    int64_t hits = 0, misses = 0, evictions = 0, count = 0, usage = 0;
+    auto stats_array = cache.shard_stats();
+    ASSERT_EQ(stats_array.size(), 4);
+    for (auto& stats : stats_array) {
+        hits += stats.hits_;
+        misses += stats.misses_;
+        evictions += stats.evictions_;
+        count += stats.item_count_;
+        usage += stats.usage_;
+    }
+    ASSERT_EQ(hits, 20);
+    ASSERT_EQ(misses, 1);
+    ASSERT_GT(evictions, 0);
+    ASSERT_EQ(count, cache.size());
+    ASSERT_EQ(usage, cache.usage());
+
+    // re-insert an existing key doesn't change the usage
+    int64_t old_usage = cache.usage();
+    cache.insert("hot_0", std::make_shared<MockCacheObj>(item_size));
+    ASSERT_EQ(cache.usage(), old_usage);
+
+    cache.erase("hot_0");
+    ASSERT_FALSE(cache.exists("hot_0"));
+    ASSERT_EQ(cache.usage(), old_usage - item_size);
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.usage(), 0);
+}
+
+TEST(CacheTest, ProtectedLimitTest) {
+    const int64_t item_size = 1024;
+    const int64_t shard_num = 4;
+    milvus::cache::Cache<milvus::cache::DataObjPtr> cache(100 * item_size, 1UL << 32, "[CACHE TEST]", shard_num);
+    cache.set_protected_percent(0.4);
+
+    // every item is hit, keys are unevenly hashed, no shard protects more than its share of the limit
+    for (int64_t i = 0; i < 80; ++i) {
+        std::string key = "hot_" + std::to_string(i);
+        cache.insert(key, std::make_shared<MockCacheObj>(item_size));
+        ASSERT_NE(cache.get(key), nullptr);
+    }
+    const int64_t shard_limit = 100 * item_size * 0.4 / shard_num;
+    int64_t protected_usage = 0;
+    for (auto& stats : cache.shard_stats()) {
+        ASSERT_LE(stats.protected_usage_, shard_limit);
+        protected_usage += stats.protected_usage_;
+    }
+    ASSERT_GT(protected_usage, 0);
+
+    // a re-inserted protected item stays protected, it survives a scan
+    cache.clear();
+    cache.insert("hot", std::make_shared<MockCacheObj>(item_size));
+    ASSERT_NE(cache.get("hot"), nullptr);
+    cache.insert("hot", std::make_shared<MockCacheObj>(item_size));
+    for (int64_t i = 0; i < 1000; ++i) {
+        cache.insert("scan_" + std::to_string(i), std::make_shared<MockCacheObj>(item_size));
+    }
+    ASSERT_TRUE(cache.exists("hot"));
+}
+
 TEST(SegmentTaskTrackerTest, TrackerTest) {
     std::string collection_name = "tracker";
 
@@ -1694,3 +2123,104 @@ TEST(SegmentTaskTrackerTest, TrackerTest) {
         ASSERT_EQ(segment_ids[0], 4);
     }
 }
+
+TEST(IndexBuildTrackerTest, TrackerTest) {
+    std::string collection_name = "tracker";
+    milvus::engine::IndexBuildTracker tracker;
+
+    milvus::json progress;
+    ASSERT_FALSE(tracker.GetProgress(collection_name, progress));
+
+    // larger segments first, a searched segment is hotter
+    std::unordered_map<int64_t, int64_t> segment_rows = {{1, 1000}, {2, 3000}, {3, 2000}};
+    std::vector<int64_t> segment_ids = {1, 2, 3};
+    tracker.SortByPriority(collection_name, segment_rows, segment_ids);
+    ASSERT_EQ(segment_ids, std::vector<int64_t>({2, 3, 1}));
+
+    for (int64_t i = 0; i < 3; ++i) {
+        tracker.MarkSearched(collection_name, {1});
+    }
+    tracker.SortByPriority(collection_name, segment_rows, segment_ids);
+    ASSERT_EQ(segment_ids, std::vector<int64_t>({1, 2, 3}));
+
+    // searches of another collection are recorded apart, even from many threads
+    std::vector<std::thread> threads;
+    for (int64_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&tracker]() {
+            for (int64_t k = 0; k < 100; ++k) {
+                tracker.MarkSearched("other", {3});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    tracker.SortByPriority(collection_name, segment_rows, segment_ids);
+    ASSERT_EQ(segment_ids, std::vector<int64_t>({1, 2, 3}));
+    std::vector<int64_t> other_ids = {1, 2, 3};
+    tracker.SortByPriority("other", segment_rows, other_ids);
+    ASSERT_EQ(other_ids, std::vector<int64_t>({3, 2, 1}));
+
+    tracker.BeginBuild(collection_name, 3, 6000);
+    ASSERT_TRUE(tracker.GetProgress(collection_name, progress));
+    ASSERT_TRUE(progress["building"].get<bool>());
+    ASSERT_EQ(progress["pending_rows"].get<int64_t>(), 6000);
+    ASSERT_EQ(progress["eta_seconds"].get<int64_t>(), -1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    tracker.FinishBuild(collection_name, {1, 2}, 4000);
+    ASSERT_TRUE(tracker.GetProgress(collection_name, progress));
+    ASSERT_EQ(progress["pending_segments"].get<int64_t>(), 1);
+    ASSERT_EQ(progress["pending_rows"].get<int64_t>(), 2000);
+    ASSERT_EQ(progress["built_segments"].get<int64_t>(), 2);
+    ASSERT_GT(progress["rows_per_second"].get<double>(), 0);
+    ASSERT_GE(progress["eta_seconds"].get<int64_t>(), 0);
+
+    // the built segment is not hot any more
+    segment_ids = {1, 3};
+    tracker.SortByPriority(collection_name, segment_rows, segment_ids);
+    ASSERT_EQ(segment_ids, std::vector<int64_t>({3, 1}));
+
+    tracker.EndBuild(collection_name);
+    ASSERT_TRUE(tracker.GetProgress(collection_name, progress));
+    ASSERT_FALSE(progress["building"].get<bool>());
+    ASSERT_EQ(progress["eta_seconds"].get<int64_t>(), 0);
+
+    tracker.ClearRecords(collection_name);
+    ASSERT_FALSE(tracker.GetProgress(collection_name, progress));
+}
+
+TEST(SearchStrategyTest, ChooseTest) {
+    using milvus::engine::SearchStrategy;
+    using milvus::engine::ChooseSearchStrategy;
+    const int64_t row_count = 1000000, topk = 10;
+
+    // nothing filtered, or too few rows left
+    auto ivf = milvus::knowhere::IndexEnum::INDEX_FAISS_IVFFLAT;
+    ASSERT_EQ(ChooseSearchStrategy(ivf, row_count, row_count, topk, row_count, true), SearchStrategy::ANN_BITSET);
+    ASSERT_EQ(ChooseSearchStrategy(ivf, row_count, 5, topk, 8000, false), SearchStrategy::BRUTE_FORCE);
+
+    // ivf scans nlist + rows * nprobe / nlist rows whatever the filter is
+    ASSERT_EQ(ChooseSearchStrategy(ivf, row_count, 50, topk, 8000, false), SearchStrategy::BRUTE_FORCE);
+    ASSERT_EQ(ChooseSearchStrategy(ivf, row_count, 500000, topk, 8000, true), SearchStrategy::ANN_BITSET);
+
+    // gathering rows which are not cached reads them from storage
+    ASSERT_EQ(ChooseSearchStrategy(ivf, row_count, 1000, topk, 8000, true), SearchStrategy::BRUTE_FORCE);
+    ASSERT_EQ(ChooseSearchStrategy(ivf, row_count, 1000, topk, 8000, false), SearchStrategy::ANN_BITSET);
+
+    // flat index never gathers rows
+    auto flat = milvus::knowhere::IndexEnum::INDEX_FAISS_IDMAP;
+    ASSERT_EQ(ChooseSearchStrategy(flat, row_count, 5, topk, row_count, true), SearchStrategy::ANN_BITSET);
+    ASSERT_EQ(ChooseSearchStrategy(flat, row_count, 400000, topk, row_count, true), SearchStrategy::ANN_BITSET);
+
+    // graph search walks further when the filter is selective
+    auto hnsw = milvus::knowhere::IndexEnum::INDEX_HNSW;
+    ASSERT_EQ(ChooseSearchStrategy(hnsw, row_count, 10000, topk, 2048, true), SearchStrategy::BRUTE_FORCE);
+    ASSERT_EQ(ChooseSearchStrategy(hnsw, row_count, 10000, topk, 2048, false), SearchStrategy::ANN_BITSET);
+    ASSERT_EQ(ChooseSearchStrategy(hnsw, row_count, 300000, topk, 2048, true), SearchStrategy::ANN_BITSET);
+    ASSERT_EQ(ChooseSearchStrategy(hnsw, row_count, 950000, topk, 2048, false), SearchStrategy::ANN_POST_FILTER);
+
+    ASSERT_EQ(milvus::engine::PostFilterTopk(row_count, 950000, topk), 13);
+    ASSERT_EQ(milvus::engine::PostFilterTopk(100, 1, topk), 100);
+    ASSERT_EQ(milvus::engine::PostFilterTopk(100, 0, topk), topk);
+}
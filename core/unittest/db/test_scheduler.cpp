@@ -0,0 +1,87 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "scheduler/TaskTable.h"
+#include "scheduler/job/SearchJob.h"
+#include "scheduler/task/TestTask.h"
+
+TEST(SchedulerTest, TASK_TABLE_PICK_TO_LOAD_PREFETCH) {
+    milvus::scheduler::TaskTable table;
+    auto task = std::make_shared<milvus::scheduler::TestTask>();
+
+    const size_t NUM_TASKS = 10;
+    for (size_t i = 0; i < NUM_TASKS; ++i) {
+        table.Put(task);
+    }
+    table[0]->state = milvus::scheduler::TaskTableItemState::LOADED;
+
+    // default prefetch one task
+    auto indexes = table.PickToLoad(3);
+    ASSERT_TRUE(indexes.empty());
+
+    // loading goes on until prefetch number of tasks are loaded
+    table.SetPrefetchNum(2);
+    indexes = table.PickToLoad(3);
+    ASSERT_EQ(indexes.size(), 3);
+    ASSERT_EQ(indexes[0] % table.capacity(), 1);
+
+    table[1]->state = milvus::scheduler::TaskTableItemState::LOADED;
+    indexes = table.PickToLoad(3);
+    ASSERT_TRUE(indexes.empty());
+}
+
+TEST(SchedulerTest, SEARCH_JOB_REDUCE_TOPK) {
+    const size_t nq = 100, topk = 10;
+
+    // task i returns ids i, i + 4, i + 8 ... with distances equal to the ids, the last task has no result
+    std::vector<milvus::scheduler::SearchTaskResult> results(5);
+    for (size_t i = 0; i < 4; ++i) {
+        auto& result = results[i];
+        result.k_ = (i == 3) ? 2 : topk;  // a small segment
+        result.ids_.resize(nq * topk, -1);
+        result.distances_.resize(nq * topk, 0.0);
+        for (size_t q = 0; q < nq; ++q) {
+            for (int64_t k = 0; k < result.k_; ++k) {
+                result.ids_[q * topk + k] = q + i + k * 4;
+                result.distances_[q * topk + k] = q + i + k * 4;
+            }
+        }
+    }
+
+    milvus::engine::ResultIds ids;
+    milvus::engine::ResultDistances distances;
+    milvus::scheduler::SearchJob::ReduceTopk(results, nq, topk, true, ids, distances);
+    ASSERT_EQ(ids.size(), nq * topk);
+    for (size_t q = 0; q < nq; ++q) {
+        for (size_t k = 0; k < topk; ++k) {
+            ASSERT_EQ(ids[q * topk + k], q + k);
+            ASSERT_FLOAT_EQ(distances[q * topk + k], q + k);
+        }
+    }
+
+    // descending, similarity is the negative id
+    for (auto& result : results) {
+        for (auto& distance : result.distances_) {
+            distance = -distance;
+        }
+    }
+    milvus::scheduler::SearchJob::ReduceTopk(results, nq, topk, false, ids, distances);
+    for (size_t q = 0; q < nq; ++q) {
+        for (size_t k = 0; k < topk; ++k) {
+            ASSERT_EQ(ids[q * topk + k], q + k);
+        }
+    }
+}
@@ -0,0 +1,161 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics/SearchMetrics.h"
+
+namespace {
+
+using milvus::SearchMetrics;
+using milvus::SearchStage;
+
+std::string
+LabelValue(const prometheus::ClientMetric& metric, const std::string& name) {
+    for (auto& label : metric.label) {
+        if (label.name == name) {
+            return label.value;
+        }
+    }
+    return "";
+}
+
+// the series of a collection, the metrics singleton is shared by all tests
+std::vector<prometheus::ClientMetric>
+CollectSeries(const std::string& collection) {
+    std::vector<prometheus::ClientMetric> series;
+    auto families = SearchMetrics::GetInstance().Collect();
+    for (auto& family : families) {
+        EXPECT_EQ(family.name, "milvus_search_stage_latency_seconds");
+        EXPECT_EQ(family.type, prometheus::MetricType::Histogram);
+        for (auto& metric : family.metric) {
+            if (LabelValue(metric, "collection") == collection) {
+                series.push_back(metric);
+            }
+        }
+    }
+    return series;
+}
+
+}  // namespace
+
+TEST(SearchMetricsTest, MERGE_THREAD_BUFFERS) {
+    std::string collection = "metrics_merge";
+    auto& metrics = SearchMetrics::GetInstance();
+
+    // the threads are alive while collecting, their buffers are merged
+    const int64_t thread_num = 4, observe_num = 100;
+    std::mutex mutex;
+    std::condition_variable cv;
+    int64_t observed = 0;
+    bool collected = false;
+    std::vector<std::thread> threads;
+    for (int64_t i = 0; i < thread_num; ++i) {
+        threads.emplace_back([&]() {
+            for (int64_t k = 0; k < observe_num; ++k) {
+                metrics.Observe(SearchStage::VECTOR_SEARCH, collection, "IVF_FLAT", 10);
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            ++observed;
+            cv.notify_all();
+            cv.wait(lock, [&]() { return collected; });
+        });
+    }
+
+    std::vector<prometheus::ClientMetric> series;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return observed == thread_num; });
+        series = CollectSeries(collection);
+        collected = true;
+        cv.notify_all();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(series.size(), 1);
+    ASSERT_EQ(series[0].histogram.sample_count, thread_num * observe_num);
+    ASSERT_DOUBLE_EQ(series[0].histogram.sample_sum, thread_num * observe_num * 10 / 1e6);
+}
+
+TEST(SearchMetricsTest, RETIRE_THREAD_BUFFERS) {
+    std::string collection = "metrics_retire";
+    auto& metrics = SearchMetrics::GetInstance();
+
+    // the data of exited threads is kept
+    for (int64_t round = 1; round <= 3; ++round) {
+        std::thread thread([&]() { metrics.Observe(SearchStage::LOAD, collection, "", 1000); });
+        thread.join();
+
+        auto series = CollectSeries(collection);
+        ASSERT_EQ(series.size(), 1);
+        ASSERT_EQ(series[0].histogram.sample_count, round);
+    }
+
+    // data of alive and exited threads are merged into one series
+    metrics.Observe(SearchStage::LOAD, collection, "", 1000);
+    auto series = CollectSeries(collection);
+    ASSERT_EQ(series.size(), 1);
+    ASSERT_EQ(series[0].histogram.sample_count, 4);
+
+    // a dropped collection leaves no series behind
+    metrics.RemoveCollection(collection);
+    ASSERT_TRUE(CollectSeries(collection).empty());
+}
+
+TEST(SearchMetricsTest, COLLECT_OUTPUT) {
+    std::string collection = "metrics_collect";
+    auto& metrics = SearchMetrics::GetInstance();
+    metrics.Observe(SearchStage::SCHEDULER_WAIT, collection, "HNSW", 50);
+    metrics.Observe(SearchStage::SCHEDULER_WAIT, collection, "HNSW", 70);
+    metrics.Observe(SearchStage::SCHEDULER_WAIT, collection, "HNSW", 20000000);
+    metrics.Observe(SearchStage::REDUCE, collection, "", 300);
+    metrics.Observe(SearchStage::REQUEST_QUEUE, collection, "", 400);
+
+    auto series = CollectSeries(collection);
+    ASSERT_EQ(series.size(), 3);
+    for (auto& metric : series) {
+        auto stage = LabelValue(metric, "stage");
+        auto& histogram = metric.histogram;
+        ASSERT_FALSE(histogram.bucket.empty());
+        ASSERT_TRUE(std::isinf(histogram.bucket.back().upper_bound));
+        ASSERT_EQ(histogram.bucket.back().cumulative_count, histogram.sample_count);
+        for (size_t i = 1; i < histogram.bucket.size(); ++i) {
+            ASSERT_LT(histogram.bucket[i - 1].upper_bound, histogram.bucket[i].upper_bound);
+            ASSERT_LE(histogram.bucket[i - 1].cumulative_count, histogram.bucket[i].cumulative_count);
+        }
+
+        if (stage == "scheduler_wait") {
+            ASSERT_EQ(LabelValue(metric, "index_type"), "HNSW");
+            ASSERT_EQ(histogram.sample_count, 3);
+            ASSERT_DOUBLE_EQ(histogram.sample_sum, (50 + 70 + 20000000) / 1e6);
+            // 50us is on the first bound, 70us in the second bucket, 20s only in +Inf
+            ASSERT_DOUBLE_EQ(histogram.bucket[0].upper_bound, 50 / 1e6);
+            ASSERT_EQ(histogram.bucket[0].cumulative_count, 1);
+            ASSERT_EQ(histogram.bucket[1].cumulative_count, 2);
+            ASSERT_EQ(histogram.bucket[histogram.bucket.size() - 2].cumulative_count, 2);
+        } else {
+            ASSERT_TRUE(stage == "reduce" || stage == "request_queue") << stage;
+            ASSERT_EQ(LabelValue(metric, "index_type"), "");
+            ASSERT_EQ(histogram.sample_count, 1);
+        }
+    }
+
+    metrics.RemoveCollection(collection);
+}
@@ -13,11 +13,13 @@
 #include <fiu/fiu-local.h>
 #include <gtest/gtest.h>
 
+#include <fstream>
 #include <random>
 #include <string>
 #include <experimental/filesystem>
 
 #include "codecs/Codec.h"
+#include "codecs/ExtraFileInfo.h"
 #include "db/IDGenerator.h"
 #include "db/utils.h"
 #include "db/SnapshotVisitor.h"
@@ -29,6 +31,7 @@
 #include "segment/SegmentReader.h"
 #include "segment/SegmentWriter.h"
 #include "segment/IdBloomFilter.h"
+#include "segment/IdIndex.h"
 #include "segment/Utils.h"
 #include "storage/disk/DiskIOReader.h"
 #include "storage/disk/DiskIOWriter.h"
@@ -341,6 +344,182 @@ TEST(BloomFilterTest, CloneTest) {
     error_rate_check(clone_filter, removed_id_array);
 }
 
+TEST(IdIndexTest, ReadWriteTest) {
+    std::string file_path = "/tmp/milvus_id_index";
+
+    milvus::storage::IOReaderPtr reader_ptr = std::make_shared<milvus::storage::DiskIOReader>();
+    milvus::storage::IOWriterPtr writer_ptr = std::make_shared<milvus::storage::DiskIOWriter>();
+    milvus::storage::OperationPtr operation_ptr = nullptr;
+    auto fs_ptr = std::make_shared<milvus::storage::FSHandler>(reader_ptr, writer_ptr, operation_ptr);
+
+    // unordered ids, the id 1000 is duplicated
+    const int64_t id_count = 10000;
+    std::vector<int64_t> id_array;
+    for (int64_t i = 0; i < id_count; ++i) {
+        id_array.push_back((i * 7919) % id_count * 2);
+    }
+    id_array.push_back(1000);
+
+    auto check_index = [&](const milvus::segment::IdIndexPtr& index) -> void {
+        ASSERT_EQ(index->GetCount(), id_array.size());
+        for (int64_t i = 0; i < id_count; ++i) {
+            milvus::engine::offset_t offset = -1;
+            ASSERT_TRUE(index->Find(id_array[i], offset));
+            ASSERT_EQ(id_array[offset], id_array[i]);
+        }
+
+        milvus::engine::offset_t offset = -1;
+        ASSERT_FALSE(index->Find(1, offset));
+        ASSERT_FALSE(index->Find(-1, offset));
+        ASSERT_FALSE(index->Find(id_count * 2, offset));
+
+        std::vector<milvus::engine::offset_t> offsets;
+        index->FindAll(1000, offsets);
+        ASSERT_EQ(offsets.size(), 2);
+        ASSERT_EQ(offsets[1], id_count);
+    };
+
+    auto id_index = std::make_shared<milvus::segment::IdIndex>(id_array.data(), id_array.size());
+    check_index(id_index);
+
+    auto& ss_codec = milvus::codec::Codec::instance();
+    auto status = ss_codec.GetIdIndexFormat()->Write(fs_ptr, file_path, id_index);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    milvus::segment::IdIndexPtr read_index;
+    status = ss_codec.GetIdIndexFormat()->Read(fs_ptr, file_path, read_index);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    check_index(read_index);
+
+    std::experimental::filesystem::remove(file_path + milvus::codec::IdIndexFormat::FilePostfix());
+}
+
+TEST(BlockFormatTest, RangedReadTest) {
+    std::string file_path = "/tmp/milvus_block_format";
+
+    milvus::storage::IOReaderPtr reader_ptr = std::make_shared<milvus::storage::DiskIOReader>();
+    milvus::storage::IOWriterPtr writer_ptr = std::make_shared<milvus::storage::DiskIOWriter>();
+    milvus::storage::OperationPtr operation_ptr = nullptr;
+    auto fs_ptr = std::make_shared<milvus::storage::FSHandler>(reader_ptr, writer_ptr, operation_ptr);
+
+    auto raw = std::make_shared<milvus::engine::BinaryData>();
+    raw->data_.resize(1000000);
+    for (size_t i = 0; i < raw->data_.size(); ++i) {
+        raw->data_[i] = static_cast<uint8_t>(i * 31 + i / 256);
+    }
+
+    milvus::codec::ReadRanges ranges;
+    ranges.emplace_back(500000, 100);
+    ranges.emplace_back(0, 10);
+    ranges.emplace_back(65530, 20);       // cross chunks
+    ranges.emplace_back(100000, 200000);  // multiple chunks
+    ranges.emplace_back(999990, 10);      // the last chunk
+
+    auto check_ranges = [&](const milvus::engine::BinaryDataPtr& read_data) -> void {
+        int64_t poz = 0;
+        for (auto& range : ranges) {
+            ASSERT_EQ(memcmp(read_data->data_.data() + poz, raw->data_.data() + range.offset_, range.num_bytes_), 0);
+            poz += range.num_bytes_;
+        }
+        ASSERT_EQ(poz, read_data->data_.size());
+    };
+
+    auto& block_format = *milvus::codec::Codec::instance().GetBlockFormat();
+    auto status = block_format.Write(fs_ptr, file_path, raw);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    milvus::engine::BinaryDataPtr read_data;
+    status = block_format.Read(fs_ptr, file_path, read_data);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(read_data->data_, raw->data_);
+
+    status = block_format.Read(fs_ptr, file_path, ranges, read_data);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    check_ranges(read_data);
+
+    status = block_format.Read(fs_ptr, file_path, 65530, 20, read_data);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(memcmp(read_data->data_.data(), raw->data_.data() + 65530, 20), 0);
+
+    milvus::codec::ReadRanges invalid_ranges = {milvus::codec::ReadRange(999990, 20)};
+    status = block_format.Read(fs_ptr, file_path, invalid_ranges, read_data);
+    ASSERT_FALSE(status.ok());
+
+    // file written by old version has no chunk sums
+    {
+        fs_ptr->writer_ptr_->Open(file_path);
+        milvus::codec::WriteMagic(fs_ptr);
+        std::unordered_map<std::string, std::string> maps = {{"size", std::to_string(raw->data_.size())}};
+        std::string header = milvus::codec::HeaderWrapper(maps);
+        milvus::codec::WriteHeaderValues(fs_ptr, header);
+        fs_ptr->writer_ptr_->Write(raw->data_.data(), raw->data_.size());
+        milvus::codec::WriteSum(fs_ptr, header, reinterpret_cast<char*>(raw->data_.data()), raw->data_.size());
+        fs_ptr->writer_ptr_->Close();
+    }
+
+    status = block_format.Read(fs_ptr, file_path, ranges, read_data);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    check_ranges(read_data);
+
+    std::experimental::filesystem::remove(file_path);
+}
+
+TEST(BlockFormatTest, StreamWriteTest) {
+    std::string file_path = "/tmp/milvus_block_format";
+    std::string stream_file_path = "/tmp/milvus_block_format_stream";
+
+    milvus::storage::IOReaderPtr reader_ptr = std::make_shared<milvus::storage::DiskIOReader>();
+    milvus::storage::IOWriterPtr writer_ptr = std::make_shared<milvus::storage::DiskIOWriter>();
+    milvus::storage::OperationPtr operation_ptr = nullptr;
+    auto fs_ptr = std::make_shared<milvus::storage::FSHandler>(reader_ptr, writer_ptr, operation_ptr);
+
+    auto raw = std::make_shared<milvus::engine::BinaryData>();
+    raw->data_.resize(300000);
+    for (size_t i = 0; i < raw->data_.size(); ++i) {
+        raw->data_[i] = static_cast<uint8_t>(i * 17 + i / 256);
+    }
+
+    auto& block_format = *milvus::codec::Codec::instance().GetBlockFormat();
+    auto status = block_format.Write(fs_ptr, file_path, raw);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    // pieces of different size, crossing chunks
+    std::vector<int64_t> piece_sizes = {10, 65526, 100000, 1, 134463};
+    size_t index = 0;
+    int64_t poz = 0;
+    auto get_piece = [&](milvus::engine::BinaryDataPtr& piece) -> milvus::Status {
+        piece = std::make_shared<milvus::engine::BinaryData>();
+        piece->data_.assign(raw->data_.begin() + poz, raw->data_.begin() + poz + piece_sizes[index]);
+        poz += piece_sizes[index++];
+        return milvus::Status::OK();
+    };
+    status = block_format.Write(fs_ptr, stream_file_path, raw->data_.size(), get_piece);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(index, piece_sizes.size());
+
+    // the file is the same as written with the whole data
+    auto read_file = [](const std::string& path) -> std::string {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    ASSERT_EQ(read_file(stream_file_path), read_file(file_path));
+
+    int64_t num_bytes = 0, chunk_size = 0;
+    status = block_format.ReadSize(fs_ptr, stream_file_path, num_bytes, chunk_size);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(num_bytes, raw->data_.size());
+    ASSERT_GT(chunk_size, 0);
+
+    // pieces exceed the size
+    index = 0;
+    poz = 0;
+    status = block_format.Write(fs_ptr, stream_file_path, 50000, get_piece);
+    ASSERT_FALSE(status.ok());
+
+    std::experimental::filesystem::remove(file_path);
+    std::experimental::filesystem::remove(stream_file_path);
+}
+
 TEST(SegmentUtilTest, CalcCopyRangeTest) {
     // invalid input test
     std::vector<int32_t> offsets;
@@ -13,12 +13,17 @@
 #include <fiu/fiu-local.h>
 #include <gtest/gtest.h>
 
-#include <string>
-#include <set>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
 
 #include "db/utils.h"
 #include "db/snapshot/HandlerFactory.h"
+#include "value/config/ServerConfig.h"
 
 Status
 GetFirstCollectionID(ID_TYPE& result_id) {
@@ -283,6 +288,125 @@ TEST_F(SnapshotTest, DropCollectionTest) {
     ASSERT_FALSE(status.ok());
 }
 
+TEST_F(SnapshotTest, LazyLoadHolderTest) {
+    // the mocked store already has some collections
+    std::vector<ID_TYPE> prev_ids;
+    ASSERT_TRUE(Snapshots::GetInstance().GetCollectionIds(prev_ids).ok());
+
+    LSN_TYPE lsn = 0;
+    std::vector<std::string> names = {"lazy_0", "lazy_1", "lazy_2"};
+    std::vector<ID_TYPE> expect_ids = prev_ids;
+    for (auto& name : names) {
+        auto ss = CreateCollection(name, ++lsn);
+        ASSERT_TRUE(ss);
+        expect_ids.push_back(ss->GetCollectionId());
+    }
+
+    // no warm-up, the holders are only loaded on first access after restart
+    auto warmup_num = milvus::config.engine.snapshot_warmup_num();
+    milvus::config.engine.snapshot_warmup_num = 0;
+    ASSERT_TRUE(Snapshots::GetInstance().Reset().ok());
+    ASSERT_TRUE(Snapshots::GetInstance().Init(store_).ok());
+
+    std::vector<ID_TYPE> ids;
+    ASSERT_TRUE(Snapshots::GetInstance().GetCollectionIds(ids).ok());
+    ASSERT_EQ(ids, expect_ids);
+    std::vector<std::string> result_names;
+    ASSERT_TRUE(Snapshots::GetInstance().GetCollectionNames(result_names).ok());
+    ASSERT_EQ(result_names.size(), prev_ids.size() + names.size());
+    for (auto& name : names) {
+        ASSERT_TRUE(std::find(result_names.begin(), result_names.end(), name) != result_names.end()) << name;
+    }
+
+    for (auto& name : names) {
+        ScopedSnapshotT ss;
+        auto status = Snapshots::GetInstance().GetSnapshot(ss, name);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        ASSERT_EQ(ss->GetName(), name);
+        int num = 0;
+        ASSERT_TRUE(Snapshots::GetInstance().NumOfSnapshot(name, num).ok());
+        ASSERT_GT(num, 0);
+    }
+
+    // loading some of them keeps the id order
+    ids.clear();
+    ASSERT_TRUE(Snapshots::GetInstance().GetCollectionIds(ids).ok());
+    ASSERT_EQ(ids, expect_ids);
+    milvus::config.engine.snapshot_warmup_num = warmup_num;
+}
+
+TEST_F(SnapshotTest, ConcurrentLoadHolderTest) {
+    LSN_TYPE lsn = 0;
+    std::string collection_name = "concurrent_load";
+    ASSERT_TRUE(CreateCollection(collection_name, ++lsn));
+
+    auto warmup_num = milvus::config.engine.snapshot_warmup_num();
+    milvus::config.engine.snapshot_warmup_num = 0;
+    ASSERT_TRUE(Snapshots::GetInstance().Reset().ok());
+    ASSERT_TRUE(Snapshots::GetInstance().Init(store_).ok());
+
+    // the threads wait for the one loading the collection, all of them get the same holder
+    const int64_t thread_num = 8;
+    std::vector<milvus::engine::snapshot::SnapshotHolderPtr> holders(thread_num);
+    std::vector<Status> statuses(thread_num);
+    std::vector<std::thread> threads;
+    for (int64_t i = 0; i < thread_num; ++i) {
+        threads.emplace_back([&, i]() {
+            statuses[i] = Snapshots::GetInstance().GetHolder(collection_name, holders[i]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int64_t i = 0; i < thread_num; ++i) {
+        ASSERT_TRUE(statuses[i].ok()) << statuses[i].ToString();
+        ASSERT_TRUE(holders[i]);
+        ASSERT_EQ(holders[i], holders[0]);
+    }
+    milvus::config.engine.snapshot_warmup_num = warmup_num;
+}
+
+TEST_F(SnapshotTest, DropDuringWarmUpTest) {
+    std::vector<std::string> prev_names;
+    ASSERT_TRUE(Snapshots::GetInstance().GetCollectionNames(prev_names).ok());
+
+    LSN_TYPE lsn = 0;
+    std::vector<std::string> names;
+    for (auto i = 0; i < 16; ++i) {
+        names.push_back("warmup_" + std::to_string(i));
+        ASSERT_TRUE(CreateCollection(names.back(), ++lsn));
+    }
+
+    auto warmup_num = milvus::config.engine.snapshot_warmup_num();
+    milvus::config.engine.snapshot_warmup_num = 4;
+    ASSERT_TRUE(Snapshots::GetInstance().Reset().ok());
+    ASSERT_TRUE(Snapshots::GetInstance().Init(store_).ok());
+
+    // drop every other collection while the warm-up threads are loading them
+    std::set<std::string> dropped;
+    for (size_t i = 0; i < names.size(); i += 2) {
+        auto status = Snapshots::GetInstance().DropCollection(names[i], ++lsn);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        dropped.insert(names[i]);
+    }
+
+    // a dropped collection never comes back once the warm-up is done
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (auto& name : names) {
+        ScopedSnapshotT ss;
+        auto status = Snapshots::GetInstance().GetSnapshot(ss, name);
+        ASSERT_EQ(status.ok(), dropped.find(name) == dropped.end()) << name;
+    }
+    std::vector<std::string> result_names;
+    ASSERT_TRUE(Snapshots::GetInstance().GetCollectionNames(result_names).ok());
+    ASSERT_EQ(result_names.size(), prev_names.size() + names.size() - dropped.size());
+    for (auto& name : result_names) {
+        ASSERT_TRUE(dropped.find(name) == dropped.end()) << name;
+    }
+
+    milvus::config.engine.snapshot_warmup_num = warmup_num;
+}
+
 /* TEST_F(SnapshotTest, ConCurrentCollectionOperation) { */
 /*     std::string collection_name("c1"); */
 /*     LSN_TYPE lsn = 1; */
@@ -623,6 +747,90 @@ TEST_F(SnapshotTest, DropSegmentTest){
 
 }
 
+template <typename ResourceT>
+void
+CheckSameResources(const ScopedSnapshotT& left, const ScopedSnapshotT& right) {
+    std::set<ID_TYPE> left_ids, right_ids;
+    for (auto& kv : left->GetResources<ResourceT>()) {
+        left_ids.insert(kv.first);
+    }
+    for (auto& kv : right->GetResources<ResourceT>()) {
+        right_ids.insert(kv.first);
+    }
+    ASSERT_EQ(left_ids, right_ids) << ResourceT::Name;
+}
+
+TEST_F(SnapshotTest, InheritSnapshotTest) {
+    LSN_TYPE lsn = 0;
+    auto collection_name = "test";
+    ScopedSnapshotT ss;
+    ss = CreateCollection(collection_name, ++lsn);
+    ASSERT_TRUE(ss);
+
+    PartitionContext pp_ctx;
+    pp_ctx.name = "partition_0";
+    ss = CreatePartition(ss->GetName(), pp_ctx, ++lsn);
+    ASSERT_TRUE(ss);
+
+    SegmentFileContext sf_context;
+    SFContextBuilder(sf_context, ss);
+    auto partitions = ss->GetResources<Partition>();
+    for (auto& kv : partitions) {
+        for (auto i = 0; i < 3; ++i) {
+            ASSERT_TRUE(CreateSegment(ss, kv.first, ++lsn, sf_context, 1024).ok());
+        }
+    }
+
+    // the latest snapshots are derived from their parents, drop a segment and add another one
+    auto status = Snapshots::GetInstance().GetSnapshot(ss, collection_name);
+    ASSERT_TRUE(status.ok());
+    OperationContext drop_seg_context;
+    drop_seg_context.prev_segment = ss->GetResources<Segment>().begin()->second.Get();
+    auto drop_op = std::make_shared<milvus::engine::snapshot::DropSegmentOperation>(drop_seg_context, ss);
+    ASSERT_TRUE(drop_op->Push().ok());
+    status = Snapshots::GetInstance().GetSnapshot(ss, collection_name);
+    ASSERT_TRUE(status.ok());
+    ASSERT_TRUE(CreateSegment(ss, partitions.begin()->first, ++lsn, sf_context, 1024).ok());
+
+    ScopedSnapshotT inherited;
+    status = Snapshots::GetInstance().GetSnapshot(inherited, collection_name);
+    ASSERT_TRUE(status.ok());
+    ScopedSnapshotT loaded(std::make_shared<milvus::engine::snapshot::Snapshot>(store_, inherited->GetID()));
+
+    CheckSameResources<Collection>(inherited, loaded);
+    CheckSameResources<milvus::engine::snapshot::CollectionCommit>(inherited, loaded);
+    CheckSameResources<milvus::engine::snapshot::SchemaCommit>(inherited, loaded);
+    CheckSameResources<Field>(inherited, loaded);
+    CheckSameResources<milvus::engine::snapshot::FieldCommit>(inherited, loaded);
+    CheckSameResources<FieldElement>(inherited, loaded);
+    CheckSameResources<Partition>(inherited, loaded);
+    CheckSameResources<milvus::engine::snapshot::PartitionCommit>(inherited, loaded);
+    CheckSameResources<Segment>(inherited, loaded);
+    CheckSameResources<SegmentCommit>(inherited, loaded);
+    CheckSameResources<SegmentFile>(inherited, loaded);
+
+    ASSERT_EQ(inherited->GetPartitionNames(), loaded->GetPartitionNames());
+    ASSERT_EQ(inherited->GetCollectionCommit()->GetRowCount(), loaded->GetCollectionCommit()->GetRowCount());
+    for (auto& kv : inherited->GetResources<Partition>()) {
+        ASSERT_EQ(inherited->GetMaxSegmentNumByPartition(kv.first), loaded->GetMaxSegmentNumByPartition(kv.first));
+        ASSERT_EQ(inherited->GetPartitionCommitByPartitionId(kv.first)->GetID(),
+                  loaded->GetPartitionCommitByPartitionId(kv.first)->GetID());
+    }
+    for (auto& kv : inherited->GetResources<Segment>()) {
+        ASSERT_EQ(inherited->GetSegmentCommitBySegmentId(kv.first)->GetID(),
+                  loaded->GetSegmentCommitBySegmentId(kv.first)->GetID());
+        ASSERT_EQ(inherited->GetSegmentFileIds(kv.first), loaded->GetSegmentFileIds(kv.first));
+        for (auto& element : inherited->GetResources<FieldElement>()) {
+            auto inherited_file = inherited->GetSegmentFile(kv.first, element.first);
+            auto loaded_file = loaded->GetSegmentFile(kv.first, element.first);
+            ASSERT_EQ(inherited_file == nullptr, loaded_file == nullptr);
+            if (inherited_file != nullptr) {
+                ASSERT_EQ(inherited_file->GetID(), loaded_file->GetID());
+            }
+        }
+    }
+}
+
 TEST_F(SnapshotTest, IndexTest) {
     LSN_TYPE lsn = 0;
     auto next_lsn = [&]() -> decltype(lsn) {
@@ -794,6 +1002,133 @@ TEST_F(SnapshotTest, IndexTest) {
     }
 }
 
+class RecordOperation : public milvus::engine::snapshot::Operations {
+ public:
+    using RecordFunc = std::function<void()>;
+
+    RecordOperation(ScopedSnapshotT ss, RecordFunc func)
+        : milvus::engine::snapshot::Operations(OperationContext(), ss), func_(std::move(func)) {
+    }
+
+    Status
+    OnExecute(StorePtr store) override {
+        func_();
+        return Status::OK();
+    }
+
+ private:
+    RecordFunc func_;
+};
+
+TEST_F(SnapshotTest, OperationExecutorTest) {
+    LSN_TYPE lsn = 0;
+    // two collections served by different executor threads
+    ScopedSnapshotT ss_1 = CreateCollection("executor_0", ++lsn);
+    ASSERT_TRUE(ss_1);
+    ScopedSnapshotT ss_2;
+    for (auto i = 1; i < 4 && !ss_2; ++i) {
+        auto ss = CreateCollection("executor_" + std::to_string(i), ++lsn);
+        ASSERT_TRUE(ss);
+        if (ss->GetCollectionId() % milvus::engine::snapshot::DEFAULT_OPERATION_EXECUTOR_NUM !=
+            ss_1->GetCollectionId() % milvus::engine::snapshot::DEFAULT_OPERATION_EXECUTOR_NUM) {
+            ss_2 = ss;
+        }
+    }
+    ASSERT_TRUE(ss_2);
+
+    // operations of one collection are applied in the order they are submitted
+    std::mutex mutex;
+    std::vector<int64_t> order;
+    std::vector<std::shared_ptr<RecordOperation>> ops;
+    for (int64_t i = 0; i < 10; ++i) {
+        ops.push_back(std::make_shared<RecordOperation>(ss_1, [&, i]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+        }));
+        ASSERT_TRUE(ops.back()->Push(false).ok());
+    }
+    for (auto& op : ops) {
+        ASSERT_TRUE(op->WaitToFinish().ok());
+    }
+    ASSERT_EQ(order, std::vector<int64_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    // operations of different collections run at the same time
+    std::atomic<int64_t> running = 0, max_running = 0;
+    auto func = [&]() {
+        auto now = ++running;
+        auto prev = max_running.load();
+        while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        --running;
+    };
+    auto op_1 = std::make_shared<RecordOperation>(ss_1, func);
+    auto op_2 = std::make_shared<RecordOperation>(ss_2, func);
+    ASSERT_TRUE(op_1->Push(false).ok());
+    ASSERT_TRUE(op_2->Push(false).ok());
+    ASSERT_TRUE(op_1->WaitToFinish().ok());
+    ASSERT_TRUE(op_2->WaitToFinish().ok());
+    ASSERT_EQ(max_running.load(), 2);
+}
+
+TEST_F(SnapshotTest, ConcurrentApplyTest) {
+    LSN_TYPE lsn = 0;
+    // two collections applied by different executor threads
+    ScopedSnapshotT ss_1 = CreateCollection("apply_0", ++lsn);
+    ASSERT_TRUE(ss_1);
+    ScopedSnapshotT ss_2;
+    for (auto i = 1; i < 4 && !ss_2; ++i) {
+        auto ss = CreateCollection("apply_" + std::to_string(i), ++lsn);
+        ASSERT_TRUE(ss);
+        if (ss->GetCollectionId() % milvus::engine::snapshot::DEFAULT_OPERATION_EXECUTOR_NUM !=
+            ss_1->GetCollectionId() % milvus::engine::snapshot::DEFAULT_OPERATION_EXECUTOR_NUM) {
+            ss_2 = ss;
+        }
+    }
+    ASSERT_TRUE(ss_2);
+
+    // both collections commit new segments at the same time, the store applies their operations concurrently
+    const int64_t segment_num = 20, row_cnt = 100;
+    std::atomic<LSN_TYPE> next_lsn(lsn);
+    auto create_segments = [&](ScopedSnapshotT ss, Status& status) {
+        SegmentFileContext sf_context;
+        SFContextBuilder(sf_context, ss);
+        auto partition_id = ss->GetResources<Partition>().begin()->first;
+        for (int64_t i = 0; i < segment_num && status.ok(); ++i) {
+            status = CreateSegment(ss, partition_id, ++next_lsn, sf_context, row_cnt);
+            if (status.ok()) {
+                status = Snapshots::GetInstance().GetSnapshot(ss, ss->GetName());
+            }
+        }
+    };
+    Status status_1, status_2;
+    std::thread thread_1(create_segments, ss_1, std::ref(status_1));
+    std::thread thread_2(create_segments, ss_2, std::ref(status_2));
+    thread_1.join();
+    thread_2.join();
+    ASSERT_TRUE(status_1.ok()) << status_1.ToString();
+    ASSERT_TRUE(status_2.ok()) << status_2.ToString();
+
+    // each collection has all of its own segments, and none of the other one
+    for (auto& ss : {ss_1, ss_2}) {
+        ScopedSnapshotT latest;
+        ASSERT_TRUE(Snapshots::GetInstance().GetSnapshot(latest, ss->GetName()).ok());
+        ASSERT_EQ(latest->GetResources<Segment>().size(), static_cast<size_t>(segment_num));
+        ASSERT_EQ(latest->GetCollectionCommit()->GetRowCount(), segment_num * row_cnt);
+        for (auto& kv : latest->GetResources<Segment>()) {
+            ASSERT_EQ(kv.second->GetCollectionId(), latest->GetCollectionId());
+        }
+
+        // the committed resources are the same as loaded from the store
+        ScopedSnapshotT loaded(std::make_shared<milvus::engine::snapshot::Snapshot>(store_, latest->GetID()));
+        CheckSameResources<Segment>(latest, loaded);
+        CheckSameResources<SegmentCommit>(latest, loaded);
+        CheckSameResources<SegmentFile>(latest, loaded);
+        ASSERT_EQ(latest->GetCollectionCommit()->GetRowCount(), loaded->GetCollectionCommit()->GetRowCount());
+    }
+}
+
 TEST_F(SnapshotTest, OperationTest) {
     std::string to_string;
     LSN_TYPE lsn = 0;
@@ -15,11 +15,13 @@
 
 #include <algorithm>
 #include <set>
+#include <sstream>
 #include <string>
 #include <experimental/filesystem>
 
 #include "db/DBProxy.h"
 #include "db/utils.h"
+#include "db/transcript/ScriptBenchmark.h"
 #include "db/transcript/ScriptFile.h"
 #include "db/transcript/ScriptCodec.h"
 #include "db/transcript/ScriptRecorder.h"
@@ -31,6 +33,7 @@ namespace {
 using DBProxy = milvus::engine::DBProxy;
 using VaribleData = milvus::engine::VaribleData;
 
+using ScriptBenchmark = milvus::engine::ScriptBenchmark;
 using ScriptFile = milvus::engine::ScriptFile;
 using ScriptCodec = milvus::engine::ScriptCodec;
 using ScriptRecorder = milvus::engine::ScriptRecorder;
@@ -708,6 +711,63 @@ TEST(TranscriptTest, ReplayTest) {
     std::experimental::filesystem::remove_all(transcript_path);
 }
 
+TEST(TranscriptTest, BenchmarkTest) {
+    DBOptions options;
+    DummyDBPtr db = std::make_shared<DummyDB>(options);
+
+    std::string transcript_path = "/tmp/milvus_transcript";
+    std::string collection_name = "collection";
+    std::string partition_name = "partition";
+    std::string script_path;
+    {
+        ScriptRecorder recorder(transcript_path);
+        script_path = recorder.GetScriptPath();
+        milvus::engine::snapshot::CreateCollectionContext context;
+        recorder.CreateCollection(context);
+        for (int32_t i = 0; i < 10; i++) {
+            milvus::engine::DataChunkPtr chunk;
+            recorder.Insert(collection_name, partition_name, chunk, 0);
+            int64_t count = 0;
+            recorder.CountEntities(collection_name, count);
+        }
+        recorder.Flush(collection_name);
+        recorder.Flush();
+    }
+
+    // the dummy db is not thread safe, replay with one worker
+    milvus::engine::BenchmarkOptions benchmark_options;
+    benchmark_options.speed_ = 100.0;
+    ScriptBenchmark benchmark(benchmark_options);
+
+    milvus::json report;
+    auto status = benchmark.Run(db, script_path, report);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(db->Actions().size(), 23);
+
+    ASSERT_EQ(report["total"]["count"].get<int64_t>(), 23);
+    ASSERT_EQ(report["total"]["failed"].get<int64_t>(), 0);
+    auto& actions = report["actions"];
+    ASSERT_EQ(actions.size(), 4);
+    ASSERT_EQ(actions[milvus::engine::ActionCreateCollection]["count"].get<int64_t>(), 1);
+    ASSERT_EQ(actions[milvus::engine::ActionInsert]["count"].get<int64_t>(), 10);
+    ASSERT_EQ(actions[milvus::engine::ActionCountEntities]["count"].get<int64_t>(), 10);
+    ASSERT_EQ(actions[milvus::engine::ActionFlush]["count"].get<int64_t>(), 2);
+    auto& insert = actions[milvus::engine::ActionInsert];
+    ASSERT_LE(insert["p50_ms"].get<double>(), insert["p99_ms"].get<double>());
+    ASSERT_LE(insert["p99_ms"].get<double>(), insert["max_ms"].get<double>());
+
+    std::stringstream out;
+    ScriptBenchmark::Compare(report, report, out);
+    std::string text = out.str();
+    ASSERT_NE(text.find(milvus::engine::ActionInsert), std::string::npos);
+    ASSERT_NE(text.find("p99_ms"), std::string::npos);
+
+    // the transcript folder doesn't exist
+    std::experimental::filesystem::remove_all(transcript_path);
+    status = benchmark.Run(db, script_path, report);
+    ASSERT_FALSE(status.ok());
+}
+
 TEST(TranscriptTest, ProxyTest) {
     std::string test_path = "/tmp/milvus_test";
     DBOptions options;
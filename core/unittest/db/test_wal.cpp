@@ -14,8 +14,12 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <set>
 #include <string>
+#include <thread>
+#include <vector>
 #include <experimental/filesystem>
 
 #include "db/DBProxy.h"
@@ -570,3 +574,104 @@ TEST_F(WalTest, WalManagerTest2) {
     idx_t max_done_id = WalManager::GetInstance().GetMaxOperationID(COLLECTION_NAME);
     ASSERT_EQ(max_done_id, max_op_id);
 }
+
+TEST_F(WalTest, WalGroupCommitTest) {
+    DBOptions options;
+    options.wal_path_ = "/tmp/milvus_wal";
+    options.wal_enable_ = true;
+
+    WalManager::GetInstance().Stop();
+    WalManager::GetInstance().Start(options);
+
+    // concurrent writers, records of them are committed in batches
+    const int64_t thread_count = 8;
+    const int64_t op_count = 100;
+    std::vector<std::thread> threads;
+    std::vector<idx_t> max_ids(thread_count, 0);
+    for (int64_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int64_t i = 1; i <= op_count; i++) {
+                WalOperationPtr operation;
+                if (i % 2 == 0) {
+                    auto op = std::make_shared<DeleteEntityOperation>();
+                    op->collection_name_ = COLLECTION_NAME;
+                    op->entity_ids_ = {t, i};
+                    operation = op;
+                } else {
+                    DataChunkPtr chunk;
+                    int64_t chunk_size = 0;
+                    CreateChunk(chunk, 10, chunk_size);
+
+                    auto op = std::make_shared<InsertEntityOperation>();
+                    op->collection_name_ = COLLECTION_NAME;
+                    op->partition_name = "";
+                    op->data_chunk_ = chunk;
+                    operation = op;
+                }
+
+                auto status = WalManager::GetInstance().RecordOperation(operation, nullptr);
+                ASSERT_TRUE(status.ok());
+                max_ids[t] = std::max(max_ids[t], operation->ID());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // all operations are persisted when RecordOperation() returns
+    DummyDBPtr db = std::make_shared<DummyDB>(options);
+    milvus::engine::CollectionMaxOpIDMap max_op_ids;
+    WalManager::GetInstance().Recovery(db, max_op_ids);
+    ASSERT_EQ(db->InsertCount(), thread_count * op_count / 2);
+    ASSERT_EQ(db->DeleteCount(), thread_count * op_count / 2);
+
+    idx_t max_done_id = WalManager::GetInstance().GetMaxOperationID(COLLECTION_NAME);
+    ASSERT_EQ(max_done_id, *std::max_element(max_ids.begin(), max_ids.end()));
+}
+
+TEST_F(WalTest, WalCommitStopRaceTest) {
+    DBOptions options;
+    options.wal_path_ = "/tmp/milvus_wal";
+    options.wal_enable_ = true;
+
+    // producers keep committing while the writer is stopped, every call must return, either
+    // committed before the writer exits or rejected, no record is left in the pending list
+    const int64_t round_count = 20;
+    const int64_t thread_count = 8;
+    for (int64_t round = 0; round < round_count; ++round) {
+        WalManager::GetInstance().Stop();
+        WalManager::GetInstance().Start(options);
+
+        std::atomic<int64_t> ok_count(0);
+        std::atomic<int64_t> fail_count(0);
+        std::vector<std::thread> threads;
+        for (int64_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int64_t i = 0;; ++i) {
+                    auto op = std::make_shared<DeleteEntityOperation>();
+                    op->collection_name_ = COLLECTION_NAME;
+                    op->entity_ids_ = {t, i};
+                    auto status = WalManager::GetInstance().RecordOperation(op, nullptr);
+                    if (!status.ok()) {
+                        ++fail_count;
+                        break;
+                    }
+                    ++ok_count;
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(round % 5));
+        WalManager::GetInstance().Stop();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(fail_count, thread_count);
+
+        auto op = std::make_shared<DeleteEntityOperation>();
+        op->collection_name_ = COLLECTION_NAME;
+        op->entity_ids_ = {1};
+        ASSERT_FALSE(WalManager::GetInstance().RecordOperation(op, nullptr).ok());
+    }
+}
@@ -79,7 +79,7 @@ BaseTest::InitLog() {
     el::Loggers::reconfigureLogger("default", defaultConf);
 }
 
-void
+StorePtr
 BaseTest::SnapshotStart(bool mock_store, DBOptions options) {
     auto store =
         Store::Build(options.meta_.backend_uri_, options.meta_.path_, milvus::codec::Codec::instance().GetSuffixSet());
@@ -109,6 +109,7 @@ BaseTest::SnapshotStart(bool mock_store, DBOptions options) {
 
     milvus::engine::snapshot::Snapshots::GetInstance().Reset();
     milvus::engine::snapshot::Snapshots::GetInstance().Init(store);
+    return store;
 }
 
 void
@@ -139,7 +140,7 @@ SnapshotTest::SetUp() {
     options.meta_.path_ = "/tmp/milvus_ss/db";
     options.meta_.backend_uri_ = "mock://:@:/";
     options.wal_enable_ = false;
-    BaseTest::SnapshotStart(true, options);
+    store_ = BaseTest::SnapshotStart(true, options);
 }
 
 void
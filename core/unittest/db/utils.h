@@ -329,7 +329,7 @@ class BaseTest : public ::testing::Test {
  protected:
     void
     InitLog();
-    void
+    StorePtr
     SnapshotStart(bool mock_store, DBOptions);
     void
     SnapshotStop();
@@ -342,6 +342,9 @@ class BaseTest : public ::testing::Test {
 
 ///////////////////////////////////////////////////////////////////////////////
 class SnapshotTest : public BaseTest {
+ protected:
+    StorePtr store_;
+
  protected:
     void
     SetUp() override;
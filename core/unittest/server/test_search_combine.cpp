@@ -0,0 +1,315 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+#include <opentracing/mocktracer/in_memory_recorder.h>
+#include <opentracing/mocktracer/tracer.h>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "db/snapshot/Snapshots.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
+#include "scheduler/ResourceFactory.h"
+#include "scheduler/SchedInst.h"
+#include "server/DBWrapper.h"
+#include "server/context/Context.h"
+#include "server/delivery/request/SearchCombineReq.h"
+#include "server/delivery/request/SearchReq.h"
+#include "value/config/ConfigMgr.h"
+
+namespace {
+
+static const char* COMBINE_TEST_DIR = "/tmp/milvus_search_combine_test/";
+static const char* COMBINE_TEST_CONFIG_FILE = "config.yaml";
+static const char* COMBINE_TEST_CONFIG_STR =
+    "version: 0.6\n"
+    "\n"
+    "general:\n"
+    "  timezone: UTC+8\n"
+    "  meta_uri: mock://:@:/\n"
+    "\n"
+    "storage:\n"
+    "  path: /tmp/milvus_search_combine_test\n"
+    "  auto_flush_interval: 1\n"
+    "\n"
+    "wal:\n"
+    "  enable: false\n"
+    "\n"
+    "cache:\n"
+    "  cache_size: 1GB\n"
+    "  insert_buffer_size: 256MB\n"
+    "\n"
+    "logs:\n"
+    "  path: /tmp/milvus_search_combine_test/logs\n"
+    "\n";
+
+static const char* COLLECTION_NAME = "test_search_combine";
+static const char* VECTOR_FIELD_NAME = "vector";
+static const char* PLACEHOLDER = "placeholder_1";
+static constexpr int64_t DIM = 8;
+static constexpr int64_t NB = 1000;
+static constexpr int64_t TOPK = 5;
+
+// a context with tracing span, the finished spans are kept by the recorder
+milvus::server::ContextPtr
+CreateContext(const std::string& req_id, opentracing::mocktracer::InMemoryRecorder*& recorder) {
+    opentracing::mocktracer::MockTracerOptions tracer_options;
+    recorder = new opentracing::mocktracer::InMemoryRecorder();
+    tracer_options.recorder.reset(recorder);
+    auto tracer = std::shared_ptr<opentracing::Tracer>{new opentracing::mocktracer::MockTracer{
+        std::move(tracer_options)}};
+    auto span = tracer->StartSpan("mock_span");
+
+    auto context = std::make_shared<milvus::server::Context>(req_id);
+    context->SetTraceContext(std::make_shared<milvus::tracing::TraceContext>(span));
+    return context;
+}
+
+milvus::query::QueryPtr
+BuildQuery(int64_t nq, int64_t topk, const std::string& metric_type, int64_t seed) {
+    auto query_ptr = std::make_shared<milvus::query::Query>();
+    query_ptr->collection_id = COLLECTION_NAME;
+    query_ptr->index_fields = {VECTOR_FIELD_NAME};
+    if (!metric_type.empty()) {
+        query_ptr->metric_types.insert({VECTOR_FIELD_NAME, metric_type});
+    }
+
+    query_ptr->root = std::make_shared<milvus::query::GeneralQuery>();
+    query_ptr->root->leaf = std::make_shared<milvus::query::LeafQuery>();
+    query_ptr->root->leaf->vector_placeholder = PLACEHOLDER;
+
+    auto vector_query = std::make_shared<milvus::query::VectorQuery>();
+    vector_query->field_name = VECTOR_FIELD_NAME;
+    vector_query->topk = topk;
+    vector_query->metric_type = metric_type;
+    std::default_random_engine e(seed);
+    std::uniform_real_distribution<float> u(0, 1);
+    vector_query->query_vector.vector_count = nq;
+    for (int64_t i = 0; i < nq * DIM; ++i) {
+        vector_query->query_vector.float_data.push_back(u(e));
+    }
+    query_ptr->vectors.insert(std::make_pair(PLACEHOLDER, vector_query));
+    return query_ptr;
+}
+
+// the request refers to result and field mappings, they are kept by the holder
+struct SearchReqHolder {
+    milvus::server::ContextPtr context_;
+    opentracing::mocktracer::InMemoryRecorder* recorder_ = nullptr;
+    milvus::engine::snapshot::FieldElementMappings mappings_;
+    milvus::engine::QueryResultPtr result_ = std::make_shared<milvus::engine::QueryResult>();
+    milvus::server::SearchReqPtr req_;
+
+    SearchReqHolder(const std::string& req_id, const milvus::query::QueryPtr& query_ptr) {
+        context_ = CreateContext(req_id, recorder_);
+        auto req = milvus::server::SearchReq::Create(context_, query_ptr, milvus::json(), mappings_, result_);
+        req_ = std::static_pointer_cast<milvus::server::SearchReq>(req);
+    }
+
+    // a request never executed blocks in its destructor
+    ~SearchReqHolder() {
+        req_->Done();
+    }
+};
+using SearchReqHolderPtr = std::shared_ptr<SearchReqHolder>;
+
+}  // namespace
+
+class SearchCombineTest : public ::testing::Test {
+ protected:
+    static void
+    SetUpTestCase() {
+        boost::filesystem::create_directories(COMBINE_TEST_DIR);
+        std::string config_path = std::string(COMBINE_TEST_DIR).append(COMBINE_TEST_CONFIG_FILE);
+        std::fstream fs(config_path.c_str(), std::ios_base::out);
+        fs << COMBINE_TEST_CONFIG_STR;
+        fs.close();
+
+        milvus::ConfigMgr::GetInstance().Init();
+        milvus::ConfigMgr::GetInstance().LoadFile(config_path);
+        milvus::engine::snapshot::Snapshots::GetInstance().StartService();
+
+        auto res_mgr = milvus::scheduler::ResMgrInst::GetInstance();
+        res_mgr->Clear();
+        res_mgr->Add(milvus::scheduler::ResourceFactory::Create("disk", "DISK", 0, false));
+        res_mgr->Add(milvus::scheduler::ResourceFactory::Create("cpu", "CPU", 0));
+        auto default_conn = milvus::scheduler::Connection("IO", 500.0);
+        res_mgr->Connect("disk", "cpu", default_conn);
+        res_mgr->Start();
+        milvus::scheduler::SchedInst::GetInstance()->Start();
+        milvus::scheduler::JobMgrInst::GetInstance()->Start();
+        milvus::scheduler::CPUBuilderInst::GetInstance()->Start();
+
+        milvus::server::DBWrapper::GetInstance().StartService();
+        CreateCollectionWithData();
+    }
+
+    static void
+    TearDownTestCase() {
+        milvus::server::DBWrapper::DB()->DropCollection(COLLECTION_NAME);
+        milvus::server::DBWrapper::GetInstance().StopService();
+        milvus::scheduler::JobMgrInst::GetInstance()->Stop();
+        milvus::scheduler::SchedInst::GetInstance()->Stop();
+        milvus::scheduler::CPUBuilderInst::GetInstance()->Stop();
+        milvus::scheduler::ResMgrInst::GetInstance()->Stop();
+        milvus::scheduler::ResMgrInst::GetInstance()->Clear();
+        milvus::engine::snapshot::Snapshots::GetInstance().StopService();
+
+        boost::filesystem::remove_all(COMBINE_TEST_DIR);
+    }
+
+    static void
+    CreateCollectionWithData() {
+        milvus::engine::snapshot::CreateCollectionContext context;
+        context.collection = std::make_shared<milvus::engine::snapshot::Collection>(COLLECTION_NAME);
+        milvus::json params;
+        params[milvus::knowhere::meta::DIM] = DIM;
+        auto vector_field = std::make_shared<milvus::engine::snapshot::Field>(
+            VECTOR_FIELD_NAME, 0, milvus::engine::DataType::VECTOR_FLOAT, params);
+        context.fields_schema[vector_field] = {};
+        auto status = milvus::server::DBWrapper::DB()->CreateCollection(context);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+
+        auto data_chunk = std::make_shared<milvus::engine::DataChunk>();
+        data_chunk->count_ = NB;
+        auto raw = std::make_shared<milvus::engine::BinaryData>();
+        raw->data_.resize(NB * DIM * sizeof(float));
+        auto data = reinterpret_cast<float*>(raw->data_.data());
+        std::default_random_engine e(0);
+        std::uniform_real_distribution<float> u(0, 1);
+        for (int64_t i = 0; i < NB * DIM; ++i) {
+            data[i] = u(e);
+        }
+        data_chunk->fixed_fields_[VECTOR_FIELD_NAME] = raw;
+
+        status = milvus::server::DBWrapper::DB()->Insert(COLLECTION_NAME, "", data_chunk);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        status = milvus::server::DBWrapper::DB()->Flush(COLLECTION_NAME);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+    }
+};
+
+TEST_F(SearchCombineTest, CAN_COMBINE) {
+    SearchReqHolder req_a("a", BuildQuery(2, TOPK, "L2", 1));
+    SearchReqHolder req_b("b", BuildQuery(3, TOPK, "L2", 2));
+    ASSERT_TRUE(milvus::server::SearchCombineReq::CanCombine(req_a.req_, req_b.req_));
+
+    // different topk, metric or collection
+    SearchReqHolder req_topk("c", BuildQuery(2, TOPK + 1, "L2", 1));
+    ASSERT_FALSE(milvus::server::SearchCombineReq::CanCombine(req_a.req_, req_topk.req_));
+    SearchReqHolder req_metric("d", BuildQuery(2, TOPK, "IP", 1));
+    ASSERT_FALSE(milvus::server::SearchCombineReq::CanCombine(req_a.req_, req_metric.req_));
+    auto query_ptr = BuildQuery(2, TOPK, "L2", 1);
+    query_ptr->collection_id = "another_collection";
+    SearchReqHolder req_collection("e", query_ptr);
+    ASSERT_FALSE(milvus::server::SearchCombineReq::CanCombine(req_a.req_, req_collection.req_));
+
+    // requests fetching output fields are not combined
+    milvus::engine::snapshot::FieldElementMappings mappings;
+    auto result = std::make_shared<milvus::engine::QueryResult>();
+    milvus::json json_params = {{"fields", {VECTOR_FIELD_NAME}}};
+    auto req_fields = std::static_pointer_cast<milvus::server::SearchReq>(milvus::server::SearchReq::Create(
+        req_a.context_, BuildQuery(2, TOPK, "L2", 1), json_params, mappings, result));
+    ASSERT_FALSE(milvus::server::SearchCombineReq::CanCombine(req_fields, req_fields));
+    req_fields->Done();
+
+    // total nq limit
+    auto combine_req = milvus::server::SearchCombineReq::Create(req_a.req_, 4);
+    ASSERT_FALSE(combine_req->CanCombine(req_b.req_));
+    SearchReqHolder req_small("f", BuildQuery(2, TOPK, "L2", 3));
+    ASSERT_TRUE(combine_req->CanCombine(req_small.req_));
+    combine_req->Combine(req_small.req_);
+    SearchReqHolder req_one("g", BuildQuery(1, TOPK, "L2", 4));
+    ASSERT_FALSE(combine_req->CanCombine(req_one.req_));
+    combine_req->Done();
+}
+
+TEST_F(SearchCombineTest, SPLIT_RESULT) {
+    std::vector<int64_t> nqs = {1, 3, 2, 5};
+    std::vector<SearchReqHolderPtr> combined;
+    std::vector<SearchReqHolderPtr> standalone;
+    for (size_t i = 0; i < nqs.size(); ++i) {
+        auto id = std::to_string(i);
+        combined.emplace_back(std::make_shared<SearchReqHolder>("combined_" + id, BuildQuery(nqs[i], TOPK, "L2", i)));
+        standalone.emplace_back(std::make_shared<SearchReqHolder>("single_" + id, BuildQuery(nqs[i], TOPK, "L2", i)));
+    }
+
+    auto combine_req = milvus::server::SearchCombineReq::Create(combined[0]->req_, 100);
+    for (size_t i = 1; i < combined.size(); ++i) {
+        ASSERT_TRUE(combine_req->CanCombine(combined[i]->req_));
+        combine_req->Combine(combined[i]->req_);
+    }
+    auto status = combine_req->Execute();
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    // each request gets the same result as searched alone, the distance kernel may vary with nq
+    for (size_t i = 0; i < nqs.size(); ++i) {
+        status = combined[i]->req_->WaitToFinish();
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        status = standalone[i]->req_->Execute();
+        ASSERT_TRUE(status.ok()) << status.ToString();
+
+        auto& result = combined[i]->result_;
+        auto& expect = standalone[i]->result_;
+        ASSERT_EQ(result->row_num_, nqs[i]);
+        ASSERT_EQ(result->result_ids_.size(), nqs[i] * TOPK);
+        ASSERT_EQ(result->result_ids_, expect->result_ids_);
+        for (size_t k = 0; k < result->result_distances_.size(); ++k) {
+            ASSERT_NEAR(result->result_distances_[k], expect->result_distances_[k], 1e-5);
+        }
+
+        // the combined query is traced in a span of each request
+        bool traced = false;
+        for (auto& span : combined[i]->recorder_->spans()) {
+            traced |= (span.operation_name.find("SearchCombineReq") == 0);
+        }
+        ASSERT_TRUE(traced);
+    }
+}
+
+TEST_F(SearchCombineTest, ERROR_PROPAGATION) {
+    // the invalid request fails with its own error, the others go on
+    auto query_ptr = BuildQuery(2, TOPK, "L2", 1);
+    query_ptr->vectors.begin()->second->query_vector.float_data.resize(DIM);
+    SearchReqHolder req_invalid("invalid", query_ptr);
+    SearchReqHolder req_valid("valid", BuildQuery(2, TOPK, "L2", 2));
+    auto combine_req = milvus::server::SearchCombineReq::Create(req_invalid.req_, 100);
+    ASSERT_TRUE(combine_req->CanCombine(req_valid.req_));
+    combine_req->Combine(req_valid.req_);
+    combine_req->Execute();
+    ASSERT_FALSE(req_invalid.req_->WaitToFinish().ok());
+    ASSERT_TRUE(req_valid.req_->WaitToFinish().ok());
+    ASSERT_EQ(req_valid.result_->result_ids_.size(), 2 * TOPK);
+
+    // metric type is required since the collection has no index, the query fails for every absorbed request
+    std::vector<SearchReqHolderPtr> holders;
+    for (int64_t i = 0; i < 3; ++i) {
+        holders.emplace_back(std::make_shared<SearchReqHolder>(std::to_string(i), BuildQuery(1, TOPK, "", i)));
+    }
+    combine_req = milvus::server::SearchCombineReq::Create(holders[0]->req_, 100);
+    for (size_t i = 1; i < holders.size(); ++i) {
+        ASSERT_TRUE(combine_req->CanCombine(holders[i]->req_));
+        combine_req->Combine(holders[i]->req_);
+    }
+    auto status = combine_req->Execute();
+    ASSERT_FALSE(status.ok());
+    for (auto& holder : holders) {
+        auto req_status = holder->req_->WaitToFinish();
+        ASSERT_FALSE(req_status.ok());
+        ASSERT_EQ(req_status.code(), status.code());
+    }
+}
@@ -13,6 +13,15 @@
 #include <fiu/fiu-local.h>
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codecs/BlockFormat.h"
+#include "codecs/ExtraFileInfo.h"
+#include "codecs/VectorIndexFormat.h"
 #include "easyloggingpp/easylogging++.h"
 #include "storage/disk/DiskIOReader.h"
 #include "storage/disk/DiskIOWriter.h"
@@ -21,6 +30,44 @@
 
 INITIALIZE_EASYLOGGINGPP
 
+namespace {
+
+// a disk reader of a storage without memory mapping, the codecs fall back to read the files
+class NoMapIOReader : public milvus::storage::DiskIOReader {
+ public:
+    std::shared_ptr<uint8_t[]>
+    Map(const std::string& name, int64_t& length) override {
+        length = 0;
+        return nullptr;
+    }
+};
+
+milvus::storage::FSHandlerPtr
+CreateFSHandler(bool map, const std::string& root_path) {
+    milvus::storage::IOReaderPtr reader_ptr;
+    if (map) {
+        reader_ptr = std::make_shared<milvus::storage::DiskIOReader>();
+    } else {
+        reader_ptr = std::make_shared<NoMapIOReader>();
+    }
+    milvus::storage::IOWriterPtr writer_ptr = std::make_shared<milvus::storage::DiskIOWriter>();
+    milvus::storage::OperationPtr operation_ptr = std::make_shared<milvus::storage::DiskOperation>(root_path);
+    return std::make_shared<milvus::storage::FSHandler>(reader_ptr, writer_ptr, operation_ptr);
+}
+
+void
+FlipByte(const std::string& file_path, int64_t offset) {
+    std::fstream file(file_path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(offset);
+    char c = 0;
+    file.read(&c, 1);
+    c = ~c;
+    file.seekp(offset);
+    file.write(&c, 1);
+}
+
+}  // namespace
+
 TEST_F(StorageTest, DISK_RW_TEST) {
     const std::string index_name = "/tmp/test_index";
     const std::string content = "abcdefg";
@@ -81,3 +128,116 @@ TEST_F(StorageTest, DISK_OPERATION_TEST) {
         ASSERT_TRUE(disk_operation.DeleteFile(path));
     }
 }
+
+TEST_F(StorageTest, DISK_MAP_TEST) {
+    const std::string file_name = "/tmp/test_map";
+    const std::string content = "abcdefghijklmn";
+    {
+        milvus::storage::DiskIOWriter writer;
+        ASSERT_TRUE(writer.Open(file_name));
+        writer.Write((void*)(content.data()), content.length());
+        writer.Close();
+    }
+
+    std::shared_ptr<uint8_t[]> mapped;
+    int64_t length = 0;
+    {
+        milvus::storage::DiskIOReader reader;
+        mapped = reader.Map(file_name, length);
+    }
+    // the mapping outlives the reader
+    ASSERT_NE(mapped, nullptr);
+    ASSERT_EQ(length, content.length());
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(mapped.get()), length), content);
+
+    // a missing or empty file can't be mapped, the caller falls back to read it
+    milvus::storage::DiskIOReader reader;
+    ASSERT_EQ(reader.Map("/tmp/notexist", length), nullptr);
+    ASSERT_EQ(length, 0);
+    {
+        milvus::storage::DiskIOWriter writer;
+        ASSERT_TRUE(writer.Open(file_name));
+        writer.Close();
+    }
+    ASSERT_EQ(reader.Map(file_name, length), nullptr);
+}
+
+TEST_F(StorageTest, DISK_MAP_READ_RAW_TEST) {
+    const std::string root_path = "/tmp/milvus_test/disk_map";
+    const std::string file_path = root_path + "/raw_file";
+    auto fs_ptr = CreateFSHandler(true, root_path);
+    fs_ptr->operation_ptr_->CreateDirectory();
+
+    auto raw = std::make_shared<milvus::engine::BinaryData>();
+    raw->data_.resize(100000);
+    for (size_t i = 0; i < raw->data_.size(); ++i) {
+        raw->data_[i] = static_cast<uint8_t>(i * 7);
+    }
+    milvus::codec::BlockFormat block_format;
+    ASSERT_TRUE(block_format.Write(fs_ptr, file_path, raw).ok());
+
+    milvus::codec::VectorIndexFormat index_format;
+    milvus::knowhere::BinaryPtr mapped_data, read_data;
+    ASSERT_TRUE(index_format.ReadRaw(fs_ptr, file_path, mapped_data).ok());
+    ASSERT_TRUE(index_format.ReadRaw(CreateFSHandler(false, root_path), file_path, read_data).ok());
+    ASSERT_EQ(mapped_data->size, raw->data_.size());
+    ASSERT_EQ(read_data->size, raw->data_.size());
+    ASSERT_EQ(memcmp(mapped_data->data.get(), raw->data_.data(), raw->data_.size()), 0);
+    ASSERT_EQ(memcmp(read_data->data.get(), raw->data_.data(), raw->data_.size()), 0);
+
+    // both paths verify the sum
+    FlipByte(file_path, MAGIC_SIZE + HEADER_SIZE + 10);
+    ASSERT_ANY_THROW(index_format.ReadRaw(fs_ptr, file_path, mapped_data));
+    ASSERT_ANY_THROW(index_format.ReadRaw(CreateFSHandler(false, root_path), file_path, read_data));
+}
+
+TEST_F(StorageTest, DISK_MAP_READ_INDEX_TEST) {
+    const std::string root_path = "/tmp/milvus_test/disk_map";
+    const std::string file_path = root_path + "/index_file";
+    const std::string full_file_path = file_path + milvus::codec::VectorIndexFormat::FilePostfix();
+    auto fs_ptr = CreateFSHandler(true, root_path);
+    fs_ptr->operation_ptr_->CreateDirectory();
+
+    // the layout written by VectorIndexFormat::WriteIndex(), binaries prefixed with name and length
+    std::vector<std::pair<std::string, std::string>> binaries = {{"IVF", std::string(3000, 'a')},
+                                                                  {"META", "meta data"}};
+    std::vector<char> data;
+    for (auto& pair : binaries) {
+        size_t meta_length = pair.first.length();
+        size_t bin_length = pair.second.length();
+        auto offset = data.size();
+        data.resize(offset + sizeof(meta_length) + meta_length + sizeof(bin_length) + bin_length);
+        memcpy(data.data() + offset, &meta_length, sizeof(meta_length));
+        offset += sizeof(meta_length);
+        memcpy(data.data() + offset, pair.first.data(), meta_length);
+        offset += meta_length;
+        memcpy(data.data() + offset, &bin_length, sizeof(bin_length));
+        offset += sizeof(bin_length);
+        memcpy(data.data() + offset, pair.second.data(), bin_length);
+    }
+    ASSERT_TRUE(fs_ptr->writer_ptr_->Open(full_file_path));
+    milvus::codec::WriteMagic(fs_ptr);
+    std::string header = milvus::codec::HeaderWrapper(milvus::codec::HeaderMap());
+    milvus::codec::WriteHeaderValues(fs_ptr, header);
+    fs_ptr->writer_ptr_->Write(data.data(), data.size());
+    milvus::codec::WriteSum(fs_ptr, header, data.data(), data.size());
+    fs_ptr->writer_ptr_->Close();
+
+    milvus::codec::VectorIndexFormat index_format;
+    for (bool map : {true, false}) {
+        milvus::knowhere::BinarySet binary_set;
+        ASSERT_TRUE(index_format.ReadIndex(CreateFSHandler(map, root_path), file_path, binary_set).ok());
+        for (auto& pair : binaries) {
+            ASSERT_TRUE(binary_set.Contains(pair.first));
+            auto binary = binary_set.GetByName(pair.first);
+            ASSERT_EQ(binary->size, pair.second.length());
+            ASSERT_EQ(std::string(reinterpret_cast<const char*>(binary->data.get()), binary->size), pair.second);
+        }
+    }
+
+    FlipByte(full_file_path, MAGIC_SIZE + HEADER_SIZE + 20);
+    for (bool map : {true, false}) {
+        milvus::knowhere::BinarySet binary_set;
+        ASSERT_ANY_THROW(index_format.ReadIndex(CreateFSHandler(map, root_path), file_path, binary_set));
+    }
+}
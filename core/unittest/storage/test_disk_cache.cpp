@@ -0,0 +1,188 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <crc32c/crc32c.h>
+#include <fiu-control.h>
+#include <fiu/fiu-local.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <experimental/filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/DiskCache.h"
+#include "storage/utils.h"
+
+namespace {
+
+const char* CACHE_PATH = "/tmp/milvus_test/disk_cache";
+
+std::string
+ReadFile(const std::string& file_path) {
+    std::ifstream file(file_path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST_F(StorageTest, DISK_CACHE_TEST) {
+    std::experimental::filesystem::remove_all(CACHE_PATH);
+
+    // a local stand-in of the remote storage, the content of an object is repeated key
+    std::atomic<int64_t> fetch_count(0);
+    auto fetch = [&](const std::string& key, const std::string& file_path) {
+        ++fetch_count;
+        std::ofstream file(file_path, std::ios::binary);
+        for (int i = 0; i < 100; ++i) {
+            file << key;
+        }
+        return milvus::Status::OK();
+    };
+    auto object_size = [](const std::string& key) { return static_cast<int64_t>(key.size()) * 100; };
+
+    {
+        milvus::storage::DiskCache cache(CACHE_PATH, 2500);
+        ASSERT_TRUE(cache.Load().ok());
+
+        std::string path_a, path_b, path_c;
+        ASSERT_TRUE(cache.Get("/a/object_a", fetch, path_a).ok());
+        ASSERT_EQ(ReadFile(path_a).size(), object_size("/a/object_a"));
+        ASSERT_TRUE(cache.Get("/a/object_b", fetch, path_b).ok());
+        ASSERT_EQ(fetch_count, 2);
+
+        // hit, and object_a becomes the most recently used
+        std::string path;
+        ASSERT_TRUE(cache.Get("/a/object_a", fetch, path).ok());
+        ASSERT_EQ(path, path_a);
+        ASSERT_EQ(fetch_count, 2);
+        ASSERT_EQ(cache.Size(), object_size("/a/object_a") + object_size("/a/object_b"));
+
+        // object_b is evicted
+        ASSERT_TRUE(cache.Get("/a/object_c", fetch, path_c).ok());
+        ASSERT_TRUE(cache.Exist("/a/object_a"));
+        ASSERT_FALSE(cache.Exist("/a/object_b"));
+        ASSERT_FALSE(std::experimental::filesystem::exists(path_b));
+        ASSERT_LE(cache.Size(), cache.Capacity());
+
+        fiu_init(0);
+        fiu_enable("DiskCache.Get.fetch_fail", 1, NULL, 0);
+        ASSERT_FALSE(cache.Get("/a/object_d", fetch, path).ok());
+        fiu_disable("DiskCache.Get.fetch_fail");
+        ASSERT_FALSE(cache.Exist("/a/object_d"));
+    }
+
+    {
+        // files of the previous run are reused, a file of another size is removed
+        std::string path_c;
+        {
+            milvus::storage::DiskCache cache(CACHE_PATH, 2500);
+            ASSERT_TRUE(cache.Load().ok());
+            ASSERT_TRUE(cache.Exist("/a/object_a"));
+            ASSERT_TRUE(cache.Exist("/a/object_c"));
+            ASSERT_TRUE(cache.Get("/a/object_c", fetch, path_c).ok());
+        }
+        std::ofstream file(path_c, std::ios::binary | std::ios::app);
+        file << "x";
+        file.close();
+
+        int64_t count = fetch_count;
+        milvus::storage::DiskCache cache(CACHE_PATH, 2500);
+        ASSERT_TRUE(cache.Load().ok());
+        ASSERT_TRUE(cache.Exist("/a/object_a"));
+        ASSERT_FALSE(cache.Exist("/a/object_c"));
+        ASSERT_FALSE(std::experimental::filesystem::exists(path_c));
+
+        std::string path;
+        ASSERT_TRUE(cache.Get("/a/object_a", fetch, path).ok());
+        ASSERT_EQ(fetch_count, count);
+
+        cache.Erase("/a/object_a");
+        ASSERT_FALSE(cache.Exist("/a/object_a"));
+        ASSERT_EQ(cache.Size(), 0);
+    }
+
+    {
+        // files in the codec layout are verified by their crc32c sum on first use after restart
+        auto fetch_codec = [&](const std::string& key, const std::string& file_path) {
+            ++fetch_count;
+            std::string content = "Milvus";
+            for (int i = 0; i < 100; ++i) {
+                content += key;
+            }
+            uint32_t sum = crc32c::Crc32c(content.data(), content.size());
+            std::ofstream file(file_path, std::ios::binary);
+            file.write(content.data(), content.size());
+            file.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+            return milvus::Status::OK();
+        };
+
+        std::string path_f, path_g;
+        {
+            milvus::storage::DiskCache cache(CACHE_PATH, 1024 * 1024);
+            ASSERT_TRUE(cache.Load().ok());
+            ASSERT_TRUE(cache.Get("/b/object_f", fetch_codec, path_f).ok());
+            ASSERT_TRUE(cache.Get("/b/object_g", fetch_codec, path_g).ok());
+        }
+
+        // a broken byte keeps the file size, the file is still reused by Load()
+        std::fstream file(path_g, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(10);
+        file.put('x');
+        file.close();
+
+        int64_t count = fetch_count;
+        milvus::storage::DiskCache cache(CACHE_PATH, 1024 * 1024);
+        ASSERT_TRUE(cache.Load().ok());
+        ASSERT_TRUE(cache.Exist("/b/object_f"));
+        ASSERT_TRUE(cache.Exist("/b/object_g"));
+
+        std::string path;
+        ASSERT_TRUE(cache.Get("/b/object_f", fetch_codec, path).ok());
+        ASSERT_EQ(fetch_count, count);
+        ASSERT_TRUE(cache.Get("/b/object_g", fetch_codec, path).ok());
+        ASSERT_EQ(fetch_count, count + 1);
+        ASSERT_EQ(ReadFile(path).substr(6, 11), "/b/object_g");
+
+        // verified once
+        ASSERT_TRUE(cache.Get("/b/object_g", fetch_codec, path).ok());
+        ASSERT_EQ(fetch_count, count + 1);
+        cache.Erase("/b/object_f");
+        cache.Erase("/b/object_g");
+    }
+
+    {
+        // concurrent gets of one object fetch it only once
+        milvus::storage::DiskCache cache(CACHE_PATH, 1024 * 1024);
+        ASSERT_TRUE(cache.Load().ok());
+        int64_t count = fetch_count;
+        std::vector<std::thread> threads;
+        std::atomic<int64_t> failed(0);
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&]() {
+                std::string path;
+                if (!cache.Get("/a/object_e", fetch, path).ok() ||
+                    ReadFile(path).size() != object_size("/a/object_e")) {
+                    ++failed;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(failed, 0);
+        ASSERT_EQ(fetch_count, count + 1);
+    }
+
+    std::experimental::filesystem::remove_all(CACHE_PATH);
+}
@@ -11,18 +11,21 @@
 
 
 #include <gtest/gtest.h>
+#include <experimental/filesystem>
 #include <fstream>
 #include <memory>
+#include <string>
+#include <vector>
 #include <fiu/fiu-local.h>
 #include <fiu-control.h>
 
 #include "easyloggingpp/easylogging++.h"
+#include "storage/DiskCache.h"
 #include "storage/s3/S3ClientWrapper.h"
 #include "storage/s3/S3IOReader.h"
 #include "storage/s3/S3IOWriter.h"
 #include "storage/utils.h"
-
-INITIALIZE_EASYLOGGINGPP
+#include "value/config/ServerConfig.h"
 
 TEST_F(StorageTest, S3_CLIENT_TEST) {
     fiu_init(0);
@@ -144,6 +147,23 @@ TEST_F(StorageTest, S3_FAIL_TEST) {
     ASSERT_TRUE(storage_inst.StartService().ok());
     fiu_disable("S3ClientWrapper.StartService.s3_disable");
 
+    /* the service does not start without credentials */
+    {
+        auto s3_enable = milvus::config.storage.s3_enable();
+        auto access_key = milvus::config.storage.s3_access_key();
+        auto secret_key = milvus::config.storage.s3_secret_key();
+        milvus::config.storage.s3_enable = true;
+        milvus::config.storage.s3_access_key = "";
+        milvus::config.storage.s3_secret_key = "secret";
+        ASSERT_FALSE(storage_inst.StartService().ok());
+        milvus::config.storage.s3_access_key = "access";
+        milvus::config.storage.s3_secret_key = "";
+        ASSERT_FALSE(storage_inst.StartService().ok());
+        milvus::config.storage.s3_enable = s3_enable;
+        milvus::config.storage.s3_access_key = access_key;
+        milvus::config.storage.s3_secret_key = secret_key;
+    }
+
     fiu_enable("S3ClientWrapper.StartService.mock_enable", 1, NULL, 0);
     ASSERT_TRUE(storage_inst.StartService().ok());
     fiu_disable("S3ClientWrapper.StartService.mock_enable");
@@ -198,3 +218,101 @@ TEST_F(StorageTest, S3_FAIL_TEST) {
 
     storage_inst.StopService();
 }
+
+TEST_F(StorageTest, S3_RANGE_TEST) {
+    fiu_init(0);
+
+    const std::string objname = "/tmp/test_range_obj";
+    const std::string filename_out = "/tmp/test_range_file_out";
+    const std::string cache_path = "/tmp/milvus_test/s3_disk_cache";
+
+    auto& storage_inst = milvus::storage::S3ClientWrapper::GetInstance();
+    fiu_enable("S3ClientWrapper.StartService.mock_enable", 1, NULL, 0);
+    ASSERT_TRUE(storage_inst.StartService().ok());
+
+    // larger than two download parts
+    std::string content(milvus::storage::S3_DOWNLOAD_PART_SIZE * 2 + 12345, 0);
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>(i * 31 + i / 4096);
+    }
+    ASSERT_TRUE(storage_inst.PutObjectStr(objname, content).ok());
+
+    int64_t length = 0;
+    ASSERT_TRUE(storage_inst.GetObjectLength(objname, length).ok());
+    ASSERT_EQ(length, content.size());
+
+    /* small range and parallel range */
+    {
+        std::string part(100, 0);
+        ASSERT_TRUE(storage_inst.GetObjectRange(objname, 1000, part.size(), &part[0]).ok());
+        ASSERT_EQ(part, content.substr(1000, part.size()));
+
+        std::string all(content.size() - 10, 0);
+        ASSERT_TRUE(storage_inst.GetObjectRange(objname, 10, all.size(), &all[0]).ok());
+        ASSERT_EQ(all, content.substr(10));
+
+        fiu_enable("S3ClientWrapper.GetPart.outcome.fail", 1, NULL, 0);
+        ASSERT_FALSE(storage_inst.GetObjectRange(objname, 10, all.size(), &all[0]).ok());
+        fiu_disable("S3ClientWrapper.GetPart.outcome.fail");
+    }
+
+    /* parallel download into file */
+    {
+        ASSERT_TRUE(storage_inst.GetObjectFile(objname, filename_out).ok());
+        std::ifstream fs_out(filename_out, std::ios::binary);
+        std::string str_out((std::istreambuf_iterator<char>(fs_out)), std::istreambuf_iterator<char>());
+        ASSERT_EQ(str_out, content);
+    }
+
+    auto read_all = [&](milvus::storage::S3IOReader& reader) {
+        std::string header(16, 0), body(content.size() - 16, 0);
+        reader.Read(&header[0], header.size());
+        reader.Seekg(header.size());
+        reader.Read(&body[0], body.size());
+        return header + body;
+    };
+
+    /* ranged reads without disk cache */
+    {
+        milvus::storage::S3IOReader reader;
+        ASSERT_TRUE(reader.Open(objname));
+        ASSERT_EQ(reader.Length(), content.size());
+        ASSERT_EQ(read_all(reader), content);
+        reader.Close();
+    }
+
+    /* reads from disk cache, the second open doesn't download again */
+    {
+        std::experimental::filesystem::remove_all(cache_path);
+        auto disk_cache = std::make_shared<milvus::storage::DiskCache>(cache_path, content.size() * 2);
+        ASSERT_TRUE(disk_cache->Load().ok());
+        storage_inst.SetDiskCache(disk_cache);
+
+        milvus::storage::S3IOReader reader;
+        ASSERT_TRUE(reader.Open(objname));
+        ASSERT_TRUE(disk_cache->Exist(objname));
+        ASSERT_EQ(read_all(reader), content);
+        reader.Close();
+
+        fiu_enable("S3ClientWrapper.GetObjectLength.outcome.fail", 1, NULL, 0);
+        ASSERT_TRUE(reader.Open(objname));
+        ASSERT_EQ(read_all(reader), content);
+        reader.Close();
+
+        int64_t map_length = 0;
+        auto data = reader.Map(objname, map_length);
+        ASSERT_NE(data, nullptr);
+        ASSERT_EQ(std::string(reinterpret_cast<char*>(data.get()), map_length), content);
+        fiu_disable("S3ClientWrapper.GetObjectLength.outcome.fail");
+
+        // overwritten object is not read from cache
+        ASSERT_TRUE(storage_inst.PutObjectStr(objname, "abc").ok());
+        ASSERT_FALSE(disk_cache->Exist(objname));
+
+        storage_inst.SetDiskCache(nullptr);
+        std::experimental::filesystem::remove_all(cache_path);
+    }
+
+    ASSERT_TRUE(storage_inst.DeleteObject(objname).ok());
+    storage_inst.StopService();
+}
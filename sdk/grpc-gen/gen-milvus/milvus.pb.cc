@@ -1334,58 +1334,59 @@ const char descriptor_table_protodef_milvus_2eproto[] PROTOBUF_SECTION_VARIABLE(
   "amPB\022\027\n\017collection_name\030\001 \001(\t\022\033\n\023partiti"
   "on_tag_array\030\002 \003(\t\0220\n\rgeneral_query\030\003 \001("
   "\0132\031.milvus.grpc.GeneralQuery\022/\n\014extra_pa"
-  "rams\030\004 \003(\0132\031.milvus.grpc.KeyValuePair*\221\001"
+  "rams\030\004 \003(\0132\031.milvus.grpc.KeyValuePair*\272\001"
   "\n\010DataType\022\010\n\004NONE\020\000\022\010\n\004BOOL\020\001\022\010\n\004INT8\020\002"
   "\022\t\n\005INT16\020\003\022\t\n\005INT32\020\004\022\t\n\005INT64\020\005\022\t\n\005FLO"
   "AT\020\n\022\n\n\006DOUBLE\020\013\022\n\n\006STRING\020\024\022\021\n\rVECTOR_B"
-  "INARY\020d\022\020\n\014VECTOR_FLOAT\020e*C\n\017CompareOper"
-  "ator\022\006\n\002LT\020\000\022\007\n\003LTE\020\001\022\006\n\002EQ\020\002\022\006\n\002GT\020\003\022\007\n"
-  "\003GTE\020\004\022\006\n\002NE\020\005*8\n\005Occur\022\013\n\007INVALID\020\000\022\010\n\004"
-  "MUST\020\001\022\n\n\006SHOULD\020\002\022\014\n\010MUST_NOT\020\0032\333\r\n\rMil"
-  "vusService\022\?\n\020CreateCollection\022\024.milvus."
-  "grpc.Mapping\032\023.milvus.grpc.Status\"\000\022F\n\rH"
-  "asCollection\022\033.milvus.grpc.CollectionNam"
-  "e\032\026.milvus.grpc.BoolReply\"\000\022I\n\022DescribeC"
-  "ollection\022\033.milvus.grpc.CollectionName\032\024"
-  ".milvus.grpc.Mapping\"\000\022Q\n\017CountCollectio"
-  "n\022\033.milvus.grpc.CollectionName\032\037.milvus."
-  "grpc.CollectionRowCount\"\000\022J\n\017ShowCollect"
-  "ions\022\024.milvus.grpc.Command\032\037.milvus.grpc"
-  ".CollectionNameList\"\000\022P\n\022ShowCollectionI"
-  "nfo\022\033.milvus.grpc.CollectionName\032\033.milvu"
-  "s.grpc.CollectionInfo\"\000\022D\n\016DropCollectio"
-  "n\022\033.milvus.grpc.CollectionName\032\023.milvus."
-  "grpc.Status\"\000\022=\n\013CreateIndex\022\027.milvus.gr"
-  "pc.IndexParam\032\023.milvus.grpc.Status\"\000\022C\n\r"
-  "DescribeIndex\022\027.milvus.grpc.IndexParam\032\027"
-  ".milvus.grpc.IndexParam\"\000\022;\n\tDropIndex\022\027"
-  ".milvus.grpc.IndexParam\032\023.milvus.grpc.St"
-  "atus\"\000\022E\n\017CreatePartition\022\033.milvus.grpc."
-  "PartitionParam\032\023.milvus.grpc.Status\"\000\022E\n"
-  "\014HasPartition\022\033.milvus.grpc.PartitionPar"
-  "am\032\026.milvus.grpc.BoolReply\"\000\022K\n\016ShowPart"
-  "itions\022\033.milvus.grpc.CollectionName\032\032.mi"
-  "lvus.grpc.PartitionList\"\000\022C\n\rDropPartiti"
-  "on\022\033.milvus.grpc.PartitionParam\032\023.milvus"
-  ".grpc.Status\"\000\022<\n\006Insert\022\030.milvus.grpc.I"
-  "nsertParam\032\026.milvus.grpc.EntityIds\"\000\022E\n\r"
-  "GetEntityByID\022\033.milvus.grpc.EntityIdenti"
-  "ty\032\025.milvus.grpc.Entities\"\000\022H\n\014GetEntity"
-  "IDs\022\036.milvus.grpc.GetEntityIDsParam\032\026.mi"
-  "lvus.grpc.EntityIds\"\000\022>\n\006Search\022\030.milvus"
-  ".grpc.SearchParam\032\030.milvus.grpc.QueryRes"
-  "ult\"\000\022P\n\017SearchInSegment\022!.milvus.grpc.S"
-  "earchInSegmentParam\032\030.milvus.grpc.QueryR"
-  "esult\"\000\0227\n\003Cmd\022\024.milvus.grpc.Command\032\030.m"
-  "ilvus.grpc.StringReply\"\000\022A\n\nDeleteByID\022\034"
-  ".milvus.grpc.DeleteByIDParam\032\023.milvus.gr"
-  "pc.Status\"\000\022G\n\021PreloadCollection\022\033.milvu"
-  "s.grpc.CollectionName\032\023.milvus.grpc.Stat"
-  "us\"\000\0227\n\005Flush\022\027.milvus.grpc.FlushParam\032\023"
-  ".milvus.grpc.Status\"\000\022;\n\007Compact\022\031.milvu"
-  "s.grpc.CompactParam\032\023.milvus.grpc.Status"
-  "\"\000\022B\n\010SearchPB\022\032.milvus.grpc.SearchParam"
-  "PB\032\030.milvus.grpc.QueryResult\"\000b\006proto3"
+  "INARY\020d\022\020\n\014VECTOR_FLOAT\020e\022\022\n\016VECTOR_FLOA"
+  "T16\020f\022\023\n\017VECTOR_BFLOAT16\020g*C\n\017CompareOpe"
+  "rator\022\006\n\002LT\020\000\022\007\n\003LTE\020\001\022\006\n\002EQ\020\002\022\006\n\002GT\020\003\022\007"
+  "\n\003GTE\020\004\022\006\n\002NE\020\005*8\n\005Occur\022\013\n\007INVALID\020\000\022\010\n"
+  "\004MUST\020\001\022\n\n\006SHOULD\020\002\022\014\n\010MUST_NOT\020\0032\333\r\n\rMi"
+  "lvusService\022\?\n\020CreateCollection\022\024.milvus"
+  ".grpc.Mapping\032\023.milvus.grpc.Status\"\000\022F\n\r"
+  "HasCollection\022\033.milvus.grpc.CollectionNa"
+  "me\032\026.milvus.grpc.BoolReply\"\000\022I\n\022Describe"
+  "Collection\022\033.milvus.grpc.CollectionName\032"
+  "\024.milvus.grpc.Mapping\"\000\022Q\n\017CountCollecti"
+  "on\022\033.milvus.grpc.CollectionName\032\037.milvus"
+  ".grpc.CollectionRowCount\"\000\022J\n\017ShowCollec"
+  "tions\022\024.milvus.grpc.Command\032\037.milvus.grp"
+  "c.CollectionNameList\"\000\022P\n\022ShowCollection"
+  "Info\022\033.milvus.grpc.CollectionName\032\033.milv"
+  "us.grpc.CollectionInfo\"\000\022D\n\016DropCollecti"
+  "on\022\033.milvus.grpc.CollectionName\032\023.milvus"
+  ".grpc.Status\"\000\022=\n\013CreateIndex\022\027.milvus.g"
+  "rpc.IndexParam\032\023.milvus.grpc.Status\"\000\022C\n"
+  "\rDescribeIndex\022\027.milvus.grpc.IndexParam\032"
+  "\027.milvus.grpc.IndexParam\"\000\022;\n\tDropIndex\022"
+  "\027.milvus.grpc.IndexParam\032\023.milvus.grpc.S"
+  "tatus\"\000\022E\n\017CreatePartition\022\033.milvus.grpc"
+  ".PartitionParam\032\023.milvus.grpc.Status\"\000\022E"
+  "\n\014HasPartition\022\033.milvus.grpc.PartitionPa"
+  "ram\032\026.milvus.grpc.BoolReply\"\000\022K\n\016ShowPar"
+  "titions\022\033.milvus.grpc.CollectionName\032\032.m"
+  "ilvus.grpc.PartitionList\"\000\022C\n\rDropPartit"
+  "ion\022\033.milvus.grpc.PartitionParam\032\023.milvu"
+  "s.grpc.Status\"\000\022<\n\006Insert\022\030.milvus.grpc."
+  "InsertParam\032\026.milvus.grpc.EntityIds\"\000\022E\n"
+  "\rGetEntityByID\022\033.milvus.grpc.EntityIdent"
+  "ity\032\025.milvus.grpc.Entities\"\000\022H\n\014GetEntit"
+  "yIDs\022\036.milvus.grpc.GetEntityIDsParam\032\026.m"
+  "ilvus.grpc.EntityIds\"\000\022>\n\006Search\022\030.milvu"
+  "s.grpc.SearchParam\032\030.milvus.grpc.QueryRe"
+  "sult\"\000\022P\n\017SearchInSegment\022!.milvus.grpc."
+  "SearchInSegmentParam\032\030.milvus.grpc.Query"
+  "Result\"\000\0227\n\003Cmd\022\024.milvus.grpc.Command\032\030."
+  "milvus.grpc.StringReply\"\000\022A\n\nDeleteByID\022"
+  "\034.milvus.grpc.DeleteByIDParam\032\023.milvus.g"
+  "rpc.Status\"\000\022G\n\021PreloadCollection\022\033.milv"
+  "us.grpc.CollectionName\032\023.milvus.grpc.Sta"
+  "tus\"\000\0227\n\005Flush\022\027.milvus.grpc.FlushParam\032"
+  "\023.milvus.grpc.Status\"\000\022;\n\007Compact\022\031.milv"
+  "us.grpc.CompactParam\032\023.milvus.grpc.Statu"
+  "s\"\000\022B\n\010SearchPB\022\032.milvus.grpc.SearchPara"
+  "mPB\032\030.milvus.grpc.QueryResult\"\000b\006proto3"
   ;
 static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor_table_milvus_2eproto_deps[1] = {
   &::descriptor_table_status_2eproto,
@@ -1435,7 +1436,7 @@ static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_mil
 static ::PROTOBUF_NAMESPACE_ID::internal::once_flag descriptor_table_milvus_2eproto_once;
 static bool descriptor_table_milvus_2eproto_initialized = false;
 const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_milvus_2eproto = {
-  &descriptor_table_milvus_2eproto_initialized, descriptor_table_protodef_milvus_2eproto, "milvus.proto", 6278,
+  &descriptor_table_milvus_2eproto_initialized, descriptor_table_protodef_milvus_2eproto, "milvus.proto", 6319,
   &descriptor_table_milvus_2eproto_once, descriptor_table_milvus_2eproto_sccs, descriptor_table_milvus_2eproto_deps, 40, 1,
   schemas, file_default_instances, TableStruct_milvus_2eproto::offsets,
   file_level_metadata_milvus_2eproto, 41, file_level_enum_descriptors_milvus_2eproto, file_level_service_descriptors_milvus_2eproto,
@@ -1462,6 +1463,8 @@ bool DataType_IsValid(int value) {
     case 20:
     case 100:
     case 101:
+    case 102:
+    case 103:
       return true;
     default:
       return false;
@@ -344,7 +344,9 @@ CopyEntityToJson(::milvus::grpc::Entities& grpc_entities, JSON& json_entity) {
                 double_data.insert(std::make_pair(grpc_field.field_name(), data));
                 break;
             }
-            case ::milvus::grpc::VECTOR_FLOAT: {
+            case ::milvus::grpc::VECTOR_FLOAT:
+            case ::milvus::grpc::VECTOR_FLOAT16:
+            case ::milvus::grpc::VECTOR_BFLOAT16: {
                 std::vector<milvus::VectorData> data(row_num);
                 for (int j = 0; j < row_num; j++) {
                     size_t dim = grpc_vector_record.records(j).float_data_size();
@@ -767,7 +769,10 @@ ParseDsl(const milvus::Mapping& mapping, nlohmann::json& dsl_json, nlohmann::jso
                     const auto& name = element.key();
                     for (const auto& field : mapping.fields) {
                         if (field->name == name) {
-                            if (field->type == milvus::DataType::VECTOR_FLOAT) {
+                            // half precision vectors are passed in float, the server converts them
+                            if (field->type == milvus::DataType::VECTOR_FLOAT ||
+                                field->type == milvus::DataType::VECTOR_FLOAT16 ||
+                                field->type == milvus::DataType::VECTOR_BFLOAT16) {
                                 auto embedding = element.value()["query"].get<std::vector<std::vector<float>>>();
                                 for (const auto& data : embedding) {
                                     milvus::VectorData vector_data = {data, std::vector<uint8_t>()};